@@ -0,0 +1,761 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "CorrelationMatrixCheck.h"
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <math.h>
+#include <algorithm>
+#include <functional>
+
+#define CHOLESKY_BLOCK 96          // columns factorized before the rows below are updated
+#define ROWS_PER_TASK 16
+#define MIN_PIVOT 1.0e-10
+#define MIN_CORRELATION 1.0e-100   // smaller taken as 0
+#define MIN_EIGENVALUE 1.0e-4      // of a repaired matrix
+#define MAX_LANCZOS_STEPS 300
+#define LANCZOS_TOLERANCE 1.0e-10
+#define MAX_OFFENDING_ENTRIES 20
+#define MAX_NEAREST_SIZE 500       // variables, above the matrix is shrunk instead
+#define MAX_PROJECTIONS 200
+#define PROJECTION_TOLERANCE 1.0e-8 // change of the projected matrix, relative
+
+static double dot(const double *x, const double *y, int n)
+{
+    // separate sums so the compiler can vectorize
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    int i = 0;
+    for (; i+4<=n; i+=4) {
+        s0 += x[i]*y[i];
+        s1 += x[i+1]*y[i+1];
+        s2 += x[i+2]*y[i+2];
+        s3 += x[i+3]*y[i+3];
+    }
+    for (; i<n; i++)
+        s0 += x[i]*y[i];
+    return (s0+s1) + (s2+s3);
+}
+
+// the update of rows first to first+3 of the lower triangle right of the
+// panel, the rows of the panel starting at column end: sums over the panel
+// are taken for four rows and four columns at once, each value loaded used
+// four times. first-end is a multiple of four so the columns end on the diagonal
+static void updateRows(double *a, int n, const double *panel, int nb, int end, int first)
+{
+    const double *p0 = panel + static_cast<size_t>(first-end)*nb;
+    const double *p1 = p0 + nb;
+    const double *p2 = p1 + nb;
+    const double *p3 = p2 + nb;
+
+    for (int j=end; j<=first; j+=4) {
+        const double *q0 = panel + static_cast<size_t>(j-end)*nb;
+        const double *q1 = q0 + nb;
+        const double *q2 = q1 + nb;
+        const double *q3 = q2 + nb;
+        double s[4][4] = {{0.}};
+        for (int k=0; k<nb; k++) {
+            double x0 = p0[k], x1 = p1[k], x2 = p2[k], x3 = p3[k];
+            double y0 = q0[k], y1 = q1[k], y2 = q2[k], y3 = q3[k];
+            s[0][0] += x0*y0; s[0][1] += x0*y1; s[0][2] += x0*y2; s[0][3] += x0*y3;
+            s[1][0] += x1*y0; s[1][1] += x1*y1; s[1][2] += x1*y2; s[1][3] += x1*y3;
+            s[2][0] += x2*y0; s[2][1] += x2*y1; s[2][2] += x2*y2; s[2][3] += x2*y3;
+            s[3][0] += x3*y0; s[3][1] += x3*y1; s[3][2] += x3*y2; s[3][3] += x3*y3;
+        }
+
+        for (int r=0; r<4; r++) {
+            double *row = a + static_cast<size_t>(first+r)*n;
+            for (int c=0; c<4; c++)
+                if (j+c <= first+r)
+                    row[j+c] -= s[r][c];
+        }
+    }
+}
+
+// first row of each task over rows first to n-1
+static std::vector<int> rowTasks(int first, int n)
+{
+    std::vector<int> tasks;
+    for (int i=first; i<n; i+=ROWS_PER_TASK)
+        tasks.push_back(i);
+    return tasks;
+}
+
+CorrelationMatrixCheck::CorrelationMatrixCheck()
+    :size(0), failedVariable(-1), shrinking(0.), repairMethod(NearestMatrix), projected(false), repairDistance(0.)
+{
+
+}
+
+void
+CorrelationMatrixCheck::setRepairMethod(RepairMethod method)
+{
+    repairMethod = method;
+}
+
+void
+CorrelationMatrixCheck::setMatrix(const std::vector<double> &values, int n)
+{
+    theMatrix = values;
+    size = n;
+    failedVariable = -1;
+    offendingEntries.clear();
+    shrinking = 0.;
+    projected = false;
+    repairDistance = 0.;
+}
+
+int
+CorrelationMatrixCheck::getSize(void) const
+{
+    return size;
+}
+
+const std::vector<double> &
+CorrelationMatrixCheck::getMatrix(void) const
+{
+    return theMatrix;
+}
+
+bool
+CorrelationMatrixCheck::isPositiveDefinite(void) const
+{
+    return failedVariable < 0;
+}
+
+int
+CorrelationMatrixCheck::getFailedVariable(void) const
+{
+    return failedVariable;
+}
+
+const std::vector<std::pair<int, int> > &
+CorrelationMatrixCheck::getOffendingEntries(void) const
+{
+    return offendingEntries;
+}
+
+double
+CorrelationMatrixCheck::getShrinking(void) const
+{
+    return shrinking;
+}
+
+bool
+CorrelationMatrixCheck::wasProjected(void) const
+{
+    return projected;
+}
+
+double
+CorrelationMatrixCheck::getRepairDistance(void) const
+{
+    return repairDistance;
+}
+
+int
+CorrelationMatrixCheck::choleskyFactor(std::vector<double> &a, int n)
+{
+    std::vector<double> panel;
+
+    // correlations that small only slow the arithmetic, e.g. those far
+    // apart in a matrix decaying with distance would reach denormals
+    for (size_t i=0; i<a.size(); i++)
+        if (fabs(a[i]) < MIN_CORRELATION)
+            a[i] = 0.;
+
+    for (int kb=0; kb<n; kb+=CHOLESKY_BLOCK) {
+        int nb = std::min(CHOLESKY_BLOCK, n-kb);
+        int end = kb+nb;
+
+        //
+        // the diagonal block, columns left of it have been applied already
+        //
+
+        for (int k=kb; k<end; k++) {
+            double *rowK = &a[static_cast<size_t>(k)*n];
+            double d = rowK[k] - dot(rowK+kb, rowK+kb, k-kb);
+            if (!(d > MIN_PIVOT))
+                return k;
+            rowK[k] = sqrt(d);
+            for (int i=k+1; i<end; i++) {
+                double *rowI = &a[static_cast<size_t>(i)*n];
+                rowI[k] = (rowI[k] - dot(rowI+kb, rowK+kb, k-kb))/rowK[k];
+            }
+        }
+
+        if (end == n)
+            break;
+
+        //
+        // the block's columns of the rows below, kept packed for the update
+        //
+
+        panel.resize(static_cast<size_t>(n-end)*nb);
+        std::vector<int> tasks = rowTasks(end, n);
+
+        QtConcurrent::blockingMap(tasks, [&a, &panel, n, kb, nb, end](int &first) {
+            int last = std::min(first+ROWS_PER_TASK, n);
+            for (int i=first; i<last; i++) {
+                double *rowI = &a[static_cast<size_t>(i)*n];
+                double *p = &panel[static_cast<size_t>(i-end)*nb];
+                for (int k=0; k<nb; k++) {
+                    const double *rowK = &a[static_cast<size_t>(kb+k)*n];
+                    p[k] = (rowI[kb+k] - dot(p, rowK+kb, k))/rowK[kb+k];
+                }
+                std::copy(p, p+nb, rowI+kb);
+            }
+        });
+
+        //
+        // the lower triangle right of the block
+        //
+
+        QtConcurrent::blockingMap(tasks, [&a, &panel, n, nb, end](int &first) {
+            int last = std::min(first+ROWS_PER_TASK, n);
+            int i = first;
+            for (; i+4<=last; i+=4)
+                updateRows(a.data(), n, panel.data(), nb, end, i);
+            for (; i<last; i++) {
+                double *rowI = &a[static_cast<size_t>(i)*n];
+                const double *pI = &panel[static_cast<size_t>(i-end)*nb];
+                for (int j=end; j<=i; j++)
+                    rowI[j] -= dot(pI, &panel[static_cast<size_t>(j-end)*nb], nb);
+            }
+        });
+    }
+
+    return -1;
+}
+
+bool
+CorrelationMatrixCheck::check(void)
+{
+    std::vector<double> factor(theMatrix);
+    failedVariable = choleskyFactor(factor, size);
+    offendingEntries.clear();
+    if (failedVariable >= 0)
+        this->findOffendingEntries(factor);
+    return failedVariable < 0;
+}
+
+void
+CorrelationMatrixCheck::findOffendingEntries(const std::vector<double> &factor)
+{
+    //
+    // with L the factor of the first k variables and c their correlations
+    // with variable k, the pivot is 1 - c'z, z = inv(L L') c; it falls by
+    // c(j) z(j) for each entry. those falling most are flagged until they
+    // are enough, on their own, to take the pivot below MIN_PIVOT
+    //
+
+    int k = failedVariable;
+    int n = size;
+    const double *y = &factor[static_cast<size_t>(k)*n];  // L y = c, row k of the factor
+
+    std::vector<double> z(y, y+k);
+    for (int j=k-1; j>=0; j--) {
+        double s = z[j];
+        for (int i=j+1; i<k; i++)
+            s -= factor[static_cast<size_t>(i)*n + j]*z[i];
+        z[j] = s/factor[static_cast<size_t>(j)*n + j];
+    }
+
+    std::vector<std::pair<double, int> > falls;
+    double pivot = theMatrix[static_cast<size_t>(k)*n + k];
+    for (int j=0; j<k; j++) {
+        double c = theMatrix[static_cast<size_t>(j)*n + k];
+        double fall = c*z[j];
+        pivot -= fall;
+        if (fall > 0.)
+            falls.push_back(std::make_pair(fall, j));
+    }
+    std::sort(falls.begin(), falls.end(), std::greater<std::pair<double, int> >());
+
+    double excess = MIN_PIVOT - pivot;
+    double sum = 0.;
+    for (size_t i=0; i<falls.size() && offendingEntries.size() < MAX_OFFENDING_ENTRIES; i++) {
+        offendingEntries.push_back(std::make_pair(falls[i].second, k));
+        sum += falls[i].first;
+        if (sum >= excess)
+            break;
+    }
+}
+
+double
+CorrelationMatrixCheck::smallestEigenvalue(const std::vector<double> &a, int n)
+{
+    if (n == 0)
+        return 0.;
+
+    //
+    // Lanczos with full reorthogonalization, the smallest eigenvalue of the
+    // tridiagonal matrix found by bisection on its Sturm sequence
+    //
+
+    int maxSteps = std::min(n, MAX_LANCZOS_STEPS);
+    std::vector<double> V(static_cast<size_t>(maxSteps+1)*n);
+    std::vector<double> alpha, beta;
+    std::vector<double> w(n);
+    std::vector<double> h(maxSteps);
+
+    // any start not orthogonal to the eigenvector will do
+    unsigned int seed = 12345;
+    double norm = 0.;
+    for (int i=0; i<n; i++) {
+        seed = seed*1103515245u + 12345u;
+        V[i] = 0.5 + ((seed >> 16) & 0x7fff)/32768.0;
+        norm += V[i]*V[i];
+    }
+    norm = sqrt(norm);
+    for (int i=0; i<n; i++)
+        V[i] /= norm;
+
+    std::vector<int> tasks = rowTasks(0, n);
+    double theta = 0.;
+    double lastTheta = 0.;
+
+    for (int step=0; step<maxSteps; step++) {
+        const double *v = &V[static_cast<size_t>(step)*n];
+
+        QtConcurrent::blockingMap(tasks, [&a, &w, v, n](int &first) {
+            int last = std::min(first+ROWS_PER_TASK, n);
+            for (int i=first; i<last; i++)
+                w[i] = dot(&a[static_cast<size_t>(i)*n], v, n);
+        });
+
+        alpha.push_back(dot(w.data(), v, n));
+
+        // against every vector so far, twice: the projections all found
+        // first, then taken off a block of rows at a time
+        for (int pass=0; pass<2; pass++) {
+            std::vector<int> vectors(step+1);
+            for (int l=0; l<=step; l++)
+                vectors[l] = l;
+            QtConcurrent::blockingMap(vectors, [&V, &w, &h, n](int &l) {
+                h[l] = dot(w.data(), &V[static_cast<size_t>(l)*n], n);
+            });
+            QtConcurrent::blockingMap(tasks, [&V, &w, &h, n, step](int &first) {
+                int last = std::min(first+ROWS_PER_TASK, n);
+                for (int l=0; l<=step; l++) {
+                    const double *u = &V[static_cast<size_t>(l)*n];
+                    for (int i=first; i<last; i++)
+                        w[i] -= h[l]*u[i];
+                }
+            });
+        }
+
+        double b = sqrt(dot(w.data(), w.data(), n));
+
+        bool lastStep = (step == maxSteps-1 || b < 1.0e-12);
+        if (lastStep || step%10 == 9) {
+            int m = static_cast<int>(alpha.size());
+
+            // Gershgorin bounds, then count the eigenvalues below x
+            double low = alpha[0], high = alpha[0];
+            for (int i=0; i<m; i++) {
+                double r = (i > 0 ? fabs(beta[i-1]) : 0.) + (i < m-1 ? fabs(beta[i]) : 0.);
+                low = std::min(low, alpha[i]-r);
+                high = std::max(high, alpha[i]+r);
+            }
+            for (int iter=0; iter<200 && high-low > 1.0e-14*std::max(1., fabs(low)); iter++) {
+                double x = 0.5*(low+high);
+                int below = 0;
+                double q = alpha[0] - x;
+                for (int i=0; ; i++) {
+                    if (q < 0.)
+                        below++;
+                    if (i == m-1)
+                        break;
+                    if (q == 0.)
+                        q = 1.0e-300;
+                    q = alpha[i+1] - x - beta[i]*beta[i]/q;
+                }
+                if (below > 0)
+                    high = x;
+                else
+                    low = x;
+            }
+            theta = high;
+
+            if (lastStep || (step > 9 && fabs(theta-lastTheta) <= LANCZOS_TOLERANCE*std::max(1., fabs(theta))))
+                break;
+            lastTheta = theta;
+        }
+
+        beta.push_back(b);
+        double *next = &V[static_cast<size_t>(step+1)*n];
+        for (int i=0; i<n; i++)
+            next[i] = w[i]/b;
+    }
+
+    return theta;
+}
+
+void
+CorrelationMatrixCheck::symmetricEigen(std::vector<double> &a, int n, std::vector<double> &values)
+{
+    values.assign(n, 0.);
+    if (n == 0)
+        return;
+    if (n == 1) {
+        values[0] = a[0];
+        a[0] = 1.;
+        return;
+    }
+
+    //
+    // Householder reduction to tridiagonal form, the transformations
+    // accumulated in a (tred2, as in EISPACK and JAMA); d the diagonal and
+    // e the subdiagonal
+    //
+
+    std::vector<double> &V = a;
+    std::vector<double> &d = values;
+    std::vector<double> e(n, 0.);
+    size_t N = n;
+
+    for (int j=0; j<n; j++)
+        d[j] = V[(N-1)*N+j];
+
+    for (int i=n-1; i>0; i--) {
+        double *Vi = &V[i*N];
+        double scale = 0., h = 0.;
+        for (int k=0; k<i; k++)
+            scale += fabs(d[k]);
+        if (scale == 0.) {
+            e[i] = d[i-1];
+            for (int j=0; j<i; j++) {
+                d[j] = V[(i-1)*N+j];
+                Vi[j] = 0.;
+                V[j*N+i] = 0.;
+            }
+        } else {
+            for (int k=0; k<i; k++) {
+                d[k] /= scale;
+                h += d[k]*d[k];
+            }
+            double f = d[i-1];
+            double g = sqrt(h);
+            if (f > 0)
+                g = -g;
+            e[i] = scale*g;
+            h -= f*g;
+            d[i-1] = f-g;
+            for (int j=0; j<i; j++)
+                e[j] = 0.;
+            for (int j=0; j<i; j++) {
+                f = d[j];
+                V[j*N+i] = f;
+                g = e[j] + V[j*N+j]*f;
+                for (int k=j+1; k<=i-1; k++) {
+                    g += V[k*N+j]*d[k];
+                    e[k] += V[k*N+j]*f;
+                }
+                e[j] = g;
+            }
+            f = 0.;
+            for (int j=0; j<i; j++) {
+                e[j] /= h;
+                f += e[j]*d[j];
+            }
+            double hh = f/(h+h);
+            for (int j=0; j<i; j++)
+                e[j] -= hh*d[j];
+            for (int j=0; j<i; j++) {
+                f = d[j];
+                g = e[j];
+                for (int k=j; k<=i-1; k++)
+                    V[k*N+j] -= (f*e[k] + g*d[k]);
+                d[j] = V[(i-1)*N+j];
+                Vi[j] = 0.;
+            }
+        }
+        d[i] = h;
+    }
+
+    for (int i=0; i<n-1; i++) {
+        V[(N-1)*N+i] = V[i*N+i];
+        V[i*N+i] = 1.;
+        double h = d[i+1];
+        if (h != 0.) {
+            for (int k=0; k<=i; k++)
+                d[k] = V[k*N+i+1]/h;
+            for (int j=0; j<=i; j++) {
+                double g = 0.;
+                for (int k=0; k<=i; k++)
+                    g += V[k*N+i+1]*V[k*N+j];
+                for (int k=0; k<=i; k++)
+                    V[k*N+j] -= g*d[k];
+            }
+        }
+        for (int k=0; k<=i; k++)
+            V[k*N+i+1] = 0.;
+    }
+    for (int j=0; j<n; j++) {
+        d[j] = V[(N-1)*N+j];
+        V[(N-1)*N+j] = 0.;
+    }
+    V[(N-1)*N+N-1] = 1.;
+    e[0] = 0.;
+
+    //
+    // implicit QL on the tridiagonal matrix (tql2). the eigenvectors are
+    // the columns of V; it is transposed first so each rotation runs along
+    // two rows in memory, leaving the eigenvectors as its rows
+    //
+
+    for (int i=0; i<n; i++)
+        for (int j=i+1; j<n; j++)
+            std::swap(V[i*N+j], V[j*N+i]);
+
+    for (int i=1; i<n; i++)
+        e[i-1] = e[i];
+    e[n-1] = 0.;
+
+    double f = 0., tst1 = 0.;
+    const double eps = 2.220446049250313e-16;
+    for (int l=0; l<n; l++) {
+        tst1 = std::max(tst1, fabs(d[l]) + fabs(e[l]));
+        int m = l;
+        while (m < n-1 && fabs(e[m]) > eps*tst1)
+            m++;
+
+        if (m > l) {
+            for (int iter=0; iter<100 && fabs(e[l]) > eps*tst1; iter++) {
+                double g = d[l];
+                double p = (d[l+1]-g)/(2.*e[l]);
+                double r = hypot(p, 1.);
+                if (p < 0)
+                    r = -r;
+                d[l] = e[l]/(p+r);
+                d[l+1] = e[l]*(p+r);
+                double dl1 = d[l+1];
+                double h = g - d[l];
+                for (int i=l+2; i<n; i++)
+                    d[i] -= h;
+                f += h;
+
+                p = d[m];
+                double c = 1., c2 = 1., c3 = 1.;
+                double el1 = e[l+1];
+                double s = 0., s2 = 0.;
+                for (int i=m-1; i>=l; i--) {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c*e[i];
+                    h = c*p;
+                    r = hypot(p, e[i]);
+                    e[i+1] = s*r;
+                    s = e[i]/r;
+                    c = p/r;
+                    p = c*d[i] - s*g;
+                    d[i+1] = h + s*(c*g + s*d[i]);
+                    double *u = &V[i*N];
+                    double *w = &V[(i+1)*N];
+                    for (int k=0; k<n; k++) {
+                        h = w[k];
+                        w[k] = s*u[k] + c*h;
+                        u[k] = c*u[k] - s*h;
+                    }
+                }
+                p = -s*s2*c3*el1*e[l]/dl1;
+                e[l] = s*p;
+                d[l] = c*p;
+            }
+        }
+        d[l] += f;
+        e[l] = 0.;
+    }
+
+    // increasing, the vectors with them
+    for (int i=0; i<n-1; i++) {
+        int k = i;
+        for (int j=i+1; j<n; j++)
+            if (d[j] < d[k])
+                k = j;
+        if (k != i) {
+            std::swap(d[i], d[k]);
+            std::swap_ranges(V.begin()+i*N, V.begin()+(i+1)*N, V.begin()+k*N);
+        }
+    }
+}
+
+bool
+CorrelationMatrixCheck::nearestCorrelation(const std::vector<double> &a, int n, std::vector<double> &nearest)
+{
+    //
+    // Y is the last matrix with unit diagonal, X the last with eigenvalues
+    // of at least MIN_EIGENVALUE and dS Dykstra's correction, what the last
+    // projection onto those eigenvalues took off. raising the eigenvalues
+    // below MIN_EIGENVALUE only needs their eigenvectors,
+    //     X = R + sum (MIN_EIGENVALUE - lambda) v v^T
+    //
+
+    size_t N = n;
+    std::vector<double> Y = a, X(N*N), R(N*N), dS(N*N, 0.), V;
+    std::vector<double> values, raise;
+    std::vector<int> tasks = rowTasks(0, n);
+
+    for (int iteration=0; iteration<MAX_PROJECTIONS; iteration++) {
+        for (size_t i=0; i<N*N; i++)
+            R[i] = Y[i] - dS[i];
+
+        V = R;
+        symmetricEigen(V, n, values);
+        int numLow = 0;
+        while (numLow < n && values[numLow] < MIN_EIGENVALUE)
+            numLow++;
+        raise.resize(numLow);
+        for (int k=0; k<numLow; k++)
+            raise[k] = MIN_EIGENVALUE - values[k];
+
+        double change = 0., norm = 0.;
+        QtConcurrent::blockingMap(tasks, [&X, &R, &V, &raise, numLow, n](int &first) {
+            int last = std::min(first+ROWS_PER_TASK, n);
+            size_t N = n;
+            for (int i=first; i<last; i++) {
+                for (int j=0; j<n; j++) {
+                    double sum = R[i*N+j];
+                    for (int k=0; k<numLow; k++)
+                        sum += raise[k]*V[k*N+i]*V[k*N+j];
+                    X[i*N+j] = sum;
+                }
+            }
+        });
+
+        for (size_t i=0; i<N*N; i++)
+            dS[i] = X[i] - R[i];
+
+        // onto unit diagonals, then the change in Y says if it has settled
+        for (int i=0; i<n; i++) {
+            for (int j=0; j<n; j++) {
+                double y = (i == j) ? 1. : X[i*N+j];
+                change += (y - Y[i*N+j])*(y - Y[i*N+j]);
+                norm += y*y;
+                Y[i*N+j] = y;
+            }
+        }
+
+        if (sqrt(change) <= PROJECTION_TOLERANCE*sqrt(norm)) {
+            nearest.swap(Y);
+            return true;
+        }
+    }
+
+    nearest.swap(Y);
+    return false;
+}
+
+double
+CorrelationMatrixCheck::shrinkToDefinite(std::vector<double> &a, int n)
+{
+    //
+    // the eigenvalues of C(alpha) are (1-alpha) lambda + alpha. the Lanczos
+    // estimate is never below the smallest, so the margin is raised until
+    // the factorization passes, at worst reaching the identity
+    //
+
+    double theta = smallestEigenvalue(a, n);
+    std::vector<double> shrunk, factor;
+    std::vector<int> tasks = rowTasks(0, n);
+
+    for (double margin = MIN_EIGENVALUE; ; margin *= 10.) {
+        double alpha = 1.;
+        if (margin < 1. && theta < 1.)
+            alpha = std::min(1., std::max(0., (margin-theta)/(1.-theta)));
+
+        shrunk = a;
+        if (alpha > 0.) {
+            QtConcurrent::blockingMap(tasks, [&shrunk, n, alpha](int &first) {
+                int last = std::min(first+ROWS_PER_TASK, n);
+                for (int i=first; i<last; i++) {
+                    double *row = &shrunk[static_cast<size_t>(i)*n];
+                    for (int j=0; j<n; j++)
+                        row[j] *= (1.-alpha);
+                    row[i] = 1.;
+                }
+            });
+        }
+
+        factor = shrunk;
+        if (choleskyFactor(factor, n) < 0 || alpha >= 1.) {
+            a.swap(shrunk);
+            return alpha;
+        }
+    }
+}
+
+bool
+CorrelationMatrixCheck::repair(void)
+{
+    //
+    // a matrix already with eigenvalues of at least MIN_EIGENVALUE is left
+    // alone; otherwise the nearest such matrix, if wanted and it can be
+    // found, then shrinking of that or of the matrix as needed
+    //
+
+    shrinking = 0.;
+    projected = false;
+    repairDistance = 0.;
+    offendingEntries.clear();
+    failedVariable = -1;
+
+    int n = size;
+    std::vector<double> factor = theMatrix;
+    if (choleskyFactor(factor, n) < 0 && smallestEigenvalue(theMatrix, n) >= MIN_EIGENVALUE)
+        return false;
+
+    std::vector<double> repaired;
+    if (repairMethod == NearestMatrix && n <= MAX_NEAREST_SIZE
+            && nearestCorrelation(theMatrix, n, repaired)) {
+        projected = true;
+    } else
+        repaired = theMatrix;
+
+    // a projected matrix has eigenvalues of about MIN_EIGENVALUE, so at most a little shrinking
+    factor = repaired;
+    if (!projected || choleskyFactor(factor, n) >= 0)
+        shrinking = shrinkToDefinite(repaired, n);
+
+    double sum = 0.;
+    for (size_t i=0; i<repaired.size(); i++)
+        sum += (repaired[i]-theMatrix[i])*(repaired[i]-theMatrix[i]);
+    repairDistance = sqrt(sum);
+
+    theMatrix.swap(repaired);
+    return true;
+}
@@ -0,0 +1,356 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "CorrelationMatrixModel.h"
+#include <QColor>
+
+#include <algorithm>
+
+CorrelationMatrixModel::CorrelationMatrixModel(QObject *parent)
+    :QAbstractTableModel(parent), numSlots(0), numColumns(0), removedColumn(-1)
+{
+
+}
+
+CorrelationMatrixModel::~CorrelationMatrixModel()
+{
+
+}
+
+int
+CorrelationMatrixModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return theNames.size();
+}
+
+int
+CorrelationMatrixModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return numColumns;
+}
+
+// the variable shown in a column, -1 for the column of a removed variable
+// still waiting to be taken out of the view
+int
+CorrelationMatrixModel::columnVariable(int column) const
+{
+    if (removedColumn < 0 || column < removedColumn)
+        return column;
+    if (column == removedColumn)
+        return -1;
+    return column-1;
+}
+
+size_t
+CorrelationMatrixModel::offset(int row, int col) const
+{
+    size_t a = theSlots[row];
+    size_t b = theSlots[col];
+    if (a < b)
+        std::swap(a, b);
+    return a*(a+1)/2 + b;
+}
+
+double
+CorrelationMatrixModel::getValue(int row, int col) const
+{
+    if (row == col)
+        return 1.0;
+    return theValues[this->offset(row, col)];
+}
+
+void
+CorrelationMatrixModel::setValue(int row, int col, double value)
+{
+    if (row != col)
+        theValues[this->offset(row, col)] = value;
+}
+
+int
+CorrelationMatrixModel::getNumVariables(void) const
+{
+    return theNames.size();
+}
+
+QVariant
+CorrelationMatrixModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    int variable = this->columnVariable(index.column());
+    if (variable < 0)
+        return QVariant();
+
+    // text for the editor too, a spin box would round to its decimals
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return QString::number(this->getValue(index.row(), variable));
+
+    int row = std::min(index.row(), variable);
+    int col = std::max(index.row(), variable);
+    bool offending = (offendingEntries.find(std::make_pair(row, col)) != offendingEntries.end());
+
+    if (role == Qt::BackgroundRole) {
+        if (offending)
+            return QColor(255, 160, 160);
+        if (variable <= index.row())
+            return QColor(240, 240, 240);
+    }
+
+    if (role == Qt::ToolTipRole && offending)
+        return tr("with the entries above and to the left this keeps the matrix from being positive definite");
+
+    return QVariant();
+}
+
+bool
+CorrelationMatrixModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.column() <= index.row())
+        return false;
+
+    bool ok;
+    double r = value.toString().toDouble(&ok);
+    if (!ok || r < -1.0 || r > 1.0)
+        return false;
+
+    this->setValue(index.row(), index.column(), r);
+    QModelIndex mirror = this->index(index.column(), index.row());
+    emit dataChanged(index, index);
+    emit dataChanged(mirror, mirror);
+    emit matrixChanged();
+    return true;
+}
+
+QVariant
+CorrelationMatrixModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal)
+        section = this->columnVariable(section);
+
+    if (role != Qt::DisplayRole || section < 0 || section >= theNames.size())
+        return QVariant();
+    return theNames.at(section);
+}
+
+Qt::ItemFlags
+CorrelationMatrixModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    int variable = this->columnVariable(index.column());
+    if (variable < 0)
+        return Qt::NoItemFlags;
+    if (variable > index.row())
+        return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+void
+CorrelationMatrixModel::addVariable(const QString &name)
+{
+    this->clearOffendingEntries();
+
+    int numVariables = theNames.size();
+    this->beginInsertRows(QModelIndex(), numVariables, numVariables);
+
+    int slot;
+    if (freeSlots.empty()) {
+        // a new last row of the triangle
+        slot = numSlots++;
+        theValues.resize(theValues.size() + slot + 1, 0.0);
+    } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    theNames.append(name);
+    theSlots.push_back(slot);
+
+    // uncorrelated with every variable present
+    for (int i=0; i<numVariables; i++)
+        this->setValue(i, numVariables, 0.0);
+
+    this->endInsertRows();
+
+    this->beginInsertColumns(QModelIndex(), numVariables, numVariables);
+    numColumns++;
+    this->endInsertColumns();
+
+    emit matrixChanged();
+}
+
+void
+CorrelationMatrixModel::removeVariable(int index)
+{
+    if (index < 0 || index >= theNames.size())
+        return;
+
+    this->clearOffendingEntries();
+
+    // the row goes first, its column is left empty until it goes too
+    this->beginRemoveRows(QModelIndex(), index, index);
+    freeSlots.push_back(theSlots[index]);
+    theSlots.erase(theSlots.begin() + index);
+    theNames.removeAt(index);
+    removedColumn = index;
+    this->endRemoveRows();
+
+    this->beginRemoveColumns(QModelIndex(), index, index);
+    numColumns--;
+    removedColumn = -1;
+    this->endRemoveColumns();
+
+    if (freeSlots.size() > theSlots.size())
+        this->compact();
+
+    emit matrixChanged();
+}
+
+void
+CorrelationMatrixModel::compact(void)
+{
+    int numVariables = theNames.size();
+    std::vector<double> values(static_cast<size_t>(numVariables)*(numVariables+1)/2);
+    for (int i=0; i<numVariables; i++) {
+        double *row = &values[static_cast<size_t>(i)*(i+1)/2];
+        for (int j=0; j<i; j++)
+            row[j] = theValues[this->offset(i, j)];
+        row[i] = 1.0;
+    }
+
+    theValues.swap(values);
+    for (int i=0; i<numVariables; i++)
+        theSlots[i] = i;
+    freeSlots.clear();
+    numSlots = numVariables;
+}
+
+void
+CorrelationMatrixModel::setVariableNames(const QStringList &names)
+{
+    if (names.size() != theNames.size())
+        return;
+
+    theNames = names;
+    if (!theNames.isEmpty()) {
+        emit headerDataChanged(Qt::Horizontal, 0, theNames.size()-1);
+        emit headerDataChanged(Qt::Vertical, 0, theNames.size()-1);
+    }
+}
+
+void
+CorrelationMatrixModel::clear(void)
+{
+    this->beginResetModel();
+    theNames.clear();
+    theSlots.clear();
+    freeSlots.clear();
+    theValues.clear();
+    numSlots = 0;
+    numColumns = 0;
+    removedColumn = -1;
+    offendingEntries.clear();
+    this->endResetModel();
+    emit matrixChanged();
+}
+
+void
+CorrelationMatrixModel::getMatrix(std::vector<double> &values) const
+{
+    int numVariables = theNames.size();
+    values.resize(static_cast<size_t>(numVariables)*numVariables);
+    for (int i=0; i<numVariables; i++) {
+        double *row = &values[static_cast<size_t>(i)*numVariables];
+        for (int j=0; j<i; j++) {
+            row[j] = theValues[this->offset(i, j)];
+            values[static_cast<size_t>(j)*numVariables + i] = row[j];
+        }
+        row[i] = 1.0;
+    }
+}
+
+void
+CorrelationMatrixModel::setMatrix(const std::vector<double> &values)
+{
+    int numVariables = theNames.size();
+    if (values.size() != static_cast<size_t>(numVariables)*numVariables)
+        return;
+
+    // one triangle, both are held in the same place
+    for (int i=0; i<numVariables; i++)
+        for (int j=0; j<i; j++)
+            this->setValue(i, j, values[static_cast<size_t>(i)*numVariables + j]);
+
+    offendingEntries.clear();
+    this->updateEntries();
+    emit matrixChanged();
+}
+
+void
+CorrelationMatrixModel::setOffendingEntries(const std::vector<std::pair<int, int> > &entries)
+{
+    if (offendingEntries.empty() && entries.empty())
+        return;
+
+    offendingEntries.clear();
+    offendingEntries.insert(entries.begin(), entries.end());
+    this->updateEntries();
+}
+
+// the entries are indices of variables, they go before any is added or removed
+void
+CorrelationMatrixModel::clearOffendingEntries(void)
+{
+    if (offendingEntries.empty())
+        return;
+
+    offendingEntries.clear();
+    this->updateEntries();
+}
+
+void
+CorrelationMatrixModel::updateEntries(void)
+{
+    int numVariables = theNames.size();
+    if (numVariables > 0)
+        emit dataChanged(this->index(0, 0), this->index(numVariables-1, numVariables-1),
+                         QVector<int>() << Qt::DisplayRole << Qt::BackgroundRole << Qt::ToolTipRole);
+}
@@ -0,0 +1,111 @@
+#ifndef CORRELATION_MATRIX_MODEL_H
+#define CORRELATION_MATRIX_MODEL_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// the correlation matrix of the random variables, held as doubles and shown
+// through a table model. only the lower triangle is stored, packed by the
+// slot each variable was given, so a variable is added or removed without
+// moving the rest of the matrix; the slots freed by removals are reused and
+// the matrix is compacted once more than half of them are free. the upper
+// triangle is edited in the view, the lower mirrors it and the diagonal is 1.
+// entries found to keep the matrix from being positive definite are shown red.
+// a variable is added or removed as a row and a column, so a view keeps its
+// layout; between the two the columns lag the rows by that one variable
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <vector>
+#include <set>
+#include <utility>
+
+class CorrelationMatrixModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit CorrelationMatrixModel(QObject *parent = 0);
+    ~CorrelationMatrixModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    // variables are added uncorrelated with the others
+    void addVariable(const QString &name);
+    void removeVariable(int index);
+    void setVariableNames(const QStringList &names);
+    void clear(void);
+
+    int getNumVariables(void) const;
+    double getValue(int row, int col) const;
+
+    // sets both (row,col) and (col,row) without telling any view
+    void setValue(int row, int col, double value);
+
+    // the full matrix, row major
+    void getMatrix(std::vector<double> &values) const;
+    void setMatrix(const std::vector<double> &values);
+
+    // (row, col) in the upper triangle
+    void setOffendingEntries(const std::vector<std::pair<int, int> > &entries);
+
+signals:
+    // any change of the variables or the values but those by setValue()
+    void matrixChanged(void);
+
+private:
+    size_t offset(int row, int col) const;
+    void compact(void);
+    int columnVariable(int column) const;
+    void clearOffendingEntries(void);
+
+    void updateEntries(void);
+
+    QStringList theNames;
+    std::vector<int> theSlots;       // slot of each variable
+    std::vector<int> freeSlots;
+    std::vector<double> theValues;   // packed lower triangle of numSlots slots
+    int numSlots;
+    int numColumns;                  // columns the views have been told of
+    int removedColumn;               // column of a variable being removed, or -1
+    std::set<std::pair<int, int> > offendingEntries;
+};
+
+#endif // CORRELATION_MATRIX_MODEL_H
@@ -11,12 +11,17 @@ INCLUDEPATH+=$$PWD
 
 INCLUDEPATH+=../Common
 
+# the correlation matrix is checked on worker threads
+QT += concurrent
+
 SOURCES += $$PWD/RandomVariableDistribution.cpp \
     $$PWD/NormalDistribution.cpp \
     $$PWD/RandomVariable.cpp \
     $$PWD/LognormalDistribution.cpp \
     $$PWD/BetaDistribution.cpp \
     $$PWD/RandomVariablesContainer.cpp \
+    $$PWD/CorrelationMatrixModel.cpp \
+    $$PWD/CorrelationMatrixCheck.cpp \
     $$PWD/UniformDistribution.cpp \
     $$PWD/ConstantDistribution.cpp \
     $$PWD/ContinuousDesignDistribution.cpp \
@@ -32,6 +37,8 @@ HEADERS += $$PWD/RandomVariableDistribution.h \
     $$PWD/LognormalDistribution.h \
     $$PWD/BetaDistribution.h \
     $$PWD/RandomVariablesContainer.h \
+    $$PWD/CorrelationMatrixModel.h \
+    $$PWD/CorrelationMatrixCheck.h \
     $$PWD/UniformDistribution.h \
     $$PWD/ConstantDistribution.h \
     $$PWD/ContinuousDesignDistribution.h \
@@ -41,6 +41,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "RandomVariablesContainer.h"
 #include "ConstantDistribution.h"
 #include "NormalDistribution.h"
+#include "CorrelationMatrixModel.h"
 #include <QPushButton>
 #include <QScrollArea>
 #include <QJsonArray>
@@ -49,13 +50,19 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QDebug>
 #include <sectiontitle.h>
 #include <QLineEdit>
-#include <QTableWidget>
+#include <QTableView>
 #include <QDialog>
 #include <QGridLayout>
 #include <QHeaderView>
+#include <QtConcurrent/QtConcurrentRun>
+
+// a check starts once typing in the matrix pauses this long, in ms
+#define CORRELATION_CHECK_DELAY 300
 
 RandomVariablesContainer::RandomVariablesContainer(QWidget *parent)
-    : SimCenterWidget(parent), correlationDialog(NULL), correlationMatrix(NULL), checkbox(NULL)
+    : SimCenterWidget(parent), correlationDialog(NULL), correlationMatrix(NULL),
+      correlationStatus(NULL), repairCorrelation(NULL), checkPending(false),
+      matrixVersion(0), checkedVersion(0), repairedVersion(0), checkbox(NULL)
 {
     randomVariableClass = QString("Uncertain");
 
@@ -66,7 +73,9 @@ RandomVariablesContainer::RandomVariablesContainer(QWidget *parent)
 }
 
 RandomVariablesContainer::RandomVariablesContainer(QString &theClass, QWidget *parent)
-    : SimCenterWidget(parent), correlationDialog(NULL), correlationMatrix(NULL), checkbox(NULL)
+    : SimCenterWidget(parent), correlationDialog(NULL), correlationMatrix(NULL),
+      correlationStatus(NULL), repairCorrelation(NULL), checkPending(false),
+      matrixVersion(0), checkedVersion(0), repairedVersion(0), checkbox(NULL)
 {
     randomVariableClass = theClass;
     verticalLayout = new QVBoxLayout();
@@ -124,12 +133,8 @@ RandomVariablesContainer::removeRandomVariable(QString &varName)
                 randomVariableNames.removeAt(j);
 
                 // remove row & col from correlation matrix
-                if (correlationMatrix != NULL) {
-                    correlationMatrix->removeRow(j);
-                    correlationMatrix->removeColumn(j);
-                    correlationMatrix->setHorizontalHeaderLabels(randomVariableNames);
-                    correlationMatrix->setVerticalHeaderLabels(randomVariableNames);
-                }
+                if (correlationMatrix != NULL)
+                    correlationMatrix->removeVariable(j);
 
             }
             j=numRandomVariables; // get out of loop if foud
@@ -241,7 +246,11 @@ RandomVariablesContainer::makeRV(void)
      verticalLayout->setSpacing(0);
      verticalLayout->setMargin(0);
 
-
+     checkTimer.setSingleShot(true);
+     checkTimer.setInterval(CORRELATION_CHECK_DELAY);
+     connect(&checkTimer,SIGNAL(timeout()),this,SLOT(startCorrelationCheck()));
+     connect(&checkWatcher,SIGNAL(finished()),this,SLOT(onCorrelationCheckFinished()));
+     connect(&repairWatcher,SIGNAL(finished()),this,SLOT(onCorrelationRepairFinished()));
 }
 
 
@@ -271,8 +280,7 @@ RandomVariablesContainer::variableNameChanged(const QString &newValue) {
             //}
         }
         // qDebug()<<"\n the table_header is       "<<table_header;
-        correlationMatrix->setHorizontalHeaderLabels(table_header);
-        correlationMatrix->setVerticalHeaderLabels(table_header);
+        correlationMatrix->setVariableNames(table_header);
     }
 
 }
@@ -292,51 +300,7 @@ RandomVariablesContainer::addRandomVariable(void) {
     {
 
         if(correlationMatrix!=NULL)
-        {
-
-            int numRandomVariables=theRandomVariables.size();
-
-            correlationMatrix->insertRow(numRandomVariables-1);
-
-            correlationMatrix->insertColumn(numRandomVariables-1);
-
-
-            //correlationMatrix->takeHorizontalHeaderItem(numRandomVariables-1);// takeHorizontalHeaderItem(int column)
-            //correlationMatrix->takeVerticalHeaderItem(numRandomVariables-1);
-
-
-
-            QStringList table_header;
-            for (int i = 0; i < numRandomVariables; i++)
-            {
-
-                table_header.append(theRandomVariables.at(i)->getVariableName());
-
-            }
-
-            correlationMatrix->setHorizontalHeaderLabels(table_header);
-            correlationMatrix->setVerticalHeaderLabels(table_header);
-
-            for(int i = 0; i < numRandomVariables-1; i++)
-            {
-                correlationMatrix->setColumnWidth(i,100);
-                QTableWidgetItem *newItem1,*newItem2;
-                newItem1 = new QTableWidgetItem("0.0");
-                newItem2 = new QTableWidgetItem("0.0");
-                correlationMatrix->setItem(numRandomVariables-1,i,newItem1);
-                correlationMatrix->setItem(i,numRandomVariables-1,newItem2);
-            }
-
-            correlationMatrix->setColumnWidth(numRandomVariables-1,100);
-            QTableWidgetItem *newItem;
-
-            newItem = new QTableWidgetItem("1.0");
-            correlationMatrix->setItem(numRandomVariables-1,numRandomVariables-1, newItem);
-
-            correlationMatrix->resizeColumnsToContents();
-            correlationMatrix->resizeRowsToContents();
-
-        }
+            correlationMatrix->addVariable(theRV->getVariableName());
     }
 }
 
@@ -347,10 +311,6 @@ void RandomVariablesContainer::removeRandomVariable(void)
     // find the ones selected & remove them
     int numRandomVariables = theRandomVariables.size();
 
-    int *index_selected_to_remove;int size_selected_to_remove=0;
-
-    index_selected_to_remove = (int *)malloc(numRandomVariables*sizeof(int));
-
     for (int i = numRandomVariables-1; i >= 0; i--) {
         qDebug()<<"\n the value of i is     "<<i;
         RandomVariable *theRV = theRandomVariables.at(i);
@@ -360,33 +320,12 @@ void RandomVariablesContainer::removeRandomVariable(void)
             theRandomVariables.remove(i);
             theRV->setParent(0);
             delete theRV;
-            index_selected_to_remove[size_selected_to_remove]=i;
-
-            size_selected_to_remove=size_selected_to_remove+1;
 
+            // going down from the end, so indices still to come are unchanged
+            if (correlationMatrix != NULL)
+                correlationMatrix->removeVariable(i);
         }
     }
-
-    if(correlationMatrix!=NULL) {
-        int counter_for_removal=size_selected_to_remove-1;//=size_selected_to_remove;
-        while (counter_for_removal>=0) {
-            correlationMatrix->removeRow(index_selected_to_remove[counter_for_removal]);
-            correlationMatrix->removeColumn(index_selected_to_remove[counter_for_removal]);
-
-            if(counter_for_removal>0) {
-
-                for (int ii=0;ii<size_selected_to_remove;++ii) {
-                    index_selected_to_remove[ii]=index_selected_to_remove[ii]-1;
-                }
-
-            }
-            counter_for_removal--;
-
-        }
-    }
-
-
-    free(index_selected_to_remove);
 }
 
 
@@ -428,19 +367,8 @@ RandomVariablesContainer::addRandomVariable(RandomVariable *theRV) {
 
         int numRVs = randomVariableNames.size();
 
-        if (correlationMatrix != NULL) {
-
-            correlationMatrix->insertRow(correlationMatrix->rowCount());
-            correlationMatrix->insertColumn(correlationMatrix->columnCount());
-            correlationMatrix->setHorizontalHeaderLabels(randomVariableNames);
-            correlationMatrix->setVerticalHeaderLabels(randomVariableNames);
-
-            for (int i=0; i<numRVs-1; i++) {
-                correlationMatrix->setItem(numRVs-1, i, new QTableWidgetItem(QString("0.0")));
-                correlationMatrix->setItem(i,numRVs-1, new QTableWidgetItem(QString("0.0")));
-            }
-            correlationMatrix->setItem(numRVs-1,numRVs-1, new QTableWidgetItem(QString("1.0")));
-        }
+        if (correlationMatrix != NULL)
+            correlationMatrix->addVariable(randomVariableNames.at(numRVs-1));
     }
 }
 
@@ -456,42 +384,29 @@ void RandomVariablesContainer::addCorrelationMatrix(void) {
         correlationDialog->setModal(true);
         correlationDialog->setWindowTitle(tr("Correlation Matrix"));
         QGridLayout *correlationLayout = new QGridLayout();
-        correlationMatrix = new QTableWidget;
-
-        correlationLayout->addWidget(correlationMatrix,0,0);
+        QTableView *correlationView = new QTableView;
+
+        correlationStatus = new QLabel();
+        repairCorrelation = new QPushButton(tr("Repair"));
+        repairCorrelation->setToolTip(tr("replace the matrix by the nearest positive definite correlation matrix, or for large matrices shrink the correlations toward zero just enough"));
+        repairCorrelation->setEnabled(false);
+        connect(repairCorrelation,SIGNAL(clicked()),this,SLOT(repairCorrelationMatrix()));
+
+        correlationLayout->addWidget(correlationView,0,0,1,2);
+        correlationLayout->addWidget(correlationStatus,1,0);
+        correlationLayout->addWidget(repairCorrelation,1,1);
+        correlationLayout->setColumnStretch(0,1);
         correlationDialog->setLayout(correlationLayout);
         flag_for_correlationMatrix=1;
 
-        correlationMatrix->setRowCount(numRandomVariables);
-        correlationMatrix->setColumnCount(numRandomVariables);
-
-        QStringList table_header;
-
+        // identity to start, the upper triangle is edited in the view
+        correlationMatrix = new CorrelationMatrixModel(this);
         for (int i = 0; i < numRandomVariables; i++)
-            table_header.append(theRandomVariables.at(i)->getVariableName());
-
-        correlationMatrix->setHorizontalHeaderLabels(table_header);
-        correlationMatrix->setVerticalHeaderLabels(table_header);
-
-        correlationMatrix->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        //correlationMatrix->setSizeAdjustPolicy(QTableWidget::AdjustToContents);
-        //correlationMatrix->setSizePolicy(QSizePolicy::Policy::Minimum,QSizePolicy::Policy::Minimum);
-
-        for(int i = 0; i < numRandomVariables; i++) {
-            correlationMatrix->setColumnWidth(i,100 );
-            for(int j = 0; j < numRandomVariables; j++) {
-                QTableWidgetItem *newItem;
+            correlationMatrix->addVariable(theRandomVariables.at(i)->getVariableName());
 
-                if (i==j)
-                    newItem = new QTableWidgetItem("1.0");
-                else
-                    newItem = new QTableWidgetItem("0.0");
-                correlationMatrix->setItem(i,j, newItem);
-            }
-        }
-
-        correlationMatrix->resizeColumnsToContents();
-        correlationMatrix->resizeRowsToContents();
+        correlationView->setModel(correlationMatrix);
+        connect(correlationMatrix,SIGNAL(matrixChanged()),this,SLOT(scheduleCorrelationCheck()));
+        correlationView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     }
     if (correlationDialog != NULL)
         correlationDialog->show();
@@ -512,11 +427,22 @@ RandomVariablesContainer::clear(void) {
   theRandomVariables.clear();
   randomVariableNames.clear();
 
+  // the dialog owns the view of the matrix
+  if (correlationDialog != NULL) {
+       delete correlationDialog;
+       correlationDialog = NULL;
+       correlationStatus = NULL;
+       repairCorrelation = NULL;
+  }
+
   if (correlationMatrix != NULL) {
-       rvLayout->removeWidget(correlationMatrix);
        delete correlationMatrix;
        correlationMatrix = NULL;
   }
+
+  checkTimer.stop();
+  matrixVersion++;
+  correlationProblem.clear();
 }
 
 
@@ -544,19 +470,15 @@ RandomVariablesContainer::outputToJSON(QJsonObject &rvObject) {
       
       qDebug() << "WRITING CORRELATION MATRIX";
 
+        // written anyway, the user may be part way through editing it
+        if (!correlationProblem.isEmpty())
+            emit sendErrorMessage(correlationProblem);
+
         QJsonArray correlationData;
-        for (int i = 0; i <theRandomVariables.size(); ++i) {
-            for (int j = 0; j <theRandomVariables.size(); ++j) {
-
-                QTableWidgetItem *cellItemFromTable=correlationMatrix->item(i,j);
-                double value = 0.0;
-                if (cellItemFromTable!=NULL) {
-                    value=((cellItemFromTable->text()).toDouble());
-		} else {
-		  value = 0.;
-		}
-		correlationData.append(value);
-            }
+        int numVariables = correlationMatrix->getNumVariables();
+        for (int i = 0; i <numVariables; ++i) {
+            for (int j = 0; j <numVariables; ++j)
+                correlationData.append(correlationMatrix->getValue(i,j));
         }
         rvObject["correlationMatrix"]=correlationData;
     }
@@ -643,21 +565,24 @@ RandomVariablesContainer::inputFromJSON(QJsonObject &rvObject)
 
           this->addCorrelationMatrix();
           QJsonArray rvArray = rvObject["correlationMatrix"].toArray();
-          // foreach object in array
+          // foreach object in array, the matrix is symmetric so only the upper triangle is read
           int row = 0; int col = 0;
 
-          foreach (const QJsonValue &rvValue, rvArray) {
-              double value = rvValue.toDouble();
-              QTableWidgetItem *item = correlationMatrix->item(row,col);
-              item->setText(QString::number(value));
-              col++;
-              if (col == numRandomVariables) {
-                  row++; col=0;
+          if (correlationMatrix != NULL) {
+              foreach (const QJsonValue &rvValue, rvArray) {
+                  if (col > row && row < numRandomVariables)
+                      correlationMatrix->setValue(row, col, rvValue.toDouble());
+                  col++;
+                  if (col == numRandomVariables) {
+                      row++; col=0;
+                  }
               }
+              this->scheduleCorrelationCheck();
           }
       }
       // hide the dialog so matrix not shown
-      correlationDialog->hide();
+      if (correlationDialog != NULL)
+          correlationDialog->hide();
   }
   return result;
 }
@@ -668,3 +593,108 @@ RandomVariablesContainer::errorMessage(QString message){
     emit sendErrorMessage(message);
 }
 
+
+void
+RandomVariablesContainer::scheduleCorrelationCheck(void)
+{
+    matrixVersion++;
+    checkTimer.start();
+}
+
+void
+RandomVariablesContainer::startCorrelationCheck(void)
+{
+    if (correlationMatrix == NULL)
+        return;
+
+    if (checkWatcher.isRunning()) {
+        checkPending = true;
+        return;
+    }
+
+    std::vector<double> values;
+    correlationMatrix->getMatrix(values);
+    int n = correlationMatrix->getNumVariables();
+    checkedVersion = matrixVersion;
+
+    checkWatcher.setFuture(QtConcurrent::run([values, n]() {
+        CorrelationMatrixCheck theCheck;
+        theCheck.setMatrix(values, n);
+        theCheck.check();
+        return theCheck;
+    }));
+}
+
+void
+RandomVariablesContainer::onCorrelationCheckFinished(void)
+{
+    CorrelationMatrixCheck theCheck = checkWatcher.result();
+    bool current = (checkedVersion == matrixVersion);
+
+    if (checkPending) {
+        checkPending = false;
+        this->startCorrelationCheck();
+    }
+
+    if (!current || correlationMatrix == NULL)
+        return;
+
+    correlationMatrix->setOffendingEntries(theCheck.getOffendingEntries());
+
+    if (theCheck.isPositiveDefinite()) {
+        correlationProblem.clear();
+        correlationStatus->setText(tr("The matrix is positive definite."));
+    } else {
+        QString name = correlationMatrix->headerData(theCheck.getFailedVariable(), Qt::Horizontal).toString();
+        correlationProblem = tr("The correlation matrix is not positive definite: the correlations of %1 "
+                                "with the variables before it are inconsistent, those most at fault are shown in red.")
+                .arg(name);
+        correlationStatus->setText(correlationProblem);
+    }
+    repairCorrelation->setEnabled(!theCheck.isPositiveDefinite() && !repairWatcher.isRunning());
+}
+
+void
+RandomVariablesContainer::repairCorrelationMatrix(void)
+{
+    if (correlationMatrix == NULL || repairWatcher.isRunning())
+        return;
+
+    std::vector<double> values;
+    correlationMatrix->getMatrix(values);
+    int n = correlationMatrix->getNumVariables();
+    repairedVersion = matrixVersion;
+
+    repairCorrelation->setEnabled(false);
+    correlationStatus->setText(tr("Repairing ..."));
+
+    repairWatcher.setFuture(QtConcurrent::run([values, n]() {
+        CorrelationMatrixCheck theRepair;
+        theRepair.setMatrix(values, n);
+        theRepair.repair();
+        return theRepair;
+    }));
+}
+
+void
+RandomVariablesContainer::onCorrelationRepairFinished(void)
+{
+    CorrelationMatrixCheck theRepair = repairWatcher.result();
+
+    if (correlationMatrix == NULL)
+        return;
+
+    // edited while repairing, the check of the edit says what it found
+    if (repairedVersion != matrixVersion || theRepair.getSize() != correlationMatrix->getNumVariables()) {
+        repairCorrelation->setEnabled(!correlationProblem.isEmpty());
+        return;
+    }
+
+    correlationMatrix->setMatrix(theRepair.getMatrix());
+    if (theRepair.wasProjected())
+        emit sendStatusMessage(tr("Correlation matrix repaired, replaced by the nearest positive definite correlation matrix, %1 away in the Frobenius norm")
+                               .arg(theRepair.getRepairDistance(), 0, 'g', 4));
+    else
+        emit sendStatusMessage(tr("Correlation matrix repaired, the correlations were scaled by %1")
+                               .arg(1.0 - theRepair.getShrinking(), 0, 'g', 4));
+}
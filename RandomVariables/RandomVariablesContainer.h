@@ -55,8 +55,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <sectiontitle.h>
 #include <QLineEdit>
 #include <QCheckBox>
+#include <QTimer>
+#include <QFutureWatcher>
+#include "CorrelationMatrixCheck.h"
 
 class QDialog;
+class CorrelationMatrixModel;
 
 class RandomVariablesContainer : public SimCenterWidget
 {
@@ -92,6 +96,13 @@ public slots:
    //   void addSobolevIndices(bool);// added by padhye for sobolev indices
    void clear(void);
 
+private slots:
+   void scheduleCorrelationCheck(void);
+   void startCorrelationCheck(void);
+   void onCorrelationCheckFinished(void);
+   void repairCorrelationMatrix(void);
+   void onCorrelationRepairFinished(void);
+
 private:
     void makeRV(void);
     QVBoxLayout *verticalLayout;
@@ -101,7 +112,19 @@ private:
     QString randomVariableClass;
     QVector<RandomVariable *>theRandomVariables;
     QDialog *correlationDialog;
-    QTableWidget *correlationMatrix;
+    CorrelationMatrixModel *correlationMatrix;
+    QLabel *correlationStatus;
+    QPushButton *repairCorrelation;
+
+    // the matrix is factorized on a worker thread a moment after each edit
+    QTimer checkTimer;
+    QFutureWatcher<CorrelationMatrixCheck> checkWatcher;
+    QFutureWatcher<CorrelationMatrixCheck> repairWatcher;
+    bool checkPending;          // edited while checking
+    int matrixVersion;          // counts the edits, to drop results of matrices since changed
+    int checkedVersion;
+    int repairedVersion;
+    QString correlationProblem; // empty unless the last check failed
     QCheckBox *checkbox;
 
     SectionTitle *correlationtabletitle;
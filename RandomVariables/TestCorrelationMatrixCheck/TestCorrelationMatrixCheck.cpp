@@ -0,0 +1,358 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of CorrelationMatrixCheck: Cholesky factors known in closed form,
+// also across the blocks the factorization works in, the smallest eigenvalue
+// of matrices whose spectrum is known, the entries flagged in matrices that
+// are not positive definite, and their repair, to the nearest correlation
+// matrix of a known example and by shrinking
+
+#include <QtTest/QtTest>
+#include <CorrelationMatrixCheck.h>
+
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class TestCorrelationMatrixCheck : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void smallFactor(void);
+    void autoregressiveFactor(void);
+    void factorReproduces(void);
+    void smallestEigenvalue_data(void);
+    void smallestEigenvalue(void);
+    void clusteredEigenvalue(void);
+    void offendingEntries(void);
+    void symmetricEigen(void);
+    void nearestMatrix(void);
+    void repairNearest(void);
+    void repairShrinking(void);
+
+private:
+    // rho on every off diagonal entry: eigenvalues 1-rho, n-1 times, and 1+(n-1)rho
+    static std::vector<double> equicorrelation(int n, double rho);
+};
+
+std::vector<double>
+TestCorrelationMatrixCheck::equicorrelation(int n, double rho)
+{
+    std::vector<double> a(static_cast<size_t>(n)*n, rho);
+    for (int i=0; i<n; i++)
+        a[static_cast<size_t>(i)*n+i] = 1;
+    return a;
+}
+
+void
+TestCorrelationMatrixCheck::smallFactor(void)
+{
+    double values[] = {4, 12, -16, 12, 37, -43, -16, -43, 98};
+    std::vector<double> a(values, values+9);
+    QCOMPARE(CorrelationMatrixCheck::choleskyFactor(a, 3), -1);
+
+    double factor[] = {2, 0, 0, 6, 1, 0, -8, 5, 3};
+    for (int i=0; i<3; i++)
+        for (int j=0; j<=i; j++)
+            QCOMPARE(a[i*3+j], factor[i*3+j]);
+
+    // the upper triangle is left alone
+    QCOMPARE(a[1], 12.0);
+    QCOMPARE(a[5], -43.0);
+}
+
+// rho^|i-j| has the factor rho^i in the first column and rho^(i-j)
+// sqrt(1-rho^2) in the others; 300 variables take several blocks and the
+// row updates
+void
+TestCorrelationMatrixCheck::autoregressiveFactor(void)
+{
+    const int n = 300;
+    const double rho = 0.6;
+    std::vector<double> a(static_cast<size_t>(n)*n);
+    for (int i=0; i<n; i++)
+        for (int j=0; j<n; j++)
+            a[static_cast<size_t>(i)*n+j] = pow(rho, abs(i-j));
+
+    QCOMPARE(CorrelationMatrixCheck::choleskyFactor(a, n), -1);
+    double maxError = 0;
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<=i; j++) {
+            double expected = pow(rho, i-j);
+            if (j != 0)
+                expected *= sqrt(1-rho*rho);
+            maxError = std::max(maxError, fabs(a[static_cast<size_t>(i)*n+j] - expected));
+        }
+    }
+    QVERIFY2(maxError < 1e-12, qPrintable(QString::number(maxError)));
+}
+
+// L L' of a random factor, odd sized so the blocks and groups of four rows
+// end short
+void
+TestCorrelationMatrixCheck::factorReproduces(void)
+{
+    const int n = 251;
+    std::mt19937_64 generator(31);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> b(static_cast<size_t>(n)*n, 0.);
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<i; j++)
+            b[static_cast<size_t>(i)*n+j] = 0.1*normal(generator);
+        b[static_cast<size_t>(i)*n+i] = 1 + fabs(normal(generator));
+    }
+
+    std::vector<double> a(static_cast<size_t>(n)*n);
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            double s = 0;
+            for (int k=0; k<=std::min(i, j); k++)
+                s += b[static_cast<size_t>(i)*n+k]*b[static_cast<size_t>(j)*n+k];
+            a[static_cast<size_t>(i)*n+j] = s;
+        }
+    }
+
+    QCOMPARE(CorrelationMatrixCheck::choleskyFactor(a, n), -1);
+    double maxError = 0;
+    for (int i=0; i<n; i++)
+        for (int j=0; j<=i; j++)
+            maxError = std::max(maxError, fabs(a[static_cast<size_t>(i)*n+j] - b[static_cast<size_t>(i)*n+j]));
+    QVERIFY2(maxError < 1e-10, qPrintable(QString::number(maxError)));
+}
+
+void
+TestCorrelationMatrixCheck::smallestEigenvalue_data(void)
+{
+    QTest::addColumn<int>("n");
+    QTest::addColumn<double>("rho");
+
+    QTest::newRow("identity") << 50 << 0.0;
+    QTest::newRow("positive") << 400 << 0.3;
+    QTest::newRow("negative") << 20 << -0.1;
+    QTest::newRow("not definite") << 1000 << -0.01;
+}
+
+void
+TestCorrelationMatrixCheck::smallestEigenvalue(void)
+{
+    QFETCH(int, n);
+    QFETCH(double, rho);
+
+    double expected = std::min(1-rho, 1+(n-1)*rho);
+    double lambda = CorrelationMatrixCheck::smallestEigenvalue(equicorrelation(n, rho), n);
+    QVERIFY2(fabs(lambda - expected) < 1e-8, qPrintable(QString::number(lambda)));
+}
+
+// tridiagonal 2, -1: eigenvalues 2 - 2 cos(k pi/(n+1)), the smallest close
+// to the next, which Lanczos finds last
+void
+TestCorrelationMatrixCheck::clusteredEigenvalue(void)
+{
+    const int n = 200;
+    std::vector<double> a(static_cast<size_t>(n)*n, 0.);
+    for (int i=0; i<n; i++) {
+        a[static_cast<size_t>(i)*n+i] = 2;
+        if (i > 0)
+            a[static_cast<size_t>(i)*n+i-1] = a[static_cast<size_t>(i-1)*n+i] = -1;
+    }
+    double expected = 2 - 2*cos(M_PI/(n+1));
+    double lambda = CorrelationMatrixCheck::smallestEigenvalue(a, n);
+    QVERIFY2(fabs(lambda - expected) < 1e-8, qPrintable(QString::number(lambda)));
+}
+
+void
+TestCorrelationMatrixCheck::offendingEntries(void)
+{
+    // 0 and 1 agree, 2 agrees with 0 and opposes 1: z = inv(C11) c = (9, -9),
+    // each entry of row 2 takes 8.1 off the pivot of 1, both are needed
+    double values[] = {1, 0.9, 0.9, 0.9, 1, -0.9, 0.9, -0.9, 1};
+    CorrelationMatrixCheck theCheck;
+    theCheck.setMatrix(std::vector<double>(values, values+9), 3);
+    QVERIFY(!theCheck.check());
+    QVERIFY(!theCheck.isPositiveDefinite());
+    QCOMPARE(theCheck.getFailedVariable(), 2);
+
+    std::vector<std::pair<int, int> > entries = theCheck.getOffendingEntries();
+    std::sort(entries.begin(), entries.end());
+    QCOMPARE(entries.size(), size_t(2));
+    QVERIFY(entries[0] == std::make_pair(0, 2));
+    QVERIFY(entries[1] == std::make_pair(1, 2));
+
+    // 2 opposes 0 only mildly, its agreeing with 1 is enough on its own:
+    // z = (-4.79, 5.21), the falls 0.48 and 4.69 of a pivot ending at -4.17
+    double mild[] = {1, 0.9, -0.1, 0.9, 1, 0.9, -0.1, 0.9, 1};
+    theCheck.setMatrix(std::vector<double>(mild, mild+9), 3);
+    QVERIFY(!theCheck.check());
+    entries = theCheck.getOffendingEntries();
+    QCOMPARE(entries.size(), size_t(1));
+    QVERIFY(entries[0] == std::make_pair(1, 2));
+
+    theCheck.setMatrix(equicorrelation(10, 0.5), 10);
+    QVERIFY(theCheck.check());
+    QCOMPARE(theCheck.getFailedVariable(), -1);
+    QVERIFY(theCheck.getOffendingEntries().empty());
+}
+
+// the second difference matrix of clusteredEigenvalue, every eigenpair:
+// eigenvalues 2 - 2cos(k pi/(n+1)), eigenvectors sin(i k pi/(n+1)) scaled
+void
+TestCorrelationMatrixCheck::symmetricEigen(void)
+{
+    const int n = 150;
+    std::vector<double> a(static_cast<size_t>(n)*n, 0.);
+    for (int i=0; i<n; i++) {
+        a[static_cast<size_t>(i)*n+i] = 2;
+        if (i > 0)
+            a[static_cast<size_t>(i)*n+i-1] = a[static_cast<size_t>(i-1)*n+i] = -1;
+    }
+
+    std::vector<double> vectors = a, values;
+    CorrelationMatrixCheck::symmetricEigen(vectors, n, values);
+    QCOMPARE(values.size(), size_t(n));
+    for (int k=0; k<n; k++) {
+        double expected = 2 - 2*cos((k+1)*M_PI/(n+1));
+        QVERIFY2(fabs(values[k] - expected) < 1e-12, qPrintable(QString::number(k)));
+
+        // unit length, up to sign the closed form
+        const double *v = &vectors[static_cast<size_t>(k)*n];
+        double scale = sqrt(2.0/(n+1));
+        double sign = (v[0] < 0) ? -1 : 1;
+        for (int i=0; i<n; i++)
+            QVERIFY(fabs(v[i] - sign*scale*sin((i+1)*(k+1)*M_PI/(n+1))) < 1e-10);
+    }
+}
+
+// Higham's example (2002, section 4): the nearest correlation matrix to
+// [1 1 0; 1 1 1; 0 1 1] has 0.7607 and 0.1573 off the diagonal, at a distance
+// of 0.5278. that found keeps its eigenvalues to 1e-4, so differs by about that,
+// and is closer than shrinking, which takes the matrix 0.586 away
+void
+TestCorrelationMatrixCheck::nearestMatrix(void)
+{
+    double values[] = {1, 1, 0, 1, 1, 1, 0, 1, 1};
+    std::vector<double> a(values, values+9);
+    std::vector<double> nearest;
+    QVERIFY(CorrelationMatrixCheck::nearestCorrelation(a, 3, nearest));
+
+    double expected[] = {1, 0.7607, 0.1573, 0.7607, 1, 0.7607, 0.1573, 0.7607, 1};
+    for (int i=0; i<9; i++)
+        QVERIFY2(fabs(nearest[i] - expected[i]) < 5e-4, qPrintable(QString::number(nearest[i])));
+
+    CorrelationMatrixCheck theCheck;
+    theCheck.setMatrix(a, 3);
+    QVERIFY(!theCheck.check());
+    QVERIFY(theCheck.repair());
+    QVERIFY(theCheck.wasProjected());
+    QVERIFY(theCheck.check());
+    QVERIFY(fabs(theCheck.getRepairDistance() - 0.5278) < 5e-4);
+    for (int i=0; i<3; i++)
+        QCOMPARE(theCheck.getMatrix()[i*3+i], 1.0);
+
+    // a small step from it toward the input is not a correlation matrix with
+    // such eigenvalues, so it is no closer: the smallest eigenvalue falls
+    std::vector<double> step = theCheck.getMatrix();
+    for (int i=0; i<9; i++)
+        step[i] += 0.01*(a[i] - step[i]);
+    QVERIFY(CorrelationMatrixCheck::smallestEigenvalue(step, 3) < 1e-4);
+
+    theCheck.setMatrix(a, 3);
+    theCheck.setRepairMethod(CorrelationMatrixCheck::Shrinking);
+    QVERIFY(theCheck.repair());
+    QVERIFY(!theCheck.wasProjected());
+    QVERIFY(theCheck.getRepairDistance() > 0.58);
+}
+
+// rho = -0.1 for 20 variables has the eigenvalue 1 + 19 rho = -0.9. the
+// nearest correlation matrix is by symmetry also equicorrelated, with that
+// eigenvalue raised to 1e-4: rho = (1e-4 - 1)/19
+void
+TestCorrelationMatrixCheck::repairNearest(void)
+{
+    const int n = 20;
+    CorrelationMatrixCheck theCheck;
+    theCheck.setMatrix(equicorrelation(n, -0.1), n);
+    QVERIFY(theCheck.repair());
+    QVERIFY(theCheck.wasProjected());
+    QVERIFY(theCheck.isPositiveDefinite());
+
+    double rho = (1e-4 - 1)/19;
+    const std::vector<double> &repaired = theCheck.getMatrix();
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            double expected = (i == j) ? 1 : rho;
+            QVERIFY(fabs(repaired[i*n+j] - expected) < 1e-8);
+        }
+    }
+    QVERIFY(theCheck.check());
+}
+
+// shrunk by alpha the eigenvalue -0.9 above is (1-alpha)(-0.9) + alpha, 1e-4
+// at alpha = 0.9001/1.9
+void
+TestCorrelationMatrixCheck::repairShrinking(void)
+{
+    const int n = 20;
+    CorrelationMatrixCheck theCheck;
+    theCheck.setRepairMethod(CorrelationMatrixCheck::Shrinking);
+    theCheck.setMatrix(equicorrelation(n, -0.1), n);
+    QVERIFY(!theCheck.check());
+    QVERIFY(theCheck.repair());
+    QVERIFY(theCheck.isPositiveDefinite());
+
+    double alpha = 0.9001/1.9;
+    QVERIFY(fabs(theCheck.getShrinking() - alpha) < 1e-8);
+    const std::vector<double> &repaired = theCheck.getMatrix();
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<n; j++) {
+            double expected = (i == j) ? 1 : -0.1*(1-alpha);
+            QVERIFY(fabs(repaired[i*n+j] - expected) < 1e-8);
+        }
+    }
+    QVERIFY(fabs(CorrelationMatrixCheck::smallestEigenvalue(repaired, n) - 1e-4) < 1e-8);
+    QVERIFY(theCheck.check());
+
+    // positive definite already: left alone
+    std::vector<double> fine = equicorrelation(n, 0.2);
+    theCheck.setMatrix(fine, n);
+    QVERIFY(!theCheck.repair());
+    QCOMPARE(theCheck.getShrinking(), 0.0);
+    QVERIFY(theCheck.getMatrix() == fine);
+}
+
+QTEST_MAIN(TestCorrelationMatrixCheck)
+#include "TestCorrelationMatrixCheck.moc"
@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# CorrelationMatrixCheck: Cholesky factors and Lanczos eigenvalues of
+# matrices known in closed form, flagged entries and the shrinking repair
+#
+#-------------------------------------------------
+
+QT       += core testlib concurrent
+QT       -= gui
+
+CONFIG   += console c++11 testcase
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+TARGET = TestCorrelationMatrixCheck
+
+RV = $$PWD/..
+INCLUDEPATH += $$RV
+
+SOURCES += TestCorrelationMatrixCheck.cpp \
+    $$RV/CorrelationMatrixCheck.cpp
@@ -7,8 +7,8 @@ include($$PWD/ConanHelper.pri)
 
 win32: DEFINES+=_CRT_SECURE_NO_DEPRECATE #silence MSVC warning for fopen and stncpy
 
-#Adding the widgets and network modules as prerequisites
-QT += widgets network charts
+#Adding the widgets, network, printsupport (for qcustomplot) and concurrent modules as prerequisites
+QT += widgets network printsupport concurrent
 
 #Include the common pri file
 include($$PWD/Common/Common.pri)
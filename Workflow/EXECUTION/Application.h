@@ -60,6 +60,11 @@ public:
 signals:
     void setupForRun(QString &, QString &);
 
+    // from applications that run the analysis locally: its results can be
+    // followed while it runs, or it failed and no processResults will come
+    void followResults(QString);
+    void stopFollowingResults(void);
+
 private:
     void submitJob(void);
 };
@@ -61,7 +61,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QProcessEnvironment>
 
 LocalApplication::LocalApplication(QString workflowScriptName, QWidget *parent)
-: Application(parent)
+: Application(parent), theWorkflow(NULL)
 {
     QVBoxLayout *layout = new QVBoxLayout();
     messageLabel = new QLabel();
@@ -187,7 +187,15 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
     // now invoke dakota, done via a python script in tool app dircetory
     //
 
-    QProcess *proc = new QProcess();
+    if (theWorkflow != NULL) {
+        emit sendErrorMessage("A workflow is already running, wait for it to finish");
+        return false;
+    }
+
+    // the workflow runs while the event loop goes on, onWorkflowFinished
+    // picks up once the process has finished
+    QProcess *proc = new QProcess(this);
+    connect(proc,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(onWorkflowFinished(int,QProcess::ExitStatus)));
 
     proc->setProcessChannelMode(QProcess::SeparateChannels);
     auto procEnv = QProcessEnvironment::systemEnvironment();
@@ -210,7 +218,7 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
         QFileInfo openseesFile(openseesPathVariant.toString());
         if (openseesFile.exists()) {
             QString openseesPath = openseesFile.absolutePath();
-            pathEnv = openseesPath + ';' + pathEnv;
+            pathEnv = openseesPath + QDir::listSeparator() + pathEnv;
 	    exportPath += ":" + openseesPath;
         }
     }
@@ -223,8 +231,8 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
             QString dakotaPythonPath = QFileInfo(dakotaPath).absolutePath() + QDir::separator() +
                       "share" + QDir::separator() + "Dakota" + QDir::separator() + "Python";
 	    exportPath += ":" + dakotaPath;
-            pathEnv = dakotaPath + ';' + pathEnv;
-            pythonPathEnv = dakotaPythonPath + ";" + pythonPathEnv;
+            pathEnv = dakotaPath + QDir::listSeparator() + pathEnv;
+            pythonPathEnv = dakotaPythonPath + QDir::listSeparator() + pythonPathEnv;
         }
     }
 
@@ -237,6 +245,9 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
 
     QStringList args{pySCRIPT, runType, inputFile, registryFile};
 
+    // results can be followed while dakota writes them, once the workflow has started
+    QString filenameTAB = tmpDirectory + QDir::separator() +  QString("dakotaTab.out");
+
 #ifdef Q_OS_WIN
     python = QString("\"") + python + QString("\"");
 
@@ -245,36 +256,12 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
 
     proc->start(python,args);
 
-    bool failed = false;
     if (!proc->waitForStarted(-1))
     {
         qDebug() << "Failed to start the workflow!!! exit code returned: " << proc->exitCode();
         qDebug() << proc->errorString().split('\n');
         emit sendStatusMessage("Failed to start the workflow!!!");
-        failed = true;
-    }
-
-    if(!proc->waitForFinished(-1))
-    {
-        qDebug() << "Failed to finish running the workflow!!! exit code returned: " << proc->exitCode();
-        qDebug() << proc->errorString();
-        emit sendStatusMessage("Failed to finish running the workflow!!!");
-        failed = true;
-    }
-
-
-    if(0 != proc->exitCode())
-    {
-        qDebug() << "Failed to run the workflow!!! exit code returned: " << proc->exitCode();
-        qDebug() << proc->errorString();
-        emit sendStatusMessage("Failed to run the workflow!!!");
-        failed = true;
-    }
-
-    if(failed)
-    {
-        qDebug().noquote() << proc->readAllStandardOutput();
-        qDebug().noquote() << proc->readAllStandardError();
+        delete proc;
         return false;
     }
 
@@ -300,30 +287,80 @@ LocalApplication::setupDoneRunApplication(QString &tmpDirectory, QString &inputF
 
     qDebug() << "PYTHON COMMAND" << command;
 
-    proc->execute("bash", QStringList() << "-c" <<  command);
-    proc->waitForStarted();
+    // output to the terminal, as it went when run with QProcess::execute
+    proc->setProcessChannelMode(QProcess::ForwardedChannels);
+    proc->start("bash", QStringList() << "-c" <<  command);
+    if (!proc->waitForStarted(-1)) {
+        qDebug() << "Failed to start the workflow!!! " << proc->errorString();
+        emit sendStatusMessage("Failed to start the workflow!!!");
+        delete proc;
+        return false;
+    }
 
 #endif
 
-    //proc->waitForStarted();
+    theWorkflow = proc;
+    workflowDirectory = tmpDirectory;
+    workflowInputFile = inputFile;
+    emit followResults(filenameTAB);
+
+    return 0;
+}
+
+void
+LocalApplication::onWorkflowFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *proc = theWorkflow;
+    theWorkflow = NULL;
+    if (proc == NULL)
+        return;
+    proc->deleteLater();   // this is called from one of its signals
+
+#ifdef Q_OS_WIN
+    bool failed = false;
+    if (exitStatus != QProcess::NormalExit)
+    {
+        qDebug() << "Failed to finish running the workflow!!! exit code returned: " << exitCode;
+        qDebug() << proc->errorString();
+        emit sendStatusMessage("Failed to finish running the workflow!!!");
+        failed = true;
+    }
+    else if (0 != exitCode)
+    {
+        qDebug() << "Failed to run the workflow!!! exit code returned: " << exitCode;
+        qDebug() << proc->errorString();
+        emit sendStatusMessage("Failed to run the workflow!!!");
+        failed = true;
+    }
+
+    if (failed)
+    {
+        emit stopFollowingResults();
+        qDebug().noquote() << proc->readAllStandardOutput();
+        qDebug().noquote() << proc->readAllStandardError();
+        return;
+    }
+#else
+    // the results are processed whatever the exit, as with QProcess::execute
+    Q_UNUSED(exitCode);
+    Q_UNUSED(exitStatus);
+#endif
 
     //
     // copy input file to main directory
     // 
 
-   QString filenameIN = tmpDirectory + QDir::separator() +  QString("dakota.json");
-   QFile::copy(inputFile, filenameIN);
+   QString filenameIN = workflowDirectory + QDir::separator() +  QString("dakota.json");
+   QFile::copy(workflowInputFile, filenameIN);
 
     //
     // process the results
     //
 
-    QString filenameOUT = tmpDirectory + QDir::separator() +  QString("dakota.out");
-    QString filenameTAB = tmpDirectory + QDir::separator() +  QString("dakotaTab.out");
-
-    emit processResults(filenameOUT, filenameTAB, inputFile);
+    QString filenameOUT = workflowDirectory + QDir::separator() +  QString("dakota.out");
+    QString filenameTAB = workflowDirectory + QDir::separator() +  QString("dakotaTab.out");
 
-    return 0;
+    emit processResults(filenameOUT, filenameTAB, workflowInputFile);
 }
 
 void
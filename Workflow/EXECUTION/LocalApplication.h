@@ -45,6 +45,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <SimCenterWidget.h>
 #include <Application.h>
+#include <QProcess>
 
 class QLabel;
 
@@ -64,10 +65,17 @@ signals:
 public slots:
    void onRunButtonPressed(void);
 
+private slots:
+   void onWorkflowFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
 private:
     void submitJob(void);
     QLabel *messageLabel;
     QString workflowScript;
+
+    QProcess *theWorkflow;      // the running workflow, NULL if none
+    QString workflowDirectory;  // its tmpDirectory and inputFile
+    QString workflowInputFile;
 };
 
 #endif // LOCAL_APPLICATION_H
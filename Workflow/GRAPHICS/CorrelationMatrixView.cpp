@@ -0,0 +1,248 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "CorrelationMatrixView.h"
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+
+#include <math.h>
+
+#define MARGIN 10
+#define COLOR_BAR_WIDTH 15
+#define MAX_NAME_WIDTH 150   // longer names are elided
+
+// blue (-1) to white (0) to red (+1)
+static QRgb correlationColor(double r)
+{
+    if (r != r)
+        return qRgb(190, 190, 190);
+
+    static const int negative[3] = {33, 102, 172};
+    static const int zero[3] = {247, 247, 247};
+    static const int positive[3] = {178, 24, 43};
+
+    const int *end = (r < 0) ? negative : positive;
+    double f = qBound(0.0, fabs(r), 1.0);
+    return qRgb(static_cast<int>(zero[0] + f*(end[0]-zero[0])),
+                static_cast<int>(zero[1] + f*(end[1]-zero[1])),
+                static_cast<int>(zero[2] + f*(end[2]-zero[2])));
+}
+
+CorrelationMatrixView::CorrelationMatrixView(QWidget *parent)
+    :QWidget(parent), showNames(false)
+{
+    this->setMouseTracking(true);
+    this->setMinimumSize(200, 200);
+}
+
+CorrelationMatrixView::~CorrelationMatrixView()
+{
+
+}
+
+QSize
+CorrelationMatrixView::sizeHint(void) const
+{
+    return QSize(600, 600);
+}
+
+void
+CorrelationMatrixView::clear(void)
+{
+    theNames.clear();
+    theValues.clear();
+    theImage = QImage();
+    this->updateLayout();
+    this->update();
+}
+
+void
+CorrelationMatrixView::setMatrix(const QStringList &names, const std::vector<double> &values)
+{
+    int n = names.size();
+    if (static_cast<int>(values.size()) != n*n) {
+        this->clear();
+        return;
+    }
+
+    theNames = names;
+    theValues = values;
+
+    theImage = QImage(n, n, QImage::Format_RGB32);
+    for (int i=0; i<n; i++) {
+        QRgb *line = reinterpret_cast<QRgb *>(theImage.scanLine(i));
+        for (int j=0; j<n; j++)
+            line[j] = correlationColor(theValues[i*n + j]);
+    }
+
+    this->updateLayout();
+    this->update();
+}
+
+void
+CorrelationMatrixView::updateLayout(void)
+{
+    int n = theNames.size();
+    QFontMetrics metrics(this->font());
+
+    // room for the colour bar and its labels on the right
+    int right = MARGIN + COLOR_BAR_WIDTH + metrics.width("-1.0") + 2*MARGIN;
+
+    // names on the left and top if a cell would be at least a line high
+    int nameWidth = 0;
+    for (int i=0; i<n; i++)
+        nameWidth = qMax(nameWidth, qMin(metrics.width(theNames.at(i)), MAX_NAME_WIDTH));
+    nameWidth += MARGIN;
+
+    int sideWithNames = qMin(this->width()-nameWidth-right, this->height()-nameWidth-MARGIN);
+    showNames = (n > 0 && sideWithNames/n >= metrics.height());
+
+    int offset = showNames ? nameWidth : MARGIN;
+    int side = qMin(this->width()-offset-right, this->height()-offset-MARGIN);
+    if (n > 0)
+        side = side/n*n;   // whole pixels per cell
+    matrixRect = QRect(offset, offset, qMax(side, 0), qMax(side, 0));
+}
+
+void
+CorrelationMatrixView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    this->updateLayout();
+}
+
+bool
+CorrelationMatrixView::cellAt(const QPoint &pos, int &row, int &col) const
+{
+    int n = theNames.size();
+    if (n == 0 || !matrixRect.contains(pos))
+        return false;
+
+    col = (pos.x()-matrixRect.left())*n/matrixRect.width();
+    row = (pos.y()-matrixRect.top())*n/matrixRect.height();
+    return row >= 0 && row < n && col >= 0 && col < n;
+}
+
+void
+CorrelationMatrixView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(this->rect(), this->palette().window());
+
+    int n = theNames.size();
+    if (n == 0 || matrixRect.isEmpty())
+        return;
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter.drawImage(matrixRect, theImage);
+    painter.setPen(Qt::darkGray);
+    painter.drawRect(matrixRect.adjusted(0, 0, -1, -1));
+
+    QFontMetrics metrics(this->font());
+    painter.setPen(this->palette().color(QPalette::WindowText));
+
+    //
+    // names, rows to the left and columns rotated above
+    //
+
+    if (showNames) {
+        double cell = 1.0*matrixRect.height()/n;
+        for (int i=0; i<n; i++) {
+            QString name = metrics.elidedText(theNames.at(i), Qt::ElideRight, MAX_NAME_WIDTH);
+            QRect rowRect(0, static_cast<int>(matrixRect.top() + i*cell),
+                          matrixRect.left()-MARGIN/2, static_cast<int>(cell));
+            painter.drawText(rowRect, Qt::AlignRight | Qt::AlignVCenter, name);
+
+            painter.save();
+            painter.translate(matrixRect.left() + (i+0.5)*cell, matrixRect.top()-MARGIN/2);
+            painter.rotate(-90);
+            painter.drawText(QRect(0, -static_cast<int>(cell/2), matrixRect.top(), static_cast<int>(cell)),
+                             Qt::AlignLeft | Qt::AlignVCenter, name);
+            painter.restore();
+        }
+    }
+
+    //
+    // colour bar, +1 at the top
+    //
+
+    QRect bar(matrixRect.right() + 2*MARGIN, matrixRect.top(), COLOR_BAR_WIDTH, matrixRect.height());
+    for (int y=0; y<bar.height(); y++) {
+        double r = 1.0 - 2.0*y/qMax(1, bar.height()-1);
+        painter.setPen(QColor(correlationColor(r)));
+        painter.drawLine(bar.left(), bar.top()+y, bar.right(), bar.top()+y);
+    }
+    painter.setPen(Qt::darkGray);
+    painter.drawRect(bar.adjusted(0, 0, -1, -1));
+
+    painter.setPen(this->palette().color(QPalette::WindowText));
+    int textLeft = bar.right() + MARGIN/2;
+    int textHeight = metrics.height();
+    painter.drawText(QRect(textLeft, bar.top(), 100, textHeight), Qt::AlignLeft | Qt::AlignTop, "1.0");
+    painter.drawText(QRect(textLeft, bar.center().y()-textHeight/2, 100, textHeight), Qt::AlignLeft | Qt::AlignVCenter, "0.0");
+    painter.drawText(QRect(textLeft, bar.bottom()-textHeight, 100, textHeight), Qt::AlignLeft | Qt::AlignBottom, "-1.0");
+}
+
+void
+CorrelationMatrixView::mousePressEvent(QMouseEvent *event)
+{
+    int row, col;
+    if (event->button() == Qt::LeftButton && this->cellAt(event->pos(), row, col))
+        emit cellClicked(row, col);
+    else
+        QWidget::mousePressEvent(event);
+}
+
+void
+CorrelationMatrixView::mouseMoveEvent(QMouseEvent *event)
+{
+    int row, col;
+    if (this->cellAt(event->pos(), row, col)) {
+        double r = theValues[row*theNames.size() + col];
+        QString value = (r != r) ? QString("-") : QString::number(r, 'f', 3);
+        QToolTip::showText(event->globalPos(),
+                           QString("%1 / %2: %3").arg(theNames.at(row)).arg(theNames.at(col)).arg(value),
+                           this);
+    } else
+        QToolTip::hideText();
+
+    QWidget::mouseMoveEvent(event);
+}
@@ -0,0 +1,83 @@
+#ifndef CORRELATION_MATRIX_VIEW_H
+#define CORRELATION_MATRIX_VIEW_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a heat map of a correlation matrix, blue for -1 through white to red for
+// +1, NaN in gray. row and column names are drawn when the cells are large
+// enough to hold them, otherwise hovering a cell shows the pair and value.
+// clicking a cell emits cellClicked(row, col)
+
+#include <QWidget>
+#include <QStringList>
+#include <QImage>
+#include <vector>
+
+class CorrelationMatrixView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CorrelationMatrixView(QWidget *parent = 0);
+    virtual ~CorrelationMatrixView();
+
+    // values are row major, names.size() squared of them; they are copied
+    void setMatrix(const QStringList &names, const std::vector<double> &values);
+    void clear(void);
+
+    QSize sizeHint(void) const;
+
+signals:
+    void cellClicked(int row, int col);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+
+private:
+    void updateLayout(void);
+    bool cellAt(const QPoint &pos, int &row, int &col) const;
+
+    QStringList theNames;
+    std::vector<double> theValues;
+    QImage theImage;      // a pixel per cell, scaled up when drawn
+    QRect matrixRect;     // where the cells are drawn
+    bool showNames;
+};
+
+#endif // CORRELATION_MATRIX_VIEW_H
@@ -0,0 +1,634 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "ParallelCoordinatesView.h"
+#include "SamplePlot.h"
+
+#include <QPainter>
+#include <QMouseEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#define MARGIN 10
+#define SIDE_MARGIN 40          // room for the labels of the first and last axes
+#define NUM_BINS 255            // bins per axis, a byte per sample
+#define MISSING_BIN 255         // NaN values, never drawn or selected
+#define AXIS_PICK_DISTANCE 6    // pixels either side of an axis that start a brush
+#define BRUSH_HALF_WIDTH 5
+#define ROWS_PER_BLOCK 65536    // rows per task when selecting
+
+ParallelCoordinatesView::ParallelCoordinatesView(QWidget *parent)
+    :QWidget(parent), numRows(0), dragAxis(-1), dragStart(0), dragMoved(false),
+      numSelected(0), renderPending(false)
+{
+    this->setMouseTracking(true);
+    this->setMinimumSize(300, 200);
+
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(0);
+    connect(&refreshTimer,SIGNAL(timeout()),this,SLOT(startRender()));
+    connect(&renderWatcher,SIGNAL(finished()),this,SLOT(onRenderFinished()));
+}
+
+ParallelCoordinatesView::~ParallelCoordinatesView()
+{
+    renderWatcher.waitForFinished();
+}
+
+QSize
+ParallelCoordinatesView::sizeHint(void) const
+{
+    return QSize(800, 500);
+}
+
+void
+ParallelCoordinatesView::clear(void)
+{
+    theNames.clear();
+    theBins.clear();
+    theMins.clear();
+    theMaxs.clear();
+    numRows = 0;
+    brushLow.clear();
+    brushHigh.clear();
+    dragAxis = -1;
+    theImage = QImage();
+    numSelected = 0;
+    refreshTimer.stop();
+    this->updateLayout();
+    this->update();
+}
+
+void
+ParallelCoordinatesView::setData(const QStringList &names, const QVector<const double *> &columns, int rows)
+{
+    int numAxes = names.size();
+    if (numAxes == 0 || columns.size() != numAxes || rows <= 0) {
+        this->clear();
+        return;
+    }
+
+    //
+    // bin each column on its own thread; a running render keeps its own
+    // reference to the old bins, so there is no need to wait for it
+    //
+
+    theNames = names;
+    numRows = rows;
+    theBins = QVector<QVector<quint8> >(numAxes);
+    theMins = QVector<double>(numAxes, 0.0);
+    theMaxs = QVector<double>(numAxes, 0.0);
+
+    QVector<int> axes;
+    for (int axis=0; axis<numAxes; axis++)
+        axes.append(axis);
+
+    QVector<QVector<quint8> > &bins = theBins;
+    QVector<double> &mins = theMins;
+    QVector<double> &maxs = theMaxs;
+    QtConcurrent::blockingMap(axes, [&columns, &bins, &mins, &maxs, rows](int &axis) {
+        const double *values = columns.at(axis);
+        double min = 0, max = 0;
+        bool found = false;
+        for (int i=0; i<rows; i++) {
+            double value = values[i];
+            if (value != value)
+                continue;
+            if (!found) {
+                min = max = value;
+                found = true;
+            } else if (value < min)
+                min = value;
+            else if (value > max)
+                max = value;
+        }
+
+        QVector<quint8> binned(rows);
+        quint8 *bin = binned.data();
+        double scale = (max > min) ? NUM_BINS/(max-min) : 0.0;
+        for (int i=0; i<rows; i++) {
+            double value = values[i];
+            if (value != value)
+                bin[i] = MISSING_BIN;
+            else if (scale == 0.0)
+                bin[i] = NUM_BINS/2;
+            else
+                bin[i] = static_cast<quint8>(qMin(static_cast<int>((value-min)*scale), NUM_BINS-1));
+        }
+
+        bins[axis] = binned;
+        mins[axis] = min;
+        maxs[axis] = max;
+    });
+
+    brushLow = QVector<int>(numAxes, -1);
+    brushHigh = QVector<int>(numAxes, -1);
+    dragAxis = -1;
+
+    this->updateLayout();
+    this->update();
+    refreshTimer.start();
+}
+
+int
+ParallelCoordinatesView::getNumAxes(void) const
+{
+    return theNames.size();
+}
+
+QString
+ParallelCoordinatesView::getAxisName(int axis) const
+{
+    return theNames.value(axis);
+}
+
+bool
+ParallelCoordinatesView::getBrush(int axis, double &min, double &max) const
+{
+    if (axis < 0 || axis >= brushLow.size() || brushLow.at(axis) < 0)
+        return false;
+
+    double width = (theMaxs.at(axis)-theMins.at(axis))/NUM_BINS;
+    min = theMins.at(axis) + brushLow.at(axis)*width;
+    max = theMins.at(axis) + (brushHigh.at(axis)+1)*width;
+    return true;
+}
+
+void
+ParallelCoordinatesView::clearBrushes(void)
+{
+    bool changed = false;
+    for (int axis=0; axis<brushLow.size(); axis++) {
+        if (brushLow.at(axis) >= 0)
+            changed = true;
+        brushLow[axis] = -1;
+        brushHigh[axis] = -1;
+    }
+    dragAxis = -1;
+
+    if (changed) {
+        this->update();
+        refreshTimer.start();
+        emit brushesChanged();
+    }
+}
+
+int
+ParallelCoordinatesView::getNumSelected(void) const
+{
+    return numSelected;
+}
+
+//
+// the image, computed on a worker thread
+//
+
+ParallelCoordinatesView::RenderResult
+ParallelCoordinatesView::renderImage(const RenderJob &job)
+{
+    RenderResult result;
+    int numAxes = job.bins.size();
+    int rows = job.numRows;
+    int width = job.width;
+    int height = job.height;
+    if (numAxes == 0 || width <= 0 || height <= 0)
+        return result;
+
+    //
+    // mark the samples inside every brush, in blocks of rows
+    //
+
+    QVector<int> brushed;
+    for (int axis=0; axis<numAxes; axis++)
+        if (job.brushLow.at(axis) >= 0)
+            brushed.append(axis);
+
+    std::vector<quint8> selected;
+    if (brushed.isEmpty())
+        result.numSelected = rows;
+    else {
+        selected.resize(rows);
+        quint8 *mask = selected.data();
+        int numBlocks = (rows + ROWS_PER_BLOCK-1)/ROWS_PER_BLOCK;
+        QVector<int> blocks;
+        for (int block=0; block<numBlocks; block++)
+            blocks.append(block);
+        QVector<int> blockCounts(numBlocks, 0);
+        int *counts = blockCounts.data();
+        QtConcurrent::blockingMap(blocks, [&job, &brushed, mask, counts, rows](int &block) {
+            int first = block*ROWS_PER_BLOCK;
+            int last = qMin(first+ROWS_PER_BLOCK, rows);
+            for (int i=first; i<last; i++)
+                mask[i] = 1;
+            foreach (int axis, brushed) {
+                const quint8 *bin = job.bins.at(axis).constData();
+                int low = job.brushLow.at(axis);
+                int high = job.brushHigh.at(axis);
+                for (int i=first; i<last; i++)
+                    if (bin[i] < low || bin[i] > high)   // MISSING_BIN is above any brush
+                        mask[i] = 0;
+            }
+            int count = 0;
+            for (int i=first; i<last; i++)
+                count += mask[i];
+            counts[block] = count;
+        });
+        foreach (int count, blockCounts)
+            result.numSelected += count;
+    }
+
+    //
+    // for each gap between neighbouring axes, count the samples joining each
+    // pair of bins and draw one line per pair weighted by its count. each gap
+    // fills its own pixel columns, so the gaps run in parallel
+    //
+
+    std::vector<float> selectedDensity(static_cast<size_t>(width)*height, 0.0f);
+    std::vector<float> otherDensity;
+    if (!brushed.isEmpty())
+        otherDensity.resize(static_cast<size_t>(width)*height, 0.0f);
+
+    QVector<int> gaps;
+    for (int gap=0; gap<numAxes-1; gap++)
+        if (job.axisX.at(gap+1) > job.axisX.at(gap))
+            gaps.append(gap);
+
+    const quint8 *mask = selected.empty() ? 0 : selected.data();
+    float *selectedPixels = selectedDensity.data();
+    float *otherPixels = otherDensity.empty() ? 0 : otherDensity.data();
+    QtConcurrent::blockingMap(gaps, [&job, mask, selectedPixels, otherPixels, rows, width, height](int &gap) {
+        const quint8 *left = job.bins.at(gap).constData();
+        const quint8 *right = job.bins.at(gap+1).constData();
+        // the selected counts, then the others when anything is brushed
+        const int numPairs = NUM_BINS*NUM_BINS;
+        std::vector<quint32> counts(mask ? 2*numPairs : numPairs, 0);
+        for (int i=0; i<rows; i++) {
+            int a = left[i];
+            int b = right[i];
+            if (a == MISSING_BIN || b == MISSING_BIN)
+                continue;
+            int layer = mask ? 1-mask[i] : 0;
+            counts[layer*numPairs + a*NUM_BINS + b]++;
+        }
+
+        int x0 = job.axisX.at(gap);
+        int gapWidth = job.axisX.at(gap+1) - x0;
+        std::vector<double> spans(static_cast<size_t>(height+1)*gapWidth);
+        std::vector<double> inverse(height+1);
+        for (int k=1; k<=height; k++)
+            inverse[k] = 1.0/k;
+
+        for (int layer=0; layer<2; layer++) {
+            float *pixels = (layer == 0) ? selectedPixels : otherPixels;
+            if (pixels == 0)
+                continue;
+            const quint32 *layerCounts = counts.data() + layer*numPairs;
+
+            // each pixel column gets the whole count of a line, spread over
+            // the rows it passes through in that column. spans are added as
+            // differences down the column, so steep lines cost no more.
+            // line ends are inside [0,height), so are the rows in between
+            std::fill(spans.begin(), spans.end(), 0.0);
+            for (int a=0; a<NUM_BINS; a++) {
+                double yA = height - (a+0.5)*height/NUM_BINS;
+                for (int b=0; b<NUM_BINS; b++) {
+                    quint32 count = layerCounts[a*NUM_BINS + b];
+                    if (count == 0)
+                        continue;
+
+                    double yB = height - (b+0.5)*height/NUM_BINS;
+                    double slope = (yB-yA)/gapWidth;
+                    double y0 = yA;
+                    for (int i=0; i<gapWidth; i++) {
+                        double y1 = yA + slope*(i+1);
+                        int low = static_cast<int>(qMin(y0, y1));
+                        int high = static_cast<int>(qMax(y0, y1));
+                        double weight = count*inverse[high-low+1];
+                        spans[static_cast<size_t>(low)*gapWidth + i] += weight;
+                        spans[static_cast<size_t>(high+1)*gapWidth + i] -= weight;
+                        y0 = y1;
+                    }
+                }
+            }
+
+            for (int i=0; i<gapWidth; i++) {
+                double density = 0.0;
+                float *pixel = pixels + x0 + i;
+                for (int y=0; y<height; y++, pixel += width) {
+                    density += spans[static_cast<size_t>(y)*gapWidth + i];
+                    if (density > 1.0e-6)   // round off where nothing was drawn
+                        *pixel = static_cast<float>(density);
+                }
+            }
+        }
+    });
+
+    //
+    // colour on a log scale, the selection over the rest in gray
+    //
+
+    float maxSelected = 0.0f, maxOther = 0.0f;
+    for (size_t i=0; i<selectedDensity.size(); i++)
+        maxSelected = qMax(maxSelected, selectedDensity[i]);
+    for (size_t i=0; i<otherDensity.size(); i++)
+        maxOther = qMax(maxOther, otherDensity[i]);
+    double selectedScale = (maxSelected > 0) ? 1.0/log(1.0+maxSelected) : 0.0;
+    double otherScale = (maxOther > 0) ? 1.0/log(1.0+maxOther) : 0.0;
+
+    QRgb colors[256];
+    for (int i=0; i<256; i++)
+        colors[i] = SamplePlot::densityColor(i/255.0).rgba();
+
+    result.image = QImage(width, height, QImage::Format_ARGB32);
+    for (int y=0; y<height; y++) {
+        QRgb *line = reinterpret_cast<QRgb *>(result.image.scanLine(y));
+        const float *selectedRow = selectedPixels + static_cast<size_t>(y)*width;
+        const float *otherRow = otherPixels ? otherPixels + static_cast<size_t>(y)*width : 0;
+        for (int x=0; x<width; x++) {
+            if (selectedRow[x] > 0) {
+                double t = log(1.0+selectedRow[x])*selectedScale;
+                line[x] = colors[qBound(0, static_cast<int>(t*255), 255)];
+            } else if (otherRow && otherRow[x] > 0) {
+                double t = log(1.0+otherRow[x])*otherScale;
+                int gray = static_cast<int>(230 - 90*t);
+                line[x] = qRgb(gray, gray, gray);
+            } else
+                line[x] = qRgba(0, 0, 0, 0);
+        }
+    }
+
+    return result;
+}
+
+void
+ParallelCoordinatesView::startRender(void)
+{
+    if (renderWatcher.isRunning()) {
+        renderPending = true;
+        return;
+    }
+
+    if (theBins.isEmpty() || plotRect.isEmpty()) {
+        theImage = QImage();
+        this->update();
+        return;
+    }
+
+    RenderJob job;
+    job.bins = theBins;
+    job.numRows = numRows;
+    job.brushLow = brushLow;
+    job.brushHigh = brushHigh;
+    for (int axis=0; axis<theBins.size(); axis++)
+        job.axisX.append(this->axisX(axis) - plotRect.left());
+    job.width = plotRect.width();
+    job.height = plotRect.height();
+
+    renderWatcher.setFuture(QtConcurrent::run(&ParallelCoordinatesView::renderImage, job));
+}
+
+void
+ParallelCoordinatesView::onRenderFinished(void)
+{
+    RenderResult result = renderWatcher.result();
+    if (renderPending) {
+        renderPending = false;
+        this->startRender();
+    }
+
+    if (theBins.isEmpty())
+        return;
+
+    theImage = result.image;
+    this->update();
+
+    if (result.numSelected != numSelected) {
+        numSelected = result.numSelected;
+        emit selectionChanged(numSelected);
+    }
+}
+
+//
+// layout and drawing
+//
+
+void
+ParallelCoordinatesView::updateLayout(void)
+{
+    QFontMetrics metrics(this->font());
+    int top = MARGIN + metrics.height();
+    int bottom = MARGIN + 2*metrics.height();
+    plotRect = QRect(SIDE_MARGIN, top,
+                     qMax(this->width()-2*SIDE_MARGIN, 0), qMax(this->height()-top-bottom, 0));
+}
+
+void
+ParallelCoordinatesView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    this->updateLayout();
+    if (!theBins.isEmpty())
+        refreshTimer.start();
+}
+
+int
+ParallelCoordinatesView::axisX(int axis) const
+{
+    int numAxes = theNames.size();
+    if (numAxes < 2)
+        return plotRect.center().x();
+    return plotRect.left() + axis*(plotRect.width()-1)/(numAxes-1);
+}
+
+int
+ParallelCoordinatesView::axisAt(const QPoint &pos) const
+{
+    if (pos.y() < plotRect.top() || pos.y() > plotRect.bottom())
+        return -1;
+
+    for (int axis=0; axis<theNames.size(); axis++)
+        if (qAbs(pos.x()-this->axisX(axis)) <= AXIS_PICK_DISTANCE)
+            return axis;
+    return -1;
+}
+
+int
+ParallelCoordinatesView::binAt(int y) const
+{
+    if (plotRect.height() <= 0)
+        return 0;
+    return qBound(0, (plotRect.bottom()-y)*NUM_BINS/plotRect.height(), NUM_BINS-1);
+}
+
+int
+ParallelCoordinatesView::yOfBin(int bin) const
+{
+    // the top edge of the bin, bin NUM_BINS is the top of the plot
+    return plotRect.bottom() + 1 - bin*plotRect.height()/NUM_BINS;
+}
+
+void
+ParallelCoordinatesView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(this->rect(), this->palette().window());
+
+    int numAxes = theNames.size();
+    if (numAxes == 0 || plotRect.isEmpty())
+        return;
+
+    // a stale image is stretched to the new size until the next one is ready
+    painter.fillRect(plotRect, Qt::white);
+    if (!theImage.isNull())
+        painter.drawImage(plotRect, theImage);
+
+    QFontMetrics metrics(this->font());
+    int spacing = (numAxes > 1) ? (plotRect.width()/(numAxes-1) - 4) : plotRect.width();
+    bool showLabels = (spacing >= metrics.width("-0.00e+00"));
+    int textHeight = metrics.height();
+
+    for (int axis=0; axis<numAxes; axis++) {
+        int x = this->axisX(axis);
+
+        if (brushLow.at(axis) >= 0) {
+            int top = this->yOfBin(brushHigh.at(axis)+1);
+            int bottom = this->yOfBin(brushLow.at(axis));
+            QRect brush(x-BRUSH_HALF_WIDTH, top, 2*BRUSH_HALF_WIDTH+1, qMax(bottom-top, 1));
+            painter.fillRect(brush, QColor(0, 0, 0, 50));
+            painter.setPen(Qt::black);
+            painter.drawRect(brush);
+        }
+
+        painter.setPen(Qt::black);
+        painter.drawLine(x, plotRect.top(), x, plotRect.bottom());
+
+        painter.setPen(this->palette().color(QPalette::WindowText));
+        QRect nameRect(x-spacing/2, plotRect.bottom()+textHeight+MARGIN/2, spacing, textHeight);
+        painter.drawText(nameRect, Qt::AlignHCenter | Qt::AlignTop,
+                         metrics.elidedText(theNames.at(axis), Qt::ElideRight, qMax(spacing, 0)));
+
+        if (showLabels) {
+            painter.drawText(QRect(x-spacing/2, plotRect.top()-textHeight-2, spacing, textHeight),
+                             Qt::AlignHCenter | Qt::AlignBottom, QString::number(theMaxs.at(axis), 'g', 4));
+            painter.drawText(QRect(x-spacing/2, plotRect.bottom()+2, spacing, textHeight),
+                             Qt::AlignHCenter | Qt::AlignTop, QString::number(theMins.at(axis), 'g', 4));
+        }
+    }
+}
+
+//
+// brushing
+//
+
+void
+ParallelCoordinatesView::mousePressEvent(QMouseEvent *event)
+{
+    int axis = this->axisAt(event->pos());
+    if (event->button() == Qt::LeftButton && axis >= 0) {
+        dragAxis = axis;
+        dragStart = this->binAt(event->pos().y());
+        dragMoved = false;
+    } else
+        QWidget::mousePressEvent(event);
+}
+
+void
+ParallelCoordinatesView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (dragAxis >= 0 && (event->buttons() & Qt::LeftButton)) {
+        int bin = this->binAt(event->pos().y());
+        if (bin != dragStart || dragMoved) {
+            dragMoved = true;
+            brushLow[dragAxis] = qMin(bin, dragStart);
+            brushHigh[dragAxis] = qMax(bin, dragStart);
+            this->update();
+            refreshTimer.start();
+        }
+        return;
+    }
+
+    int axis = this->axisAt(event->pos());
+    if (axis >= 0) {
+        double width = (theMaxs.at(axis)-theMins.at(axis))/NUM_BINS;
+        double value = theMins.at(axis) + (this->binAt(event->pos().y())+0.5)*width;
+        QToolTip::showText(event->globalPos(),
+                           QString("%1: %2").arg(theNames.at(axis)).arg(QString::number(value, 'g', 6)),
+                           this);
+    } else
+        QToolTip::hideText();
+
+    QWidget::mouseMoveEvent(event);
+}
+
+void
+ParallelCoordinatesView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || dragAxis < 0) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+
+    // a click without a drag clears the axis brush
+    bool changed = dragMoved;
+    if (!dragMoved && brushLow.at(dragAxis) >= 0) {
+        brushLow[dragAxis] = -1;
+        brushHigh[dragAxis] = -1;
+        changed = true;
+        this->update();
+        refreshTimer.start();
+    }
+    dragAxis = -1;
+
+    if (changed)
+        emit brushesChanged();
+}
+
+void
+ParallelCoordinatesView::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton)
+        this->clearBrushes();
+    else
+        QWidget::mouseDoubleClickEvent(event);
+}
@@ -0,0 +1,141 @@
+#ifndef PARALLEL_COORDINATES_VIEW_H
+#define PARALLEL_COORDINATES_VIEW_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a parallel coordinates plot of many samples over many dimensions. values
+// are quantized to a byte per sample and axis, and the lines between each
+// pair of neighbouring axes are drawn as a density image (log colour scale)
+// built on worker threads from the joint bin counts, so the cost of drawing
+// does not grow with the number of samples. dragging along an axis brushes a
+// range on it; samples inside every brush are coloured, the others are drawn
+// in gray behind them. clicking an axis clears its brush, double clicking
+// clears them all
+
+#include <QWidget>
+#include <QStringList>
+#include <QVector>
+#include <QImage>
+#include <QTimer>
+#include <QFutureWatcher>
+
+class ParallelCoordinatesView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ParallelCoordinatesView(QWidget *parent = 0);
+    virtual ~ParallelCoordinatesView();
+
+    // a column of numRows values per name; the values are binned in parallel
+    // and not kept, the columns need not outlive the call. brushes are cleared
+    void setData(const QStringList &names, const QVector<const double *> &columns, int numRows);
+    void clear(void);
+
+    int getNumAxes(void) const;
+    QString getAxisName(int axis) const;
+
+    // the value range brushed on the axis, false if it has no brush
+    bool getBrush(int axis, double &min, double &max) const;
+    void clearBrushes(void);
+
+    // samples inside every brush, as of the last image drawn
+    int getNumSelected(void) const;
+
+    QSize sizeHint(void) const;
+
+signals:
+    void brushesChanged(void);
+    void selectionChanged(int numSelected);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void mousePressEvent(QMouseEvent *event);
+    void mouseMoveEvent(QMouseEvent *event);
+    void mouseReleaseEvent(QMouseEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+private slots:
+    void startRender(void);
+    void onRenderFinished(void);
+
+private:
+    // all a render needs, copied so the widget can change while it runs
+    struct RenderJob {
+        QVector<QVector<quint8> > bins;   // implicitly shared, not copied
+        int numRows;
+        QVector<int> brushLow;
+        QVector<int> brushHigh;
+        QVector<int> axisX;               // relative to the image
+        int width;
+        int height;
+    };
+    struct RenderResult {
+        RenderResult() :numSelected(0) {}
+        QImage image;
+        int numSelected;
+    };
+    static RenderResult renderImage(const RenderJob &job);
+
+    void updateLayout(void);
+    int axisX(int axis) const;
+    int axisAt(const QPoint &pos) const;
+    int binAt(int y) const;
+    int yOfBin(int bin) const;
+
+    QStringList theNames;
+    QVector<QVector<quint8> > theBins;
+    QVector<double> theMins;
+    QVector<double> theMaxs;
+    int numRows;
+
+    QVector<int> brushLow;    // in bins, -1 for no brush
+    QVector<int> brushHigh;
+    int dragAxis;             // axis being brushed, -1 if none
+    int dragStart;
+    bool dragMoved;
+
+    QRect plotRect;           // from the top of the first axis to the bottom of the last
+    QImage theImage;
+    int numSelected;
+
+    QFutureWatcher<RenderResult> renderWatcher;
+    bool renderPending;       // brushes or size changed while rendering
+    QTimer refreshTimer;      // a drag moves many times, render once per event loop
+};
+
+#endif // PARALLEL_COORDINATES_VIEW_H
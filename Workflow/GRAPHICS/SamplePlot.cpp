@@ -0,0 +1,455 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SamplePlot.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <QThread>
+#include <QPainter>
+#include <QMouseEvent>
+#include <math.h>
+
+// the most points drawn as points, beyond this a density image is drawn
+#define MAX_SCATTER_POINTS 5000
+
+// size of a density grid cell in pixels
+#define DENSITY_CELL_SIZE 2
+
+// fewest points binned by one parallel task
+#define MIN_POINTS_PER_TASK 65536
+
+struct DensityTask {
+    const double *x;
+    const double *y;
+    int numPoints;
+    QVector<int> counts;
+    int numInside;
+};
+
+int
+SamplePlot::binPoints(const double *x, const double *y, int numPoints,
+                            double minX, double maxX, double minY, double maxY,
+                            int numX, int numY, QVector<int> &counts)
+{
+    counts.fill(0, numX*numY);
+    if (numPoints <= 0 || numX <= 0 || numY <= 0 || !(maxX > minX) || !(maxY > minY))
+        return 0;
+
+    int numTasks = qMax(1, qMin(QThread::idealThreadCount(), numPoints/MIN_POINTS_PER_TASK));
+    int pointsPerTask = (numPoints + numTasks - 1)/numTasks;
+
+    QVector<DensityTask> tasks(numTasks);
+    for (int i=0; i<numTasks; i++) {
+        int start = i*pointsPerTask;
+        tasks[i].x = x+start;
+        tasks[i].y = y+start;
+        tasks[i].numPoints = qMin(pointsPerTask, numPoints-start);
+        tasks[i].numInside = 0;
+    }
+
+    double scaleX = numX/(maxX-minX);
+    double scaleY = numY/(maxY-minY);
+
+    // each task bins into its own grid, the grids are summed after
+    QtConcurrent::blockingMap(tasks, [=](DensityTask &task) {
+        task.counts.fill(0, numX*numY);
+        int *grid = task.counts.data();
+        int numInside = 0;
+        for (int i=0; i<task.numPoints; i++) {
+            double xi = task.x[i];
+            double yi = task.y[i];
+            if (xi < minX || xi > maxX || yi < minY || yi > maxY)
+                continue;
+            int ix = static_cast<int>((xi-minX)*scaleX);
+            int iy = static_cast<int>((yi-minY)*scaleY);
+            if (ix == numX) ix = numX-1;
+            if (iy == numY) iy = numY-1;
+            grid[iy*numX+ix]++;
+            numInside++;
+        }
+        task.numInside = numInside;
+    });
+
+    int numInside = 0;
+    int *grid = counts.data();
+    for (int i=0; i<numTasks; i++) {
+        const int *taskGrid = tasks.at(i).counts.constData();
+        for (int j=0; j<numX*numY; j++)
+            grid[j] += taskGrid[j];
+        numInside += tasks.at(i).numInside;
+    }
+
+    return numInside;
+}
+
+QColor
+SamplePlot::densityColor(double t)
+{
+    static const int numColors = 5;
+    static const int colors[numColors][3] = {
+        {68, 1, 84}, {59, 82, 139}, {33, 145, 140}, {94, 201, 98}, {253, 231, 37}
+    };
+
+    double position = qBound(0.0, t, 1.0)*(numColors-1);
+    int i = qMin(static_cast<int>(position), numColors-2);
+    double f = position-i;
+    return QColor(static_cast<int>(colors[i][0] + f*(colors[i+1][0]-colors[i][0])),
+                  static_cast<int>(colors[i][1] + f*(colors[i+1][1]-colors[i][1])),
+                  static_cast<int>(colors[i][2] + f*(colors[i+1][2]-colors[i][2])));
+}
+
+// counts are coloured on a log scale so sparse tails stay visible beside the mode
+static double
+densityScale(int count, int maxCount)
+{
+    if (maxCount <= 1)
+        return 1.0;
+    return log(static_cast<double>(count))/log(static_cast<double>(maxCount));
+}
+
+// colours of the graphs in the order they are added
+static const int numPlotColors = 5;
+static const int plotColors[numPlotColors][3] = {
+    {32, 159, 223}, {153, 202, 83}, {246, 166, 37}, {109, 95, 213}, {191, 89, 62}
+};
+
+SamplePlot::SamplePlot(QWidget *parent)
+    :QCustomPlot(parent), valuesX(0), valuesY(0), numPoints(0), scatterGraph(0), densityItem(0),
+      scatterStale(false), maxCount(0)
+{
+    this->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    this->setNoAntialiasingOnDrag(true);
+    this->legend->setVisible(false);
+
+#ifdef QCUSTOMPLOT_USE_OPENGL
+    // falls back to the raster buffer if no context can be made
+    this->setOpenGl(true);
+#endif
+
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(0);
+    connect(&refreshTimer,SIGNAL(timeout()),this,SLOT(refresh()));
+    connect(this->xAxis,SIGNAL(rangeChanged(QCPRange)),this,SLOT(scheduleRefresh()));
+    connect(this->yAxis,SIGNAL(rangeChanged(QCPRange)),this,SLOT(scheduleRefresh()));
+}
+
+SamplePlot::~SamplePlot()
+{
+
+}
+
+void
+SamplePlot::clearPlot(void)
+{
+    this->clearScatterData();
+    this->clearPlottables();
+    this->clearItems();
+    scatterGraph = 0;
+    densityItem = 0;
+    this->legend->setVisible(false);
+    this->replot(QCustomPlot::rpQueuedReplot);
+}
+
+void
+SamplePlot::setAxes(const QString &titleX, double minX, double maxX,
+                    const QString &titleY, double minY, double maxY)
+{
+    homeX = QCPRange(minX, maxX);
+    homeY = QCPRange(minY, maxY);
+    this->xAxis->setLabel(titleX);
+    this->yAxis->setLabel(titleY);
+    this->xAxis->setRange(homeX);
+    this->yAxis->setRange(homeY);
+    this->replot(QCustomPlot::rpQueuedReplot);
+}
+
+QColor
+SamplePlot::nextColor(void) const
+{
+    int i = this->plottableCount() % numPlotColors;
+    return QColor(plotColors[i][0], plotColors[i][1], plotColors[i][2]);
+}
+
+QCPGraph *
+SamplePlot::addLine(QSharedPointer<QCPGraphDataContainer> data, const QString &name, const QColor &color)
+{
+    QColor lineColor = color.isValid() ? color : this->nextColor();
+    QCPGraph *graph = this->addGraph();
+    graph->setData(data);
+    graph->setName(name);
+    graph->setPen(QPen(lineColor, 2));
+    graph->setAdaptiveSampling(true);
+    this->replot(QCustomPlot::rpQueuedReplot);
+    return graph;
+}
+
+QCPGraph *
+SamplePlot::addMarkers(QSharedPointer<QCPGraphDataContainer> data, const QString &name, const QColor &color)
+{
+    QColor markerColor = color.isValid() ? color : this->nextColor();
+    QCPGraph *graph = this->addGraph();
+    graph->setData(data);
+    graph->setName(name);
+    graph->setLineStyle(QCPGraph::lsNone);
+    graph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, markerColor, 6));
+    graph->setPen(QPen(markerColor));
+    graph->setAdaptiveSampling(true);
+    this->replot(QCustomPlot::rpQueuedReplot);
+    return graph;
+}
+
+QCPBars *
+SamplePlot::addBars(const QVector<double> &centres, const QVector<double> &heights, double width, const QString &name)
+{
+    QColor barColor = this->nextColor();
+    QCPBars *bars = new QCPBars(this->xAxis, this->yAxis);
+    bars->setData(centres, heights, true);
+    bars->setWidth(width);
+    bars->setName(name);
+    bars->setPen(QPen(barColor));
+    barColor.setAlpha(80);
+    bars->setBrush(barColor);
+    this->replot(QCustomPlot::rpQueuedReplot);
+    return bars;
+}
+
+QSharedPointer<QCPGraphDataContainer>
+SamplePlot::makeData(const QVector<QPointF> &points, bool sorted)
+{
+    QVector<QCPGraphData> data;
+    data.reserve(points.size());
+    for (int i=0; i<points.size(); i++) {
+        const QPointF &point = points.at(i);
+        if (point.x() == point.x() && point.y() == point.y())
+            data.append(QCPGraphData(point.x(), point.y()));
+    }
+
+    QSharedPointer<QCPGraphDataContainer> container(new QCPGraphDataContainer);
+    container->set(data, sorted);
+    return container;
+}
+
+QSharedPointer<QCPGraphDataContainer>
+SamplePlot::makeData(const double *x, const double *y, int num, bool sorted)
+{
+    QVector<QCPGraphData> data;
+    data.reserve(num);
+    for (int i=0; i<num; i++)
+        if (x[i] == x[i] && y[i] == y[i])
+            data.append(QCPGraphData(x[i], y[i]));
+
+    QSharedPointer<QCPGraphDataContainer> container(new QCPGraphDataContainer);
+    container->set(data, sorted);
+    return container;
+}
+
+QSharedPointer<QCPGraphDataContainer>
+SamplePlot::makeCDF(const double *sorted, int num)
+{
+    QVector<QCPGraphData> data(num);
+    for (int i=0; i<num; i++)
+        data[i] = QCPGraphData(sorted[i], 1.0*i/num);
+
+    QSharedPointer<QCPGraphDataContainer> container(new QCPGraphDataContainer);
+    container->set(data, true);
+    return container;
+}
+
+void
+SamplePlot::setScatterData(const double *x, const double *y, int num)
+{
+    this->clearScatterData();
+
+    valuesX = x;
+    valuesY = y;
+    numPoints = num;
+
+    scatterGraph = this->addGraph();
+    scatterGraph->setName("Samples");
+    scatterGraph->setLineStyle(QCPGraph::lsNone);
+    scatterGraph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, this->nextColor(), 5));
+    scatterGraph->setAdaptiveSampling(true);
+    scatterGraph->removeFromLegend();
+    scatterStale = true;
+
+    densityItem = new QCPItemPixmap(this);
+    densityItem->setScaled(true, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    densityItem->setVisible(false);
+
+    this->refresh();
+}
+
+void
+SamplePlot::clearScatterData(void)
+{
+    if (scatterGraph != 0)
+        this->removeGraph(scatterGraph);
+    if (densityItem != 0)
+        this->removeItem(densityItem);
+    scatterGraph = 0;
+    densityItem = 0;
+
+    valuesX = 0;
+    valuesY = 0;
+    numPoints = 0;
+    maxCount = 0;
+    refreshTimer.stop();
+}
+
+void
+SamplePlot::moveScatterData(const double *x, const double *y, int num)
+{
+    if (scatterGraph == 0)
+        return;
+
+    valuesX = x;
+    valuesY = y;
+    numPoints = num;
+    scatterStale = true;
+}
+
+void
+SamplePlot::scheduleRefresh(void)
+{
+    if (scatterGraph != 0)
+        refreshTimer.start();
+}
+
+void
+SamplePlot::refresh(void)
+{
+    if (scatterGraph == 0 || numPoints == 0)
+        return;
+
+    QCPRange rangeX = this->xAxis->range();
+    QCPRange rangeY = this->yAxis->range();
+
+    QRect plotArea = this->axisRect()->rect();
+    int numX = qMax(1, plotArea.width()/DENSITY_CELL_SIZE);
+    int numY = qMax(1, plotArea.height()/DENSITY_CELL_SIZE);
+
+    QVector<int> counts;
+    int numInside = numPoints;
+    if (numPoints > MAX_SCATTER_POINTS)
+        numInside = binPoints(valuesX, valuesY, numPoints, rangeX.lower, rangeX.upper,
+                              rangeY.lower, rangeY.upper, numX, numY, counts);
+
+    if (numInside <= MAX_SCATTER_POINTS) {
+
+        // few enough points in view, draw them; the graph holds every point,
+        // sorted once, and only draws those in view
+        if (scatterStale) {
+            scatterGraph->setData(makeData(valuesX, valuesY, numPoints));
+            scatterStale = false;
+        }
+        scatterGraph->setVisible(true);
+        densityItem->setVisible(false);
+        maxCount = 0;
+
+    } else {
+
+        // image row 0 is the top of the plot, i.e. the largest y
+        maxCount = 0;
+        for (int i=0; i<counts.size(); i++)
+            maxCount = qMax(maxCount, counts.at(i));
+
+        QImage densityImage(numX, numY, QImage::Format_ARGB32);
+        densityImage.fill(Qt::transparent);
+        for (int iy=0; iy<numY; iy++) {
+            QRgb *line = reinterpret_cast<QRgb *>(densityImage.scanLine(numY-1-iy));
+            const int *row = counts.constData() + iy*numX;
+            for (int ix=0; ix<numX; ix++)
+                if (row[ix] != 0)
+                    line[ix] = densityColor(densityScale(row[ix], maxCount)).rgba();
+        }
+
+        // placed in plot coordinates, it moves with a drag until redrawn
+        densityItem->setPixmap(QPixmap::fromImage(densityImage));
+        densityItem->topLeft->setCoords(rangeX.lower, rangeY.upper);
+        densityItem->bottomRight->setCoords(rangeX.upper, rangeY.lower);
+        densityItem->setVisible(true);
+        scatterGraph->setVisible(false);
+    }
+
+    this->replot(QCustomPlot::rpQueuedReplot);
+}
+
+void
+SamplePlot::paintEvent(QPaintEvent *event)
+{
+    QCustomPlot::paintEvent(event);
+
+    if (maxCount == 0)
+        return;
+
+    QPainter painter(this);
+    QRect plotArea = this->axisRect()->rect();
+
+    // colour scale in the top right corner of the plot
+    QRectF scale(plotArea.right()-20, plotArea.top()+10, 10, qMin(100, plotArea.height()-20));
+    QLinearGradient gradient(scale.bottomLeft(), scale.topLeft());
+    for (int i=0; i<=4; i++)
+        gradient.setColorAt(i/4.0, densityColor(i/4.0));
+    painter.fillRect(scale, gradient);
+    painter.setPen(Qt::black);
+    painter.drawRect(scale);
+
+    QFontMetrics metrics(painter.font());
+    QString maxText = QString::number(maxCount);
+    painter.drawText(QPointF(scale.left()-metrics.width(maxText)-4, scale.top()+metrics.ascent()), maxText);
+    painter.drawText(QPointF(scale.left()-metrics.width("1")-4, scale.bottom()), QString("1"));
+    QString title("samples/cell");
+    painter.drawText(QPointF(scale.right()-metrics.width(title), scale.bottom()+metrics.height()), title);
+}
+
+void
+SamplePlot::resizeEvent(QResizeEvent *event)
+{
+    QCustomPlot::resizeEvent(event);
+
+    // the grid is at screen resolution
+    this->scheduleRefresh();
+}
+
+void
+SamplePlot::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && homeX.size() > 0 && homeY.size() > 0) {
+        this->xAxis->setRange(homeX);
+        this->yAxis->setRange(homeY);
+        this->replot(QCustomPlot::rpQueuedReplot);
+    }
+    QCustomPlot::mouseDoubleClickEvent(event);
+}
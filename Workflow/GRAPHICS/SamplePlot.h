@@ -0,0 +1,122 @@
+#ifndef SAMPLE_PLOT_H
+#define SAMPLE_PLOT_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a QCustomPlot for plots of many samples. graphs share their data
+// containers with the caller and are drawn with adaptive sampling, so a
+// column of a million values is plotted whole and pans and zooms smoothly.
+// a scatter plot of more than a few thousand points inside the axes ranges
+// is binned at screen resolution and drawn as a heat-map image with a
+// colour scale; once zoomed in far enough, the samples are drawn as points
+// again. dragging pans, the wheel zooms and a double click returns to the
+// ranges given to setAxes(). the scatter x and y values are not copied until
+// points are drawn, they must outlive the plot. built with
+// QCUSTOMPLOT_USE_OPENGL the plot is drawn through OpenGL where available
+
+#include <qcustomplot.h>
+#include <QImage>
+#include <QTimer>
+
+class SamplePlot : public QCustomPlot
+{
+    Q_OBJECT
+public:
+    explicit SamplePlot(QWidget *parent = 0);
+    virtual ~SamplePlot();
+
+    // removes the graphs, bars, scatter data and legend entries
+    void clearPlot(void);
+
+    // titles and ranges of the axes, the ranges a double click returns to
+    void setAxes(const QString &titleX, double minX, double maxX,
+                 const QString &titleY, double minY, double maxY);
+
+    // graphs drawn from a container they share, an invalid colour takes the next of the plot's colours
+    QCPGraph *addLine(QSharedPointer<QCPGraphDataContainer> data, const QString &name, const QColor &color = QColor());
+    QCPGraph *addMarkers(QSharedPointer<QCPGraphDataContainer> data, const QString &name, const QColor &color = QColor());
+    QCPBars *addBars(const QVector<double> &centres, const QVector<double> &heights, double width, const QString &name);
+
+    // containers for the graphs above, pairs with a NaN are left out
+    static QSharedPointer<QCPGraphDataContainer> makeData(const QVector<QPointF> &points, bool sorted = false);
+    static QSharedPointer<QCPGraphDataContainer> makeData(const double *x, const double *y, int numPoints, bool sorted = false);
+
+    // the empirical CDF (x[i], i/n) of sorted values
+    static QSharedPointer<QCPGraphDataContainer> makeCDF(const double *sorted, int numPoints);
+
+    // setAxes() must be called before this is
+    void setScatterData(const double *x, const double *y, int numPoints);
+    void clearScatterData(void);
+
+    // the arrays were reallocated or grew, used from the next refresh on
+    void moveScatterData(const double *x, const double *y, int numPoints);
+
+    // grid cell counts of numX by numY cells over the ranges, computed in
+    // parallel; returns the number of points inside the ranges
+    static int binPoints(const double *x, const double *y, int numPoints,
+                         double minX, double maxX, double minY, double maxY,
+                         int numX, int numY, QVector<int> &counts);
+
+    // a perceptually ordered colour scale running dark blue to yellow, t in [0,1]
+    static QColor densityColor(double t);
+
+protected:
+    void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
+    void mouseDoubleClickEvent(QMouseEvent *event);
+
+private slots:
+    void scheduleRefresh(void);
+    void refresh(void);
+
+private:
+    QColor nextColor(void) const;
+
+    const double *valuesX;
+    const double *valuesY;
+    int numPoints;
+    QCPGraph *scatterGraph;       // the points, when few enough are in view
+    QCPItemPixmap *densityItem;   // otherwise the density image
+    bool scatterStale;            // the graph's container is not of the values
+
+    int maxCount;                 // of a density image cell, 0 if none shown
+    QCPRange homeX;
+    QCPRange homeY;
+    QTimer refreshTimer;          // axes change range one at a time, refresh once
+};
+
+#endif // SAMPLE_PLOT_H
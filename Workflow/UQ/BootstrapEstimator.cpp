@@ -0,0 +1,525 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "BootstrapEstimator.h"
+#include <SampleDataStore.h>
+#include <OnlineMoments.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+#define REPLICATES_PER_TASK 16
+
+BootstrapInterval::BootstrapInterval()
+    :estimate(NAN), lower(NAN), upper(NAN), bcaLower(NAN), bcaUpper(NAN)
+{
+
+}
+
+//
+// draw i of replicate r is a hash of (seed, r, i), as for the Sobol' indices
+//
+
+static inline quint64 splitMix64(quint64 x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// the statistics of a sample from its power sums of deviations from
+// center, s[k] = sum w (x-center)^(k+1), and its size
+static void momentsFromSums(double n, double center, const double s[4], OnlineMoments &moments)
+{
+    double delta = s[0]/n;
+    double delta2 = delta*delta;
+    moments.setSums(n, center + delta,
+                    s[1] - n*delta2,
+                    s[2] - 3*delta*s[1] + 2*n*delta2*delta,
+                    s[3] - 4*delta*s[2] + 6*delta2*s[1] - 3*n*delta2*delta2);
+}
+
+static void setStatistics(const OnlineMoments &moments, double *statistics)
+{
+    statistics[BootstrapEstimator::Mean] = moments.getMean();
+    statistics[BootstrapEstimator::StdDev] = moments.getStdDev();
+    statistics[BootstrapEstimator::Skewness] = moments.getSkewness();
+    statistics[BootstrapEstimator::Kurtosis] = moments.getKurtosis();
+}
+
+// position of percentile p among numValues order statistics, as the summary
+static void percentilePosition(double p, int numValues, int &below, double &fraction)
+{
+    double position = p*(numValues-1);
+    below = static_cast<int>(floor(position));
+    if (below >= numValues-1)
+        below = numValues-1;
+    fraction = position-below;
+}
+
+BootstrapEstimator::BootstrapEstimator()
+    :numReplicates(2000), confidenceLevel(0.95), seed(0), numRows(0)
+{
+
+}
+
+BootstrapEstimator::~BootstrapEstimator()
+{
+
+}
+
+void
+BootstrapEstimator::clear(void)
+{
+    numRows = 0;
+    theSortedColumns.clear();
+    theReplicates.clear();
+    theIntervals.clear();
+}
+
+void
+BootstrapEstimator::setNumReplicates(int num)
+{
+    numReplicates = num;
+}
+
+int
+BootstrapEstimator::getNumReplicates(void) const
+{
+    return numReplicates;
+}
+
+void
+BootstrapEstimator::setConfidenceLevel(double level)
+{
+    confidenceLevel = level;
+}
+
+double
+BootstrapEstimator::getConfidenceLevel(void) const
+{
+    return confidenceLevel;
+}
+
+void
+BootstrapEstimator::setSeed(quint64 value)
+{
+    seed = value;
+}
+
+void
+BootstrapEstimator::setColumns(const SampleDataStore &theData, int firstCol, int lastCol, const std::vector<int> *rows)
+{
+    this->clear();
+    int numCols = lastCol-firstCol+1;
+    if (numCols <= 0)
+        return;
+
+    numRows = rows ? static_cast<int>(rows->size()) : theData.getNumRows();
+    theSortedColumns.resize(numCols);
+
+    QVector<int> columns;
+    for (int col=0; col<numCols; col++)
+        columns.append(col);
+
+    QtConcurrent::blockingMap(columns, [this, &theData, firstCol, rows](int &col) {
+        const double *values = theData.getColumn(firstCol+col);
+        std::vector<double> &sorted = theSortedColumns[col];
+        if (rows != NULL) {
+            sorted.resize(numRows);
+            for (int i=0; i<numRows; i++)
+                sorted[i] = values[(*rows)[i]];
+        } else
+            sorted.assign(values, values+numRows);
+        std::sort(sorted.begin(), sorted.end());
+    });
+}
+
+int
+BootstrapEstimator::getNumColumns(void) const
+{
+    return static_cast<int>(theSortedColumns.size());
+}
+
+const BootstrapInterval &
+BootstrapEstimator::getInterval(int col, int statistic) const
+{
+    return theIntervals.at(col*NUM_BOOTSTRAP_STATISTICS + statistic);
+}
+
+void
+BootstrapEstimator::cancel(void)
+{
+    cancelled.store(1);
+}
+
+//
+// normal distribution
+//
+
+double
+BootstrapEstimator::normalCDF(double x)
+{
+    return 0.5*erfc(-x/sqrt(2.0));
+}
+
+double
+BootstrapEstimator::normalQuantile(double p)
+{
+    if (!(p > 0))
+        return -INFINITY;
+    if (!(p < 1))
+        return INFINITY;
+
+    // Acklam's rational approximation, then one Halley step
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00};
+
+    double x;
+    if (p < 0.02425) {
+        double q = sqrt(-2*log(p));
+        x = (((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) / ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+    } else if (p <= 1-0.02425) {
+        double q = p-0.5;
+        double r = q*q;
+        x = (((((a[0]*r+a[1])*r+a[2])*r+a[3])*r+a[4])*r+a[5])*q / (((((b[0]*r+b[1])*r+b[2])*r+b[3])*r+b[4])*r+1);
+    } else {
+        double q = sqrt(-2*log(1-p));
+        x = -(((((c[0]*q+c[1])*q+c[2])*q+c[3])*q+c[4])*q+c[5]) / ((((d[0]*q+d[1])*q+d[2])*q+d[3])*q+1);
+    }
+
+    double e = normalCDF(x) - p;
+    double u = e*sqrt(2*M_PI)*exp(0.5*x*x);
+    return x - u/(1 + 0.5*x*u);
+}
+
+//
+// intervals
+//
+
+double
+BootstrapEstimator::getAcceleration(const double *jackknife, const double *counts, int numValues)
+{
+    double total = 0, mean = 0;
+    for (int i=0; i<numValues; i++) {
+        double w = counts ? counts[i] : 1.0;
+        total += w;
+        mean += w*jackknife[i];
+    }
+    if (!(total > 0))
+        return 0;
+    mean /= total;
+
+    double sum2 = 0, sum3 = 0;
+    for (int i=0; i<numValues; i++) {
+        double w = counts ? counts[i] : 1.0;
+        double d = mean-jackknife[i];
+        sum2 += w*d*d;
+        sum3 += w*d*d*d;
+    }
+    if (!(sum2 > 0))
+        return 0;
+    return sum3/(6*pow(sum2, 1.5));
+}
+
+// the q point of sorted replicates, nearest rank as for the Sobol' indices
+static double replicatePoint(const std::vector<double> &sorted, double q)
+{
+    size_t last = sorted.size()-1;
+    double position = floor(q*last + 0.5);
+    if (!(position > 0))
+        return sorted.front();
+    if (position >= last)
+        return sorted.back();
+    return sorted[static_cast<size_t>(position)];
+}
+
+void
+BootstrapEstimator::computeInterval(std::vector<double> &replicates, double estimate, double acceleration,
+                                    double level, BootstrapInterval &interval)
+{
+    interval = BootstrapInterval();
+    interval.estimate = estimate;
+
+    // replicates that could not be formed, e.g. skewness of a constant resample
+    replicates.erase(std::remove_if(replicates.begin(), replicates.end(),
+                                    [](double x) { return x != x; }), replicates.end());
+    if (replicates.empty() || estimate != estimate)
+        return;
+
+    std::sort(replicates.begin(), replicates.end());
+    double alpha = 0.5*(1-level);
+    interval.lower = replicatePoint(replicates, alpha);
+    interval.upper = replicatePoint(replicates, 1-alpha);
+
+    // bias correction from the fraction of replicates below the estimate
+    size_t below = std::lower_bound(replicates.begin(), replicates.end(), estimate) - replicates.begin();
+    size_t equal = std::upper_bound(replicates.begin(), replicates.end(), estimate) - replicates.begin() - below;
+    double fraction = (below + 0.5*equal)/replicates.size();
+    if (!(fraction > 0 && fraction < 1)) {
+        // the estimate is outside the replicates, BCa is not defined
+        interval.bcaLower = interval.lower;
+        interval.bcaUpper = interval.upper;
+        return;
+    }
+
+    double z0 = normalQuantile(fraction);
+    double zLower = normalQuantile(alpha);
+    double zUpper = -zLower;
+    double tLower = z0 + zLower;
+    double tUpper = z0 + zUpper;
+    double qLower = normalCDF(z0 + tLower/(1 - acceleration*tLower));
+    double qUpper = normalCDF(z0 + tUpper/(1 - acceleration*tUpper));
+    interval.bcaLower = replicatePoint(replicates, qLower);
+    interval.bcaUpper = replicatePoint(replicates, qUpper);
+}
+
+//
+// the estimates and jackknife accelerations of one column
+//
+
+void
+BootstrapEstimator::computeEstimates(int col, double *acceleration)
+{
+    const std::vector<double> &sorted = theSortedColumns[col];
+    BootstrapInterval *intervals = theIntervals.data() + col*NUM_BOOTSTRAP_STATISTICS;
+    double n = numRows;
+
+    double statistics[NUM_BOOTSTRAP_STATISTICS];
+    OnlineMoments moments;
+    double min, max;
+    SampleStatistics::computeMoments(sorted.data(), numRows, moments, min, max);
+    setStatistics(moments, statistics);
+
+    // sums about the mean, each left out value is removed from them
+    double center = moments.getMean();
+    double sums[4] = {0,0,0,0};
+    for (int i=0; i<numRows; i++) {
+        double d = sorted[i]-center;
+        sums[0] += d;
+        sums[1] += d*d;
+        sums[2] += d*d*d;
+        sums[3] += d*d*d*d;
+    }
+
+    std::vector<double> jackknife(4*numRows);
+    for (int i=0; i<numRows; i++) {
+        double d = sorted[i]-center;
+        double s[4] = {sums[0]-d, sums[1]-d*d, sums[2]-d*d*d, sums[3]-d*d*d*d};
+        OnlineMoments left;
+        momentsFromSums(n-1, center, s, left);
+        double values[4];
+        setStatistics(left, values);
+        for (int k=0; k<4; k++)
+            jackknife[k*numRows+i] = values[k];
+    }
+    for (int k=0; k<4; k++)
+        acceleration[k] = getAcceleration(jackknife.data()+k*numRows, NULL, numRows);
+
+    // a percentile with one value left out takes one of three values,
+    // depending on whether the value was below, at or above it
+    for (int p=0; p<NUM_PERCENTILES; p++) {
+        int below;
+        double f;
+        percentilePosition(SampleStatistics::percentileLevels[p], numRows, below, f);
+        statistics[FirstPercentile+p] = sorted[below] + ((below+1 < numRows) ? f*(sorted[below+1]-sorted[below]) : 0);
+
+        percentilePosition(SampleStatistics::percentileLevels[p], numRows-1, below, f);
+        double values[3] = {0,0,0};
+        double counts[3] = {0,0,0};
+        if (below+2 < numRows) {
+            values[0] = sorted[below+1] + f*(sorted[below+2]-sorted[below+1]);
+            values[1] = sorted[below] + f*(sorted[below+2]-sorted[below]);
+            values[2] = sorted[below] + f*(sorted[below+1]-sorted[below]);
+            counts[0] = below+1;
+            counts[1] = 1;
+            counts[2] = numRows-below-2;
+        }
+        acceleration[FirstPercentile+p] = getAcceleration(values, counts, 3);
+    }
+
+    for (int k=0; k<NUM_BOOTSTRAP_STATISTICS; k++)
+        intervals[k].estimate = statistics[k];
+}
+
+//
+// replicates
+//
+
+void
+BootstrapEstimator::resampleBlock(int firstReplicate, int num)
+{
+    int numCols = this->getNumColumns();
+    std::vector<double> counts(numRows);
+
+    // order statistics of each percentile and the one after, positions in the resample
+    int below[NUM_PERCENTILES];
+    double fraction[NUM_PERCENTILES];
+    for (int p=0; p<NUM_PERCENTILES; p++)
+        percentilePosition(SampleStatistics::percentileLevels[p], numRows, below[p], fraction[p]);
+
+    for (int r=firstReplicate; r<firstReplicate+num; r++) {
+        if (cancelled.load() != 0)
+            return;
+
+        std::fill(counts.begin(), counts.end(), 0.0);
+        quint64 key = splitMix64(seed ^ (static_cast<quint64>(r) << 32));
+        for (int i=0; i<numRows; i++) {
+            quint64 hash = splitMix64(key ^ static_cast<quint64>(i));
+            quint64 position = ((hash >> 32) * static_cast<quint64>(numRows)) >> 32;
+            counts[position] += 1;
+        }
+
+        // positions in the sorted columns of the order statistics, the
+        // percentile levels are increasing
+        int lowerPosition[NUM_PERCENTILES];
+        int upperPosition[NUM_PERCENTILES];
+        double sum = 0;
+        int p = 0, q = 0;
+        for (int i=0; i<numRows && q<NUM_PERCENTILES; i++) {
+            sum += counts[i];
+            while (p < NUM_PERCENTILES && sum > below[p])
+                lowerPosition[p++] = i;
+            while (q < NUM_PERCENTILES && sum > below[q]+1)
+                upperPosition[q++] = i;
+        }
+        for (; q<NUM_PERCENTILES; q++)
+            upperPosition[q] = numRows-1;
+
+        for (int col=0; col<numCols; col++) {
+            const double *x = theSortedColumns[col].data();
+            double center = theIntervals.at(col*NUM_BOOTSTRAP_STATISTICS + Mean).estimate;
+            const double *w = counts.data();
+
+            // count weighted power sums, four independent lanes
+            double a[4] = {0,0,0,0};
+            double b[4] = {0,0,0,0};
+            double c[4] = {0,0,0,0};
+            double d[4] = {0,0,0,0};
+            int n4 = numRows - numRows%4;
+            for (int i=0; i<n4; i+=4) {
+                for (int j=0; j<4; j++) {
+                    double dev = x[i+j] - center;
+                    double wdev = w[i+j]*dev;
+                    double wdev2 = wdev*dev;
+                    a[j] += wdev;
+                    b[j] += wdev2;
+                    c[j] += wdev2*dev;
+                    d[j] += wdev2*dev*dev;
+                }
+            }
+            for (int i=n4; i<numRows; i++) {
+                double dev = x[i] - center;
+                double wdev = w[i]*dev;
+                double wdev2 = wdev*dev;
+                a[0] += wdev;
+                b[0] += wdev2;
+                c[0] += wdev2*dev;
+                d[0] += wdev2*dev*dev;
+            }
+            double sums[4] = {(a[0]+a[1])+(a[2]+a[3]), (b[0]+b[1])+(b[2]+b[3]),
+                              (c[0]+c[1])+(c[2]+c[3]), (d[0]+d[1])+(d[2]+d[3])};
+
+            double statistics[NUM_BOOTSTRAP_STATISTICS];
+            OnlineMoments moments;
+            momentsFromSums(numRows, center, sums, moments);
+            setStatistics(moments, statistics);
+            for (int k=0; k<NUM_PERCENTILES; k++) {
+                double lowerValue = x[lowerPosition[k]];
+                statistics[FirstPercentile+k] = lowerValue + fraction[k]*(x[upperPosition[k]]-lowerValue);
+            }
+
+            double *replicates = theReplicates.data() + static_cast<size_t>(col)*NUM_BOOTSTRAP_STATISTICS*numReplicates;
+            for (int k=0; k<NUM_BOOTSTRAP_STATISTICS; k++)
+                replicates[k*numReplicates + r] = statistics[k];
+        }
+    }
+}
+
+bool
+BootstrapEstimator::estimate(void)
+{
+    cancelled.store(0);
+
+    int numCols = this->getNumColumns();
+    theIntervals.fill(BootstrapInterval(), numCols*NUM_BOOTSTRAP_STATISTICS);
+    if (numCols == 0 || numRows < 2 || numReplicates < 2)
+        return true;
+
+    // estimates and accelerations, columns in parallel
+    std::vector<double> accelerations(numCols*NUM_BOOTSTRAP_STATISTICS);
+    QVector<int> columns;
+    for (int col=0; col<numCols; col++)
+        columns.append(col);
+    QtConcurrent::blockingMap(columns, [this, &accelerations](int &col) {
+        this->computeEstimates(col, accelerations.data() + col*NUM_BOOTSTRAP_STATISTICS);
+    });
+
+    // replicates, blocks in parallel
+    theReplicates.assign(static_cast<size_t>(numCols)*NUM_BOOTSTRAP_STATISTICS*numReplicates, NAN);
+    QVector<int> blocks;
+    for (int r=0; r<numReplicates; r+=REPLICATES_PER_TASK)
+        blocks.append(r);
+    QtConcurrent::blockingMap(blocks, [this](int &first) {
+        this->resampleBlock(first, std::min(REPLICATES_PER_TASK, numReplicates-first));
+    });
+    if (cancelled.load() != 0)
+        return false;
+
+    // intervals, each statistic of each column in parallel
+    QVector<int> statistics;
+    for (int i=0; i<numCols*NUM_BOOTSTRAP_STATISTICS; i++)
+        statistics.append(i);
+    BootstrapInterval *intervals = theIntervals.data();
+    QtConcurrent::blockingMap(statistics, [this, &accelerations, intervals](int &i) {
+        double *first = theReplicates.data() + static_cast<size_t>(i)*numReplicates;
+        std::vector<double> replicates(first, first+numReplicates);
+        BootstrapInterval &interval = intervals[i];
+        computeInterval(replicates, interval.estimate, accelerations[i], confidenceLevel, interval);
+    });
+
+    theReplicates.clear();
+    return true;
+}
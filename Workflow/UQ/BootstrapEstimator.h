@@ -0,0 +1,138 @@
+#ifndef BOOTSTRAP_ESTIMATOR_H
+#define BOOTSTRAP_ESTIMATOR_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// bootstrap confidence intervals for the summary statistics of the columns
+// of a SampleDataStore: mean, standard deviation, skewness, kurtosis and the
+// percentiles of the summary. both the percentile interval and the bias
+// corrected and accelerated (BCa) one, the acceleration from the jackknife.
+//  - each column is copied and sorted once. as the order of the samples
+//    does not matter, a replicate is one vector of counts of how often each
+//    position is drawn, shared by all columns: the moments are then count
+//    weighted power sums over the sorted values and the percentiles the
+//    order statistics found in one running sum of the counts
+//  - draw i of replicate r is a hash of (seed, r, i), so the intervals are
+//    reproducible whatever the number of threads; replicates run in
+//    parallel blocks, each with its own counts
+// estimate() can run on a worker thread and be cancelled from another
+
+#include <SampleStatistics.h>
+#include <QAtomicInt>
+#include <QVector>
+#include <QtGlobal>
+#include <vector>
+
+class SampleDataStore;
+
+#define NUM_BOOTSTRAP_STATISTICS (4+NUM_PERCENTILES)
+
+class BootstrapInterval
+{
+public:
+    BootstrapInterval();
+
+    double estimate;
+    double lower;        // percentile interval
+    double upper;
+    double bcaLower;     // bias corrected and accelerated interval
+    double bcaUpper;
+};
+
+class BootstrapEstimator
+{
+public:
+    // the statistics of each column, the percentiles at SampleStatistics::percentileLevels
+    enum Statistic {
+        Mean = 0,
+        StdDev,
+        Skewness,
+        Kurtosis,
+        FirstPercentile
+    };
+
+    BootstrapEstimator();
+    ~BootstrapEstimator();
+
+    void clear(void);
+    void setNumReplicates(int numReplicates);
+    int getNumReplicates(void) const;
+    void setConfidenceLevel(double level);
+    double getConfidenceLevel(void) const;
+    void setSeed(quint64 seed);
+
+    // copies and sorts columns firstCol to lastCol, of only the given rows
+    // if rows is not NULL; the store is not used after this returns
+    void setColumns(const SampleDataStore &theData, int firstCol, int lastCol, const std::vector<int> *rows);
+
+    // resamples and forms the intervals, false if cancelled
+    bool estimate(void);
+    void cancel(void);
+
+    int getNumColumns(void) const;
+    const BootstrapInterval &getInterval(int col, int statistic) const;
+
+    //
+    // the pieces
+    //
+
+    static double normalCDF(double x);
+    static double normalQuantile(double p);
+
+    // jackknife acceleration; counts, if not NULL, are how many times each value occurs
+    static double getAcceleration(const double *jackknife, const double *counts, int numValues);
+
+    // intervals from the replicates, which are reordered
+    static void computeInterval(std::vector<double> &replicates, double estimate, double acceleration,
+                                double level, BootstrapInterval &interval);
+
+private:
+    void computeEstimates(int col, double *acceleration);
+    void resampleBlock(int firstReplicate, int numReplicates);
+
+    int numReplicates;
+    double confidenceLevel;
+    quint64 seed;
+    QAtomicInt cancelled;
+
+    int numRows;
+    std::vector<std::vector<double> > theSortedColumns;
+    std::vector<double> theReplicates;       // per column, statistic and replicate
+    QVector<BootstrapInterval> theIntervals; // per column and statistic
+};
+
+#endif // BOOTSTRAP_ESTIMATOR_H
@@ -0,0 +1,348 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "CorrelationMatrix.h"
+#include <SampleDataStore.h>
+
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#define TILE_COLUMNS 32     // columns in a tile, a multiple of 4
+#define ROW_BLOCK 1024      // rows of two tiles held in cache at a time
+
+// x -> (x - mean)/|x - mean|, zero if the column is constant
+static bool standardise(double *x, int n)
+{
+    double sum = 0;
+    for (int i=0; i<n; i++)
+        sum += x[i];
+    double mean = sum/n;
+
+    double sumSq = 0;
+    for (int i=0; i<n; i++) {
+        x[i] -= mean;
+        sumSq += x[i]*x[i];
+    }
+
+    if (!(sumSq > 0)) {
+        memset(x, 0, n*sizeof(double));
+        return false;
+    }
+
+    double scale = 1.0/sqrt(sumSq);
+    for (int i=0; i<n; i++)
+        x[i] *= scale;
+    return true;
+}
+
+// doubles mapped to unsigned integers in the same order, -0 taken as +0
+static inline quint64 orderedKey(double value)
+{
+    value += 0.0;
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 63) ? ~bits : (bits | 0x8000000000000000ULL);
+}
+
+#define RADIX_BITS 11
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+// ranks 1..n of the values, ties sharing the average of their ranks. the
+// values are put in order by a radix sort of their keys, skipping the digits
+// that are the same for every value
+static void rank(const double *values, int n, double *ranks)
+{
+    std::vector<quint64> keys(n), keysOut(n);
+    std::vector<int> order(n), orderOut(n);
+    for (int i=0; i<n; i++) {
+        keys[i] = orderedKey(values[i]);
+        order[i] = i;
+    }
+
+    std::vector<int> counts(RADIX_SIZE);
+    for (int shift=0; shift<64; shift += RADIX_BITS) {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int i=0; i<n; i++)
+            counts[(keys[i] >> shift) & (RADIX_SIZE-1)]++;
+        if (counts[(keys[0] >> shift) & (RADIX_SIZE-1)] == n)
+            continue;
+
+        int total = 0;
+        for (int d=0; d<RADIX_SIZE; d++) {
+            int count = counts[d];
+            counts[d] = total;
+            total += count;
+        }
+        for (int i=0; i<n; i++) {
+            int pos = counts[(keys[i] >> shift) & (RADIX_SIZE-1)]++;
+            keysOut[pos] = keys[i];
+            orderOut[pos] = order[i];
+        }
+        keys.swap(keysOut);
+        order.swap(orderOut);
+    }
+
+    int first = 0;
+    while (first < n) {
+        int last = first+1;
+        while (last < n && keys[last] == keys[first])
+            last++;
+        double average = 0.5*(first+last-1) + 1.0;
+        for (int i=first; i<last; i++)
+            ranks[order[i]] = average;
+        first = last;
+    }
+}
+
+//
+// dot products of columns a..a+3 with b..b+3 over n rows, added to sums
+//
+
+static void kernel4x4(const double *a, const double *b, int stride, int n, double sums[4][4])
+{
+    const double *a0 = a, *a1 = a+stride, *a2 = a+2*stride, *a3 = a+3*stride;
+    const double *b0 = b, *b1 = b+stride, *b2 = b+2*stride, *b3 = b+3*stride;
+
+    double s00 = 0, s01 = 0, s02 = 0, s03 = 0;
+    double s10 = 0, s11 = 0, s12 = 0, s13 = 0;
+    double s20 = 0, s21 = 0, s22 = 0, s23 = 0;
+    double s30 = 0, s31 = 0, s32 = 0, s33 = 0;
+    for (int r=0; r<n; r++) {
+        double x0 = a0[r], x1 = a1[r], x2 = a2[r], x3 = a3[r];
+        double y0 = b0[r], y1 = b1[r], y2 = b2[r], y3 = b3[r];
+        s00 += x0*y0; s01 += x0*y1; s02 += x0*y2; s03 += x0*y3;
+        s10 += x1*y0; s11 += x1*y1; s12 += x1*y2; s13 += x1*y3;
+        s20 += x2*y0; s21 += x2*y1; s22 += x2*y2; s23 += x2*y3;
+        s30 += x3*y0; s31 += x3*y1; s32 += x3*y2; s33 += x3*y3;
+    }
+
+    sums[0][0] += s00; sums[0][1] += s01; sums[0][2] += s02; sums[0][3] += s03;
+    sums[1][0] += s10; sums[1][1] += s11; sums[1][2] += s12; sums[1][3] += s13;
+    sums[2][0] += s20; sums[2][1] += s21; sums[2][2] += s22; sums[2][3] += s23;
+    sums[3][0] += s30; sums[3][1] += s31; sums[3][2] += s32; sums[3][3] += s33;
+}
+
+struct CorrelationTile {
+    int firstA;    // first column of each tile
+    int firstB;
+    std::vector<double> sums;  // TILE_COLUMNS x TILE_COLUMNS
+};
+
+CorrelationMatrix::CorrelationMatrix()
+    :numColumns(0), firstColumn(0), numRows(0), paddedRows(0)
+{
+
+}
+
+CorrelationMatrix::~CorrelationMatrix()
+{
+
+}
+
+void
+CorrelationMatrix::clear(void)
+{
+    numColumns = 0;
+    numRows = 0;
+    paddedRows = 0;
+    theHeadings.clear();
+    thePearson.clear();
+    theSpearman.clear();
+}
+
+int
+CorrelationMatrix::getNumColumns(void) const
+{
+    return numColumns;
+}
+
+int
+CorrelationMatrix::getFirstColumn(void) const
+{
+    return firstColumn;
+}
+
+const QStringList &
+CorrelationMatrix::getHeadings(void) const
+{
+    return theHeadings;
+}
+
+double
+CorrelationMatrix::getCorrelation(Type type, int i, int j) const
+{
+    const std::vector<double> &values = (type == Pearson) ? thePearson : theSpearman;
+    return values[i*numColumns + j];
+}
+
+const std::vector<double> &
+CorrelationMatrix::getCorrelations(Type type) const
+{
+    return (type == Pearson) ? thePearson : theSpearman;
+}
+
+void
+CorrelationMatrix::compute(const SampleDataStore &theData, int firstCol, int lastCol)
+{
+    this->clear();
+
+    firstColumn = firstCol;
+    numColumns = lastCol-firstCol+1;
+    numRows = theData.getNumRows();
+    if (numColumns <= 0 || numRows < 2) {
+        numColumns = 0;
+        return;
+    }
+
+    for (int col=firstCol; col<=lastCol; col++)
+        theHeadings << theData.getHeading(col);
+
+    //
+    // standardised values and standardised ranks of each column, the columns
+    // padded with zeros to whole tiles so the kernels need no edge cases
+    //
+
+    paddedRows = (numRows+7) & ~7;
+    int paddedColumns = (numColumns+TILE_COLUMNS-1)/TILE_COLUMNS*TILE_COLUMNS;
+    std::vector<double> values(static_cast<size_t>(paddedColumns)*paddedRows, 0.0);
+    std::vector<double> ranks(static_cast<size_t>(paddedColumns)*paddedRows, 0.0);
+
+    QVector<int> columns;
+    for (int col=0; col<numColumns; col++)
+        columns.append(col);
+
+    std::vector<char> varies(numColumns, 0);
+    double *valuesPtr = values.data();
+    double *ranksPtr = ranks.data();
+    char *variesPtr = varies.data();
+    int n = numRows;
+    size_t stride = paddedRows;
+    QtConcurrent::blockingMap(columns, [&theData, firstCol, valuesPtr, ranksPtr, variesPtr, n, stride](int &col) {
+        const double *x = theData.getColumn(firstCol+col);
+        double *z = valuesPtr + col*stride;
+        memcpy(z, x, n*sizeof(double));
+        variesPtr[col] = standardise(z, n);
+
+        double *r = ranksPtr + col*stride;
+        rank(x, n, r);
+        standardise(r, n);
+    });
+
+    this->correlate(values, thePearson);
+    this->correlate(ranks, theSpearman);
+
+    // exact on the diagonal, NaN for columns that do not vary
+    for (int i=0; i<numColumns; i++) {
+        for (int j=0; j<numColumns; j++) {
+            if (!varies[i] || !varies[j]) {
+                thePearson[i*numColumns + j] = NAN;
+                theSpearman[i*numColumns + j] = NAN;
+            } else if (i == j) {
+                thePearson[i*numColumns + j] = 1.0;
+                theSpearman[i*numColumns + j] = 1.0;
+            }
+        }
+    }
+}
+
+void
+CorrelationMatrix::correlate(const std::vector<double> &columns, std::vector<double> &result) const
+{
+    int numTiles = (numColumns+TILE_COLUMNS-1)/TILE_COLUMNS;
+
+    // the upper triangle of tiles, each task its own tile of sums
+    QVector<CorrelationTile> tiles;
+    for (int a=0; a<numTiles; a++) {
+        for (int b=a; b<numTiles; b++) {
+            CorrelationTile tile;
+            tile.firstA = a*TILE_COLUMNS;
+            tile.firstB = b*TILE_COLUMNS;
+            tiles.append(tile);
+        }
+    }
+
+    const double *data = columns.data();
+    int stride = paddedRows;
+    int n = numRows;
+    QtConcurrent::blockingMap(tiles, [data, stride, n](CorrelationTile &tile) {
+        tile.sums.assign(TILE_COLUMNS*TILE_COLUMNS, 0.0);
+        double sums[4][4];
+        for (int row=0; row<n; row += ROW_BLOCK) {
+            int numRowsBlock = qMin(ROW_BLOCK, n-row);
+            for (int i=0; i<TILE_COLUMNS; i += 4) {
+                const double *a = data + static_cast<size_t>(tile.firstA+i)*stride + row;
+                // in a diagonal tile only the quads on or above the diagonal
+                int firstJ = (tile.firstA == tile.firstB) ? i : 0;
+                for (int j=firstJ; j<TILE_COLUMNS; j += 4) {
+                    const double *b = data + static_cast<size_t>(tile.firstB+j)*stride + row;
+                    memset(sums, 0, sizeof(sums));
+                    kernel4x4(a, b, stride, numRowsBlock, sums);
+                    for (int k=0; k<4; k++)
+                        for (int l=0; l<4; l++)
+                            tile.sums[(i+k)*TILE_COLUMNS + j+l] += sums[k][l];
+                }
+            }
+        }
+    });
+
+    //
+    // scatter the tiles into the symmetric matrix
+    //
+
+    result.assign(static_cast<size_t>(numColumns)*numColumns, 0.0);
+    for (int t=0; t<tiles.size(); t++) {
+        const CorrelationTile &tile = tiles.at(t);
+        for (int i=0; i<TILE_COLUMNS; i++) {
+            int colA = tile.firstA+i;
+            if (colA >= numColumns)
+                break;
+            for (int j=0; j<TILE_COLUMNS; j++) {
+                int colB = tile.firstB+j;
+                if (colB >= numColumns)
+                    break;
+                if (tile.firstA == tile.firstB && (j/4) < (i/4))
+                    continue;
+                double value = qBound(-1.0, tile.sums[i*TILE_COLUMNS + j], 1.0);
+                result[colA*numColumns + colB] = value;
+                result[colB*numColumns + colA] = value;
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CORRELATION_MATRIX_H
+#define CORRELATION_MATRIX_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// Pearson and Spearman correlations between every pair of columns of a
+// SampleDataStore. each column is standardised once, to zero mean and unit
+// length so a dot product of two is their correlation, and for Spearman
+// first replaced by its ranks (ties given their average rank). the matrix of
+// dot products is then formed in square tiles of columns, run in parallel,
+// each going through the rows in blocks small enough to stay in cache and
+// computing 4x4 column pairs at a time. constant columns correlate as NaN
+
+#include <QStringList>
+#include <vector>
+
+class SampleDataStore;
+
+class CorrelationMatrix
+{
+public:
+    enum Type {
+        Pearson = 0,
+        Spearman
+    };
+
+    CorrelationMatrix();
+    ~CorrelationMatrix();
+
+    void clear(void);
+
+    // correlations between columns firstCol to lastCol inclusive
+    void compute(const SampleDataStore &theData, int firstCol, int lastCol);
+
+    int getNumColumns(void) const;
+    int getFirstColumn(void) const;
+    const QStringList &getHeadings(void) const;
+    double getCorrelation(Type type, int i, int j) const;
+    const std::vector<double> &getCorrelations(Type type) const;  // row major, numColumns^2
+
+private:
+    void correlate(const std::vector<double> &columns, std::vector<double> &result) const;
+
+    int numColumns;
+    int firstColumn;
+    int numRows;
+    int paddedRows;       // rows rounded up so every column starts aligned
+    QStringList theHeadings;
+    std::vector<double> thePearson;
+    std::vector<double> theSpearman;
+};
+
+#endif // CORRELATION_MATRIX_H
@@ -0,0 +1,242 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaCDFParser.h"
+#include <DakotaTabParser.h>
+#include <SampleDataStore.h>
+
+#include <QFile>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+struct CDFTable {
+    const char *begin;      // start of the header line
+    const char *end;        // start of the next table or end of file
+    QString name;
+    std::vector<double> levels;
+    std::vector<double> probabilities;
+};
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char *skipBlanks(const char *p, const char *end)
+{
+    while (p < end && isBlank(*p))
+        p++;
+    return p;
+}
+
+static const char *nextLine(const char *p, const char *end)
+{
+    const char *newLine = static_cast<const char *>(memchr(p, '\n', end-p));
+    return (newLine == NULL) ? end : newLine+1;
+}
+
+// a data line starts with a number, the table ends at a line of dashes or text
+static bool startsWithNumber(const char *p, const char *end)
+{
+    if (p < end && (*p == '-' || *p == '+'))
+        p++;
+    if (p < end && *p == '.')
+        p++;
+    return p < end && *p >= '0' && *p <= '9';
+}
+
+//
+// header line is "Cumulative Distribution Function (CDF) for <name>:", then
+// the column titles and a line of dashes, then one line per level:
+//   response level   probability level   [reliability index  general rel index]
+//
+
+static void parseTable(CDFTable &table)
+{
+    const char *end = table.end;
+    const char *headerEnd = static_cast<const char *>(memchr(table.begin, '\n', end-table.begin));
+    if (headerEnd == NULL)
+        headerEnd = end;
+
+    const char *nameEnd = headerEnd;
+    while (nameEnd > table.begin && (isBlank(nameEnd[-1]) || nameEnd[-1] == ':'))
+        nameEnd--;
+    const char *nameBegin = nameEnd;
+    while (nameBegin > table.begin && !isBlank(nameBegin[-1]))
+        nameBegin--;
+    table.name = QString::fromLatin1(nameBegin, nameEnd-nameBegin);
+
+    // skip the column titles and the dashes under them
+    const char *p = nextLine(table.begin, end);
+    p = nextLine(p, end);
+    p = nextLine(p, end);
+
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end-p));
+        if (lineEnd == NULL)
+            lineEnd = end;
+
+        const char *q = skipBlanks(p, lineEnd);
+        if (!startsWithNumber(q, lineEnd))
+            break;
+
+        double level, probability;
+        q = DakotaTabParser::parseNumber(q, lineEnd, level);
+        q = skipBlanks(q, lineEnd);
+        if (!startsWithNumber(q, lineEnd))
+            break;
+        DakotaTabParser::parseNumber(q, lineEnd, probability);
+
+        table.levels.push_back(level);
+        table.probabilities.push_back(probability);
+
+        p = lineEnd+1;
+    }
+}
+
+DakotaCDFParser::DakotaCDFParser()
+{
+
+}
+
+DakotaCDFParser::~DakotaCDFParser()
+{
+
+}
+
+QString
+DakotaCDFParser::getErrorMessage(void) const
+{
+    return errorMessage;
+}
+
+int
+DakotaCDFParser::parseFile(const QString &filename, const QVector<qint64> &offsets,
+                           SampleDataStore &levels, SampleDataStore &probabilities)
+{
+    levels.clear();
+    probabilities.clear();
+    errorMessage.clear();
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("DakotaCDFParser: Could not open file ") + filename;
+        return -1;
+    }
+
+    qint64 fileSize = file.size();
+
+    // map the file, if that is not possible read it in
+    QByteArray contents;
+    const char *begin = reinterpret_cast<const char *>(file.map(0, fileSize));
+    if (begin == NULL) {
+        contents = file.readAll();
+        begin = contents.constData();
+        fileSize = contents.size();
+    }
+    const char *end = begin + fileSize;
+
+    //
+    // each table runs to the start of the next, parse them all in parallel
+    //
+
+    QVector<CDFTable> tables;
+    for (int i=0; i<offsets.size(); i++) {
+        if (offsets.at(i) < 0 || offsets.at(i) >= fileSize)
+            continue;
+        CDFTable table;
+        table.begin = begin + offsets.at(i);
+        table.end = (i+1 < offsets.size() && offsets.at(i+1) <= fileSize) ? begin + offsets.at(i+1) : end;
+        tables.append(table);
+    }
+
+    if (tables.isEmpty()) {
+        file.close();
+        errorMessage = QString("DakotaCDFParser: no CDF tables in ") + filename;
+        return -1;
+    }
+
+    QtConcurrent::blockingMap(tables, [](CDFTable &table) {
+        parseTable(table);
+    });
+
+    file.close();  // also unmaps
+
+    //
+    // size both stores once and copy each table into its columns
+    //
+
+    int numResponses = tables.size();
+    int numRows = 0;
+    QStringList names;
+    for (int i=0; i<numResponses; i++) {
+        names << tables.at(i).name;
+        int numLevels = static_cast<int>(tables.at(i).levels.size());
+        if (numLevels > numRows)
+            numRows = numLevels;
+    }
+
+    probabilities.setHeadings(names);
+    names.prepend("%");
+    levels.setHeadings(names);
+    levels.resizeRows(numRows);
+    probabilities.resizeRows(numRows);
+
+    for (int i=0; i<numResponses; i++) {
+        const CDFTable &table = tables.at(i);
+        int numLevels = static_cast<int>(table.levels.size());
+
+        double *levelColumn = levels.getColumnData(i+1);
+        double *probabilityColumn = probabilities.getColumnData(i);
+        if (numLevels != 0) {
+            memcpy(levelColumn, table.levels.data(), numLevels*sizeof(double));
+            memcpy(probabilityColumn, table.probabilities.data(), numLevels*sizeof(double));
+        }
+        for (int row=numLevels; row<numRows; row++) {
+            levelColumn[row] = NAN;
+            probabilityColumn[row] = NAN;
+        }
+    }
+
+    if (numRows != 0)
+        memcpy(levels.getColumnData(0), probabilities.getColumn(0), numRows*sizeof(double));
+
+    return numResponses;
+}
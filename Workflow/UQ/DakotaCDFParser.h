@@ -0,0 +1,70 @@
+#ifndef DAKOTA_CDF_PARSER_H
+#define DAKOTA_CDF_PARSER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// reader for the "Cumulative Distribution Function (CDF) for <response>:"
+// tables of a dakota reliability run. the tables are located with a
+// DakotaOutIndex, the mapped file is then read once, each table parsed in
+// parallel, and the values placed in two stores sized for all the responses:
+//  - levels: "%" (the probability levels of the first response) followed by
+//    the response levels of each response, as shown in the results table
+//  - probabilities: the probability levels of each response, for its curve
+// responses with fewer levels than the longest are padded with NaN
+
+#include <QString>
+#include <QVector>
+
+class SampleDataStore;
+
+class DakotaCDFParser
+{
+public:
+    DakotaCDFParser();
+    ~DakotaCDFParser();
+
+    // offsets are those of the CDF table headers, returns number of responses or -1 on error
+    int parseFile(const QString &filename, const QVector<qint64> &offsets,
+                  SampleDataStore &levels, SampleDataStore &probabilities);
+
+    QString getErrorMessage(void) const;
+
+private:
+    QString errorMessage;
+};
+
+#endif // DAKOTA_CDF_PARSER_H
@@ -0,0 +1,308 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaOutIndex.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <string.h>
+
+// below this many bytes the file is searched on the calling thread
+static const qint64 MIN_BYTES_PER_CHUNK = 16 << 20;
+
+// sidecar file layout, bump the version if the patterns or format change
+static const quint32 INDEX_MAGIC = 0x44414b49;
+static const quint32 INDEX_VERSION = 1;
+
+static const char *sectionPatterns[DakotaOutIndex::NumSectionTypes] = {
+    "Global sensitivity indices for each response function:",
+    "Sobol' indices:",
+    "Cumulative Distribution Function (CDF)",
+    "Probability Density Function (PDF)",
+    "Sample moment statistics for each response function:",
+    "<<<<< Function evaluation summary"
+};
+
+//
+// the byte of a pattern to memchr for: upper case letters and punctuation
+// are rare in dakota output, digits, blanks, signs and lower case are not
+//
+
+static int anchorRank(char c)
+{
+    if ((c >= 'A' && c <= 'Z') || strchr("'():<>", c) != NULL)
+        return 0;
+    if ((c >= '0' && c <= '9') || c == ' ' || c == '.' || c == '-' || c == '+' || c == 'e')
+        return 2;
+    return 1;
+}
+
+static int anchorOffset(const char *pattern)
+{
+    int best = 0;
+    int length = static_cast<int>(strlen(pattern));
+    for (int i=1; i<length; i++)
+        if (anchorRank(pattern[i]) < anchorRank(pattern[best]))
+            best = i;
+    return best;
+}
+
+struct IndexChunk {
+    const char *begin;   // matches must start in [begin, end)
+    const char *end;
+    QVector<qint64> offsets[DakotaOutIndex::NumSectionTypes];
+};
+
+static void scanChunk(const char *fileBegin, const char *fileEnd, IndexChunk &chunk)
+{
+    for (int type=0; type<DakotaOutIndex::NumSectionTypes; type++) {
+        const char *pattern = sectionPatterns[type];
+        int length = static_cast<int>(strlen(pattern));
+        int anchor = anchorOffset(pattern);
+        char anchorChar = pattern[anchor];
+
+        const char *p = chunk.begin + anchor;
+        const char *last = std::min(chunk.end + anchor, fileEnd - length + anchor + 1);
+        while (p < last) {
+            p = static_cast<const char *>(memchr(p, anchorChar, last-p));
+            if (p == NULL)
+                break;
+
+            const char *start = p - anchor;
+            if (memcmp(start, pattern, length) == 0) {
+                // record the start of the line it is on, once per line
+                const char *lineStart = start;
+                while (lineStart > fileBegin && lineStart[-1] != '\n')
+                    lineStart--;
+                qint64 offset = lineStart - fileBegin;
+                QVector<qint64> &offsets = chunk.offsets[type];
+                if (offsets.isEmpty() || offsets.last() != offset)
+                    offsets.append(offset);
+            }
+            p++;
+        }
+    }
+}
+
+DakotaOutIndex::DakotaOutIndex()
+{
+
+}
+
+DakotaOutIndex::~DakotaOutIndex()
+{
+
+}
+
+const QVector<qint64> &
+DakotaOutIndex::getOffsets(SectionType type) const
+{
+    return theOffsets[type];
+}
+
+void
+DakotaOutIndex::setOffsets(SectionType type, const QVector<qint64> &offsets)
+{
+    theOffsets[type] = offsets;
+}
+
+qint64
+DakotaOutIndex::getFirstOffset(SectionType type) const
+{
+    if (theOffsets[type].isEmpty())
+        return -1;
+    return theOffsets[type].first();
+}
+
+QString
+DakotaOutIndex::getErrorMessage(void) const
+{
+    return errorMessage;
+}
+
+bool
+DakotaOutIndex::build(const QString &filename)
+{
+    errorMessage.clear();
+    for (int type=0; type<NumSectionTypes; type++)
+        theOffsets[type].clear();
+
+    QFileInfo fileInfo(filename);
+    if (!fileInfo.exists()) {
+        errorMessage = QString("DakotaOutIndex: No file ") + filename;
+        return false;
+    }
+    qint64 fileSize = fileInfo.size();
+    qint64 fileTime = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    QString cacheName = filename + QString(".index");
+    if (this->readCache(cacheName, fileSize, fileTime))
+        return true;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("DakotaOutIndex: Could not open file ") + filename;
+        return false;
+    }
+
+    // map the file, if that is not possible read it in
+    if (fileSize != 0) {
+        QByteArray contents;
+        const char *begin = reinterpret_cast<const char *>(file.map(0, fileSize));
+        if (begin == NULL) {
+            contents = file.readAll();
+            begin = contents.constData();
+            fileSize = contents.size();
+        }
+        this->scan(begin, begin + fileSize);
+    }
+    file.close();  // also unmaps
+
+    this->writeCache(cacheName, fileSize, fileTime);
+    return true;
+}
+
+void
+DakotaOutIndex::scan(const char *begin, const char *end)
+{
+    qint64 size = end-begin;
+    int numChunks = static_cast<int>(qMin(static_cast<qint64>(QThread::idealThreadCount()*4),
+                                          size/MIN_BYTES_PER_CHUNK + 1));
+
+    QVector<IndexChunk> chunks(numChunks);
+    for (int i=0; i<numChunks; i++) {
+        chunks[i].begin = begin + size*i/numChunks;
+        chunks[i].end = begin + size*(i+1)/numChunks;
+    }
+
+    if (numChunks == 1)
+        scanChunk(begin, end, chunks[0]);
+    else
+        QtConcurrent::blockingMap(chunks, [begin, end](IndexChunk &chunk) {
+            scanChunk(begin, end, chunk);
+        });
+
+    // chunks are in file order, a header split between two is found by the first
+    for (int type=0; type<NumSectionTypes; type++) {
+        QVector<qint64> &offsets = theOffsets[type];
+        for (int i=0; i<numChunks; i++)
+            offsets += chunks.at(i).offsets[type];
+        offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    }
+}
+
+bool
+DakotaOutIndex::readCache(const QString &cacheName, qint64 fileSize, qint64 fileTime)
+{
+    QFile cache(cacheName);
+    if (!cache.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&cache);
+    quint32 magic, version, numTypes;
+    qint64 cachedSize, cachedTime;
+    in >> magic >> version >> cachedSize >> cachedTime >> numTypes;
+    if (in.status() != QDataStream::Ok || magic != INDEX_MAGIC || version != INDEX_VERSION
+            || cachedSize != fileSize || cachedTime != fileTime || numTypes != NumSectionTypes)
+        return false;
+
+    for (int type=0; type<NumSectionTypes; type++)
+        in >> theOffsets[type];
+
+    if (in.status() != QDataStream::Ok) {
+        for (int type=0; type<NumSectionTypes; type++)
+            theOffsets[type].clear();
+        return false;
+    }
+
+    return true;
+}
+
+void
+DakotaOutIndex::writeCache(const QString &cacheName, qint64 fileSize, qint64 fileTime)
+{
+    // not being able to write it, e.g. a read only directory, only costs a rescan
+    QFile cache(cacheName);
+    if (!cache.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&cache);
+    out << INDEX_MAGIC << INDEX_VERSION << fileSize << fileTime << quint32(NumSectionTypes);
+    for (int type=0; type<NumSectionTypes; type++)
+        out << theOffsets[type];
+}
+
+QString
+DakotaOutIndex::readLastLine(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    qint64 fileSize = file.size();
+    if (fileSize == 0)
+        return QString();
+
+    // read a growing tail until it holds the whole last line
+    qint64 tailSize = 4096;
+    while (true) {
+        qint64 start = qMax(static_cast<qint64>(0), fileSize-tailSize);
+        file.seek(start);
+        QByteArray tail = file.read(fileSize-start);
+
+        // like reading line by line, a final newline does not start another line
+        int lineEnd = tail.size();
+        if (lineEnd > 0 && tail.at(lineEnd-1) == '\n')
+            lineEnd--;
+        if (lineEnd == 0)
+            return QString();
+        int lineStart = tail.lastIndexOf('\n', lineEnd-1) + 1;
+
+        if (lineStart > 0 || start == 0) {
+            QByteArray line = tail.mid(lineStart, lineEnd-lineStart);
+            if (line.endsWith('\r'))
+                line.chop(1);
+            return QString::fromLocal8Bit(line);
+        }
+        tailSize *= 4;
+    }
+}
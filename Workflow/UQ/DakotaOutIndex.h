@@ -0,0 +1,87 @@
+#ifndef DAKOTA_OUT_INDEX_H
+#define DAKOTA_OUT_INDEX_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// byte offsets of the sections of a dakota.out file the result widgets read,
+// so they can seek straight to them instead of reading gigabytes of verbose
+// output line by line. the file is mapped and searched once, in parallel
+// chunks, each pattern by memchr on its rarest byte; the offsets are saved
+// in a sidecar file (dakota.out.index) that is reused while the size and
+// modification time of dakota.out are unchanged
+
+#include <QString>
+#include <QVector>
+
+class DakotaOutIndex
+{
+public:
+    enum SectionType {
+        SensitivityIndices = 0, // Global sensitivity indices for each response function:
+        SobolIndices,           // <response> Sobol' indices:
+        CDFTable,               // Cumulative Distribution Function (CDF) for <response>:
+        PDFTable,               // Probability Density Function (PDF) histograms ...
+        MomentStatistics,       // Sample moment statistics for each response function:
+        EvaluationSummary,      // <<<<< Function evaluation summary: ...
+        NumSectionTypes
+    };
+
+    DakotaOutIndex();
+    ~DakotaOutIndex();
+
+    // index the file, from the sidecar if it is still valid, returns false on error
+    bool build(const QString &filename);
+
+    // offsets of the start of the lines the section headers are on, in file order
+    const QVector<qint64> &getOffsets(SectionType type) const;
+    qint64 getFirstOffset(SectionType type) const;    // -1 if not found
+    void setOffsets(SectionType type, const QVector<qint64> &offsets);  // e.g. from DakotaResultsCache
+    QString getErrorMessage(void) const;
+
+    // the last line of a file, reading only its tail; used for dakota.err
+    static QString readLastLine(const QString &filename);
+
+private:
+    bool readCache(const QString &cacheName, qint64 fileSize, qint64 fileTime);
+    void writeCache(const QString &cacheName, qint64 fileSize, qint64 fileTime);
+    void scan(const char *begin, const char *end);
+
+    QVector<qint64> theOffsets[NumSectionTypes];
+    QString errorMessage;
+};
+
+#endif // DAKOTA_OUT_INDEX_H
@@ -0,0 +1,354 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaResultsCache.h"
+#include <SampleDataStore.h>
+#include <SampleStatistics.h>
+#include <DakotaOutIndex.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <string.h>
+
+#define CACHE_MAGIC 0x44524331        // "DRC1"
+#define CACHE_VERSION 1               // bump when the parsers or statistics change
+#define HASH_CHUNK_SIZE (1 << 22)     // bytes hashed by one task
+#define RAW_BLOCK_SIZE (1 << 28)      // bytes per read or write of a column
+
+// parts present in the cache, a bit each
+#define CACHE_DATA 1
+#define CACHE_STATISTICS 2
+#define CACHE_INDEX 4
+
+static const quint64 prime1 = 0x9E3779B185EBCA87ULL;
+static const quint64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const quint64 prime3 = 0x165667B19E3779F9ULL;
+
+static inline quint64 rotateLeft(quint64 x, int r)
+{
+    return (x << r) | (x >> (64-r));
+}
+
+static inline quint64 finalMix(quint64 h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//
+// four independent lanes of multiply-rotate over 8 byte words, so the loop
+// is limited by memory rather than the multiplier latency
+//
+
+static quint64 hashChunk(const char *p, qint64 length)
+{
+    quint64 h[4] = {prime1, prime2, prime3, prime1 ^ prime2};
+
+    qint64 i = 0;
+    for (; i+32 <= length; i += 32) {
+        for (int lane=0; lane<4; lane++) {
+            quint64 word;
+            memcpy(&word, p+i+8*lane, sizeof(word));
+            h[lane] = rotateLeft(h[lane] ^ (word*prime2), 31)*prime1;
+        }
+    }
+
+    // the last (up to 3) whole words go through the lanes like the rest,
+    // then the final (up to 7) bytes each get their own byte of a word
+    for (int lane=0; i+8 <= length; i += 8, lane++) {
+        quint64 word;
+        memcpy(&word, p+i, sizeof(word));
+        h[lane] = rotateLeft(h[lane] ^ (word*prime2), 31)*prime1;
+    }
+
+    quint64 tail = 0;
+    for (int shift=0; i < length; i++, shift += 8)
+        tail |= static_cast<quint64>(static_cast<unsigned char>(p[i])) << shift;
+
+    quint64 result = h[0] ^ rotateLeft(h[1], 7) ^ rotateLeft(h[2], 12) ^ rotateLeft(h[3], 18);
+    return finalMix(result ^ (tail*prime3) ^ static_cast<quint64>(length));
+}
+
+struct HashChunk {
+    const char *begin;
+    qint64 length;
+    quint64 hash;
+};
+
+DakotaResultsCache::DakotaResultsCache()
+{
+
+}
+
+DakotaResultsCache::~DakotaResultsCache()
+{
+
+}
+
+quint64
+DakotaResultsCache::hashFile(const QString &filename, qint64 &fileSize, bool &ok)
+{
+    ok = false;
+    fileSize = 0;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    fileSize = file.size();
+    ok = true;
+    if (fileSize == 0)
+        return 0;
+
+    // map the file, if that is not possible read it in
+    QByteArray contents;
+    const char *begin = reinterpret_cast<const char *>(file.map(0, fileSize));
+    if (begin == NULL) {
+        contents = file.readAll();
+        begin = contents.constData();
+        fileSize = contents.size();
+    }
+
+    QVector<HashChunk> chunks;
+    for (qint64 offset=0; offset<fileSize; offset += HASH_CHUNK_SIZE) {
+        HashChunk chunk;
+        chunk.begin = begin + offset;
+        chunk.length = qMin(static_cast<qint64>(HASH_CHUNK_SIZE), fileSize-offset);
+        chunk.hash = 0;
+        chunks.append(chunk);
+    }
+
+    QtConcurrent::blockingMap(chunks, [](HashChunk &chunk) {
+        chunk.hash = hashChunk(chunk.begin, chunk.length);
+    });
+
+    file.close();  // also unmaps
+
+    // combine in file order
+    quint64 hash = prime3;
+    for (int i=0; i<chunks.size(); i++)
+        hash = rotateLeft(hash ^ chunks.at(i).hash, 27)*prime1 + prime2;
+
+    return finalMix(hash ^ static_cast<quint64>(fileSize));
+}
+
+bool
+DakotaResultsCache::setSources(const QStringList &filenames)
+{
+    theSizes.clear();
+    theHashes.clear();
+    cacheName.clear();
+
+    if (filenames.isEmpty())
+        return false;
+
+    for (int i=0; i<filenames.size(); i++) {
+        bool ok;
+        qint64 fileSize;
+        quint64 hash = hashFile(filenames.at(i), fileSize, ok);
+        if (!ok)
+            return false;
+        theSizes.append(fileSize);
+        theHashes.append(hash);
+    }
+
+    QFileInfo tabInfo(filenames.at(0));
+    cacheName = tabInfo.absolutePath() + QDir::separator() + tabInfo.fileName() + QString(".cache");
+    return true;
+}
+
+bool
+DakotaResultsCache::load(SampleDataStore *theData, QVector<ColumnStatistics> *theStatistics, DakotaOutIndex *theIndex)
+{
+    if (cacheName.isEmpty())
+        return false;
+
+    QFile cache(cacheName);
+    if (!cache.open(QIODevice::ReadOnly))
+        return false;
+
+    //
+    // the key: version, byte order of the raw columns and every source
+    //
+
+    QDataStream in(&cache);
+    quint32 magic, version, byteOrder, parts;
+    QVector<qint64> cachedSizes;
+    QVector<quint64> cachedHashes;
+    in >> magic >> version >> byteOrder >> cachedSizes >> cachedHashes >> parts;
+    if (in.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION
+            || byteOrder != Q_BYTE_ORDER || cachedSizes != theSizes || cachedHashes != theHashes)
+        return false;
+
+    quint32 wanted = (theData ? CACHE_DATA : 0) | (theStatistics ? CACHE_STATISTICS : 0) | (theIndex ? CACHE_INDEX : 0);
+    if ((parts & wanted) != wanted)
+        return false;
+
+    //
+    // the parts are stored in order, those not wanted are read past
+    //
+
+    if (parts & CACHE_DATA) {
+        QStringList headings;
+        qint64 numRows;
+        in >> headings >> numRows;
+        if (in.status() != QDataStream::Ok || numRows < 0)
+            return false;
+
+        qint64 columnBytes = numRows*static_cast<qint64>(sizeof(double));
+        if (theData == NULL) {
+            if (!cache.seek(cache.pos() + columnBytes*headings.size()))
+                return false;
+        } else {
+            theData->setHeadings(headings);
+            theData->resizeRows(static_cast<int>(numRows));
+            for (int col=0; col<headings.size(); col++) {
+                char *dest = reinterpret_cast<char *>(theData->getColumnData(col));
+                for (qint64 done=0; done<columnBytes; ) {
+                    int length = static_cast<int>(qMin(static_cast<qint64>(RAW_BLOCK_SIZE), columnBytes-done));
+                    if (in.readRawData(dest+done, length) != length) {
+                        theData->clear();
+                        return false;
+                    }
+                    done += length;
+                }
+            }
+        }
+    }
+
+    if (parts & CACHE_STATISTICS) {
+        qint32 numColumns;
+        in >> numColumns;
+        QVector<ColumnStatistics> statistics(qMax(0, numColumns));
+        for (int i=0; i<statistics.size(); i++) {
+            ColumnStatistics &stats = statistics[i];
+            in >> stats.count >> stats.mean >> stats.stdDev >> stats.skewness >> stats.kurtosis
+               >> stats.min >> stats.max;
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                in >> stats.percentiles[j];
+        }
+        if (theStatistics != NULL)
+            *theStatistics = statistics;
+    }
+
+    if (parts & CACHE_INDEX) {
+        quint32 numTypes;
+        in >> numTypes;
+        for (quint32 type=0; type<numTypes; type++) {
+            QVector<qint64> offsets;
+            in >> offsets;
+            if (theIndex != NULL && type < DakotaOutIndex::NumSectionTypes)
+                theIndex->setOffsets(static_cast<DakotaOutIndex::SectionType>(type), offsets);
+        }
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        if (theData != NULL)
+            theData->clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+DakotaResultsCache::save(const SampleDataStore *theData, const QVector<ColumnStatistics> *theStatistics, const DakotaOutIndex *theIndex)
+{
+    if (cacheName.isEmpty())
+        return false;
+
+    // written to a temporary and renamed, a reader never sees half a cache
+    QSaveFile cache(cacheName);
+    if (!cache.open(QIODevice::WriteOnly))
+        return false;
+
+    quint32 parts = (theData ? CACHE_DATA : 0) | (theStatistics ? CACHE_STATISTICS : 0) | (theIndex ? CACHE_INDEX : 0);
+
+    QDataStream out(&cache);
+    out << quint32(CACHE_MAGIC) << quint32(CACHE_VERSION) << quint32(Q_BYTE_ORDER)
+        << theSizes << theHashes << parts;
+
+    if (theData != NULL) {
+        qint64 numRows = theData->getNumRows();
+        out << theData->getHeadings() << numRows;
+
+        qint64 columnBytes = numRows*static_cast<qint64>(sizeof(double));
+        for (int col=0; col<theData->getNumColumns(); col++) {
+            const char *src = reinterpret_cast<const char *>(theData->getColumn(col));
+            for (qint64 done=0; done<columnBytes; ) {
+                int length = static_cast<int>(qMin(static_cast<qint64>(RAW_BLOCK_SIZE), columnBytes-done));
+                if (out.writeRawData(src+done, length) != length) {
+                    cache.cancelWriting();
+                    return false;
+                }
+                done += length;
+            }
+        }
+    }
+
+    if (theStatistics != NULL) {
+        out << qint32(theStatistics->size());
+        for (int i=0; i<theStatistics->size(); i++) {
+            const ColumnStatistics &stats = theStatistics->at(i);
+            out << stats.count << stats.mean << stats.stdDev << stats.skewness << stats.kurtosis
+                << stats.min << stats.max;
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                out << stats.percentiles[j];
+        }
+    }
+
+    if (theIndex != NULL) {
+        out << quint32(DakotaOutIndex::NumSectionTypes);
+        for (int type=0; type<DakotaOutIndex::NumSectionTypes; type++)
+            out << theIndex->getOffsets(static_cast<DakotaOutIndex::SectionType>(type));
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        cache.cancelWriting();
+        return false;
+    }
+
+    return cache.commit();
+}
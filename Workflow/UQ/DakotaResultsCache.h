@@ -0,0 +1,82 @@
+#ifndef DAKOTA_RESULTS_CACHE_H
+#define DAKOTA_RESULTS_CACHE_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a binary cache of the parsed results of a run, so reopening a project or
+// fetching a remote job again reads the columns, statistics and dakota.out
+// section offsets back in instead of parsing the text files. the cache
+// (dakotaTab.out.cache, next to the tab file) is keyed by the size and a
+// 64 bit hash of the contents of every source file, plus CACHE_VERSION,
+// which is to be bumped whenever the parsers or the statistics change. the
+// hash is computed over the mapped file in parallel chunks, so checking a
+// cache costs a read of the sources at memory speed rather than a parse
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class SampleDataStore;
+class ColumnStatistics;
+class DakotaOutIndex;
+
+class DakotaResultsCache
+{
+public:
+    DakotaResultsCache();
+    ~DakotaResultsCache();
+
+    // the files the results are parsed from, the first being the tab file;
+    // hashes them, returns false if one cannot be read
+    bool setSources(const QStringList &filenames);
+
+    // fill the parts asked for (those not NULL) from the cache, false if
+    // there is no cache for these sources or it lacks one of the parts
+    bool load(SampleDataStore *theData, QVector<ColumnStatistics> *theStatistics, DakotaOutIndex *theIndex);
+
+    // write the parts given, failing to write only costs a parse next time
+    bool save(const SampleDataStore *theData, const QVector<ColumnStatistics> *theStatistics, const DakotaOutIndex *theIndex);
+
+    static quint64 hashFile(const QString &filename, qint64 &fileSize, bool &ok);
+
+private:
+    QString cacheName;
+    QVector<qint64> theSizes;
+    QVector<quint64> theHashes;
+};
+
+#endif // DAKOTA_RESULTS_CACHE_H
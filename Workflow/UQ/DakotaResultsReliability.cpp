@@ -45,8 +45,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QFileDialog>
 #include <QTabWidget>
 #include <QTextEdit>
-#include <MyTableWidget.h>
+#include <MyTableView.h>
+#include <SampleDataModel.h>
+#include <SampleDataExporter.h>
 #include <QDebug>
+#include <DakotaOutIndex.h>
+#include <DakotaCDFParser.h>
 #include <QHBoxLayout>
 #include <QColor>
 #include <QMenuBar>
@@ -70,35 +74,28 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QGridLayout>
 #include <QLabel>
 
-#include <QtCharts/QChart>
-#include <QtCharts/QChartView>
-#include <QtCharts/QLineSeries>
-#include <QtCharts/QScatterSeries>
-#include <QtCharts/QVXYModelMapper>
-using namespace QtCharts;
+#include <SamplePlot.h>
 #include <math.h>
-#include <QValueAxis>
 #include <QLabel>
 
-#include <QXYSeries>
 #include <RandomVariablesContainer.h>
-#include <QMap>
 
 #define NUM_DIVISIONS 10
 #include <iostream>
 
 DakotaResultsReliability::DakotaResultsReliability(RandomVariablesContainer *theRandomVariables, QWidget *parent)
-  : UQ_Results(parent), theRVs(theRandomVariables), numSpreadsheetRows(0), numSpreadsheetCols(0)
+  : UQ_Results(parent), theRVs(theRandomVariables)
 {
-  chart = new QChart();
-  chart->setAnimationOptions(QChart::AllAnimations);
-  QChartView *chartView = new QChartView(chart);
-  chartView->setRenderHint(QPainter::Antialiasing);
-  chartView->chart()->legend()->hide();
+  chart = new SamplePlot();
 
   //layout = new QVBoxLayout();
-  spreadsheet = new MyTableWidget();  
-  layout->addWidget(chartView);
+  spreadsheet = new MyTableView();
+  dataModel = new SampleDataModel(&theData, spreadsheet);
+  spreadsheet->setModel(dataModel);
+  spreadsheet->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  spreadsheet->verticalHeader()->setVisible(false);
+  spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  layout->addWidget(chart);
   layout->addWidget(spreadsheet);
 
   mLeft = true;
@@ -116,11 +113,11 @@ DakotaResultsReliability::~DakotaResultsReliability()
 
 void DakotaResultsReliability::clear(void)
 {
-  spreadsheet->clear();
-  theHeadings.clear();
-
-  numSpreadsheetCols = 0;
-  numSpreadsheetRows = 0;
+  theData.clear();
+  theProbabilities.clear();
+  dataModel->setHighlightedColumns(-1, -1);
+  dataModel->reset();
+  chart->clearPlot();
 
   mLeft = true;
   col1 = 0;
@@ -137,13 +134,6 @@ int DakotaResultsReliability::processResults(QString &filenameResults, QString &
   // clear current
   this->clear();
 
-  numSpreadsheetCols = 1;
-  numSpreadsheetRows = 0;
-
-  theHeadings << "%";
-  spreadsheet->setColumnCount(1);
-
-
   //
   // check it actually ran with n errors
   //
@@ -156,15 +146,7 @@ int DakotaResultsReliability::processResults(QString &filenameResults, QString &
       emit sendErrorMessage("No dakota.err file - dakota did not run - problem with dakota setup or the applications failed with inputs provided");
       return 0;
   }
-  QFile fileError(filenameErrorString);
-  QString line("");
-  if (fileError.open(QIODevice::ReadOnly)) {
-     QTextStream in(&fileError);
-     while (!in.atEnd()) {
-        line = in.readLine();
-     }
-     fileError.close();
-  }
+  QString line = DakotaOutIndex::readLastLine(filenameErrorString);
 
   if ((line.length() != 0) && (!line.contains("Warning: unit probability", Qt::CaseInsensitive)
                                && !line.contains("We set the probability to 1.0 in this case", Qt::CaseInsensitive))){
@@ -184,15 +166,6 @@ int DakotaResultsReliability::processResults(QString &filenameResults, QString &
   // read data from file filename
   //  
   
-  // open file containing data
-  std::ifstream fileResults(filenameResults.toStdString().c_str());
-  if (!fileResults.is_open()) {
-    std::cerr << "DakotaResultsReliability: Could not open file";
-    return -1;
-  }
-  
-
-  
   /* **************************************** LOOKING FOR THE FOLLOWING
      -----------------------------------------------------------------
      Cumulative Distribution Function (CDF) for response_fn_1:
@@ -202,109 +175,33 @@ int DakotaResultsReliability::processResults(QString &filenameResults, QString &
      ........           ........           .......           .........
      ........           ........           .......           .........
      -----------------------------------------------------------------
-     
-  *************************************************************************** */
-
-  const std::string needleStart = "Cumulative Distribution Function (CDF)";
-  std::string haystack;
-
-  bool foundResults = false;
-  bool endResponses = false;
-  while(foundResults == false && fileResults.eof() != true) {
-
-      std::vector<double>col1;
-      std::vector<double>col2;
 
-      while (std::getline(fileResults, haystack)) {
-          if (haystack.find(needleStart) != std::string::npos) {
-              foundResults = true;
-              break;
-          }
-      }
+  *************************************************************************** */
 
-      if (fileResults.eof()) {
-          endResponses = true;
-          break;
-      }
+  // find every table in one scan of the file, then read them all at once
+  DakotaOutIndex theIndex;
+  if (theIndex.build(filenameResults) == false) {
+      qDebug() << theIndex.getErrorMessage();
+      return -1;
   }
 
-  if (foundResults == false || endResponses == true) {
+  const QVector<qint64> &offsets = theIndex.getOffsets(DakotaOutIndex::CDFTable);
+  if (offsets.isEmpty()) {
       emit sendErrorMessage("ProcessingResults: No Results found in output file & no error .. Dakota crashed");
       return -1;
   }
 
-  /*
-   * for each response quantity enter prob levels into spreadsheet
-   */
-
-  while(endResponses == false && fileResults.eof() != true) {
-
-      std::istringstream iss(haystack);
-      std::string subs;
-
-      do {
-          iss >> subs;
-      } while (iss);
-
-      theHeadings << subs.c_str();
-      qDebug() << "HEADINGS" << theHeadings << " numCols: " << numSpreadsheetCols;
-
-
-      // read next 2 lines of drivel
-      std::getline(fileResults, haystack);
-      std::getline(fileResults, haystack);
-
-      // for some reason
-      // std::getline(fileResults, haystack);
-
-      const std::string needleEnd = "---------------------------------------";
-
-       spreadsheet->insertColumn(numSpreadsheetCols);
-       numSpreadsheetCols++;
-
-       QMap<float,float> data;
-       // now read the data till end of data encountered
-       int numRows = 0;
-
-       while (std::getline(fileResults, haystack)) {
-           if (haystack.find(needleStart) != std::string::npos) {
-               break;
-           } else if (haystack.find(needleEnd) != std::string::npos) {
-               qDebug() << "FOUND END";
-               endResponses = true;
-               break;
-           } else {
-               // read column entries
-               if (numSpreadsheetCols == 2)
-                   spreadsheet->insertRow(numRows);
-
-               std::string data1, data2, data3, data4;
-               std::istringstream is(haystack);
-
-               is >> data1 >> data2 >> data3 >> data4;
-
-               if (numSpreadsheetCols == 2) {
-                   data.insert(std::stod(data2),std::stod(data1));
-                   QModelIndex index = spreadsheet->model()->index(numRows, numSpreadsheetCols-2);
-                   spreadsheet->model()->setData(index, data2.c_str());
-               }
-               QModelIndex index = spreadsheet->model()->index(numRows, numSpreadsheetCols-1);
-               spreadsheet->model()->setData(index, data1.c_str());
-
-               numRows++;
-           }
-       }
-
-       numSpreadsheetRows = numRows;
+  DakotaCDFParser theParser;
+  if (theParser.parseFile(filenameResults, offsets, theData, theProbabilities) < 0) {
+      qDebug() << theParser.getErrorMessage();
+      emit sendErrorMessage("ProcessingResults: No Results found in output file & no error .. Dakota crashed");
+      return -1;
   }
 
-  spreadsheet->setHorizontalHeaderLabels(theHeadings);
-  spreadsheet->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-
-  fileResults.close();
+  dataModel->reset();
 
-  this->onSpreadsheetCellClicked(0,numSpreadsheetCols-1);
-  if (numSpreadsheetRows == 0)
+  this->onSpreadsheetCellClicked(0, theData.getNumColumns()-1);
+  if (theData.getNumRows() == 0)
       emit sendStatusMessage(tr("No Result Data Found .. dakota failed .. possibly no QoI provided"));
 
   return 0;
@@ -314,116 +211,64 @@ int DakotaResultsReliability::processResults(QString &filenameResults, QString &
 void
 DakotaResultsReliability::onSaveSpreadsheetClicked()
 {
-
-  int rowCount = spreadsheet->rowCount();
-  int columnCount = spreadsheet->columnCount();
-  
-  QString fileName = QFileDialog::getSaveFileName(this,
-						  tr("Save Data"), "",
-						  tr("All Files (*)"));
-  
-  QFile file(fileName);
-  if (file.open(QIODevice::ReadWrite))
-  {
-      QTextStream stream(&file);
-      for (int j=0; j<columnCount; j++)
-      {
-          stream <<theHeadings.at(j)<<",\t";
-      }
-      stream <<endl;
-      for (int i=0; i<rowCount; i++)
-      {
-          for (int j=0; j<columnCount; j++)
-          {
-              QTableWidgetItem *item_value = spreadsheet->item(i,j);
-              double value = item_value->text().toDouble();
-              stream << value << ",\t";
-              //     qDebug()<<value;
-          }
-          stream<<endl;
-      }
-  }
+    SampleDataExporter::exportData(theData, this);
 }
 
 
+
 void DakotaResultsReliability::onSpreadsheetCellClicked(int row, int col)
 {
     Q_UNUSED(row);
     col2 = 0;
-    int oldCol = col1;
-    if (col == 0)
+    if (col <= 0 || col >= theData.getNumColumns())
         return;
     else
         col1 = col;
 
     mLeft = spreadsheet->wasLeftKeyPressed();
+    dataModel->setHighlightedColumns(col1, col2);
 
-    // create a new series
-    chart->removeAllSeries();
-
-    //Remove all axes
-    for(auto axis: chart->axes())
-        chart->removeAxis(axis);
-
-    int rowCount = spreadsheet->rowCount();
-
-    if (col1 != col2) {
-        QScatterSeries *series = new QScatterSeries;
-        QLineSeries *lineSeries= new QLineSeries;
-
-        double minX = 0, maxX = 0;
-
-        for (int i=0; i<rowCount; i++) {
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);    //col1 goes in x-axis, col2 on y-axis
-            //col1=0;
-            QTableWidgetItem *itemY = spreadsheet->item(i,col2);
-            QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-            itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-            itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-            itemY->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-            double xVal = itemX->text().toDouble();
-            double yVal = itemY->text().toDouble();
-
-            series->append(xVal,yVal);
-            lineSeries->append(xVal,yVal);
-
-            if (i == 0) {
-                maxX = xVal;
-                minX = xVal;
-            } else {
-                if(xVal<minX){minX=xVal;}
-                if(xVal>maxX){maxX=xVal;}
-            }
-        }
-
-        chart->addSeries(series);
-        chart->addSeries(lineSeries);
-        series->setName("Samples");
-
-        QValueAxis *axisX = new QValueAxis();
-        QValueAxis *axisY = new QValueAxis();
+    chart->clearPlot();
 
-        axisX->setTitleText(theHeadings.at(col1));
-        axisY->setTitleText("Probability");
+    //
+    // the curve of the clicked response only: its levels against its own
+    // probabilities, straight from the columns of the two stores
+    //
 
-        if (maxX == minX) {
-            maxX = maxX*1.1;
-            minX = minX*0.9;
+    int rowCount = theData.getNumRows();
+    const double *levels = theData.getColumn(col1);
+    const double *probabilities = theProbabilities.getColumn(col1-1);
+
+    QVector<QPointF> points;
+    points.reserve(rowCount);
+    double minX = 0, maxX = 0;
+    for (int i=0; i<rowCount; i++) {
+        double xVal = levels[i];
+        double yVal = probabilities[i];
+        if (qIsNaN(xVal) || qIsNaN(yVal))
+            continue;
+
+        if (points.isEmpty()) {
+            maxX = xVal;
+            minX = xVal;
+        } else {
+            if(xVal<minX){minX=xVal;}
+            if(xVal>maxX){maxX=xVal;}
         }
+        points.append(QPointF(xVal, yVal));
+    }
 
-        double xRange=maxX-minX;
+    if (maxX == minX) {
+        maxX = maxX*1.1;
+        minX = minX*0.9;
+    }
 
-        //axisX->setRange(minX - 0.01*xRange, maxX + 0.1*xRange);
-        axisX->setRange(minX, maxX);
-        axisY->setRange(0, 1.0);
+    chart->setAxes(theData.getHeading(col1), minX, maxX, "Probability", 0, 1.0);
 
-        chart->addAxis(axisX, Qt::AlignBottom);
-        series->attachAxis(axisX);
-        lineSeries->attachAxis(axisX);
-        chart->addAxis(axisY, Qt::AlignLeft);
-        lineSeries->attachAxis(axisY);
-        series->attachAxis(axisY);
-   }
+    // the line and its points share the one container
+    QSharedPointer<QCPGraphDataContainer> data = SamplePlot::makeData(points);
+    QCPGraph *line = chart->addLine(data, "Samples");
+    chart->addMarkers(data, "Samples", line->pen().color());
 }
 
 
@@ -460,29 +305,9 @@ DakotaResultsReliability::outputToJSON(QJsonObject &jsonObject)
     //
 
     QJsonObject spreadsheetData;
-
-
-    spreadsheetData["numRow"]=numSpreadsheetRows;
-    spreadsheetData["numCol"]=numSpreadsheetCols;
-
-    QJsonArray headingsArray;
-    for (int i = 0; i <theHeadings.size(); ++i) {
-        headingsArray.append(QJsonValue(theHeadings.at(i)));
-    }
-
-    spreadsheetData["headings"]=headingsArray;
-
-    QJsonArray dataArray;
     QApplication::setOverrideCursor(Qt::WaitCursor);
-    for (int row = 0; row < numSpreadsheetRows; ++row) {
-        for (int column = 0; column < numSpreadsheetCols; ++column) {
-            QTableWidgetItem *theItem = spreadsheet->item(row,column);
-            QString textData = theItem->text();
-            dataArray.append(textData.toDouble());
-        }
-    }
+    theData.writeJSON(spreadsheetData);
     QApplication::restoreOverrideCursor();
-    spreadsheetData["data"]=dataArray;
 
     jsonObject["spreadsheet"] = spreadsheetData;
     return result;
@@ -40,18 +40,18 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written: fmckenna
 
 #include <UQ_Results.h>
-#include <QtCharts/QChart>
 #include <QMessageBox>
 #include <QPushButton>
+#include <SampleDataStore.h>
 
 
-using namespace QtCharts;
-
 class QTextEdit;
 class QTabWidget;
-class MyTableWidget;
+class MyTableView;
+class SampleDataModel;
 class MainWindow;
 class RandomVariablesContainer;
+class SamplePlot;
 
 //class QChart;
 
@@ -79,16 +79,14 @@ public slots:
 private:
    RandomVariablesContainer *theRVs;
 
-   MyTableWidget *spreadsheet;  
-   QChart *chart;
-   int numSpreadsheetRows;
-   int numSpreadsheetCols;
+   SampleDataStore theData;           // "%" then the response levels of each response
+   SampleDataStore theProbabilities;  // the probability levels of each response
+   SampleDataModel *dataModel;        // formats only the visible cells of theData
+   MyTableView *spreadsheet;
+   SamplePlot *chart;
 
    int col1, col2;
    bool mLeft;
-   QStringList theHeadings;
-
-   //   QVector<QString>theHeadings;
 };
 
 #endif // DAKOTA_RESULTS_RELIABILITY_H
@@ -47,15 +47,29 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QFileDialog>
 #include <QTabWidget>
 #include <QTextEdit>
-#include <MyTableWidget.h>
+#include <MyTableView.h>
+#include <SampleDataModel.h>
+#include <SampleDataExporter.h>
+#include <DakotaTabParser.h>
+#include <DakotaTabFollower.h>
+#include <DakotaTabMerger.h>
+#include <SampleComparisonModel.h>
+#include <ParallelCoordinatesView.h>
+#include <QTableView>
+#include <SamplePlot.h>
+#include <CorrelationMatrixView.h>
+#include <QComboBox>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QTimer>
 #include <QDebug>
+#include <DakotaOutIndex.h>
+#include <DakotaResultsCache.h>
 #include <QHBoxLayout>
 #include <QColor>
 #include <QMenuBar>
 #include <QAction>
 #include <QMenu>
 #include <QPushButton>
-#include <QProcess>
 #include <QScrollArea>
 
 #include <iostream>
@@ -79,16 +93,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 //#include <MainWindow.h>
 #include <QHeaderView>
 
-#include <QtCharts/QChart>
-#include <QtCharts/QChartView>
-#include <QtCharts/QLineSeries>
-#include <QtCharts/QScatterSeries>
-#include <QtCharts/QVXYModelMapper>
-using namespace QtCharts;
 #include <math.h>
-#include <QValueAxis>
 
-#include <QXYSeries>
 #include <RandomVariablesContainer.h>
 #include <QFileInfo>
 #include <QFile>
@@ -96,7 +102,13 @@ using namespace QtCharts;
 //#define NUM_DIVISIONS 10
 
 DakotaResultsSampling::DakotaResultsSampling(RandomVariablesContainer *theRandomVariables, QWidget *parent)
-  : UQ_Results(parent), theRVs(theRandomVariables)
+  : UQ_Results(parent), theRVs(theRandomVariables), theColumnCache(&theData), theDensities(&theData, &theColumnCache), theFilter(&theData),
+    dataModel(NULL), spreadsheet(NULL), chart(NULL),
+    correlationRows(-1), correlationView(NULL), correlationType(NULL), filterLineEdit(NULL), filterCount(NULL),
+    fitLabel(NULL), binRule(NULL), weightColumn(NULL), fittingColumn(-1), fittedColumn(-1),
+    fragilityIntensity(NULL), fragilityResponse(NULL), fragilityThresholds(NULL), fragilityChart(NULL), fragilityResults(NULL),
+    comparisonModel(NULL), comparisonView(NULL), comparisonLabel(NULL), comparisonRows(-1),
+    parallelView(NULL), parallelLabel(NULL), parallelRows(-1)
 {
     // title & add button
     tabWidget = new QTabWidget(this);
@@ -104,84 +116,111 @@ DakotaResultsSampling::DakotaResultsSampling(RandomVariablesContainer *theRandom
     mLeft = true;
     col1 = 0;
     col2 = 0;
+    pendingUnreadable = false;
+
+    theFollower = new DakotaTabFollower(&theData, this);
+    theFollower->setSketches(&theSketches);
+    connect(theFollower,SIGNAL(headingsRead()),this,SLOT(onFollowedHeadingsRead()));
+    connect(theFollower,SIGNAL(rowsAppended(int,int)),this,SLOT(onFollowedRowsAppended(int,int)));
+
+    connect(tabWidget,SIGNAL(currentChanged(int)),this,SLOT(onTabChanged(int)));
+    connect(&bootstrapWatcher,SIGNAL(finished()),this,SLOT(onBootstrapFinished()));
+    connect(&fitWatcher,SIGNAL(finished()),this,SLOT(onFitFinished()));
+    connect(&fragilityWatcher,SIGNAL(finished()),this,SLOT(onFragilityFitFinished()));
 }
 
 DakotaResultsSampling::~DakotaResultsSampling()
 {
-
+    // the workers use theBootstrap, theFitter and theFragilities
+    this->stopBootstrap();
+    fitWatcher.waitForFinished();
+    fragilityWatcher.waitForFinished();
 }
 
 
 void DakotaResultsSampling::clear(void)
 {
-    // delete any existing widgets
-    int count = tabWidget->count();
-    if (count > 0) {
-        for (int i=0; i<count; i++) {
-            QWidget *theWidget = tabWidget->widget(count);
-            delete theWidget;
-        }
+    // delete any existing widgets, with the views and models on them; quietly,
+    // onTabChanged would otherwise be called with pages half gone
+    tabWidget->blockSignals(true);
+    while (tabWidget->count() != 0) {
+        QWidget *theWidget = tabWidget->widget(0);
+        tabWidget->removeTab(0);
+        delete theWidget;
     }
+    tabWidget->blockSignals(false);
     theHeadings.clear();
-    theMeans.clear();
-    theStdDevs.clear();
-    theKurtosis.clear();
-    theSkewness.clear();
+    theNames.clear();
+    theStatistics.clear();
+    theMeanLineEdits.clear();
+    theStdDevLineEdits.clear();
+    theSkewnessLineEdits.clear();
+    theKurtosisLineEdits.clear();
+    theMinLineEdits.clear();
+    theMaxLineEdits.clear();
+    for (int i=0; i<NUM_PERCENTILES; i++)
+        thePercentileLineEdits[i].clear();
+    this->stopBootstrap();
+    for (int i=0; i<NUM_BOOTSTRAP_STATISTICS; i++)
+        theIntervalLabels[i].clear();
+    theBootstrap.clear();
+
+    theFollower->stop();
+    theFollowedMoments.clear();
 
-    tabWidget->clear();
     spreadsheet = NULL;
+    dataModel = NULL;
+    chart = NULL;
+    correlationView = NULL;
+    correlationType = NULL;
+    correlationRows = -1;
+    theCorrelations.clear();
+    filterLineEdit = NULL;
+    filterCount = NULL;
+    fitLabel = NULL;
+    binRule = NULL;
+    weightColumn = NULL;
+    fitWatcher.waitForFinished();
+    fittingColumn = -1;
+    fittedColumn = -1;
+    theFitter.clear();
+    fragilityIntensity = NULL;
+    fragilityResponse = NULL;
+    fragilityThresholds = NULL;
+    fragilityChart = NULL;
+    fragilityResults = NULL;
+    fragilityWatcher.waitForFinished();
+    theFragilities.clear();
+    comparisonModel = NULL;
+    comparisonView = NULL;
+    comparisonLabel = NULL;
+    comparisonRows = -1;
+    parallelView = NULL;
+    parallelLabel = NULL;
+    parallelRows = -1;
+    theFilter.clear();
+    theSketches.clear();
+    filteredX.clear();
+    filteredY.clear();
+    pendingSpreadsheet = QJsonObject();
+    pendingUnreadable = false;
+    theColumnCache.setRows(NULL);
+    theDensities.clear();
+    theDensities.setWeights(std::vector<double>());
+    theData.clear();
 }
 
 
 
-static void merge_helper(double *input, int left, int right, double *scratch)
-{
-    // if one element: done  else: recursive call and then merge
-    if(right == left + 1) {
-        return;
-    } else {
-        int length = right - left;
-        int midpoint_distance = length/2;
-        /* l and r are to the positions in the left and right subarrays */
-        int l = left, r = left + midpoint_distance;
-
-        // sort each subarray
-        merge_helper(input, left, left + midpoint_distance, scratch);
-        merge_helper(input, left + midpoint_distance, right, scratch);
-
-        // merge the arrays together using scratch for temporary storage
-        for(int i = 0; i < length; i++) {
-            /* Check to see if any elements remain in the left array; if so,
-            * we check if there are any elements left in the right array; if
-            * so, we compare them.  Otherwise, we know that the merge must
-            * use take the element from the left array */
-            if(l < left + midpoint_distance &&
-                    (r == right || fmin(input[l], input[r]) == input[l])) {
-                scratch[i] = input[l];
-                l++;
-            } else {
-                scratch[i] = input[r];
-                r++;
-            }
-        }
-        // Copy the sorted subarray back to the input
-        for(int i = left; i < right; i++) {
-            input[i] = scratch[i - left];
-        }
-    }
-}
+// points the fitted density is drawn with
+#define NUM_FIT_POINTS 256
 
-static int mergesort(double *input, int size)
-{
-    double *scratch = new double[size];
-    if(scratch != NULL) {
-        merge_helper(input, 0, size, scratch);
-        delete [] scratch;
-        return 1;
-    } else {
-        return 0;
-    }
-}
+// fewest points a CDF read from a quantile sketch is drawn with
+#define NUM_SKETCH_CDF_POINTS 800
+#define CDF_BINS_PER_PIXEL 4      // of the CDF from a sorted column, each bin giving at most 2 points
+
+// points each fragility curve is drawn with
+#define NUM_FRAGILITY_POINTS 200
 
 // if sobelov indices are selected then we would need to do some processing outselves
 
@@ -207,15 +246,7 @@ int DakotaResultsSampling::processResults(QString &filenameResults, QString &fil
         emit sendErrorMessage("No dakota.err file - dakota did not run - problem with dakota setup or the applications failed with inputs provided");
         return 0;
     }
-    QFile fileError(filenameErrorString);
-    QString line("");
-    if (fileError.open(QIODevice::ReadOnly)) {
-       QTextStream in(&fileError);
-       while (!in.atEnd()) {
-          line = in.readLine();
-       }
-       fileError.close();
-    }
+    QString line = DakotaOutIndex::readLastLine(filenameErrorString);
 
     if (line.length() != 0) {
         qDebug() << line.length() << " " << line;
@@ -229,6 +260,20 @@ int DakotaResultsSampling::processResults(QString &filenameResults, QString &fil
         return 0;
     }
 
+    return this->processTabFiles(QStringList() << filenameTab);
+}
+
+int
+DakotaResultsSampling::processTabFiles(const QStringList &filenamesTab)
+{
+    if (filenamesTab.isEmpty())
+        return -1;
+
+    this->clear();
+    mLeft = true;
+    col1 = 0;
+    col2 = 0;
+
     //
     // create summary, a QWidget for summary data, the EDP name, mean, stdDev, kurtosis info
     //
@@ -247,578 +292,1169 @@ int DakotaResultsSampling::processResults(QString &filenameResults, QString &fil
     sa->setWidget(summary);
 
     //
-    // create spreadsheet,  a QTableWidget showing RV and results for each run
+    // read the tab data into the columnar store
     //
 
-    spreadsheet = new MyTableWidget();
+    int firstEDP = theRVs->getNumRandomVariables()+1; // +1 for first col which is nit an RV
+    QVector<ColumnStatistics> edpStatistics;
+    if (filenamesTab.size() == 1) {
+        // the columns and statistics of an earlier load of the same tab file
+        QString filenameTab = filenamesTab.at(0);
+        DakotaResultsCache theCache;
+        bool cached = theCache.setSources(QStringList() << filenameTab)
+                && theCache.load(&theData, &edpStatistics, NULL);
+
+        // read the tab file, headings and all the data, into the store
+        if (!cached) {
+            DakotaTabParser theParser;
+            theParser.setSketches(&theSketches);
+            if (theParser.parseFile(filenameTab, theData) < 0) {
+                emit sendErrorMessage(theParser.getErrorMessage());
+                return -1;
+            }
+        } else
+            QuantileSketch::sketchColumns(theData, theSketches);
+
+        // determine summary statistics for each edp, one pass over each column, columns in parallel,
+        // the percentiles from the sorted columns the plots use
+        int colCount = theData.getNumColumns();
+        if (!cached || edpStatistics.size() != colCount-firstEDP) {
+            edpStatistics = SampleStatistics::computeColumns(theData, firstEDP, colCount-1, theColumnCache);
+            theCache.save(&theData, &edpStatistics, NULL);
+        }
+    } else {
+        // the files of a study split into several jobs, read in parallel with
+        // the statistics of each merged
+        DakotaTabMerger theMerger;
+        if (theMerger.mergeFiles(filenamesTab, theData) < 0) {
+            emit sendErrorMessage(theMerger.getErrorMessage());
+            return -1;
+        }
+        theSketches = theMerger.getSketches();
+        const QVector<ColumnStatistics> &statistics = theMerger.getStatistics();
+        for (int col=firstEDP; col<statistics.size(); col++)
+            edpStatistics.append(statistics.at(col));
+    }
+    theHeadings = theData.getHeadings();
+    int colCount = theData.getNumColumns();
 
-    // open file containing tab data
-    std::ifstream tabResults(filenameTab.toStdString().c_str());
-    if (!tabResults.is_open()) {
-        qDebug() << "Could not open file";
-        return -1;
+    for (int col = firstEDP; col<colCount; ++col) {
+        QString variableName = theHeadings.at(col);
+        QWidget *theWidget = this->createResultEDPWidget(variableName, edpStatistics.at(col-firstEDP));
+        summaryLayout->addWidget(theWidget);
     }
 
+    summaryLayout->addStretch();
+    this->startBootstrap();
+
     //
-    // read first line and set headings (ignoring second column for now)
+    // create the spreadsheet and chart, by default the chart plots the graph of
+    // the last column on Y-axis w.r.t first column on the X-axis
     //
 
-    std::string inputLine;
-    std::getline(tabResults, inputLine);
-    std::istringstream iss(inputLine);
-    int colCount = 0;
-
-    theHeadings << "Run #";
-
-    bool includesInterface = false;
-    do {
-        std::string subs;
-        iss >> subs;
-        if (colCount > 0) {
-            if (subs != " ") {
-                if (subs != "interface")
-                    theHeadings << subs.c_str();
-                else
-                    includesInterface = true;
-            }
-        }
-        colCount++;
-    } while (iss);
+    theColumnCache.sortColumns();
 
-    if (includesInterface == true)
-        colCount = colCount-2;
-    else
-        colCount = colCount -1;
+    QWidget *widget = this->createDataValuesWidget();
+    this->onSpreadsheetCellClicked(0,colCount-1);
 
-    spreadsheet->setColumnCount(colCount);
-    spreadsheet->setHorizontalHeaderLabels(theHeadings);
+    //
+    // add summary, detained info and spreadsheet with chart to the tabed widget
+    //
+
+    tabWidget->addTab(sa,tr("Summary"));
+    tabWidget->addTab(widget, tr("Data Values"));
+    tabWidget->addTab(this->createCorrelationsWidget(), tr("Correlations"));
+    tabWidget->addTab(this->createFragilityWidget(), tr("Fragility"));
+    tabWidget->addTab(this->createComparisonWidget(), tr("Compare"));
+    tabWidget->addTab(this->createParallelCoordinatesWidget(), tr("Parallel Coordinates"));
+    tabWidget->adjustSize();
 
-    // now until end of file, read lines and place data into spreadsheet
+    emit sendStatusMessage(tr(""));
 
-    int rowCount = 0;
-    while (std::getline(tabResults, inputLine)) {
-        std::istringstream is(inputLine);
-        int col=0;
+    return 0;
+}
 
-        spreadsheet->insertRow(rowCount);
-        for (int i=0; i<colCount+2; i++) {
-            std::string data;
-            is >> data;
-            if ((includesInterface == true && i != 1) || (includesInterface == false)) {
-                QModelIndex index = spreadsheet->model()->index(rowCount, col);
-                spreadsheet->model()->setData(index, data.c_str());
 
-                col++;
-            }
-        }
-        rowCount++;
-    }
-   // spreadsheet->resizeColumnsToContents();
-    //spreadsheet->setAutoScroll(true);
-    //spreadsheet->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    if (colCount < 10)
+QWidget *
+DakotaResultsSampling::createDataValuesWidget(void)
+{
+    //
+    // create spreadsheet, a QTableView onto the store showing RV and results for each run
+    //
+
+    spreadsheet = new MyTableView();
+    dataModel = new SampleDataModel(&theData, spreadsheet);
+    spreadsheet->setModel(dataModel);
+    if (theData.getNumColumns() < 10)
         spreadsheet->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     spreadsheet->verticalHeader()->setVisible(false);
-    //spreadsheet->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    tabResults.close();
 
+    // this is where we are connecting edit triggers
+    spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
 
     //
-    // determine summary statistics for each edp
+    // create a chart, to control the properties, how your graph looks you must click and study the updateChart
     //
 
+    chart = new SamplePlot();
 
-    for (int col = theRVs->getNumRandomVariables()+1; col<colCount; ++col) { // +1 for first col which is nit an RV
-        // compute the mean
-        double sum_value=0;
-        for(int row=0;row<rowCount;++row) {
-            QTableWidgetItem *item_index = spreadsheet->item(row,col);
-            double value_item = item_index->text().toDouble();
-            sum_value=sum_value+value_item;
-        }
+    QWidget *widget = new QWidget();
+    QGridLayout *layout = new QGridLayout(widget);
+    QPushButton* save_spreadsheet = new QPushButton();
+    save_spreadsheet->setText("Save Data");
+    save_spreadsheet->setToolTip(tr("Save data into file in a CSV format"));
+    save_spreadsheet->resize(30,30);
+    connect(save_spreadsheet,SIGNAL(clicked()),this,SLOT(onSaveSpreadsheetClicked()));
 
-        double mean_value=sum_value/rowCount;
-
-        double sd_value=0;
-        double kurtosis_value=0;
-        double skewness_value = 0;
-        for(int row=0; row<rowCount;++row) {
-            QTableWidgetItem *item_index = spreadsheet->item(row,col);
-            double value_item = item_index->text().toDouble();
-            double tmp = value_item - mean_value;
-            double tmp2 = tmp*tmp;
-            sd_value += tmp2;
-            skewness_value += tmp*tmp2;
-            kurtosis_value += tmp2*tmp2;
-        }
+    QPushButton *loadTabFiles = new QPushButton(tr("Load Tab Files"));
+    loadTabFiles->setToolTip(tr("Load the dakotaTab.out files of a study split into several jobs as one set of results"));
+    connect(loadTabFiles,SIGNAL(clicked()),this,SLOT(onLoadTabFilesClicked()));
 
+    //
+    // filter bar, range predicates on the columns select the rows the
+    // summary, charts and spreadsheet are shown for
+    //
 
-        double n = rowCount;
-        double tmpV = sd_value/n;
+    QWidget *filterBar = new QWidget();
+    QHBoxLayout *filterLayout = new QHBoxLayout(filterBar);
+    filterLayout->setContentsMargins(0,0,0,0);
+    filterLineEdit = new QLineEdit();
+    filterLineEdit->setPlaceholderText(tr("e.g. 1-PFD-1-1 > 0.02 and 0.5 <= 1-PFA-0-1 < 1.5"));
+    filterLineEdit->setToolTip(tr("Range conditions on the columns joined by \"and\"; statistics, charts and data are shown for the samples meeting all of them"));
+    QPushButton *applyFilter = new QPushButton(tr("Filter"));
+    QPushButton *clearFilter = new QPushButton(tr("Clear"));
+    filterCount = new QLabel();
+    filterLayout->addWidget(new QLabel(tr("Samples where")));
+    filterLayout->addWidget(filterLineEdit,1);
+    filterLayout->addWidget(applyFilter);
+    filterLayout->addWidget(clearFilter);
+    filterLayout->addWidget(filterCount);
+    connect(filterLineEdit,SIGNAL(returnPressed()),this,SLOT(onFilterApplied()));
+    connect(applyFilter,SIGNAL(clicked()),this,SLOT(onFilterApplied()));
+    connect(clearFilter,SIGNAL(clicked()),this,SLOT(onFilterCleared()));
+
+    // how the histogram is binned and weighted; col 0, the run #, is no weight
+    binRule = new QComboBox();
+    binRule->addItem(tr("Freedman-Diaconis"), DensityEstimator::FreedmanDiaconis);
+    binRule->addItem(tr("Scott"), DensityEstimator::Scott);
+    binRule->setCurrentIndex(binRule->findData(theDensities.getBinRule()));
+    binRule->setToolTip(tr("Rule for the width of the histogram bins"));
+    connect(binRule,SIGNAL(currentIndexChanged(int)),this,SLOT(onBinRuleChanged(int)));
+
+    weightColumn = new QComboBox();
+    weightColumn->addItem(tr("None"));
+    weightColumn->addItems(theHeadings.mid(1));
+    weightColumn->setToolTip(tr("Column holding a weight for each sample, e.g. the likelihood ratio of importance sampling, for the histogram and density"));
+    connect(weightColumn,SIGNAL(currentIndexChanged(int)),this,SLOT(onWeightColumnChanged(int)));
+
+    // the best fitting distribution when a histogram is shown
+    fitLabel = new QLabel();
+    QHBoxLayout *saveLayout = new QHBoxLayout();
+    saveLayout->addWidget(save_spreadsheet);
+    saveLayout->addWidget(loadTabFiles);
+    saveLayout->addWidget(new QLabel(tr("Bins")));
+    saveLayout->addWidget(binRule);
+    saveLayout->addWidget(new QLabel(tr("Weights")));
+    saveLayout->addWidget(weightColumn);
+    saveLayout->addWidget(fitLabel,1);
+
+    layout->addWidget(filterBar, 0,0,1,1);
+    layout->addWidget(chart, 1,0,1,1);
+    layout->addLayout(saveLayout,2,0);
+    layout->addWidget(spreadsheet,3,0,1,1);
+
+    return widget;
+}
 
-        if (rowCount > 1)
-            sd_value = sd_value/(n-1);
-        sd_value=sqrt(sd_value);
+QWidget *
+DakotaResultsSampling::createCorrelationsWidget(void)
+{
+    //
+    // a heat map of the correlations between all the columns, computed when
+    // the tab is shown; clicking a cell plots that pair on the data values tab
+    //
 
-        // biased Kurtosis
-        kurtosis_value = kurtosis_value/(n*tmpV*tmpV);
-        // unbiased kurtosis value as calculated by Matlab
-        if (n > 3)
-            kurtosis_value = (n-1)/((n-2)*(n-3))*((n+1)*kurtosis_value - 3*(n-1)) + 3;
+    QWidget *widget = new QWidget();
+    QVBoxLayout *correlationLayout = new QVBoxLayout(widget);
+
+    QHBoxLayout *typeLayout = new QHBoxLayout();
+    correlationType = new QComboBox();
+    correlationType->addItem(tr("Pearson"));
+    correlationType->addItem(tr("Spearman (rank)"));
+    correlationType->setToolTip(tr("Pearson: linear correlation of the values, Spearman: of their ranks"));
+    typeLayout->addWidget(new QLabel(tr("Correlation")));
+    typeLayout->addWidget(correlationType);
+    typeLayout->addSpacing(20);
+    typeLayout->addWidget(new QLabel(tr("click a cell to plot that pair")));
+    typeLayout->addStretch();
+
+    correlationView = new CorrelationMatrixView();
+    correlationRows = -1;
+    correlationLayout->addLayout(typeLayout);
+    correlationLayout->addWidget(correlationView, 1);
+
+    connect(correlationType,SIGNAL(currentIndexChanged(int)),this,SLOT(onCorrelationTypeChanged(int)));
+    connect(correlationView,SIGNAL(cellClicked(int,int)),this,SLOT(onCorrelationCellClicked(int,int)));
+
+    return widget;
+}
 
-        tmpV = sqrt(tmpV);
-        // biased skewness
-        skewness_value = skewness_value/(n*tmpV*tmpV*tmpV);
-        // unbiased skewness like Matlab
-        if (n > 3)
-            skewness_value *= sqrt(n*(n-1))/(n-2);
+void
+DakotaResultsSampling::updateCorrelations(void)
+{
+    if (correlationView == NULL)
+        return;
 
-        QString variableName = theHeadings.at(col);
-        QWidget *theWidget = this->createResultEDPWidget(variableName, mean_value, sd_value, skewness_value, kurtosis_value);
-        summaryLayout->addWidget(theWidget);
+    // again only if rows have arrived since, e.g. while following a run
+    int numRows = theData.getNumRows();
+    if (numRows != correlationRows) {
+        emit sendStatusMessage(tr("Computing correlations"));
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        theCorrelations.compute(theData, 1, theData.getNumColumns()-1);  // col 0 is the run #
+        correlationRows = numRows;
+        QApplication::restoreOverrideCursor();
+        emit sendStatusMessage(tr(""));
     }
 
-    summaryLayout->addStretch();
+    CorrelationMatrix::Type type = (correlationType->currentIndex() == 1) ? CorrelationMatrix::Spearman : CorrelationMatrix::Pearson;
+    correlationView->setMatrix(theCorrelations.getHeadings(), theCorrelations.getCorrelations(type));
+}
 
-    // this is where we are connecting edit triggers
-    spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
+void
+DakotaResultsSampling::onCorrelationTypeChanged(int index)
+{
+    Q_UNUSED(index);
+    if (correlationRows >= 0)
+        this->updateCorrelations();
+}
 
-    connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
+void
+DakotaResultsSampling::onCorrelationCellClicked(int row, int col)
+{
+    if (spreadsheet == NULL)
+        return;
+
+    // the column of the matrix on the x axis, the row on the y axis
+    int firstCol = theCorrelations.getFirstColumn();
+    col1 = firstCol + col;
+    col2 = firstCol + row;
 
+    tabWidget->setCurrentIndex(1);
+    this->updateChart();
+}
+
+QWidget *
+DakotaResultsSampling::createFragilityWidget(void)
+{
     //
-    // create a chart, setting data points from first and last col of spreadsheet
+    // lognormal fragility curves of a response column against an intensity
+    // column, one for each damage state threshold, with the fractions of the
+    // samples observed to reach them; the columns are listed when the tab is
+    // shown
     //
-    chart = new QChart();
-    chart->setAnimationOptions(QChart::AllAnimations);
 
-    // by default the constructor is called and it plots the graph of the last column on Y-axis w.r.t first column on the
-    // X-axis
-    this->onSpreadsheetCellClicked(0,colCount-1);
+    QWidget *widget = new QWidget();
+    QVBoxLayout *fragilityLayout = new QVBoxLayout(widget);
+
+    QHBoxLayout *inputLayout = new QHBoxLayout();
+    fragilityIntensity = new QComboBox();
+    fragilityResponse = new QComboBox();
+    fragilityThresholds = new QLineEdit();
+    fragilityThresholds->setPlaceholderText(tr("e.g. 0.005, 0.01, 0.02"));
+    fragilityThresholds->setToolTip(tr("a damage state is reached when the response is at or above its threshold"));
+    QPushButton *fitButton = new QPushButton(tr("Fit"));
+    inputLayout->addWidget(new QLabel(tr("Intensity")));
+    inputLayout->addWidget(fragilityIntensity);
+    inputLayout->addSpacing(20);
+    inputLayout->addWidget(new QLabel(tr("Response")));
+    inputLayout->addWidget(fragilityResponse);
+    inputLayout->addSpacing(20);
+    inputLayout->addWidget(new QLabel(tr("Damage state thresholds")));
+    inputLayout->addWidget(fragilityThresholds, 1);
+    inputLayout->addWidget(fitButton);
+
+    fragilityChart = new SamplePlot();
+    fragilityResults = new QLabel();
+    fragilityResults->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    fragilityLayout->addLayout(inputLayout);
+    fragilityLayout->addWidget(fragilityChart, 1);
+    fragilityLayout->addWidget(fragilityResults);
+
+    connect(fitButton,SIGNAL(clicked()),this,SLOT(onFragilityFitClicked()));
+    connect(fragilityThresholds,SIGNAL(returnPressed()),this,SLOT(onFragilityFitClicked()));
+
+    return widget;
+}
 
-    // to control the properties, how your graph looks you must click and study the onSpreadsheetCellClicked
+QWidget *
+DakotaResultsSampling::createComparisonWidget(void)
+{
+    //
+    // this run against a baseline run, e.g. the last design iteration, one
+    // row per column in both; computed when the tab is shown, double
+    // clicking a row plots the CDF of that column on the data values tab
+    //
 
-    QChartView *chartView = new QChartView(chart);
-    chartView->setRenderHint(QPainter::Antialiasing);
-    chartView->chart()->legend()->hide();
+    QWidget *widget = new QWidget();
+    QVBoxLayout *comparisonLayout = new QVBoxLayout(widget);
+
+    QHBoxLayout *baselineLayout = new QHBoxLayout();
+    QPushButton *loadBaseline = new QPushButton(tr("Load Baseline"));
+    loadBaseline->setToolTip(tr("Read the dakotaTab.out of the run to compare this one with"));
+    comparisonLabel = new QLabel();
+    baselineLayout->addWidget(loadBaseline);
+    baselineLayout->addWidget(comparisonLabel, 1);
+
+    comparisonModel = new SampleComparisonModel(&theComparison, widget);
+    comparisonView = new QTableView();
+    comparisonView->setModel(comparisonModel);
+    comparisonView->setSortingEnabled(true);
+    comparisonView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    comparisonView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    comparisonView->verticalHeader()->hide();
+    comparisonRows = -1;
+
+    comparisonLayout->addLayout(baselineLayout);
+    comparisonLayout->addWidget(comparisonView, 1);
+
+    connect(loadBaseline,SIGNAL(clicked()),this,SLOT(onLoadBaselineClicked()));
+    connect(comparisonView,SIGNAL(doubleClicked(QModelIndex)),this,SLOT(onComparisonDoubleClicked(QModelIndex)));
+
+    return widget;
+}
 
+void
+DakotaResultsSampling::updateComparison(void)
+{
+    if (comparisonModel == NULL)
+        return;
 
-    QWidget *widget = new QWidget();
-    QGridLayout *layout = new QGridLayout(widget);
-    QPushButton* save_spreadsheet = new QPushButton();
-    save_spreadsheet->setText("Save Data");
-    save_spreadsheet->setToolTip(tr("Save data into file in a CSV format"));
-    save_spreadsheet->resize(30,30);
-    connect(save_spreadsheet,SIGNAL(clicked()),this,SLOT(onSaveSpreadsheetClicked()));
+    if (!theComparison.hasBaseline()) {
+        comparisonModel->reset();
+        comparisonLabel->setText(tr("Load the dakotaTab.out of a run to compare this one with"));
+        return;
+    }
 
-    layout->addWidget(chartView, 0,0,1,1);
-    layout->addWidget(save_spreadsheet,1,0,Qt::AlignLeft);
+    // again only if the rows have changed since, e.g. with the filter or
+    // while following a run; the rows compared are those the filter selects
+    int numRows = theColumnCache.getNumRows();
+    if (numRows != comparisonRows) {
+        emit sendStatusMessage(tr("Comparing with the baseline"));
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        theColumnCache.sortColumns();
+        QVector<const std::vector<double> *> sortedColumns;
+        for (int col=0; col<theData.getNumColumns(); col++)
+            sortedColumns.append(&theColumnCache.getSortedColumn(col));
+        theComparison.compare(theHeadings, sortedColumns);
+        comparisonModel->reset();
+        comparisonRows = numRows;
+        QApplication::restoreOverrideCursor();
+        emit sendStatusMessage(tr(""));
+    }
 
+    comparisonLabel->setText(QString::number(theComparison.getNumChanged()) + QString(" of ") +
+                             QString::number(theComparison.getNumColumns()) + QString(" columns changed significantly from ") +
+                             theComparison.getBaselineName());
+}
 
-    // create a scrollable windows, place summary inside it
-    QScrollArea *ss = new QScrollArea;
-    ss->setWidgetResizable(true);
-    ss->setLineWidth(0);
-    ss->setFrameShape(QFrame::NoFrame);
-    //ss->setWidget(spreadsheet);
-    layout->addWidget(spreadsheet,2,0,1,1);
+void
+DakotaResultsSampling::onLoadBaselineClicked(void)
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Load Baseline"), QString(),
+                                                    tr("Dakota tab files (dakotaTab.out *.out);;All files (*)"));
+    if (filename.isEmpty())
+        return;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = theComparison.readBaseline(filename);
+    QApplication::restoreOverrideCursor();
+    if (!ok)
+        emit sendErrorMessage(theComparison.getErrorMessage());
+
+    comparisonRows = -1;
+    this->updateComparison();
+}
+
+void
+DakotaResultsSampling::onComparisonDoubleClicked(const QModelIndex &index)
+{
+    if (spreadsheet == NULL || comparisonModel == NULL)
+        return;
+
+    int col = comparisonModel->getResultColumn(index.row());
+    if (col < 0)
+        return;
+
+    col1 = col;
+    col2 = col;
+    mLeft = false;   // the CDF
+    tabWidget->setCurrentIndex(1);
+    this->updateChart();
+}
 
+QWidget *
+DakotaResultsSampling::createParallelCoordinatesWidget(void)
+{
     //
-    // add summary, detained info and spreadsheet with chart to the tabed widget
+    // every column but the run number on its own axis, the samples drawn as
+    // a density image; brushing ranges on the axes highlights the samples in
+    // all of them, and the brushes can be turned into the filter expression
     //
 
-    tabWidget->addTab(sa,tr("Summary"));
-    tabWidget->addTab(widget, tr("Data Values"));
-    tabWidget->adjustSize();
+    QWidget *widget = new QWidget();
+    QVBoxLayout *parallelLayout = new QVBoxLayout(widget);
 
-    emit sendStatusMessage(tr(""));
+    QHBoxLayout *selectionLayout = new QHBoxLayout();
+    QLabel *instructions = new QLabel(tr("Drag along an axis to select a range, click an axis to clear its range, double click to clear all"));
+    parallelLabel = new QLabel();
+    QPushButton *filterButton = new QPushButton(tr("Filter to Selection"));
+    filterButton->setToolTip(tr("Apply the selected ranges as the filter of the data values"));
+    selectionLayout->addWidget(instructions, 1);
+    selectionLayout->addWidget(parallelLabel);
+    selectionLayout->addWidget(filterButton);
 
-    return 0;
+    parallelView = new ParallelCoordinatesView();
+    parallelRows = -1;
+
+    parallelLayout->addLayout(selectionLayout);
+    parallelLayout->addWidget(parallelView, 1);
+
+    connect(parallelView,SIGNAL(selectionChanged(int)),this,SLOT(onParallelSelectionChanged(int)));
+    connect(filterButton,SIGNAL(clicked()),this,SLOT(onFilterToSelectionClicked()));
+
+    return widget;
 }
 
+void
+DakotaResultsSampling::updateParallelCoordinates(void)
+{
+    if (parallelView == NULL)
+        return;
+
+    int numRows = theData.getNumRows();
+    int numCol = theData.getNumColumns();
+    if (numRows == parallelRows || numCol < 2)
+        return;
+
+    QStringList names;
+    QVector<const double *> columns;
+    for (int col=1; col<numCol; col++) {
+        names << theHeadings.at(col);
+        columns.append(theData.getColumn(col));
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    parallelView->setData(names, columns, numRows);
+    QApplication::restoreOverrideCursor();
+
+    parallelRows = numRows;
+}
 
 void
-DakotaResultsSampling::onSaveSpreadsheetClicked()
+DakotaResultsSampling::onParallelSelectionChanged(int numSelected)
+{
+    if (parallelLabel != NULL)
+        parallelLabel->setText(QString::number(numSelected) + QString(" of ") +
+                               QString::number(parallelRows) + QString(" samples"));
+}
+
+void
+DakotaResultsSampling::onFilterToSelectionClicked(void)
 {
+    if (parallelView == NULL || filterLineEdit == NULL)
+        return;
 
-    int rowCount = spreadsheet->rowCount();
-    int columnCount = spreadsheet->columnCount();
+    // the brushes as "min <= name <= max" clauses of a filter expression
+    QStringList clauses;
+    for (int axis=0; axis<parallelView->getNumAxes(); axis++) {
+        double min, max;
+        if (parallelView->getBrush(axis, min, max))
+            clauses << QString::number(min, 'g', 10) + QString(" <= ") + parallelView->getAxisName(axis) +
+                       QString(" <= ") + QString::number(max, 'g', 10);
+    }
 
-    QString fileName = QFileDialog::getSaveFileName(this,
-                                                    tr("Save Data"), "",
-                                                    tr("All Files (*)"));
+    // no brushes clears the filter
+    filterLineEdit->setText(clauses.join(" and "));
+    this->onFilterApplied();
+}
 
-    QFile file(fileName);
-    if (file.open(QIODevice::ReadWrite))
-    {
-        QTextStream stream(&file);
-        for (int j=0; j<columnCount; j++)
-        {
-            stream <<theHeadings.at(j)<<",\t";
-        }
-        stream <<endl;
-        for (int i=0; i<rowCount; i++)
-        {
-            for (int j=0; j<columnCount; j++)
-            {
-                QTableWidgetItem *item_value = spreadsheet->item(i,j);
-                double value = item_value->text().toDouble();
-                stream << value << ",\t";
+void
+DakotaResultsSampling::updateFragilityColumns(void)
+{
+    if (fragilityIntensity == NULL || fragilityIntensity->count() == theHeadings.size()-1)
+        return;
+
+    // col 0 is the run #; by default the intensity is the first random
+    // variable and the response the last column
+    QStringList columns = theHeadings.mid(1);
+    fragilityIntensity->clear();
+    fragilityIntensity->addItems(columns);
+    fragilityResponse->clear();
+    fragilityResponse->addItems(columns);
+    fragilityResponse->setCurrentIndex(columns.size()-1);
+}
+
+void
+DakotaResultsSampling::onFragilityFitClicked(void)
+{
+    if (fragilityIntensity == NULL || fragilityWatcher.isRunning())
+        return;
+
+    QVector<double> thresholds;
+    if (!FragilityFitter::parseThresholds(fragilityThresholds->text(), thresholds)) {
+        fragilityResults->setText(tr("Enter the response thresholds of the damage states, separated by commas"));
+        return;
+    }
+
+    int intensityCol = fragilityIntensity->currentIndex()+1;
+    int responseCol = fragilityResponse->currentIndex()+1;
+    if (intensityCol < 1 || responseCol < 1 || intensityCol >= theData.getNumColumns() || responseCol >= theData.getNumColumns())
+        return;
+
+    // the worker gets its own copy of the pairs, of the rows the filter selects
+    const std::vector<int> *rows = theFilter.isActive() ? &theFilter.getRows() : NULL;
+    theFragilities.setSamples(theData.getColumn(intensityCol), theData.getColumn(responseCol), theData.getNumRows(), rows);
+    theFragilities.setThresholds(thresholds);
+    fragilityIntensityName = theHeadings.at(intensityCol);
+
+    fragilityResults->setText(tr("Fitting ..."));
+    fragilityWatcher.setFuture(QtConcurrent::run(&theFragilities, &FragilityFitter::fit));
+}
+
+void
+DakotaResultsSampling::onFragilityFitFinished(void)
+{
+    if (fragilityChart == NULL)
+        return;
+
+    if (fragilityWatcher.result() == false) {
+        fragilityResults->setText(tr("Too few samples with a positive intensity to fit"));
+        return;
+    }
+
+    //
+    // each curve with the fractions observed in its color
+    //
+
+    fragilityChart->clearPlot();
+    double maxIntensity = theFragilities.getMaxIntensity();
+    fragilityChart->setAxes(fragilityIntensityName, 0, maxIntensity*1.05,
+                            "Probability of Reaching Damage State", 0, 1);
+
+    const std::vector<double> &intensities = theFragilities.getObservedIntensities();
+    QString results;
+    for (int i=0; i<theFragilities.getNumCurves(); i++) {
+        const FragilityCurve &theCurve = theFragilities.getCurve(i);
+        QString name = QString("DS") + QString::number(i+1);
+        if (i != 0)
+            results += QString("\n");
+
+        QColor color;
+        if (theCurve.ok) {
+            QVector<QPointF> points;
+            points.reserve(NUM_FRAGILITY_POINTS+1);
+            for (int j=0; j<=NUM_FRAGILITY_POINTS; j++) {
+                double x = maxIntensity*j/NUM_FRAGILITY_POINTS;
+                points.append(QPointF(x, theCurve.probability(x)));
             }
-            stream<<endl;
-        }
+            QCPGraph *curve = fragilityChart->addLine(SamplePlot::makeData(points, true),
+                                                      name + QString(": median ") + QString::number(theCurve.median, 'g', 4) +
+                                                      QString(", beta ") + QString::number(theCurve.beta, 'g', 3));
+            color = curve->pen().color();
+            results += name + QString(" (") + QString::number(theCurve.threshold) + QString("): median ") +
+                    QString::number(theCurve.median, 'g', 4) + QString(", beta ") + QString::number(theCurve.beta, 'g', 3);
+        } else
+            results += name + QString(" (") + QString::number(theCurve.threshold) + QString("): ") + theCurve.errorMessage;
+        results += QString(", ") + QString::number(theCurve.numExceeding) + QString(" of ") +
+                QString::number(theFragilities.getNumSamples()) + QString(" samples reach it");
+
+        fragilityChart->addMarkers(SamplePlot::makeData(intensities.data(), theCurve.observedFractions.data(),
+                                                        static_cast<int>(intensities.size())),
+                                   name + QString(" observed"), color);
     }
+
+    // the curves rise to the right, the top left is clear
+    fragilityChart->legend->setVisible(true);
+    fragilityChart->axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignLeft);
+    fragilityChart->replot(QCustomPlot::rpQueuedReplot);
+
+    fragilityResults->setText(results);
 }
 
-void DakotaResultsSampling::onSpreadsheetCellClicked(int row, int col)
+//
+// follow the tab file of an analysis that is still running, the summary is
+// updated from running moments as rows arrive, the chart at a slower rate
+//
+
+int
+DakotaResultsSampling::followResults(QString &filenameTab)
 {
-    mLeft = spreadsheet->wasLeftKeyPressed();
+    this->clear();
+    mLeft = true;
+    col1 = 0;
+    col2 = 0;
 
-    chart->removeAllSeries();
+    theFollower->start(filenameTab);
+    emit sendStatusMessage(tr("Following Sampling Results"));
 
-    QAbstractAxis *oldAxisX=chart->axisX();
-    if (oldAxisX != 0)
-        chart->removeAxis(oldAxisX);
-    QAbstractAxis *oldAxisY=chart->axisY();
-    if (oldAxisY != 0)
-        chart->removeAxis(oldAxisY);
+    return 0;
+}
 
-    // QScatterSeries *series;//= new QScatterSeries;
+void
+DakotaResultsSampling::stopFollowingResults(void)
+{
+    // the rows read so far stay, they can now be filtered and saved
+    if (theFollower->isFollowing()) {
+        theFollower->readNewData();
+        theFollower->stop();
+        emit sendStatusMessage(tr("Analysis failed, showing the samples it wrote"));
+    }
+}
 
-    int oldCol;
-    if (mLeft == true) {
-        oldCol= col2;   //
-        //oldCol=0;   // padhye trying. I don't think it makes sense to use coldCol as col2, i.e., something that was
-        // previously selected?
-        col2 = col; // col is the one that comes in te function, based on the click made after clicking
+void
+DakotaResultsSampling::onFollowedHeadingsRead()
+{
+    // file restarted, start over
+    if (tabWidget->count() != 0) {
+        while (tabWidget->count() != 0) {
+            QWidget *theWidget = tabWidget->widget(0);
+            tabWidget->removeTab(0);
+            delete theWidget;
+        }
+        theNames.clear();
+        theStatistics.clear();
+        theMeanLineEdits.clear();
+        theStdDevLineEdits.clear();
+        theSkewnessLineEdits.clear();
+        theKurtosisLineEdits.clear();
+        theMinLineEdits.clear();
+        theMaxLineEdits.clear();
+        for (int i=0; i<NUM_PERCENTILES; i++)
+            thePercentileLineEdits[i].clear();
+        for (int i=0; i<NUM_BOOTSTRAP_STATISTICS; i++)
+            theIntervalLabels[i].clear();
+    }
 
-    } else {
-        oldCol= col1;
-        col1 = col;
+    theHeadings = theData.getHeadings();
+    int colCount = theData.getNumColumns();
+    int firstEDP = theRVs->getNumRandomVariables()+1;
+
+    QScrollArea *sa = new QScrollArea;
+    sa->setWidgetResizable(true);
+    sa->setLineWidth(0);
+    sa->setFrameShape(QFrame::NoFrame);
+
+    QWidget *summary = new QWidget();
+    QVBoxLayout *summaryLayout = new QVBoxLayout();
+    summaryLayout->setContentsMargins(0,0,0,0);
+    summary->setLayout(summaryLayout);
+    sa->setWidget(summary);
+
+    theFollowedMoments.clear();
+    for (int col = firstEDP; col<colCount; ++col) {
+        QString variableName = theHeadings.at(col);
+        QWidget *theWidget = this->createResultEDPWidget(variableName, ColumnStatistics());
+        summaryLayout->addWidget(theWidget);
+        theFollowedMoments.append(OnlineMoments());
     }
+    summaryLayout->addStretch();
 
-    int rowCount = spreadsheet->rowCount();
+    QWidget *widget = this->createDataValuesWidget();
+    col2 = colCount-1;
 
-    if (col1 != col2) {
-        QScatterSeries *series = new QScatterSeries;
-
-        for (int i=0; i<rowCount; i++) {
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);    //col1 goes in x-axis, col2 on y-axis
-            //col1=0;
-            QTableWidgetItem *itemY = spreadsheet->item(i,col2);
-            QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-            itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-            itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-            itemY->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-
-            series->append(itemX->text().toDouble(), itemY->text().toDouble());
+    tabWidget->addTab(sa,tr("Summary"));
+    tabWidget->addTab(widget, tr("Data Values"));
+    tabWidget->addTab(this->createCorrelationsWidget(), tr("Correlations"));
+    tabWidget->addTab(this->createFragilityWidget(), tr("Fragility"));
+    tabWidget->addTab(this->createComparisonWidget(), tr("Compare"));
+    tabWidget->addTab(this->createParallelCoordinatesWidget(), tr("Parallel Coordinates"));
+    tabWidget->adjustSize();
+
+    lastChartUpdate.invalidate();
+}
+
+void
+DakotaResultsSampling::onFollowedRowsAppended(int firstRow, int lastRow)
+{
+    if (dataModel == NULL)
+        return;
+
+    dataModel->appendRows();
+
+    int firstEDP = theRVs->getNumRandomVariables()+1;
+    int numRows = lastRow-firstRow+1;
+    for (int i=0; i<theFollowedMoments.size(); i++) {
+        OnlineMoments &moments = theFollowedMoments[i];
+        ColumnStatistics stats = theStatistics.at(i);
+
+        // moments of the new rows merged into those of the rows before
+        OnlineMoments newMoments;
+        double min, max;
+        SampleStatistics::computeMoments(theData.getColumn(firstEDP+i)+firstRow, numRows, newMoments, min, max);
+        if (moments.getCount() == 0) {
+            stats.min = min;
+            stats.max = max;
+        } else {
+            stats.min = qMin(stats.min, min);
+            stats.max = qMax(stats.max, max);
         }
-        chart->addSeries(series);
-        series->setName("Samples");
+        moments.merge(newMoments);
 
-        QValueAxis *axisX = new QValueAxis();
-        QValueAxis *axisY = new QValueAxis();
+        // the percentiles from the sketches the parser updated
+        if (firstEDP+i < theSketches.size())
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                stats.percentiles[j] = theSketches.at(firstEDP+i).quantile(SampleStatistics::percentileLevels[j]);
 
-        axisX->setTitleText(theHeadings.at(col1));
-        axisY->setTitleText(theHeadings.at(col2));
+        stats.setMoments(moments);
+        this->updateResultEDPWidget(i, stats);
+    }
 
-        // padhye adding ranges 8/25/2018
-        // finding the range for X and Y axis
-        // now the axes will look a bit clean.
+    // charts are redrawn at most every few seconds
+    if (!lastChartUpdate.isValid() || lastChartUpdate.elapsed() > 5000) {
+        fittingColumn = -1;   // a fit still running is of fewer rows
+        fittedColumn = -1;
+        this->updateChart();
+        lastChartUpdate.start();
+    } else if (col1 != col2) {
+        // appending may have moved the columns the scatter plot points into
+        chart->moveScatterData(theData.getColumn(col1), theData.getColumn(col2), theData.getNumRows());
+    }
 
-        double minX, maxX;
-        double minY, maxY;
+    emit sendStatusMessage(QString("Following Sampling Results: ") + QString::number(lastRow+1) + QString(" samples"));
+}
 
-        for (int i=0; i<rowCount; i++) {
+void
+DakotaResultsSampling::onLoadTabFilesClicked(void)
+{
+    if (theFollower->isFollowing()) {
+        QMessageBox::information(this, tr("Load Tab Files"), tr("Tab files can be loaded once the analysis has finished"));
+        return;
+    }
 
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-            QTableWidgetItem *itemY = spreadsheet->item(i,col2);
+    QStringList filenames = QFileDialog::getOpenFileNames(this, tr("Load Tab Files"), QString(),
+                                                          tr("Dakota tab files (dakotaTab.out *.out);;All files (*)"));
+    if (filenames.isEmpty())
+        return;
 
-            double value1 = itemX->text().toDouble();
+    // loading clears the tabs, which would delete this button while its
+    // clicked() is still being handled, so load once control is back in the event loop
+    selectedTabFiles = filenames;
+    QTimer::singleShot(0, this, SLOT(loadSelectedTabFiles()));
+}
 
-            double value2 = itemY->text().toDouble();
+void
+DakotaResultsSampling::loadSelectedTabFiles(void)
+{
+    QStringList filenames = selectedTabFiles;
+    selectedTabFiles.clear();
+    if (filenames.isEmpty())
+        return;
 
+    emit sendStatusMessage(tr("Loading ") + QString::number(filenames.size()) + tr(" tab files"));
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    this->processTabFiles(filenames);
+    QApplication::restoreOverrideCursor();
+}
 
-            if (i == 0) {
-                minX=value1;
-                maxX=value1;
-                minY=value2;
-                maxY=value2;
-            }
-            if(value1<minX){minX=value1;}
-            if(value1>maxX){maxX=value1;}
+void
+DakotaResultsSampling::onFilterApplied(void)
+{
+    if (filterLineEdit == NULL)
+        return;
 
-            if(value2<minY){minY=value2;}
-            if(value2>maxY){maxY=value2;}
+    // rows are still being appended to the store
+    if (theFollower->isFollowing()) {
+        QMessageBox::information(this, tr("Filter"), tr("The samples can be filtered once the analysis has finished"));
+        return;
+    }
 
-        }
+    QString errorMessage;
+    if (!theFilter.setExpression(filterLineEdit->text(), errorMessage)) {
+        emit sendErrorMessage(QString("Filter: ") + errorMessage);
+        return;
+    }
 
-        double xRange=maxX-minX;
-        double yRange=maxY-minY;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
 
-        // if the column is not the run number, i.e., 0 column, then adjust the x-axis differently
+    const std::vector<int> *rows = NULL;
+    int numSelected = theFilter.apply();
+    if (theFilter.isActive())
+        rows = &theFilter.getRows();
+
+    // the cache, estimator and spreadsheet only look at the selected rows
+    theColumnCache.setRows(rows);
+    theDensities.clear();
+    fittingColumn = -1;     // a fit still running is of the rows before
+    fittedColumn = -1;
+    dataModel->setRows(rows);
+
+    if (rows != NULL)
+        filterCount->setText(QString::number(numSelected) + QString(" of ") +
+                             QString::number(theData.getNumRows()) + QString(" samples"));
+    else
+        filterCount->setText(QString());
 
-        if(col1!=0)
-        {
-            axisX->setRange(minX - 0.01*xRange, maxX + 0.1*xRange);
-        }
-        else{
+    this->updateFilteredStatistics();
+    this->updateChart();
 
-            axisX->setRange(int (minX - 1), int (maxX +1));
-            // axisX->setTickCount(1);
+    QApplication::restoreOverrideCursor();
+}
 
-        }
-        // adjust y with some fine precision
-        axisY->setRange(minY - 0.1*yRange, maxY + 0.1*yRange);
-        chart->setAxisX(axisX, series);
-        chart->setAxisY(axisY, series);
+void
+DakotaResultsSampling::onFilterCleared(void)
+{
+    if (filterLineEdit == NULL || !theFilter.isActive())
+        return;
 
-    } else {
+    filterLineEdit->clear();
+    this->onFilterApplied();
+}
 
-        QLineSeries *series= new QLineSeries;
-
-        double NUM_DIVISIONS_FOR_DIVISION = ceil(sqrt(rowCount));
-        if (NUM_DIVISIONS_FOR_DIVISION < 10)
-            NUM_DIVISIONS_FOR_DIVISION = 10;
-        else if (NUM_DIVISIONS_FOR_DIVISION > 20)
-            NUM_DIVISIONS_FOR_DIVISION = 20;
-
-        int NUM_DIVISIONS = NUM_DIVISIONS_FOR_DIVISION;
-
-        double *dataValues = new double[rowCount];
-        double histogram[20];
-        for (int i=0; i<NUM_DIVISIONS; i++)
-            histogram[i] = 0;
-
-        double min = 0;
-        double max = 0;
-        for (int i=0; i<rowCount; i++) {
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-            QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-            itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-            itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-            double value = itemX->text().toDouble();
-            dataValues[i] =  value;
-
-            if (i == 0) {
-                min = value;
-                max = value;
-            } else if (value < min) {
-                min = value;
-            } else if (value > max) {
-                max = value;
-            }
+void
+DakotaResultsSampling::onBinRuleChanged(int index)
+{
+    if (binRule == NULL || index < 0)
+        return;
+
+    theDensities.setBinRule(static_cast<DensityEstimator::BinRule>(binRule->itemData(index).toInt()));
+    this->updateChart();
+}
+
+void
+DakotaResultsSampling::onWeightColumnChanged(int index)
+{
+    if (weightColumn == NULL || index < 0)
+        return;
+
+    // the weights are taken once, rows appended later would have none
+    QString errorMessage;
+    std::vector<double> weights;
+    if (index != 0 && theFollower->isFollowing()) {
+        QMessageBox::information(this, tr("Weights"), tr("The samples can be weighted once the analysis has finished"));
+    } else if (index != 0) {
+        int numRows = theData.getNumRows();
+        const double *values = theData.getColumn(index);
+        double sum = 0;
+        for (int i=0; i<numRows && errorMessage.isEmpty(); i++) {
+            if (!(values[i] >= 0) || qIsInf(values[i]))
+                errorMessage = QString(" has a negative or missing value in run ") + QString::number(i+1);
+            sum += values[i];
         }
+        if (errorMessage.isEmpty() && !(sum > 0))
+            errorMessage = QString(" is all zero");
+        if (errorMessage.isEmpty())
+            weights.assign(values, values+numRows);
+        else
+            emit sendErrorMessage(QString("Weights: ") + weightColumn->itemText(index) + errorMessage);
+    }
 
-        if (mLeft == true) {
+    // back to none if the column could not be used
+    if (index != 0 && weights.empty()) {
+        weightColumn->blockSignals(true);
+        weightColumn->setCurrentIndex(0);
+        weightColumn->blockSignals(false);
+    }
 
-            // frequency distribution
-            double range = max-min;
-            double dRange = range/NUM_DIVISIONS_FOR_DIVISION;
+    theDensities.setWeights(weights);
+    this->updateChart();
+}
 
-            for (int i=0; i<rowCount; i++) {
-                // compute block belongs to, watch under and overflow due to numerics
-                int block = floor((dataValues[i]-min)/dRange);
-                if (block < 0) block = 0;
-                if (block > NUM_DIVISIONS-1) block = NUM_DIVISIONS-1;
-                histogram[block] += 1;
-            }
+void
+DakotaResultsSampling::updateFilteredStatistics(void)
+{
+    int firstEDP = theRVs->getNumRandomVariables()+1;
+    int lastEDP = firstEDP + theStatistics.size() - 1;
 
-            double maxPercent = 0;
-            for (int i=0; i<NUM_DIVISIONS; i++) {
-                histogram[i] = histogram[i]/rowCount;
-                if (histogram[i] > maxPercent)
-                    maxPercent = histogram[i];
-            }
-            for (int i=0; i<NUM_DIVISIONS; i++) {
-                series->append(min+i*dRange, 0);
-                series->append(min+i*dRange, histogram[i]);
-                series->append(min+(i+1)*dRange, histogram[i]);
-                series->append(min+(i+1)*dRange, 0);
-            }
+    // the cache holds the rows the filter selects
+    QVector<ColumnStatistics> edpStatistics = SampleStatistics::computeColumns(theData, firstEDP, lastEDP, theColumnCache);
+    for (int i=0; i<edpStatistics.size(); i++)
+        this->updateResultEDPWidget(i, edpStatistics.at(i));
 
-            chart->addSeries(series);
-            series->setName("Histogram");
+    comparisonRows = -1;
+    this->startBootstrap();
+}
 
-            QValueAxis *axisX = new QValueAxis();
-            QValueAxis *axisY = new QValueAxis();
+void
+DakotaResultsSampling::startBootstrap(void)
+{
+    this->stopBootstrap();
 
-            axisX->setRange(min-(max-min)*.1, max+(max-min)*.1);
-            axisY->setRange(0, 1.1*maxPercent);
-            axisY->setTitleText("Frequency %");
-            axisX->setTitleText(theHeadings.at(col1));
-            axisX->setTickCount(NUM_DIVISIONS+1);
-            chart->setAxisX(axisX, series);
-            chart->setAxisY(axisY, series);
+    int numEDP = theIntervalLabels[0].size();
+    for (int k=0; k<NUM_BOOTSTRAP_STATISTICS; k++) {
+        for (int i=0; i<numEDP; i++) {
+            theIntervalLabels[k].at(i)->clear();
+            theIntervalLabels[k].at(i)->setToolTip(QString());
+        }
+    }
 
-	    /* ************************************* REMVING BUGGY BEST FIT
-            //calling external python script to find the best fit, generating the data and then plotting it.
-            // this will be done in the application directory
+    int firstEDP = theRVs->getNumRandomVariables()+1;
+    if (numEDP == 0 || theData.getNumColumns() < firstEDP+numEDP)
+        return;
 
-            QString appDIR = qApp->applicationDirPath(); // this is where the .exe is and also the parseJson.py, and now the fit_distribution.py
+    // the columns are copied here, the store is free to change while the worker runs
+    const std::vector<int> *rows = theFilter.isActive() ? &theFilter.getRows() : NULL;
+    theBootstrap.setColumns(theData, firstEDP, firstEDP+numEDP-1, rows);
+    bootstrapWatcher.setFuture(QtConcurrent::run(&theBootstrap, &BootstrapEstimator::estimate));
+}
 
-            QString data_input_file = appDIR +  QDir::separator() + QString("data_input.txt");
-            QString pySCRIPT_dist_fit =  appDIR +  QDir::separator() + QString("fit.py");
+void
+DakotaResultsSampling::stopBootstrap(void)
+{
+    if (bootstrapWatcher.isRunning()) {
+        theBootstrap.cancel();
+        bootstrapWatcher.waitForFinished();
+    }
+}
 
-            QFile file(data_input_file);
-            QTextStream stream(&file);
+static QString
+intervalText(double lower, double upper)
+{
+    if (qIsNaN(lower) || qIsNaN(upper))
+        return QString();
+    return QString("[") + QString::number(lower, 'g', 4) + QString(", ") + QString::number(upper, 'g', 4) + QString("]");
+}
 
-            if (file.open(QIODevice::ReadWrite))
-            {
-                for(int i=0;i<rowCount;++i)
-                {
+void
+DakotaResultsSampling::onBootstrapFinished(void)
+{
+    if (bootstrapWatcher.isCanceled() || !bootstrapWatcher.result())
+        return;
 
-                    stream<<dataValues[i];
-                    stream<< endl;
-                }
-            }else {qDebug()<<"\n error in opening file data file for histogram fit  ";exit(1);}
+    // the summary was rebuilt while the worker ran
+    int numEDP = theIntervalLabels[0].size();
+    if (numEDP != theBootstrap.getNumColumns())
+        return;
 
+    QString level = QString::number(theBootstrap.getConfidenceLevel()*100) + QString("%");
+    QString replicates = QString::number(theBootstrap.getNumReplicates());
+    for (int i=0; i<numEDP; i++) {
+        for (int k=0; k<NUM_BOOTSTRAP_STATISTICS; k++) {
+            const BootstrapInterval &interval = theBootstrap.getInterval(i, k);
+            QLabel *theLabel = theIntervalLabels[k].at(i);
+            theLabel->setText(intervalText(interval.bcaLower, interval.bcaUpper));
+            theLabel->setToolTip(level + QString(" bootstrap confidence interval from ") + replicates +
+                                 QString(" replicates\nBCa: ") + intervalText(interval.bcaLower, interval.bcaUpper) +
+                                 QString("\npercentile: ") + intervalText(interval.lower, interval.upper));
+        }
+    }
+}
 
-            delete [] dataValues;
+void
+DakotaResultsSampling::startFit(int col)
+{
+    // one fit at a time, they take well under a second
+    if (fitWatcher.isRunning()) {
+        if (fittingColumn == col)
+            return;
+        fitWatcher.waitForFinished();
+    }
 
-            QString file_fitted_path = appDIR +  QDir::separator() + QString("Best_fit.out");
+    // the worker gets its own copy of the column, the rows the filter selects
+    const std::vector<double> &sorted = theColumnCache.getSortedColumn(col);
+    theFitter.setValues(sorted.data(), static_cast<int>(sorted.size()));
+    fittingColumn = col;
+    fittedColumn = -1;
+    fitWatcher.setFuture(QtConcurrent::run(&theFitter, &DistributionFitter::fit));
+}
 
-            QFile file_fitted_distribution(file_fitted_path);
-            if(!file_fitted_distribution.open(QIODevice::WriteOnly)) {
-                QMessageBox::information(0,"error",file.errorString());
-            }else
-            {
+void
+DakotaResultsSampling::onFitFinished(void)
+{
+    fittedColumn = fittingColumn;
 
-            }
-            // make sure to check if Q_OS_WIN or Mac etc. else there will be a bug
-            //QProcess process;
-            QProcess *process = new QProcess();
-            process->setWorkingDirectory(appDIR);
+    // redraw if the histogram of the column is still shown
+    if (chart != NULL && col1 == col2 && mLeft == true && col1 == fittedColumn)
+        this->updateChart();
+}
 
-            //pySCRIPT_dist_fit = QString("source $HOME/.bash_profile; source $HOME/.bashrc; python ") + pySCRIPT_dist_fit + QString(" ") + data_input_file;
+void
+DakotaResultsSampling::onSaveSpreadsheetClicked()
+{
+    // rows are still being appended to the store
+    if (theFollower->isFollowing()) {
+        QMessageBox::information(this, tr("Save Data"), tr("The data can be saved once the analysis has finished"));
+        return;
+    }
 
-#ifdef Q_OS_WIN
+    SampleDataExporter::exportData(theData, this);
+}
 
-            QStringList args{pySCRIPT_dist_fit, data_input_file};
-            process->execute("python", args);
 
-            //pySCRIPT_dist_fit = QString("python ") + pySCRIPT_dist_fit + QString(" ") + data_input_file;
-            //process->execute("cmd", QStringList() << "/C" << pySCRIPT_dist_fit);
-#else
-            pySCRIPT_dist_fit = QString("source $HOME/.bash_profile; source $HOME/.bashrc; python ") + pySCRIPT_dist_fit + QString(" ") + data_input_file;
-            qDebug() << pySCRIPT_dist_fit;
-            process->execute("bash", QStringList() << "-c" <<  pySCRIPT_dist_fit);
-#endif
+void DakotaResultsSampling::onSpreadsheetCellClicked(int row, int col)
+{
+    Q_UNUSED(row);
+    mLeft = spreadsheet->wasLeftKeyPressed();
 
+    if (mLeft == true) {
+        col2 = col; // col is the one that comes in te function, based on the click made after clicking
+    } else {
+        col1 = col;
+    }
 
-            QFile file_fitted_data("Best_fit.out");
-            if(!file_fitted_data.exists())
-            {
-                qDebug()<<"\n The file does not exist and hence exiting";
-                exit(1);
+    this->updateChart();
+}
+
+void DakotaResultsSampling::updateChart(void)
+{
+    fitLabel->clear();
+    fitLabel->setToolTip(QString());
+    chart->clearPlot();
+
+    // rows passing the filter, all of them if there is none
+    int rowCount = theColumnCache.getNumRows();
+    if (rowCount == 0)
+        return;
+
+    if (col1 != col2) {
 
+        dataModel->setHighlightedColumns(col1, col2);
+
+        const double *valuesX = theData.getColumn(col1);    //col1 goes in x-axis, col2 on y-axis
+        const double *valuesY = theData.getColumn(col2);
+
+        // the plot reads the points in place, a filtered plot needs them gathered
+        if (theFilter.isActive()) {
+            const std::vector<int> &rows = theFilter.getRows();
+            filteredX.resize(rows.size());
+            filteredY.resize(rows.size());
+            for (size_t i=0; i<rows.size(); i++) {
+                filteredX[i] = valuesX[rows[i]];
+                filteredY[i] = valuesY[rows[i]];
             }
-            QLineSeries *series_best_fit = new QLineSeries();
-            series_best_fit->setName("Best Fit");
-            if(file_fitted_data.open(QIODevice::ReadOnly |QIODevice::Text ))
-            {
-
-                QTextStream txtStream(&file_fitted_data);
-                while(!txtStream.atEnd())
-                {
-                    QString line = txtStream.readLine();
-                    //  double first_value;
-                    //   txtStream>>first_value;
-
-                    QStringList list2 = line.split(',', QString::SkipEmptyParts);
-                    double value1= list2[0].toDouble();
-                    double value2= list2[1].toDouble();
-
-                    series_best_fit->append(value1,value2);
-
-                    //chart->setAxisX(axisX, series_best_fit);
-                    //chart->setAxisY(axisY, series_best_fit);
-                    //  chart->adjustSize();
-
-                    // qDebug()<<"\n the line read is      "<<line;
-                    // qDebug()<<"\n the value1 is         "<<value1;
-                    // qDebug()<<"\n the value2 is         "<<value2;
-                }
+            valuesX = filteredX.data();
+            valuesY = filteredY.data();
+        }
+
+        // padhye adding ranges 8/25/2018
+        // finding the range for X and Y axis
+        // now the axes will look a bit clean.
 
-                file_fitted_data.close();
+        // ranges from the ends of the cached sorted columns, which hold no
+        // NaN and are empty if every value is missing
+        const std::vector<double> &sortedX = theColumnCache.getSortedColumn(col1);
+        const std::vector<double> &sortedY = theColumnCache.getSortedColumn(col2);
+        double minX = sortedX.empty() ? 0 : sortedX.front();
+        double maxX = sortedX.empty() ? 0 : sortedX.back();
+        double minY = sortedY.empty() ? 0 : sortedY.front();
+        double maxY = sortedY.empty() ? 0 : sortedY.back();
 
-                chart->addSeries(series_best_fit);
-                chart->legend()->setVisible(true);
-                chart->legend()->setAlignment(Qt::AlignTop);
-                // chart->setTitle("The best fit plot is");
-                QString best_fit_info_file = appDIR +  QDir::separator() + QString("data_fit_info.out");
+        double xRange=maxX-minX;
+        double yRange=maxY-minY;
 
-                QFile info_fit_file("data_fit_info.out");
-                QTextStream stream(&info_fit_file);
+        // if the column is not the run number, i.e., 0 column, then adjust the x-axis differently
+        double startX = minX - 0.01*xRange;
+        double endX = maxX + 0.1*xRange;
+        if (col1 == 0) {
+            startX = int (minX - 1);
+            endX = int (maxX + 1);
+        }
 
-                //QStringList message_fitting_info;
+        // adjust y with some fine precision
+        chart->setAxes(theHeadings.at(col1), startX, endX,
+                       theHeadings.at(col2), minY - 0.1*yRange, maxY + 0.1*yRange);
 
-                QString line_from_file="";
-                if (info_fit_file.open(QIODevice::ReadWrite))
-                {
+        // the plot draws the points, or a density image if too many are in view
+        chart->setScatterData(valuesX, valuesY, rowCount);
 
-                    while(!info_fit_file.atEnd())
-                    {
-                        line_from_file=line_from_file+info_fit_file.readLine();//+"\n";
-                        //  qDebug()<<"\n the value of info_fit_file.readLine() is   "<<info_fit_file.readLine();
-                        //  qDebug()<<"\n The value of line_from_file is    "<<line_from_file;
-                        //   message_fitting_info<<info_fit_file.readLine();
-                        //   message_fitting_info<<"\n";
-                    }
-                    //line_from_file=line_from_file+info_fit_file.readLine()+"\n";
-                }
-                qDebug() << line_from_file;
+    } else {
 
-                // best_fit_label_text->setText(line_from_file);
-                // best_fit_label_text->setStyleSheet("QLabel { background-color : white; color : gray; }");
+        dataModel->setHighlightedColumns(col1, -1);
 
-                // QFont f2("Helvetica [Cronyx]", 10, QFont::Normal);
-                // best_fit_label_text->setFont(f2);
+        if (mLeft == true) {
 
-                //msgBox.show();
-                //  msgBox.exec();
+            // histogram and kernel density, cached per column by the estimator
+            const ColumnDensity &theDensity = theDensities.getDensity(col1);
+            const QVector<double> &histogram = theDensity.histogram;
+            int numBins = histogram.size();
+            double min = theDensity.min;
+            double max = theDensity.max;
+
+            double maxDensity = 0;
+            QVector<double> centres(numBins);
+            for (int i=0; i<numBins; i++) {
+                centres[i] = theDensity.binStart + (i+0.5)*theDensity.binWidth;
+                if (histogram[i] > maxDensity)
+                    maxDensity = histogram[i];
+            }
+            for (int i=0; i<theDensity.density.size(); i++)
+                if (theDensity.density.at(i).y() > maxDensity)
+                    maxDensity = theDensity.density.at(i).y();
 
-                //     best_fit_instructions->setText("I am fitting the best fit info. here");
-                //qDebug()<<"\n\n\n I am about to exit from here   \n\n\n";
-                // exit(1);
+            if (max == min) {
+                min = theDensity.binStart;
+                max = theDensity.binStart + theDensity.binWidth;
+            }
+            double start = min-(max-min)*.1;
+            double end = max+(max-min)*.1;
+            chart->setAxes(theHeadings.at(col1), start, end, "Probability Density", 0, 1.1*maxDensity);
+
+            chart->addBars(centres, histogram, theDensity.binWidth, "Histogram");
+            chart->addLine(SamplePlot::makeData(theDensity.density, true), "Kernel Density");
+
+            // the best of the distributions fitted to the column, fitted on a
+            // worker thread the first time the histogram is shown
+            if (fittedColumn != col1) {
+                this->startFit(col1);
+            } else if (theFitter.getNumFits() != 0 && theFitter.getFit(0).ok) {
+                const DistributionFit &best = theFitter.getFit(0);
+                QVector<QPointF> fitPoints;
+                fitPoints.reserve(NUM_FIT_POINTS);
+                for (int i=0; i<NUM_FIT_POINTS; i++) {
+                    double x = start + i*(end-start)/(NUM_FIT_POINTS-1);
+                    fitPoints.append(QPointF(x, qMin(best.pdf(x), 1.1*maxDensity)));
+                }
+                chart->addLine(SamplePlot::makeData(fitPoints, true),
+                               QString("Best Fit: ") + DistributionFitter::getName(best.type));
+
+                fitLabel->setText(QString("Best fit: ") + DistributionFitter::getName(best.type) + QString(" (") +
+                                  best.getParameterText() + QString("), KS distance ") + QString::number(best.ks, 'g', 3));
+                QString ranking("Fits ranked by AIC:");
+                for (int i=0; i<theFitter.getNumFits(); i++) {
+                    const DistributionFit &theFit = theFitter.getFit(i);
+                    if (!theFit.ok)
+                        continue;
+                    ranking += QString("\n") + QString::number(i+1) + QString(". ") + DistributionFitter::getName(theFit.type) +
+                            QString(": AIC ") + QString::number(theFit.aic, 'f', 1) + QString(", KS ") + QString::number(theFit.ks, 'g', 3) +
+                            QString(", ") + theFit.getParameterText();
+                }
+                fitLabel->setToolTip(ranking);
             }
-            //std::ifstream fitted_data_file("Best_fit.out");
-            //if(!fitted_data_file.exists)
-            // process.execute("python C:/Users/nikhil/NHERI/build-uqFEM-Desktop_Qt_5_11_0_MSVC2015_32bit-Release/debug\\fit.py");
-            // exit(1);
-            //qDebug()<<"\n   the value of pySCRIPT_dist_fit   is         "<<pySCRIPT_dist_fit;
-            //#ifdef Q_OS_WIN
-            //   QProcess process;
-            //String command = "notepad";
-            //process.execute("cmd", QStringList() << "/C" << command);
-            //process.start("cmd", QStringList(), QIODevice::ReadWrite);
-            //std::cerr << command << "\n";
-
-            //     process.waitForStarted();
-
-            //     qDebug()<<"process has been completed       ";
-            //         exit(1);
-
-	    ************************************ */
         } else {
-            // cumulative distribution
-            mergesort(dataValues, rowCount);
-            for (int i=0; i<rowCount; i++) {
-                series->append(dataValues[i], 1.0*i/rowCount);
-                //qDebug()<<"\n the dataValues[i] and rowCount is     "<<dataValues[i]<<"\t"<<rowCount<<"";
+            // cumulative distribution reduced to a few points per pixel from
+            // the sorted column, finer than the plot so it stands some zoom;
+            // while following read from the sketch rather than resorting the
+            // column every time rows arrive
+            QSharedPointer<QCPGraphDataContainer> cdf;
+            double min, max;
+            if (theFollower->isFollowing() && col1 < theSketches.size()) {
+                const QuantileSketch &sketch = theSketches.at(col1);
+                min = sketch.getMin();
+                max = sketch.getMax();
+                int numPoints = qMax(chart->axisRect()->width(), NUM_SKETCH_CDF_POINTS);
+                QVector<QPointF> points;
+                points.reserve(numPoints+1);
+                for (int i=0; i<=numPoints; i++) {
+                    double x = min + (max-min)*i/numPoints;
+                    points.append(QPointF(x, sketch.cdf(x)));
+                }
+                cdf = SamplePlot::makeData(points, true);
+            } else {
+                const std::vector<double> &sorted = theColumnCache.getSortedColumn(col1);
+                int numBins = CDF_BINS_PER_PIXEL*qMax(chart->axisRect()->width(), NUM_SKETCH_CDF_POINTS);
+                QVector<QPointF> points;
+                theColumnCache.getCDF(col1, numBins, points);
+                cdf = SamplePlot::makeData(points, true);
+                min = sorted.empty() ? 0 : sorted.front();
+                max = sorted.empty() ? 0 : sorted.back();
             }
-            delete [] dataValues;
-            chart->addSeries(series);
-            QValueAxis *axisX = new QValueAxis();
-            QValueAxis *axisY = new QValueAxis();
+
             // padhye, make these consistent changes all across.
-            axisX->setRange(min- (max-min)*0.1, max+(max-min)*0.1);
-            axisY->setRange(0, 1);
-            axisY->setTitleText("Cumulative Probability");
-            axisX->setTitleText(theHeadings.at(col1));
-            axisX->setTickCount(NUM_DIVISIONS+1);
-            chart->setAxisX(axisX, series);
-            chart->setAxisY(axisY, series);
-            series->setName("Cumulative Frequency Distribution");
+            chart->setAxes(theHeadings.at(col1), min- (max-min)*0.1, max+(max-min)*0.1,
+                           "Cumulative Probability", 0, 1);
+            chart->addLine(cdf, "Cumulative Frequency Distribution");
         }
     }
 }
@@ -831,7 +1467,7 @@ DakotaResultsSampling::outputToJSON(QJsonObject &jsonObject)
 {
     bool result = true;
 
-    if (spreadsheet == NULL)
+    if (spreadsheet == NULL && pendingSpreadsheet.isEmpty())
         return true;
 
     jsonObject["resultType"]=QString(tr("DakotaResultsSampling"));
@@ -842,13 +1478,37 @@ DakotaResultsSampling::outputToJSON(QJsonObject &jsonObject)
 
     QJsonArray resultsData;
     int numEDP = theNames.count();
+
+    // the summary saved is that of all the samples, not of those the filter shows;
+    // the cached sorted columns are of the filtered rows, so percentiles are from the sketches
+    int firstEDP = theRVs->getNumRandomVariables()+1;
+    QVector<ColumnStatistics> edpStatistics = theStatistics;
+    if (theFilter.isActive()) {
+        edpStatistics = SampleStatistics::computeColumns(theData, firstEDP, firstEDP+numEDP-1, theSketches);
+    }
+
     for (int i=0; i<numEDP; i++) {
         QJsonObject edpData;
         edpData["name"]=theNames.at(i);
-        edpData["mean"]=theMeans.at(i);
-        edpData["stdDev"]=theStdDevs.at(i);
-        edpData["kurtosis"]=theKurtosis.at(i);
-        edpData["skewness"]=theSkewness.at(i);
+        const ColumnStatistics &stats = edpStatistics.at(i);
+        edpData["mean"]=stats.mean;
+        edpData["stdDev"]=stats.stdDev;
+        edpData["kurtosis"]=stats.kurtosis;
+        edpData["skewness"]=stats.skewness;
+        edpData["min"]=stats.min;
+        edpData["max"]=stats.max;
+        if (!qIsNaN(stats.percentiles[0])) {
+            QJsonArray percentileData;
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                percentileData.append(stats.percentiles[j]);
+            edpData["percentiles"]=percentileData;
+        }
+        // also of all the samples, so the results of separate runs can be combined
+        if (firstEDP+i < theSketches.size()) {
+            QJsonObject sketchData;
+            theSketches.at(firstEDP+i).writeJSON(sketchData);
+            edpData["quantileSketch"]=sketchData;
+        }
         resultsData.append(edpData);
     }
 
@@ -860,32 +1520,18 @@ DakotaResultsSampling::outputToJSON(QJsonObject &jsonObject)
 
 
 
-    QJsonObject spreadsheetData;
-
-    int numCol = spreadsheet->columnCount();
-    int numRow = spreadsheet->rowCount();
-
-    spreadsheetData["numRow"]=numRow;
-    spreadsheetData["numCol"]=numCol;
-
-    QJsonArray headingsArray;
-    for (int i = 0; i <theHeadings.size(); ++i) {
-        headingsArray.append(QJsonValue(theHeadings.at(i)));
+    // values never shown since being read, or that could not be decoded,
+    // are written back as they were read
+    if (!pendingSpreadsheet.isEmpty()) {
+        jsonObject["spreadsheet"] = pendingSpreadsheet;
+        return result;
     }
 
-    spreadsheetData["headings"]=headingsArray;
+    QJsonObject spreadsheetData;
 
-    QJsonArray dataArray;
     QApplication::setOverrideCursor(Qt::WaitCursor);
-    for (int row = 0; row < numRow; ++row) {
-        for (int column = 0; column < numCol; ++column) {
-            QTableWidgetItem *theItem = spreadsheet->item(row,column);
-            QString textData = theItem->text();
-            dataArray.append(textData.toDouble());
-        }
-    }
+    theData.writeJSON(spreadsheetData);
     QApplication::restoreOverrideCursor();
-    spreadsheetData["data"]=dataArray;
 
     jsonObject["spreadsheet"] = spreadsheetData;
     return result;
@@ -932,104 +1578,155 @@ DakotaResultsSampling::inputFromJSON(QJsonObject &jsonObject)
     QJsonArray edpArray = theObject["summary"].toArray();
     foreach (const QJsonValue &edpValue, edpArray) {
         QString name;
-        double mean, stdDev;
+        ColumnStatistics stats;
         QJsonObject edpObject = edpValue.toObject();
         QJsonValue theNameValue = edpObject["name"];
         name = theNameValue.toString();
 
-        QJsonValue theMeanValue = edpObject["mean"];
-        mean = theMeanValue.toDouble();
-
-        QJsonValue theStdDevValue = edpObject["stdDev"];
-        stdDev = theStdDevValue.toDouble();
-
-        QJsonValue theKurtosis = edpObject["kurtosis"];
-        double kurtosis = theKurtosis.toDouble();
-
-        QJsonValue theSkewness = edpObject["skewness"];
-        double skewness = theSkewness.toDouble();
+        stats.mean = edpObject["mean"].toDouble();
+        stats.stdDev = edpObject["stdDev"].toDouble();
+        stats.kurtosis = edpObject["kurtosis"].toDouble();
+        stats.skewness = edpObject["skewness"].toDouble();
+
+        // range and percentiles only in files written since they were added
+        stats.min = edpObject["min"].toDouble(NAN);
+        stats.max = edpObject["max"].toDouble(NAN);
+        QJsonArray percentileData = edpObject["percentiles"].toArray();
+        if (percentileData.size() == NUM_PERCENTILES)
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                stats.percentiles[j] = percentileData.at(j).toDouble(NAN);
+        else if (edpObject.contains("quantileSketch")) {
+            // percentiles not saved, read them from the sketch
+            QuantileSketch sketch;
+            if (sketch.readJSON(edpObject["quantileSketch"].toObject()) && sketch.getCount() != 0)
+                for (int j=0; j<NUM_PERCENTILES; j++)
+                    stats.percentiles[j] = sketch.quantile(SampleStatistics::percentileLevels[j]);
+        }
 
-        QWidget *theWidget = this->createResultEDPWidget(name, mean, stdDev, skewness, kurtosis);
+        QWidget *theWidget = this->createResultEDPWidget(name, stats);
         summaryLayout->addWidget(theWidget);
     }
     summaryLayout->addStretch();
 
 
     //
-    // into a spreadsheet place all the data returned
+    // the data values are only decoded, and the spreadsheet and chart built,
+    // once the tab is shown; until then it holds an empty placeholder
     //
 
-    spreadsheet = new MyTableWidget();
-    QJsonObject spreadsheetData = spreadsheetValue.toObject();
+    pendingSpreadsheet = spreadsheetValue.toObject();
+    QWidget *widget = new QWidget();
 
-    int numRow = spreadsheetData["numRow"].toInt();
-    int numCol = spreadsheetData["numCol"].toInt();
-    spreadsheet->setColumnCount(numCol);
-    spreadsheet->setRowCount(numRow);
+    tabWidget->addTab(summary,tr("Summmary"));
+    tabWidget->addTab(widget, tr("Data Values"));
+    tabWidget->addTab(this->createCorrelationsWidget(), tr("Correlations"));
+    tabWidget->addTab(this->createFragilityWidget(), tr("Fragility"));
+    tabWidget->addTab(this->createComparisonWidget(), tr("Compare"));
+    tabWidget->addTab(this->createParallelCoordinatesWidget(), tr("Parallel Coordinates"));
 
-    QJsonArray headingData= spreadsheetData["headings"].toArray();
-    for (int i=0; i<numCol; i++) {
-        theHeadings << headingData.at(i).toString();
+    tabWidget->adjustSize();
+
+    return result;
+}
+
+
+void
+DakotaResultsSampling::onTabChanged(int index)
+{
+    // the other tabs need the data values too
+    if (!pendingSpreadsheet.isEmpty() && !pendingUnreadable && index >= 1 && index <= 5) {
+        this->loadPendingSpreadsheet();
+        if (index != 1)
+            tabWidget->setCurrentIndex(index);
+        return;
     }
 
-    spreadsheet->setHorizontalHeaderLabels(theHeadings);
+    if (index == 2)
+        this->updateCorrelations();
+    else if (index == 3)
+        this->updateFragilityColumns();
+    else if (index == 4)
+        this->updateComparison();
+    else if (index == 5)
+        this->updateParallelCoordinates();
+}
 
-    QJsonArray dataData= spreadsheetData["data"].toArray();
-    int dataCount =0;
-    for (int row =0; row<numRow; row++) {
-        for (int col=0; col<numCol; col++) {
-            QModelIndex index = spreadsheet->model()->index(row, col);
-            spreadsheet->model()->setData(index, dataData.at(dataCount).toDouble());
-            dataCount++;
-        }
+void
+DakotaResultsSampling::loadPendingSpreadsheet(void)
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = theData.readJSON(pendingSpreadsheet);
+    QApplication::restoreOverrideCursor();
+
+    // keep the values as read, so saving the results does not drop them,
+    // and do not try them again each time a tab is shown
+    if (!ok) {
+        theData.clear();
+        pendingUnreadable = true;
+        emit sendErrorMessage("Could not read the data values of the results");
+        return;
     }
-    spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
+    pendingSpreadsheet = QJsonObject();
+
+    theHeadings = theData.getHeadings();
+    int numCol = theData.getNumColumns();
+    QuantileSketch::sketchColumns(theData, theSketches);
 
     //
-    // create a chart, setting data points from first and last col of spreadsheet
+    // create a widget with the spreadsheet and chart, setting data points from first and last col of spreadsheet
     //
 
-    chart = new QChart();
-    chart->setAnimationOptions(QChart::AllAnimations);
-    QScatterSeries *series = new QScatterSeries;
+    theColumnCache.sortColumns();
+    QWidget *widget = this->createDataValuesWidget();
+    this->startBootstrap();
+
     col1 = 0;           // col1 is initialied as the first column in spread sheet
     col2 = numCol-1;    // col2 is initialized as the second column in spread sheet
     mLeft = true;       // left click
 
-    this->onSpreadsheetCellClicked(0,numCol-1);
-
-    QChartView *chartView = new QChartView(chart);
-    chartView->setRenderHint(QPainter::Antialiasing);
-    chartView->chart()->legend()->hide();
-
-
-    //
-    // create a widget into which we place the chart and the spreadsheet
-    //
-
-    QWidget *widget = new QWidget();
-    QVBoxLayout *layout = new QVBoxLayout(widget);
-    layout->addWidget(chartView, 1);
-    layout->addWidget(spreadsheet, 1);
+    // swap the placeholder for it
+    QWidget *placeholder = tabWidget->widget(1);
+    tabWidget->removeTab(1);
+    tabWidget->insertTab(1, widget, tr("Data Values"));
+    tabWidget->setCurrentIndex(1);
+    delete placeholder;
 
-    //layout->addWidget(analysis_message,1);
-    // add 3 Widgets to TabWidget
-    //
+    this->onSpreadsheetCellClicked(0,numCol-1);
+}
 
-    tabWidget->addTab(summary,tr("Summmary"));
-    tabWidget->addTab(widget, tr("Data Values"));
 
-    tabWidget->adjustSize();
+extern QWidget *addLabeledLineEdit(QString theLabelName, QLineEdit **theLineEdit);
 
-    return result;
+// statistics not known, e.g. percentiles in files saved before they were added, are left blank
+static QString
+summaryText(double value)
+{
+    if (qIsNaN(value))
+        return QString();
+    return QString::number(value);
 }
 
+// a label under the line edit of a labeled line edit, for a confidence interval
+static QLabel *
+addIntervalLabel(QWidget *labeledLineEdit)
+{
+    QLabel *theLabel = new QLabel();
+    theLabel->setMaximumWidth(200);
+    theLabel->setMinimumWidth(200);
+    labeledLineEdit->layout()->addWidget(theLabel);
+    return theLabel;
+}
 
-extern QWidget *addLabeledLineEdit(QString theLabelName, QLineEdit **theLineEdit);
+static QString
+percentileLabel(double level)
+{
+    if (level == 0.5)
+        return QString("Median");
+    return QString::number(level*100) + QString("%");
+}
 
 QWidget *
-DakotaResultsSampling::createResultEDPWidget(QString &name, double mean, double stdDev, double skewness, double kurtosis) {
+DakotaResultsSampling::createResultEDPWidget(QString &name, const ColumnStatistics &stats) {
     QWidget *edp = new QWidget;
     QHBoxLayout *edpLayout = new QHBoxLayout();
 
@@ -1040,37 +1737,79 @@ DakotaResultsSampling::createResultEDPWidget(QString &name, double mean, double
     nameLineEdit->setText(name);
     nameLineEdit->setDisabled(true);
     theNames.append(name);
+    addIntervalLabel(nameWidget);   // keeps the line edits in one row
     edpLayout->addWidget(nameWidget);
 
     QLineEdit *meanLineEdit;
     QWidget *meanWidget = addLabeledLineEdit(QString("Mean"), &meanLineEdit);
-    meanLineEdit->setText(QString::number(mean));
     meanLineEdit->setDisabled(true);
-    theMeans.append(mean);
+    theMeanLineEdits.append(meanLineEdit);
+    theIntervalLabels[BootstrapEstimator::Mean].append(addIntervalLabel(meanWidget));
     edpLayout->addWidget(meanWidget);
 
     QLineEdit *stdDevLineEdit;
     QWidget *stdDevWidget = addLabeledLineEdit(QString("StdDev"), &stdDevLineEdit);
-    stdDevLineEdit->setText(QString::number(stdDev));
     stdDevLineEdit->setDisabled(true);
-    theStdDevs.append(stdDev);
+    theStdDevLineEdits.append(stdDevLineEdit);
+    theIntervalLabels[BootstrapEstimator::StdDev].append(addIntervalLabel(stdDevWidget));
     edpLayout->addWidget(stdDevWidget);
 
     QLineEdit *skewnessLineEdit;
     QWidget *skewnessWidget = addLabeledLineEdit(QString("Skewness"), &skewnessLineEdit);
-    skewnessLineEdit->setText(QString::number(skewness));
     skewnessLineEdit->setDisabled(true);
-    theSkewness.append(skewness);
+    theSkewnessLineEdits.append(skewnessLineEdit);
+    theIntervalLabels[BootstrapEstimator::Skewness].append(addIntervalLabel(skewnessWidget));
     edpLayout->addWidget(skewnessWidget);
 
     QLineEdit *kurtosisLineEdit;
     QWidget *kurtosisWidget = addLabeledLineEdit(QString("Kurtosis"), &kurtosisLineEdit);
-    kurtosisLineEdit->setText(QString::number(kurtosis));
     kurtosisLineEdit->setDisabled(true);
-    theKurtosis.append(kurtosis);
+    theKurtosisLineEdits.append(kurtosisLineEdit);
+    theIntervalLabels[BootstrapEstimator::Kurtosis].append(addIntervalLabel(kurtosisWidget));
     edpLayout->addWidget(kurtosisWidget);
 
+    QLineEdit *minLineEdit;
+    QWidget *minWidget = addLabeledLineEdit(QString("Min"), &minLineEdit);
+    minLineEdit->setDisabled(true);
+    theMinLineEdits.append(minLineEdit);
+    addIntervalLabel(minWidget);
+    edpLayout->addWidget(minWidget);
+
+    for (int i=0; i<NUM_PERCENTILES; i++) {
+        QLineEdit *percentileLineEdit;
+        QWidget *percentileWidget = addLabeledLineEdit(percentileLabel(SampleStatistics::percentileLevels[i]), &percentileLineEdit);
+        percentileLineEdit->setDisabled(true);
+        thePercentileLineEdits[i].append(percentileLineEdit);
+        theIntervalLabels[BootstrapEstimator::FirstPercentile+i].append(addIntervalLabel(percentileWidget));
+        edpLayout->addWidget(percentileWidget);
+    }
+
+    QLineEdit *maxLineEdit;
+    QWidget *maxWidget = addLabeledLineEdit(QString("Max"), &maxLineEdit);
+    maxLineEdit->setDisabled(true);
+    theMaxLineEdits.append(maxLineEdit);
+    addIntervalLabel(maxWidget);
+    edpLayout->addWidget(maxWidget);
+
     edpLayout->addStretch();
 
+    theStatistics.append(stats);
+    this->updateResultEDPWidget(theStatistics.size()-1, stats);
+
     return edp;
 }
+
+void
+DakotaResultsSampling::updateResultEDPWidget(int edp, const ColumnStatistics &stats)
+{
+    theStatistics[edp] = stats;
+
+    theMeanLineEdits.at(edp)->setText(summaryText(stats.mean));
+    theStdDevLineEdits.at(edp)->setText(summaryText(stats.stdDev));
+    theSkewnessLineEdits.at(edp)->setText(summaryText(stats.skewness));
+    theKurtosisLineEdits.at(edp)->setText(summaryText(stats.kurtosis));
+    theMinLineEdits.at(edp)->setText(summaryText(stats.min));
+    theMaxLineEdits.at(edp)->setText(summaryText(stats.max));
+    for (int i=0; i<NUM_PERCENTILES; i++)
+        thePercentileLineEdits[i].at(edp)->setText(summaryText(stats.percentiles[i]));
+}
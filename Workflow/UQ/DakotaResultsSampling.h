@@ -40,16 +40,37 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written: fmckenna
 
 #include <UQ_Results.h>
-#include <QtCharts/QChart>
 #include <QMessageBox>
 #include <QPushButton>
-
-
-using namespace QtCharts;
+#include <SampleDataStore.h>
+#include <OnlineMoments.h>
+#include <SampleStatistics.h>
+#include <SampleColumnCache.h>
+#include <DensityEstimator.h>
+#include <SampleFilter.h>
+#include <BootstrapEstimator.h>
+#include <DistributionFitter.h>
+#include <QuantileSketch.h>
+#include <FragilityFitter.h>
+#include <SampleComparison.h>
+#include <CorrelationMatrix.h>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QJsonObject>
 
 class QTextEdit;
 class QTabWidget;
-class MyTableWidget;
+class MyTableView;
+class SampleDataModel;
+class DakotaTabFollower;
+class SamplePlot;
+class CorrelationMatrixView;
+class SampleComparisonModel;
+class ParallelCoordinatesView;
+class QTableView;
+class QModelIndex;
+class QComboBox;
+class QLineEdit;
 class MainWindow;
 class RandomVariablesContainer;
 
@@ -66,7 +87,12 @@ public:
     bool inputFromJSON(QJsonObject &rvObject);
 
     int processResults(QString &filenameResults, QString &filenameTab);
-    QWidget *createResultEDPWidget(QString &name, double mean, double stdDev, double skewness, double kurtosis);
+    // one or more tab files, several being the jobs of one study, read as one set of results
+    int processTabFiles(const QStringList &filenamesTab);
+    int followResults(QString &filenameTab) override;
+    void stopFollowingResults(void) override;
+    QWidget *createResultEDPWidget(QString &name, const ColumnStatistics &stats);
+    void updateResultEDPWidget(int edp, const ColumnStatistics &stats);
 
 signals:
 
@@ -74,15 +100,98 @@ public slots:
    void clear(void);
    void onSpreadsheetCellClicked(int, int);
    void onSaveSpreadsheetClicked();
+   void onLoadTabFilesClicked(void);
+   void loadSelectedTabFiles(void);
+   void onFollowedHeadingsRead();
+   void onFollowedRowsAppended(int firstRow, int lastRow);
+   void onTabChanged(int index);
+   void onCorrelationTypeChanged(int index);
+   void onCorrelationCellClicked(int row, int col);
+   void onFilterApplied(void);
+   void onFilterCleared(void);
+   void onBinRuleChanged(int index);
+   void onWeightColumnChanged(int index);
+   void onBootstrapFinished(void);
+   void onFitFinished(void);
+   void onFragilityFitClicked(void);
+   void onFragilityFitFinished(void);
+   void onLoadBaselineClicked(void);
+   void onComparisonDoubleClicked(const QModelIndex &index);
+   void onParallelSelectionChanged(int numSelected);
+   void onFilterToSelectionClicked(void);
 
    // modified by padhye 08/25/2018
 
 private:
+   QWidget *createDataValuesWidget(void);
+   QWidget *createCorrelationsWidget(void);
+   QWidget *createFragilityWidget(void);
+   void updateFragilityColumns(void);
+   QWidget *createComparisonWidget(void);
+   void updateComparison(void);
+   QWidget *createParallelCoordinatesWidget(void);
+   void updateParallelCoordinates(void);
+   void updateCorrelations(void);
+   void loadPendingSpreadsheet(void);
+   void updateChart(void);
+   void updateFilteredStatistics(void);
+   void startBootstrap(void);
+   void stopBootstrap(void);
+   void startFit(int col);
+
    RandomVariablesContainer *theRVs;
    QTabWidget *tabWidget;
 
-   MyTableWidget *spreadsheet;  // MyTableWidget inherits the QTableWidget
-   QChart *chart;
+   SampleDataStore theData;     // owns the sample values, one array per column
+   SampleColumnCache theColumnCache; // sorted columns for the CDF and histogram
+   DensityEstimator theDensities;    // histogram and kernel density of each column
+   SampleFilter theFilter;           // rows selected by the filter bar, all if no predicates
+   QVector<QuantileSketch> theSketches; // quantiles of each column, kept as rows are read
+   std::vector<double> filteredX;    // the selected rows of the scatter plot columns
+   std::vector<double> filteredY;
+   QJsonObject pendingSpreadsheet;   // data values read but not yet shown
+   bool pendingUnreadable;           // pendingSpreadsheet could not be decoded, kept to save back
+   SampleDataModel *dataModel;  // formats only the visible cells of theData
+   MyTableView *spreadsheet;    // MyTableView inherits the QTableView
+   SamplePlot *chart;           // scatter plots of many samples drawn as a density image
+
+   CorrelationMatrix theCorrelations;     // between all columns but the run number
+   int correlationRows;                   // rows of theData they were computed from, -1 if none
+   CorrelationMatrixView *correlationView;
+   QComboBox *correlationType;
+   QLineEdit *filterLineEdit;
+   QLabel *filterCount;
+   QLabel *fitLabel;
+   QComboBox *binRule;               // of the histogram
+   QComboBox *weightColumn;          // column weighting the histogram and density, first item for none
+
+   // distributions fitted to the column of the histogram, on a worker thread
+   DistributionFitter theFitter;
+   QFutureWatcher<void> fitWatcher;
+   int fittingColumn;                // column being fitted or last fitted, -1 if none
+   int fittedColumn;                 // column theFitter holds results for, -1 if none
+
+   // fragility curves of a response against an intensity column, on a worker thread
+   FragilityFitter theFragilities;
+   QFutureWatcher<bool> fragilityWatcher;
+   QComboBox *fragilityIntensity;
+   QComboBox *fragilityResponse;
+   QLineEdit *fragilityThresholds;
+   SamplePlot *fragilityChart;
+   QLabel *fragilityResults;
+   QString fragilityIntensityName;   // heading of the intensity column fitted
+
+   // this run against a baseline run, which is kept when other results are loaded
+   SampleComparison theComparison;
+   SampleComparisonModel *comparisonModel;
+   QTableView *comparisonView;
+   QLabel *comparisonLabel;
+   int comparisonRows;               // rows compared, -1 if to be compared again
+
+   // all columns but the run number as a parallel coordinates density plot
+   ParallelCoordinatesView *parallelView;
+   QLabel *parallelLabel;
+   int parallelRows;                 // rows of theData shown, -1 if none
    QPushButton* save_spreadheet; // save the data from spreadsheet
    QLabel *label;
    QLabel *best_fit_instructions;
@@ -90,12 +199,28 @@ private:
    int col1, col2;
    bool mLeft;
    QStringList theHeadings;
+   QStringList selectedTabFiles;    // chosen with the load button, loaded once its click has returned
 
    QVector<QString>theNames;
-   QVector<double>theMeans;
-   QVector<double>theStdDevs;
-   QVector<double>theKurtosis;
-   QVector<double>theSkewness;
+   QVector<ColumnStatistics>theStatistics;
+
+   QVector<QLineEdit *>theMeanLineEdits;
+   QVector<QLineEdit *>theStdDevLineEdits;
+   QVector<QLineEdit *>theSkewnessLineEdits;
+   QVector<QLineEdit *>theKurtosisLineEdits;
+   QVector<QLineEdit *>theMinLineEdits;
+   QVector<QLineEdit *>theMaxLineEdits;
+   QVector<QLineEdit *>thePercentileLineEdits[NUM_PERCENTILES];
+
+   // bootstrap confidence intervals of the statistics above, found on a worker thread
+   BootstrapEstimator theBootstrap;
+   QFutureWatcher<bool> bootstrapWatcher;
+   QVector<QLabel *>theIntervalLabels[NUM_BOOTSTRAP_STATISTICS];
+
+   // following the tab file of a running analysis
+   DakotaTabFollower *theFollower;
+   QVector<OnlineMoments> theFollowedMoments;
+   QElapsedTimer lastChartUpdate;
 };
 
 #endif // DAKOTA_RESULTS_SAMPLING_H
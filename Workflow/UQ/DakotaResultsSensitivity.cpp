@@ -47,8 +47,15 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QFileDialog>
 #include <QTabWidget>
 #include <QTextEdit>
-#include <MyTableWidget.h>
+#include <MyTableView.h>
+#include <SampleDataModel.h>
+#include <SampleDataExporter.h>
+#include <DakotaTabParser.h>
 #include <QDebug>
+#include <DakotaOutIndex.h>
+#include <DakotaResultsCache.h>
+#include <SobolEstimator.h>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QHBoxLayout>
 #include <QColor>
 #include <QMenuBar>
@@ -77,16 +84,9 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <InputWidgetUQ.h>
 #include <QHeaderView>
 
-#include <QtCharts/QChart>
-#include <QtCharts/QChartView>
-#include <QtCharts/QLineSeries>
-#include <QtCharts/QScatterSeries>
-#include <QtCharts/QVXYModelMapper>
-using namespace QtCharts;
+#include <SamplePlot.h>
 #include <math.h>
-#include <QValueAxis>
 
-#include <QXYSeries>
 #include <RandomVariablesContainer.h>
 
 #define NUM_DIVISIONS 10
@@ -95,8 +95,8 @@ using namespace QtCharts;
 
 
 
-DakotaResultsSensitivity::DakotaResultsSensitivity(QWidget *parent)
-  : UQ_Results(parent)
+DakotaResultsSensitivity::DakotaResultsSensitivity(RandomVariablesContainer *theRandomVariables, QWidget *parent)
+  : UQ_Results(parent), theRVs(theRandomVariables), indicesLayout(NULL), dataModel(NULL), spreadsheet(NULL)
 {
     // title & add button
     tabWidget = new QTabWidget(this);
@@ -104,33 +104,38 @@ DakotaResultsSensitivity::DakotaResultsSensitivity(QWidget *parent)
     mLeft = true;
     col1 = 0;
     col2 = 0;
+
+    connect(&sobolWatcher,SIGNAL(finished()),this,SLOT(onSobolFinished()));
 }
 
 DakotaResultsSensitivity::~DakotaResultsSensitivity()
 {
-
+    // the worker reads theData and writes theEstimator
+    sobolWatcher.waitForFinished();
 }
 
 
 void DakotaResultsSensitivity::clear(void)
 {
-  // delete any existing widgets
-  int count = tabWidget->count();
-  if (count > 0) {
-    for (int i=0; i<count; i++) {
-      QWidget *theWidget = tabWidget->widget(count);
-      delete theWidget;
-    }
+  // the estimate reads theData, let it finish before the store is cleared
+  sobolWatcher.waitForFinished();
+  indicesLayout = NULL;
+
+  // delete any existing widgets, with the views and models on them
+  while (tabWidget->count() != 0) {
+    QWidget *theWidget = tabWidget->widget(0);
+    tabWidget->removeTab(0);
+    delete theWidget;
   }
   theHeadings.clear();
   theMeans.clear();
   theStdDevs.clear();
   theKurtosis.clear();
 
-  tabWidget->clear();
-
   spreadsheet = NULL;
-  
+  dataModel = NULL;
+  theData.clear();
+
 }
 
 
@@ -207,15 +212,7 @@ int DakotaResultsSensitivity::processResults(QString &filenameResults, QString &
         emit sendErrorMessage("No dakota.err file - dakota did not run - problem with dakota setup or the applications failed with inputs provided");
         return 0;
     }
-    QFile fileError(filenameErrorString);
-    QString line("");
-    if (fileError.open(QIODevice::ReadOnly)) {
-       QTextStream in(&fileError);
-       while (!in.atEnd()) {
-          line = in.readLine();
-       }
-       fileError.close();
-    }
+    QString line = DakotaOutIndex::readLastLine(filenameErrorString);
 
     if (line.length() != 0) {
         qDebug() << line.length() << " " << line;
@@ -275,20 +272,26 @@ Node_2_Disp Sobol' indices:
 
 		      ******************************************** */
 
-    const std::string needleStart = "Global sensitivity indices for each response function:";
-    std::string haystack;
+    // seek straight to the indices, skipping everything dakota wrote before them;
+    // if dakota was not asked for them they are estimated from the samples
+    DakotaOutIndex theIndex;
 
-    while (std::getline(fileResults, haystack))
-        if (haystack.find(needleStart) != std::string::npos)
-            break;
+    // the parsed columns and section offsets of an earlier load of the same files
+    DakotaResultsCache theCache;
+    bool cached = theCache.setSources(QStringList() << filenameTab << filenameResults)
+            && theCache.load(&theData, NULL, &theIndex);
+    if (!cached)
+        theIndex.build(filenameResults);
+    qint64 offsetStart = theIndex.getFirstOffset(DakotaOutIndex::SensitivityIndices);
 
-    if (fileResults.eof()) {
-        std::cerr << "DakotaResultsReliability: No sensitivity results in output";
-        return -1;
+    std::string haystack;
+    if (offsetStart >= 0) {
+        fileResults.seekg(offsetStart);
+        std::getline(fileResults, haystack);
     }
 
     const std::string needleSobol = "Sobol'";
-    bool done = false;
+    bool done = (offsetStart < 0);
     QGroupBox *groupBox = NULL;
     int numEDP = 0;
     QGridLayout * trainingDataLayout = NULL;
@@ -376,81 +379,32 @@ Node_2_Disp Sobol' indices:
         }
     }
 
-    summaryLayout->addStretch();
-
     fileResults.close();
 
     //
-    // create spreadsheet,  a QTableWidget showing RV and results for each run
+    // read the tab file into the store & create spreadsheet, a QTableView onto it
     //
 
-    spreadsheet = new MyTableWidget();
-
-    // open file containing tab data
-    std::ifstream tabResults(filenameTab.toStdString().c_str());
-    if (!tabResults.is_open()) {
-        qDebug() << "Could not open file";
-        return -1;
+    if (!cached) {
+        DakotaTabParser theParser;
+        if (theParser.parseFile(filenameTab, theData) < 0) {
+            qDebug() << theParser.getErrorMessage();
+            return -1;
+        }
+        theCache.save(&theData, NULL, &theIndex);
     }
+    theHeadings = theData.getHeadings();
+    int colCount = theData.getNumColumns();
 
-    //
-    // read first line and set headings (ignoring second column for now)
-    //
-
-    std::string inputLine;
-    std::getline(tabResults, inputLine);
-    std::istringstream iss(inputLine);
-    int colCount = 0;
-
-    theHeadings << "Run #";
-
-    bool includesInterface = false;
-    do {
-        std::string subs;
-            iss >> subs;
-            if (colCount > 0) {
-                if (subs != " ") {
-                    if (subs != "interface")
-                        theHeadings << subs.c_str();
-                    else
-                        includesInterface = true;
-                }
-            }
-            colCount++;
-        } while (iss);
-
-        if (includesInterface == true)
-            colCount = colCount-2;
-        else
-            colCount = colCount -1;
-
-        spreadsheet->setColumnCount(colCount);
-        spreadsheet->setHorizontalHeaderLabels(theHeadings);
-        spreadsheet->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        spreadsheet->verticalHeader()->setVisible(false);
-
-        // now until end of file, read lines and place data into spreadsheet
-
-        int rowCount = 0;
-        while (std::getline(tabResults, inputLine)) {
-            std::istringstream is(inputLine);
-            int col=0;
-            //qDebug()<<"\n the inputLine is        "<<inputLine.c_str();
-
-            spreadsheet->insertRow(rowCount);
-            for (int i=0; i<colCount+2; i++) {
-                std::string data;
-                is >> data;
-                if ((includesInterface == true && i != 1) || (includesInterface == false)) {
-                    QModelIndex index = spreadsheet->model()->index(rowCount, col);
-                    spreadsheet->model()->setData(index, data.c_str());
-                    col++;
-                }
-            }
-            rowCount++;
-        }
-        tabResults.close();
+    if (offsetStart < 0)
+        this->addEstimatedIndices(summaryLayout);
+    summaryLayout->addStretch();
 
+    spreadsheet = new MyTableView();
+    dataModel = new SampleDataModel(&theData, spreadsheet);
+    spreadsheet->setModel(dataModel);
+    spreadsheet->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    spreadsheet->verticalHeader()->setVisible(false);
 
         // this is where we are connecting edit triggers
         spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -461,8 +415,7 @@ Node_2_Disp Sobol' indices:
         // create a chart, setting data points from first and last col of spreadsheet
         //
 
-        chart = new QChart();
-        chart->setAnimationOptions(QChart::AllAnimations);
+        chart = new SamplePlot();
 
         // by default the constructor is called and it plots the graph of the last column on Y-axis w.r.t first column on the
         // X-axis
@@ -470,9 +423,6 @@ Node_2_Disp Sobol' indices:
 
         // to control the properties, how your graph looks you must click and study the onSpreadsheetCellClicked
 
-        QChartView *chartView = new QChartView(chart);
-        chartView->setRenderHint(QPainter::Antialiasing);
-        chartView->chart()->legend()->hide();
 
 
         QWidget *widget = new QWidget();
@@ -483,7 +433,7 @@ Node_2_Disp Sobol' indices:
         save_spreadsheet->resize(30,30);
         connect(save_spreadsheet,SIGNAL(clicked()),this,SLOT(onSaveSpreadsheetClicked()));
 
-        layout->addWidget(chartView, 0,0,1,1);
+        layout->addWidget(chart, 0,0,1,1);
         layout->addWidget(save_spreadsheet,1,0,Qt::AlignLeft);
         layout->addWidget(spreadsheet,2,0,1,1);
 
@@ -501,45 +451,106 @@ Node_2_Disp Sobol' indices:
     }
 
 
-    void
-            DakotaResultsSensitivity::onSaveSpreadsheetClicked()
-    {
+void
+DakotaResultsSensitivity::addEstimatedIndices(QVBoxLayout *summaryLayout)
+{
+    // first col is the eval id, then the random variables, then the edp
+    int numRV = theRVs->getNumRandomVariables();
+    int firstEDP = numRV+1;
+    int numEDP = theData.getNumColumns() - firstEDP;
+    if (numRV <= 0 || numEDP <= 0 || theData.getNumRows() < 2)
+        return;
 
-        int rowCount = spreadsheet->rowCount();
-        int columnCount = spreadsheet->columnCount();
+    // the estimate takes seconds for large files, so it runs on a worker and
+    // the indices are added under this label once it finishes
+    QWidget *indicesWidget = new QWidget();
+    indicesLayout = new QVBoxLayout(indicesWidget);
+    indicesLayout->setContentsMargins(0,0,0,0);
+    indicesLayout->addWidget(new QLabel(tr("Estimating Sobol' indices from samples ...")));
+    summaryLayout->addWidget(indicesWidget);
 
-        QString fileName = QFileDialog::getSaveFileName(this,
-                                                        tr("Save Data"), "",
-                                                        tr("All Files (*)"));
+    emit sendStatusMessage(tr("Estimating Sobol' indices from samples"));
 
-        QFile file(fileName);
-        if (file.open(QIODevice::ReadWrite))
-        {
-            QTextStream stream(&file);
-            for (int j=0; j<columnCount; j++)
-            {
-                stream <<theHeadings.at(j)<<",\t";
-            }
-            stream <<endl;
-            for (int i=0; i<rowCount; i++)
-            {
-                for (int j=0; j<columnCount; j++)
-                {
-                    QTableWidgetItem *item_value = spreadsheet->item(i,j);
-                    double value = item_value->text().toDouble();
-                    stream << value << ",\t";
-                    //     qDebug()<<value;
-                }
-                stream<<endl;
+    // the store is only cleared, by clear(), once the worker has finished
+    sobolWatcher.setFuture(QtConcurrent::run([this, numRV, firstEDP, numEDP]() {
+        theEstimator.estimate(theData, 1, numRV, firstEDP, numEDP);
+    }));
+}
+
+void
+DakotaResultsSensitivity::onSobolFinished(void)
+{
+    // the results were cleared while the worker ran
+    if (indicesLayout == NULL)
+        return;
+
+    int numRV = theRVs->getNumRandomVariables();
+    int firstEDP = numRV+1;
+    int numEDP = theData.getNumColumns() - firstEDP;
+
+    // drop the label saying the indices are being estimated
+    QLayoutItem *item = indicesLayout->takeAt(0);
+    if (item != NULL) {
+        delete item->widget();
+        delete item;
+    }
+
+    emit sendStatusMessage(tr(""));
+
+    QFont font;
+    font.setBold(true);
+    QStringList theLabels;
+    theLabels << "Random Variable" << "Main" << "Main 95%" << "Total" << "Total 95%";
+    QString intervalToolTip = tr("95% bootstrap interval, median-shifted: the 2.5% and 97.5% points of the\n"
+                                 "bootstrap replicates less the difference of their median and the estimate.\n"
+                                 "Not a percentile or BCa interval.");
+
+    for (int edp=0; edp<numEDP; edp++) {
+        QGroupBox *groupBox = new QGroupBox(theHeadings.at(firstEDP+edp)
+                                            + tr(" Sobol' indices (estimated from samples)"));
+        indicesLayout->addWidget(groupBox);
+
+        QGridLayout *indexLayout = new QGridLayout();
+        for (int i=0; i<theLabels.length(); i++) {
+            QLabel *label = new QLabel(theLabels.at(i));
+            label->setAlignment(Qt::AlignCenter);
+            label->setFont(font);
+            if (i == 2 || i == 4)
+                label->setToolTip(intervalToolTip);
+            indexLayout->addWidget(label, 0, i);
+        }
+
+        for (int rv=0; rv<numRV; rv++) {
+            const SobolIndex &theIndex = theEstimator.getIndex(edp, rv);
+            QStringList theValues;
+            theValues << theHeadings.at(1+rv)
+                      << QString::number(theIndex.main, 'g', 4)
+                      << QString("[%1, %2]").arg(theIndex.mainLower, 0, 'g', 3).arg(theIndex.mainUpper, 0, 'g', 3)
+                      << QString::number(theIndex.total, 'g', 4)
+                      << QString("[%1, %2]").arg(theIndex.totalLower, 0, 'g', 3).arg(theIndex.totalUpper, 0, 'g', 3);
+            for (int i=0; i<theValues.length(); i++) {
+                QLineEdit *lineEdit = new QLineEdit(theValues.at(i));
+                lineEdit->setReadOnly(true);
+                lineEdit->setAlignment(i == 0 ? Qt::AlignCenter : Qt::AlignRight);
+                indexLayout->addWidget(lineEdit, rv+1, i);
             }
         }
+        indexLayout->setColumnStretch(theLabels.length(), 1);
+        groupBox->setLayout(indexLayout);
+    }
 
-        //    QFileDialog::getOpenFileName( this, tr("Open Document"), QDir::currentPath(), tr("Document files (*.doc *.rtf);;All files (*.*)"), 0, QFileDialog::DontUseNativeDialog );
+    QLabel *note = new QLabel(tr("95% intervals are median-shifted bootstrap intervals, see their tooltips"));
+    indicesLayout->addWidget(note);
+}
 
-        //  qDebug()<<QDir::currentPath();
 
+    void
+            DakotaResultsSensitivity::onSaveSpreadsheetClicked()
+    {
+        SampleDataExporter::exportData(theData, this);
     }
 
+
     void DakotaResultsSensitivity::onSpreadsheetCellClicked(int row, int col)
     {
         Q_UNUSED(row);
@@ -550,56 +561,23 @@ Node_2_Disp Sobol' indices:
         //qDebug()<<"\n the value of mLeft       "<<mLeft;
         //qDebug()<<"\n I am inside the onSpreadsheetCellClicked routine  and I am exiting!!  ";
         //  exit(1);
-        // create a new series
-        chart->removeAllSeries();
-        //chart->removeA
-
-        auto axes = chart->axes();
-        for (auto axis: axes)
-            chart->removeAxis(axis);
+        chart->clearPlot();
 
-        // QScatterSeries *series;//= new QScatterSeries;
-
-        int oldCol;
         if (mLeft == true) {
-            oldCol= col2;   //
-            //oldCol=0;   // padhye trying. I don't think it makes sense to use coldCol as col2, i.e., something that was
-            // previously selected?
             col2 = col; // col is the one that comes in te function, based on the click made after clicking
-
-            //    qDebug()<<"\n the value of oldcol is  "<<oldCol;
-            //    qDebug()<<"\n the value of col2 is    "<<col2;
-            //    qDebug()<<"\t the value of col is     "<<col;
-
         } else {
-            oldCol= col1;
             col1 = col;
         }
 
-        int rowCount = spreadsheet->rowCount();
+        int rowCount = theData.getNumRows();
+        if (rowCount == 0)
+            return;
 
         if (col1 != col2) {
-            QScatterSeries *series = new QScatterSeries;
-
-            for (int i=0; i<rowCount; i++) {
-                QTableWidgetItem *itemX = spreadsheet->item(i,col1);    //col1 goes in x-axis, col2 on y-axis
-                //col1=0;
-                QTableWidgetItem *itemY = spreadsheet->item(i,col2);
-                QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-                itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-                itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-                itemY->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-
-                series->append(itemX->text().toDouble(), itemY->text().toDouble());
-            }
-            chart->addSeries(series);
-            series->setName("Samples");
-
-            QValueAxis *axisX = new QValueAxis();
-            QValueAxis *axisY = new QValueAxis();
+            dataModel->setHighlightedColumns(col1, col2);
 
-            axisX->setTitleText(theHeadings.at(col1));
-            axisY->setTitleText(theHeadings.at(col2));
+            const double *valuesX = theData.getColumn(col1);    //col1 goes in x-axis, col2 on y-axis
+            const double *valuesY = theData.getColumn(col2);
 
             // padhye adding ranges 8/25/2018
             // finding the range for X and Y axis
@@ -610,13 +588,8 @@ Node_2_Disp Sobol' indices:
 
             for (int i=0; i<rowCount; i++) {
 
-                QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-                QTableWidgetItem *itemY = spreadsheet->item(i,col2);
-
-                double value1 = itemX->text().toDouble();
-
-                double value2 = itemY->text().toDouble();
-
+                double value1 = valuesX[i];
+                double value2 = valuesY[i];
 
                 if (i == 0) {
                     minX=value1;
@@ -643,26 +616,21 @@ Node_2_Disp Sobol' indices:
 
             // if the column is not the run number, i.e., 0 column, then adjust the x-axis differently
 
-            if(col1!=0)
-            {
-                axisX->setRange(minX - 0.01*xRange, maxX + 0.1*xRange);
+            double startX = minX - 0.01*xRange;
+            double endX = maxX + 0.1*xRange;
+            if (col1 == 0) {
+                startX = int (minX - 1);
+                endX = int (maxX + 1);
             }
-            else{
-
-                axisX->setRange(int (minX - 1), int (maxX +1));
-                // axisX->setTickCount(1);
 
-            }
             // adjust y with some fine precision
-            axisY->setRange(minY - 0.1*yRange, maxY + 0.1*yRange);
-            chart->addAxis(axisX, Qt::AlignBottom);
-            series->attachAxis(axisX);
-            chart->addAxis(axisY, Qt::AlignLeft);
-            series->attachAxis(axisY);
+            chart->setAxes(theHeadings.at(col1), startX, endX,
+                           theHeadings.at(col2), minY - 0.1*yRange, maxY + 0.1*yRange);
 
-        } else {
+            // the plot draws the points, or a density image if too many are in view
+            chart->setScatterData(valuesX, valuesY, rowCount);
 
-            QLineSeries *series= new QLineSeries;
+        } else {
 
             static double NUM_DIVISIONS_FOR_DIVISION = 10.0;
             double *dataValues = new double[rowCount];
@@ -670,14 +638,14 @@ Node_2_Disp Sobol' indices:
             for (int i=0; i<NUM_DIVISIONS; i++)
                 histogram[i] = 0;
 
+            dataModel->setHighlightedColumns(col1, -1);
+
+            const double *valuesX = theData.getColumn(col1);
+
             double min = 0;
             double max = 0;
             for (int i=0; i<rowCount; i++) {
-                QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-                QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-                itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-                itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-                double value = itemX->text().toDouble();
+                double value = valuesX[i];
                 dataValues[i] =  value;
 
                 if (i == 0) {
@@ -709,29 +677,16 @@ Node_2_Disp Sobol' indices:
                     if (histogram[i] > maxPercent)
                         maxPercent = histogram[i];
                 }
+                QVector<double> centres(NUM_DIVISIONS);
+                QVector<double> heights(NUM_DIVISIONS);
                 for (int i=0; i<NUM_DIVISIONS; i++) {
-                    series->append(min+i*dRange, 0);
-                    series->append(min+i*dRange, histogram[i]);
-                    series->append(min+(i+1)*dRange, histogram[i]);
-                    series->append(min+(i+1)*dRange, 0);
+                    centres[i] = min+(i+0.5)*dRange;
+                    heights[i] = histogram[i];
                 }
 
-
-                chart->addSeries(series);
-                series->setName("Histogram");
-
-                QValueAxis *axisX = new QValueAxis();
-                QValueAxis *axisY = new QValueAxis();
-
-                axisX->setRange(min-(max-min)*.1, max+(max-min)*.1);
-                axisY->setRange(0, 1.1*maxPercent);
-                axisY->setTitleText("Frequency %");
-                axisX->setTitleText(theHeadings.at(col1));
-                axisX->setTickCount(NUM_DIVISIONS+1);
-                chart->addAxis(axisX, Qt::AlignBottom);
-                series->attachAxis(axisX);
-                chart->addAxis(axisY, Qt::AlignLeft);
-                series->attachAxis(axisY);
+                chart->setAxes(theHeadings.at(col1), min-(max-min)*.1, max+(max-min)*.1,
+                               "Frequency %", 0, 1.1*maxPercent);
+                chart->addBars(centres, heights, dRange, "Histogram");
 
                 //calling external python script to find the best fit, generating the data and then plotting it.
 
@@ -808,8 +763,7 @@ Node_2_Disp Sobol' indices:
                     exit(1);
 
                 }
-                QLineSeries *series_best_fit = new QLineSeries();
-                series_best_fit->setName("Best Fit");
+                QVector<QPointF> best_fit_points;
                 if(file_fitted_data.open(QIODevice::ReadOnly |QIODevice::Text ))
                 {
 
@@ -824,7 +778,7 @@ Node_2_Disp Sobol' indices:
                         double value1= list2[0].toDouble();
                         double value2= list2[1].toDouble();
 
-                        series_best_fit->append(value1,value2);
+                        best_fit_points.append(QPointF(value1,value2));
 
                         //chart->setAxisX(axisX, series_best_fit);
                         //chart->setAxisY(axisY, series_best_fit);
@@ -837,9 +791,9 @@ Node_2_Disp Sobol' indices:
 
                     file_fitted_data.close();
 
-                    chart->addSeries(series_best_fit);
-                    chart->legend()->setVisible(true);
-                    chart->legend()->setAlignment(Qt::AlignTop);
+                    chart->addLine(SamplePlot::makeData(best_fit_points), "Best Fit");
+                    chart->legend->setVisible(true);
+                    chart->axisRect()->insetLayout()->setInsetAlignment(0, Qt::AlignTop | Qt::AlignHCenter);
                     // chart->setTitle("The best fit plot is");
                     QString best_fit_info_file = appDIR +  QDir::separator() + QString("data_fit_info.out");
 
@@ -908,25 +862,12 @@ Node_2_Disp Sobol' indices:
             } else {
                 // cumulative distribution
                 mergesort(dataValues, rowCount);
-                for (int i=0; i<rowCount; i++) {
-                    series->append(dataValues[i], 1.0*i/rowCount);
-                    //qDebug()<<"\n the dataValues[i] and rowCount is     "<<dataValues[i]<<"\t"<<rowCount<<"";
-                }
-                delete [] dataValues;
-                chart->addSeries(series);
-                QValueAxis *axisX = new QValueAxis();
-                QValueAxis *axisY = new QValueAxis();
+
                 // padhye, make these consistent changes all across.
-                axisX->setRange(min- (max-min)*0.1, max+(max-min)*0.1);
-                axisY->setRange(0, 1);
-                axisY->setTitleText("Cumulative Probability");
-                axisX->setTitleText(theHeadings.at(col1));
-                axisX->setTickCount(NUM_DIVISIONS+1);
-                chart->addAxis(axisX, Qt::AlignBottom);
-                series->attachAxis(axisX);
-                chart->addAxis(axisY, Qt::AlignLeft);
-                series->attachAxis(axisY);
-                series->setName("Cumulative Frequency Distribution");
+                chart->setAxes(theHeadings.at(col1), min- (max-min)*0.1, max+(max-min)*0.1,
+                               "Cumulative Probability", 0, 1);
+                chart->addLine(SamplePlot::makeCDF(dataValues, rowCount), "Cumulative Frequency Distribution");
+                delete [] dataValues;
             }
         }
     }
@@ -967,30 +908,9 @@ Node_2_Disp Sobol' indices:
 
         QJsonObject spreadsheetData;
 
-        int numCol = spreadsheet->columnCount();
-        int numRow = spreadsheet->rowCount();
-
-        spreadsheetData["numRow"]=numRow;
-        spreadsheetData["numCol"]=numCol;
-
-        QJsonArray headingsArray;
-        for (int i = 0; i <theHeadings.size(); ++i) {
-            headingsArray.append(QJsonValue(theHeadings.at(i)));
-        }
-
-        spreadsheetData["headings"]=headingsArray;
-
-        QJsonArray dataArray;
         QApplication::setOverrideCursor(Qt::WaitCursor);
-        for (int row = 0; row < numRow; ++row) {
-            for (int column = 0; column < numCol; ++column) {
-                QTableWidgetItem *theItem = spreadsheet->item(row,column);
-                QString textData = theItem->text();
-                dataArray.append(textData.toDouble());
-            }
-        }
+        theData.writeJSON(spreadsheetData);
         QApplication::restoreOverrideCursor();
-        spreadsheetData["data"]=dataArray;
 
         jsonObject["spreadsheet"] = spreadsheetData;
         return result;
@@ -1046,29 +966,18 @@ Node_2_Disp Sobol' indices:
         // into a spreadsheet place all the data returned
         //
 
-        spreadsheet = new MyTableWidget();
         QJsonObject spreadsheetData = jsonObject["spreadsheet"].toObject();
-        int numRow = spreadsheetData["numRow"].toInt();
-        int numCol = spreadsheetData["numCol"].toInt();
-        spreadsheet->setColumnCount(numCol);
-        spreadsheet->setRowCount(numRow);
-
-        QJsonArray headingData= spreadsheetData["headings"].toArray();
-        for (int i=0; i<numCol; i++) {
-            theHeadings << headingData.at(i).toString();
+        if (!theData.readJSON(spreadsheetData)) {
+            emit sendErrorMessage("Could not read the data values of the results");
+            return false;
         }
+        theHeadings = theData.getHeadings();
+        int numCol = theData.getNumColumns();
 
-        spreadsheet->setHorizontalHeaderLabels(theHeadings);
-
-        QJsonArray dataData= spreadsheetData["data"].toArray();
-        int dataCount =0;
-        for (int row =0; row<numRow; row++) {
-            for (int col=0; col<numCol; col++) {
-                QModelIndex index = spreadsheet->model()->index(row, col);
-                spreadsheet->model()->setData(index, dataData.at(dataCount).toDouble());
-                dataCount++;
-            }
-        }
+        spreadsheet = new MyTableView();
+        dataModel = new SampleDataModel(&theData, spreadsheet);
+        spreadsheet->setModel(dataModel);
+        spreadsheet->verticalHeader()->setVisible(false);
         spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
         connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
 
@@ -1076,17 +985,13 @@ Node_2_Disp Sobol' indices:
         // create a chart, setting data points from first and last col of spreadsheet
         //
 
-        chart = new QChart();
-        chart->setAnimationOptions(QChart::AllAnimations);
+        chart = new SamplePlot();
         col1 = 0;           // col1 is initialied as the first column in spread sheet
         col2 = numCol-1;    // col2 is initialized as the second column in spread sheet
         mLeft = true;       // left click
 
         this->onSpreadsheetCellClicked(0,numCol-1);
 
-        QChartView *chartView = new QChartView(chart);
-        chartView->setRenderHint(QPainter::Antialiasing);
-        chartView->chart()->legend()->hide();
 
 
         //
@@ -1095,7 +1000,7 @@ Node_2_Disp Sobol' indices:
 
         QWidget *widget = new QWidget();
         QVBoxLayout *layout = new QVBoxLayout(widget);
-        layout->addWidget(chartView, 1);
+        layout->addWidget(chart, 1);
         layout->addWidget(spreadsheet, 1);
 
         //layout->addWidget(analysis_message,1);
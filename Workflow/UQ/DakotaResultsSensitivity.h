@@ -40,18 +40,21 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 // Written: fmckenna
 
 #include <UQ_Results.h>
-#include <QtCharts/QChart>
 #include <QMessageBox>
 #include <QPushButton>
+#include <SampleDataStore.h>
+#include <SobolEstimator.h>
+#include <QFutureWatcher>
 
 
-using namespace QtCharts;
-
 class QTextEdit;
 class QTabWidget;
-class MyTableWidget;
+class MyTableView;
+class SampleDataModel;
 class MainWindow;
 class RandomVariablesContainer;
+class SamplePlot;
+class QVBoxLayout;
 
 //class QChart;
 
@@ -59,7 +62,7 @@ class DakotaResultsSensitivity : public UQ_Results
 {
     Q_OBJECT
 public:
-    explicit DakotaResultsSensitivity(QWidget *parent = 0);
+    explicit DakotaResultsSensitivity(RandomVariablesContainer *theRandomVariables, QWidget *parent = 0);
     ~DakotaResultsSensitivity();
 
     bool outputToJSON(QJsonObject &rvObject) override;
@@ -74,14 +77,23 @@ public slots:
    void clear(void);
    void onSpreadsheetCellClicked(int, int);
    void onSaveSpreadsheetClicked();
+   void onSobolFinished(void);
 
    // modified by padhye 08/25/2018
 
 private:
+   void addEstimatedIndices(QVBoxLayout *summaryLayout);
+
+   RandomVariablesContainer *theRVs;
    QTabWidget *tabWidget;
 
-   MyTableWidget *spreadsheet;  // MyTableWidget inherits the QTableWidget
-   QChart *chart;
+   SampleDataStore theData;     // owns the sample values, one array per column
+   SobolEstimator theEstimator;       // indices estimated from theData, off the gui thread
+   QFutureWatcher<void> sobolWatcher;
+   QVBoxLayout *indicesLayout;        // on the summary, where the indices go once estimated
+   SampleDataModel *dataModel;  // formats only the visible cells of theData
+   MyTableView *spreadsheet;    // MyTableView inherits the QTableView
+   SamplePlot *chart;
    QPushButton* save_spreadheet; // save the data from spreadsheet
    QLabel *label;
    QLabel *best_fit_instructions;
@@ -0,0 +1,144 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaTabFollower.h"
+#include <SampleDataStore.h>
+
+#include <QFile>
+#include <QTimer>
+
+#include <string.h>
+
+DakotaTabFollower::DakotaTabFollower(SampleDataStore *data, QObject *parent)
+    :QObject(parent), theData(data), fileOffset(0), headerRead(false)
+{
+    pollTimer = new QTimer(this);
+    connect(pollTimer, SIGNAL(timeout()), this, SLOT(readNewData()));
+}
+
+DakotaTabFollower::~DakotaTabFollower()
+{
+
+}
+
+void
+DakotaTabFollower::start(const QString &name, int pollInterval)
+{
+    this->stop();
+
+    filename = name;
+    fileOffset = 0;
+    partialLine.clear();
+    headerRead = false;
+    theData->clear();
+
+    pollTimer->start(pollInterval);
+}
+
+void
+DakotaTabFollower::stop(void)
+{
+    pollTimer->stop();
+}
+
+bool
+DakotaTabFollower::isFollowing(void) const
+{
+    return pollTimer->isActive();
+}
+
+void
+DakotaTabFollower::setSketches(QVector<QuantileSketch> *theSketches)
+{
+    theParser.setSketches(theSketches);
+}
+
+void
+DakotaTabFollower::readNewData(void)
+{
+    QFile file(filename);
+    if (!file.exists())
+        return;
+
+    qint64 fileSize = file.size();
+
+    // file started again from scratch, so do we
+    if (fileSize < fileOffset) {
+        fileOffset = 0;
+        partialLine.clear();
+        headerRead = false;
+        theData->clear();
+    }
+
+    if (fileSize == fileOffset)
+        return;
+
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    file.seek(fileOffset);
+    QByteArray newData = file.read(fileSize - fileOffset);
+    file.close();
+
+    fileOffset += newData.size();
+    partialLine.append(newData);
+
+    int lastNewLine = partialLine.lastIndexOf('\n');
+    if (lastNewLine < 0)
+        return;
+
+    const char *begin = partialLine.constData();
+    const char *end = begin + lastNewLine + 1;
+
+    if (headerRead == false) {
+        const char *headerEnd = static_cast<const char *>(memchr(begin, '\n', end-begin));
+        QStringList headings;
+        if (theParser.parseHeader(begin, headerEnd, headings) == false)
+            return;
+        theData->setHeadings(headings);
+        headerRead = true;
+        begin = headerEnd+1;
+        emit headingsRead();
+    }
+
+    int firstRow = theData->getNumRows();
+    int numNew = theParser.parseLines(begin, end, *theData);
+
+    partialLine.remove(0, lastNewLine+1);
+
+    if (numNew > 0)
+        emit rowsAppended(firstRow, firstRow+numNew-1);
+}
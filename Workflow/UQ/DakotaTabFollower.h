@@ -0,0 +1,84 @@
+#ifndef DAKOTA_TAB_FOLLOWER_H
+#define DAKOTA_TAB_FOLLOWER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// follows a dakotaTab.out file while dakota is still writing it. the file is
+// polled at a fixed interval, only the bytes appended since the last poll are
+// read and only complete lines are parsed into the SampleDataStore
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <DakotaTabParser.h>
+
+class QTimer;
+class SampleDataStore;
+
+class DakotaTabFollower : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DakotaTabFollower(SampleDataStore *theData, QObject *parent = 0);
+    ~DakotaTabFollower();
+
+    void start(const QString &filename, int pollInterval = 1000);
+    void stop(void);
+    bool isFollowing(void) const;
+
+    // quantile sketches kept up to date as rows are appended
+    void setSketches(QVector<QuantileSketch> *theSketches);
+
+signals:
+    void headingsRead(void);
+    void rowsAppended(int firstRow, int lastRow);
+
+public slots:
+    void readNewData(void);
+
+private:
+    SampleDataStore *theData;
+    DakotaTabParser theParser;
+    QTimer *pollTimer;
+
+    QString filename;
+    qint64 fileOffset;     // bytes of the file consumed so far
+    QByteArray partialLine; // text after the last newline, waiting for the rest
+    bool headerRead;
+};
+
+#endif // DAKOTA_TAB_FOLLOWER_H
@@ -0,0 +1,219 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaTabMerger.h"
+#include <DakotaTabParser.h>
+#include <SampleDataStore.h>
+#include <OnlineMoments.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <string.h>
+#include <vector>
+
+// one file, parsed and summarized on its own
+struct TabFile {
+    QString filename;
+    SampleDataStore theData;
+    QVector<QuantileSketch> sketches;
+    std::vector<OnlineMoments> moments;
+    std::vector<double> min;
+    std::vector<double> max;
+    int numRows;
+    QString errorMessage;
+};
+
+DakotaTabMerger::DakotaTabMerger()
+{
+
+}
+
+DakotaTabMerger::~DakotaTabMerger()
+{
+
+}
+
+const QVector<ColumnStatistics> &
+DakotaTabMerger::getStatistics(void) const
+{
+    return theStatistics;
+}
+
+const QVector<QuantileSketch> &
+DakotaTabMerger::getSketches(void) const
+{
+    return theSketches;
+}
+
+const QVector<int> &
+DakotaTabMerger::getNumFileRows(void) const
+{
+    return numFileRows;
+}
+
+QString
+DakotaTabMerger::getErrorMessage(void) const
+{
+    return errorMessage;
+}
+
+int
+DakotaTabMerger::mergeFiles(const QStringList &filenames, SampleDataStore &theData)
+{
+    theData.clear();
+    theStatistics.clear();
+    theSketches.clear();
+    numFileRows.clear();
+    errorMessage.clear();
+
+    int numFiles = filenames.size();
+    if (numFiles == 0) {
+        errorMessage = QString("DakotaTabMerger: no files given");
+        return -1;
+    }
+
+    //
+    // parse and summarize the files in parallel
+    //
+
+    std::vector<TabFile> files(numFiles);
+    for (int i=0; i<numFiles; i++)
+        files[i].filename = filenames.at(i);
+
+    QtConcurrent::blockingMap(files, [](TabFile &file) {
+        DakotaTabParser theParser;
+        theParser.setSketches(&file.sketches);
+        file.numRows = theParser.parseFile(file.filename, file.theData);
+        if (file.numRows < 0) {
+            file.errorMessage = theParser.getErrorMessage();
+            return;
+        }
+
+        int numCols = file.theData.getNumColumns();
+        file.moments.resize(numCols);
+        file.min.resize(numCols);
+        file.max.resize(numCols);
+        for (int col=0; col<numCols; col++)
+            SampleStatistics::computeMoments(file.theData.getColumn(col), file.numRows,
+                                             file.moments[col], file.min[col], file.max[col]);
+    });
+
+    //
+    // all must have been read, with the columns of the first
+    //
+
+    QStringList headings = files[0].theData.getHeadings();
+    int numCols = headings.size();
+    int totalRows = 0;
+    for (int i=0; i<numFiles; i++) {
+        const TabFile &file = files[i];
+        if (file.numRows < 0) {
+            errorMessage = file.errorMessage;
+            return -1;
+        }
+        if (file.theData.getHeadings() != headings) {
+            errorMessage = QString("DakotaTabMerger: the columns of ") + file.filename +
+                    QString(" do not match those of ") + files[0].filename;
+            return -1;
+        }
+        totalRows += file.numRows;
+    }
+
+    //
+    // the rows one file after the other, each file freed once copied
+    //
+
+    theData.setHeadings(headings);
+    theData.resizeRows(totalRows);
+
+    int firstRow = 0;
+    double idOffset = 0;
+    for (int i=0; i<numFiles; i++) {
+        TabFile &file = files[i];
+        for (int col=0; col<numCols; col++)
+            memcpy(theData.getColumnData(col)+firstRow, file.theData.getColumn(col), file.numRows*sizeof(double));
+
+        // col 0 is the evaluation id
+        double *ids = theData.getColumnData(0)+firstRow;
+        for (int row=0; row<file.numRows; row++)
+            ids[row] += idOffset;
+        if (file.numRows != 0)
+            idOffset += file.max[0];
+
+        numFileRows.append(file.numRows);
+        firstRow += file.numRows;
+        file.theData.clear();
+    }
+
+    //
+    // the statistics of the files merged, in file order; those of the ids,
+    // having been offset, are found again
+    //
+
+    theSketches.resize(numCols);
+    theStatistics.resize(numCols);
+    for (int col=0; col<numCols; col++) {
+        OnlineMoments moments;
+        double min = 0, max = 0;
+        if (col == 0) {
+            SampleStatistics::computeMoments(theData.getColumn(0), totalRows, moments, min, max);
+            theSketches[0].add(theData.getColumn(0), totalRows);
+        } else {
+            bool first = true;
+            for (int i=0; i<numFiles; i++) {
+                const TabFile &file = files[i];
+                if (file.numRows == 0)
+                    continue;
+                moments.merge(file.moments[col]);
+                min = first ? file.min[col] : qMin(min, file.min[col]);
+                max = first ? file.max[col] : qMax(max, file.max[col]);
+                first = false;
+                if (col < file.sketches.size())
+                    theSketches[col].merge(file.sketches.at(col));
+            }
+        }
+
+        ColumnStatistics &stats = theStatistics[col];
+        stats.setMoments(moments);
+        stats.min = min;
+        stats.max = max;
+        if (theSketches.at(col).getCount() != 0)
+            for (int j=0; j<NUM_PERCENTILES; j++)
+                stats.percentiles[j] = theSketches.at(col).quantile(SampleStatistics::percentileLevels[j]);
+    }
+
+    return totalRows;
+}
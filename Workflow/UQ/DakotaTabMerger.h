@@ -0,0 +1,81 @@
+#ifndef DAKOTA_TAB_MERGER_H
+#define DAKOTA_TAB_MERGER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// reads the dakotaTab.out files of a study split into independent jobs, e.g.
+// run through RemoteJobManager, as one set of results. the files are parsed
+// in parallel, each into its own store, and the moments, range and quantile
+// sketch of each column are found while its rows are still in cache. the
+// headings must match; the rows are appended in file order, the evaluation
+// ids of each file offset by the largest id of the files before it, and the
+// statistics of the whole set are those of the files merged, without another
+// pass over the rows, the percentiles being read from the merged sketches
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <SampleStatistics.h>
+#include <QuantileSketch.h>
+
+class SampleDataStore;
+
+class DakotaTabMerger
+{
+public:
+    DakotaTabMerger();
+    ~DakotaTabMerger();
+
+    // read the files into theData, returns number of rows read or -1 on error
+    int mergeFiles(const QStringList &filenames, SampleDataStore &theData);
+
+    // of every column of theData
+    const QVector<ColumnStatistics> &getStatistics(void) const;
+    const QVector<QuantileSketch> &getSketches(void) const;
+
+    // rows read from each file
+    const QVector<int> &getNumFileRows(void) const;
+    QString getErrorMessage(void) const;
+
+private:
+    QVector<ColumnStatistics> theStatistics;
+    QVector<QuantileSketch> theSketches;
+    QVector<int> numFileRows;
+    QString errorMessage;
+};
+
+#endif // DAKOTA_TAB_MERGER_H
@@ -0,0 +1,448 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DakotaTabParser.h"
+#include <SampleDataStore.h>
+#include <QuantileSketch.h>
+
+#include <QFile>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+// below this many bytes the rows are parsed on the calling thread
+static const qint64 MIN_BYTES_PER_CHUNK = 1 << 20;
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char *skipBlanks(const char *p, const char *end)
+{
+    while (p < end && isBlank(*p))
+        p++;
+    return p;
+}
+
+static const char *skipToken(const char *p, const char *end)
+{
+    while (p < end && !isBlank(*p) && *p != '\n')
+        p++;
+    return p;
+}
+
+//
+// parse a double starting at p, the common case of at most 19 significant
+// digits and a small exponent is converted exactly using the fast path of
+// Clinger's algorithm, anything else is handed to strtod
+//
+
+static const double powersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const char *slowParseDouble(const char *p, const char *end, double &value)
+{
+    const char *tokenEnd = skipToken(p, end);
+    char buffer[128];
+    size_t length = tokenEnd - p;
+    if (length >= sizeof(buffer))
+        length = sizeof(buffer)-1;
+    memcpy(buffer, p, length);
+    buffer[length] = '\0';
+    value = strtod(buffer, NULL);
+    return tokenEnd;
+}
+
+static const char *parseDouble(const char *p, const char *end, double &value)
+{
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    while (p < end && *p >= '0' && *p <= '9') {
+        anyDigits = true;
+        if (numDigits < 19) {
+            mantissa = mantissa*10 + (*p - '0');
+            if (mantissa != 0)
+                numDigits++;
+        } else
+            exponent++;
+        p++;
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            anyDigits = true;
+            if (numDigits < 19) {
+                mantissa = mantissa*10 + (*p - '0');
+                if (mantissa != 0)
+                    numDigits++;
+                exponent--;
+            }
+            p++;
+        }
+    }
+
+    if (!anyDigits)
+        return slowParseDouble(start, end, value);
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExp = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExp = (*p == '-');
+            p++;
+        }
+        int exp = 0;
+        bool expDigits = false;
+        while (p < end && *p >= '0' && *p <= '9') {
+            expDigits = true;
+            if (exp < 100000)
+                exp = exp*10 + (*p - '0');
+            p++;
+        }
+        if (!expDigits)
+            return slowParseDouble(start, end, value);
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    // something other than a number follows, let strtod decide
+    if (p < end && !isBlank(*p) && *p != '\n')
+        return slowParseDouble(start, end, value);
+
+    if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        if (exponent < 0)
+            result /= powersOfTen[-exponent];
+        else
+            result *= powersOfTen[exponent];
+        value = negative ? -result : result;
+        return p;
+    }
+
+    return slowParseDouble(start, end, value);
+}
+
+//
+// parse the lines in [begin, end) writing row by row into columns starting at
+// firstRow, lines that are blank or short are skipped. returns rows written
+//
+
+static int parseChunk(const char *begin, const char *end, int numTokens, int skip,
+                      double **columns, int firstRow)
+{
+    int row = firstRow;
+    const char *p = begin;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end-p));
+        if (lineEnd == NULL)
+            lineEnd = end;
+
+        int col = 0;
+        int token = 0;
+        const char *q = skipBlanks(p, lineEnd);
+        while (q < lineEnd && token < numTokens) {
+            if (token == skip) {
+                q = skipToken(q, lineEnd);
+            } else {
+                double value;
+                q = parseDouble(q, lineEnd, value);
+                columns[col][row] = value;
+                col++;
+            }
+            token++;
+            q = skipBlanks(q, lineEnd);
+        }
+
+        // only complete lines count as a row
+        if (token == numTokens)
+            row++;
+
+        p = lineEnd+1;
+    }
+    return row-firstRow;
+}
+
+struct TabChunk {
+    const char *begin;
+    const char *end;
+    int firstRow;
+    int numRows;
+    QVector<QuantileSketch> sketches;
+};
+
+DakotaTabParser::DakotaTabParser()
+    :numTokens(0), interfaceToken(-1), theSketches(0)
+{
+
+}
+
+DakotaTabParser::~DakotaTabParser()
+{
+
+}
+
+const char *
+DakotaTabParser::parseNumber(const char *p, const char *end, double &value)
+{
+    return parseDouble(p, end, value);
+}
+
+int
+DakotaTabParser::getInterfaceToken(void) const
+{
+    return interfaceToken;
+}
+
+void
+DakotaTabParser::setSketches(QVector<QuantileSketch> *sketches)
+{
+    theSketches = sketches;
+}
+
+QString
+DakotaTabParser::getErrorMessage(void) const
+{
+    return errorMessage;
+}
+
+bool
+DakotaTabParser::parseHeader(const char *begin, const char *end, QStringList &headings)
+{
+    //
+    // first token is the eval_id, shown as "Run #", "interface" token skipped
+    //
+
+    headings.clear();
+    numTokens = 0;
+    interfaceToken = -1;
+
+    const char *p = skipBlanks(begin, end);
+    while (p < end && *p != '\n') {
+        const char *tokenEnd = skipToken(p, end);
+        QString token = QString::fromLatin1(p, tokenEnd-p);
+        if (numTokens == 0)
+            headings << "Run #";
+        else if (token == "interface")
+            interfaceToken = numTokens;
+        else
+            headings << token;
+        numTokens++;
+        p = skipBlanks(tokenEnd, end);
+    }
+
+    if (numTokens == 0) {
+        errorMessage = QString("DakotaTabParser: no headings found");
+        return false;
+    }
+
+    if (theSketches != 0) {
+        theSketches->clear();
+        theSketches->resize(headings.size());
+    }
+
+    return true;
+}
+
+int
+DakotaTabParser::parseLines(const char *begin, const char *end, SampleDataStore &theData)
+{
+    int numCols = theData.getNumColumns();
+    if (numCols == 0 || numTokens == 0)
+        return 0;
+
+    //
+    // count the lines so the columns can be sized up front, split the text
+    // into line aligned chunks and let each thread write its own rows
+    //
+
+    qint64 numBytes = end-begin;
+    int numChunks = 1;
+    if (numBytes > 2*MIN_BYTES_PER_CHUNK) {
+        numChunks = QThread::idealThreadCount()*4;
+        if (numChunks > numBytes/MIN_BYTES_PER_CHUNK)
+            numChunks = numBytes/MIN_BYTES_PER_CHUNK;
+        if (numChunks < 1)
+            numChunks = 1;
+    }
+
+    QVector<TabChunk> chunks;
+    const char *chunkBegin = begin;
+    for (int i=0; i<numChunks && chunkBegin < end; i++) {
+        const char *chunkEnd = end;
+        if (i != numChunks-1) {
+            chunkEnd = begin + numBytes*(i+1)/numChunks;
+            if (chunkEnd <= chunkBegin)
+                continue;
+            const char *newLine = static_cast<const char *>(memchr(chunkEnd, '\n', end-chunkEnd));
+            chunkEnd = (newLine == NULL) ? end : newLine+1;
+        }
+        TabChunk chunk;
+        chunk.begin = chunkBegin;
+        chunk.end = chunkEnd;
+        chunk.firstRow = 0;
+        chunk.numRows = 0;
+        chunks.append(chunk);
+        chunkBegin = chunkEnd;
+    }
+
+    // an upper bound on the rows in each chunk is its number of lines
+    QtConcurrent::blockingMap(chunks, [](TabChunk &chunk) {
+        int numLines = 0;
+        const char *p = chunk.begin;
+        while (p < chunk.end) {
+            const char *newLine = static_cast<const char *>(memchr(p, '\n', chunk.end-p));
+            numLines++;
+            if (newLine == NULL)
+                break;
+            p = newLine+1;
+        }
+        chunk.numRows = numLines;
+    });
+
+    int firstNewRow = theData.getNumRows();
+    int maxRows = firstNewRow;
+    for (int i=0; i<chunks.size(); i++) {
+        chunks[i].firstRow = maxRows;
+        maxRows += chunks[i].numRows;
+    }
+    theData.resizeRows(maxRows);
+
+    std::vector<double *> columns(numCols);
+    for (int col=0; col<numCols; col++)
+        columns[col] = theData.getColumnData(col);
+
+    int numTokensLine = numTokens;
+    int skip = interfaceToken;
+    double **columnPtrs = columns.data();
+    bool sketch = (theSketches != 0 && theSketches->size() == numCols);
+    QtConcurrent::blockingMap(chunks, [numTokensLine, skip, columnPtrs, numCols, sketch](TabChunk &chunk) {
+        chunk.numRows = parseChunk(chunk.begin, chunk.end, numTokensLine, skip, columnPtrs, chunk.firstRow);
+        if (sketch) {
+            chunk.sketches.resize(numCols);
+            for (int col=0; col<numCols; col++)
+                chunk.sketches[col].add(columnPtrs[col]+chunk.firstRow, chunk.numRows);
+        }
+    });
+
+    // merged in file order so the result does not depend on the threads
+    if (sketch) {
+        for (int i=0; i<chunks.size(); i++)
+            for (int col=0; col<numCols; col++)
+                (*theSketches)[col].merge(chunks.at(i).sketches.at(col));
+    }
+
+    //
+    // blank or short lines leave gaps at the end of a chunk, close them up
+    //
+
+    int numRows = firstNewRow;
+    for (int i=0; i<chunks.size(); i++) {
+        const TabChunk &chunk = chunks.at(i);
+        if (chunk.firstRow != numRows && chunk.numRows != 0) {
+            for (int col=0; col<numCols; col++)
+                memmove(columns[col]+numRows, columns[col]+chunk.firstRow, chunk.numRows*sizeof(double));
+        }
+        numRows += chunk.numRows;
+    }
+    theData.resizeRows(numRows);
+
+    return numRows-firstNewRow;
+}
+
+int
+DakotaTabParser::parseFile(const QString &filename, SampleDataStore &theData)
+{
+    theData.clear();
+    errorMessage.clear();
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("DakotaTabParser: Could not open file ") + filename;
+        return -1;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize == 0) {
+        errorMessage = QString("DakotaTabParser: empty file ") + filename;
+        return -1;
+    }
+
+    // map the file, if that is not possible read it in
+    QByteArray contents;
+    const char *begin = reinterpret_cast<const char *>(file.map(0, fileSize));
+    if (begin == NULL) {
+        contents = file.readAll();
+        begin = contents.constData();
+        fileSize = contents.size();
+    }
+    const char *end = begin + fileSize;
+
+    const char *headerEnd = static_cast<const char *>(memchr(begin, '\n', fileSize));
+    if (headerEnd == NULL)
+        headerEnd = end;
+
+    QStringList headings;
+    if (this->parseHeader(begin, headerEnd, headings) == false) {
+        file.close();
+        return -1;
+    }
+    theData.setHeadings(headings);
+
+    int numRows = 0;
+    if (headerEnd < end)
+        numRows = this->parseLines(headerEnd+1, end, theData);
+
+    file.close();  // also unmaps
+
+    return numRows;
+}
@@ -0,0 +1,88 @@
+#ifndef DAKOTA_TAB_PARSER_H
+#define DAKOTA_TAB_PARSER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// reader for the dakotaTab.out files shared by the result widgets. the file is
+// memory mapped and split into line aligned chunks that are parsed in parallel
+// directly into the columns of a SampleDataStore. as before the "interface"
+// column dakota writes is skipped and the eval_id column becomes "Run #".
+// if given a set of QuantileSketch, one per column, each chunk also sketches
+// the rows it parsed while they are still in cache and the chunk sketches are
+// merged into them, so the quantiles are kept up to date as rows arrive
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class SampleDataStore;
+class QuantileSketch;
+
+class DakotaTabParser
+{
+public:
+    DakotaTabParser();
+    ~DakotaTabParser();
+
+    // read the whole file into theData, returns number of rows read or -1 on error
+    int parseFile(const QString &filename, SampleDataStore &theData);
+
+    // parse the heading line, sets the headings and which token to skip
+    bool parseHeader(const char *begin, const char *end, QStringList &headings);
+
+    // parse complete lines in [begin,end) appending the rows to theData,
+    // the header must have been parsed first. returns number of rows added
+    int parseLines(const char *begin, const char *end, SampleDataStore &theData);
+
+    // parse the number at p, returns the position just after it; exact for the
+    // %.10e values dakota writes, used by the other dakota output readers
+    static const char *parseNumber(const char *p, const char *end, double &value);
+
+    // sketches to update, resized to the columns when the header is parsed
+    void setSketches(QVector<QuantileSketch> *theSketches);
+
+    int getInterfaceToken(void) const;
+    QString getErrorMessage(void) const;
+
+private:
+    int numTokens;        // tokens per line in the file
+    int interfaceToken;   // token to skip, -1 if none
+    QString errorMessage;
+    QVector<QuantileSketch> *theSketches;
+};
+
+#endif // DAKOTA_TAB_PARSER_H
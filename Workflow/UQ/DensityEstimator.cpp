@@ -0,0 +1,390 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DensityEstimator.h"
+#include <SampleDataStore.h>
+#include <SampleColumnCache.h>
+
+#include <algorithm>
+#include <complex>
+#include <math.h>
+#include <utility>
+
+#define MAX_BINS 1000          // more than a chart can show
+#define KDE_GRID_SIZE 1024     // points the density is evaluated at
+#define KDE_TAIL 3.0           // bandwidths the grid extends past the samples
+#define KERNEL_SUPPORT 4.0     // bandwidths the kernel is truncated at
+
+ColumnDensity::ColumnDensity()
+    :numRows(-1), binRule(0), min(0), max(0), binStart(0), binWidth(0), bandwidth(0)
+{
+
+}
+
+//
+// in place radix 2 FFT, n a power of 2; inverse without the 1/n scaling
+//
+
+static void fft(std::vector<std::complex<double> > &a, bool inverse)
+{
+    int n = static_cast<int>(a.size());
+    for (int i=1, j=0; i<n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+
+    for (int length=2; length<=n; length <<= 1) {
+        double angle = 2*M_PI/length * (inverse ? 1 : -1);
+        std::complex<double> step(cos(angle), sin(angle));
+        for (int i=0; i<n; i += length) {
+            std::complex<double> w(1.0);
+            for (int k=0; k<length/2; k++) {
+                std::complex<double> u = a[i+k];
+                std::complex<double> v = a[i+k+length/2]*w;
+                a[i+k] = u+v;
+                a[i+k+length/2] = u-v;
+                w *= step;
+            }
+        }
+    }
+}
+
+// value below which a fraction p of the total weight lies, values sorted
+static double weightedQuantile(const std::vector<std::pair<double, double> > &sorted, double total, double p)
+{
+    double target = p*total;
+    double sum = 0;
+    for (size_t i=0; i<sorted.size(); i++) {
+        sum += sorted[i].second;
+        if (sum >= target)
+            return sorted[i].first;
+    }
+    return sorted.back().first;
+}
+
+// linear interpolation between order statistics, as for the summary
+static double quantile(const double *sorted, int numValues, double p)
+{
+    double position = p*(numValues-1);
+    int below = static_cast<int>(position);
+    if (below+1 >= numValues)
+        return sorted[numValues-1];
+    double f = position-below;
+    return sorted[below] + f*(sorted[below+1]-sorted[below]);
+}
+
+DensityEstimator::DensityEstimator(const SampleDataStore *data, SampleColumnCache *cache)
+    :theData(data), theColumnCache(cache), binRule(FreedmanDiaconis)
+{
+
+}
+
+DensityEstimator::~DensityEstimator()
+{
+
+}
+
+void
+DensityEstimator::clear(void)
+{
+    theDensities.clear();
+}
+
+void
+DensityEstimator::setBinRule(BinRule rule)
+{
+    binRule = rule;
+}
+
+DensityEstimator::BinRule
+DensityEstimator::getBinRule(void) const
+{
+    return binRule;
+}
+
+void
+DensityEstimator::setWeights(const std::vector<double> &weights)
+{
+    theWeights = weights;
+    theDensities.clear();
+}
+
+int
+DensityEstimator::getNumBins(BinRule rule, double numSamples, double stdDev, double iqr, double range)
+{
+    if (!(range > 0) || numSamples < 2)
+        return 1;
+
+    // Freedman-Diaconis is robust to outliers but fails if half the samples
+    // share a value, Scott then
+    double width = 0;
+    if (rule == FreedmanDiaconis && iqr > 0)
+        width = 2.0*iqr*pow(numSamples, -1.0/3.0);
+    else
+        width = 3.49*stdDev*pow(numSamples, -1.0/3.0);
+
+    if (!(width > 0))
+        return 1;
+
+    double numBins = ceil(range/width);
+    return static_cast<int>(qBound(1.0, numBins, static_cast<double>(MAX_BINS)));
+}
+
+double
+DensityEstimator::getBandwidth(double numSamples, double stdDev, double iqr, double range)
+{
+    // Silverman's rule of thumb
+    double spread = stdDev;
+    if (iqr > 0 && iqr/1.34 < spread)
+        spread = iqr/1.34;
+
+    double bandwidth = 0.9*spread*pow(qMax(numSamples, 1.0), -0.2);
+    if (!(bandwidth > 0))
+        bandwidth = (range > 0) ? range/100 : 1.0;
+    return bandwidth;
+}
+
+void
+DensityEstimator::computeHistogram(const double *values, const double *weights, int numValues,
+                                   double binStart, double binWidth, int numBins, QVector<double> &histogram)
+{
+    histogram.fill(0., numBins);
+    if (numValues == 0 || numBins == 0)
+        return;
+
+    double total = 0;
+    double scale = (binWidth > 0) ? 1.0/binWidth : 0;
+    double *bins = histogram.data();
+    for (int i=0; i<numValues; i++) {
+        int bin = static_cast<int>((values[i]-binStart)*scale);
+        bin = qBound(0, bin, numBins-1);   // the maximum falls in the last bin
+        double w = weights ? weights[i] : 1.0;
+        bins[bin] += w;
+        total += w;
+    }
+
+    // probability density, integrates to 1
+    double norm = (total > 0 && binWidth > 0) ? 1.0/(total*binWidth) : 0;
+    for (int i=0; i<numBins; i++)
+        bins[i] *= norm;
+}
+
+void
+DensityEstimator::computeKernelDensity(const double *values, const double *weights, int numValues,
+                                       double min, double max, double bandwidth, int gridSize,
+                                       QVector<QPointF> &density)
+{
+    density.clear();
+    if (numValues == 0 || !(bandwidth > 0) || gridSize < 2)
+        return;
+
+    //
+    // linear binning: each sample split between the two grid points around it
+    //
+
+    double start = min - KDE_TAIL*bandwidth;
+    double end = max + KDE_TAIL*bandwidth;
+    double delta = (end-start)/(gridSize-1);
+
+    std::vector<double> counts(gridSize, 0.0);
+    double total = 0;
+    for (int i=0; i<numValues; i++) {
+        double position = (values[i]-start)/delta;
+        int j = static_cast<int>(position);
+        if (j < 0 || j >= gridSize-1)
+            continue;
+        double f = position-j;
+        double w = weights ? weights[i] : 1.0;
+        counts[j] += w*(1-f);
+        counts[j+1] += w*f;
+        total += w;
+    }
+    if (!(total > 0))
+        return;
+
+    //
+    // convolve with the kernel, zero padded so the ends do not wrap around
+    //
+
+    int support = static_cast<int>(qMin(ceil(KERNEL_SUPPORT*bandwidth/delta), static_cast<double>(gridSize-1)));
+    int size = 1;
+    while (size < gridSize + 2*support)
+        size <<= 1;
+
+    std::vector<std::complex<double> > binned(size), kernel(size);
+    for (int j=0; j<gridSize; j++)
+        binned[j] = counts[j];
+
+    double norm = 1.0/(sqrt(2*M_PI)*bandwidth*total);
+    for (int l=0; l<=support; l++) {
+        double u = l*delta/bandwidth;
+        double k = norm*exp(-0.5*u*u);
+        kernel[l] = k;
+        if (l != 0)
+            kernel[size-l] = k;
+    }
+
+    fft(binned, false);
+    fft(kernel, false);
+    for (int i=0; i<size; i++)
+        binned[i] *= kernel[i];
+    fft(binned, true);
+
+    density.reserve(gridSize);
+    for (int j=0; j<gridSize; j++)
+        density.append(QPointF(start + j*delta, qMax(0.0, binned[j].real()/size)));
+}
+
+void
+DensityEstimator::computeStatistics(const double *values, const double *weights, int numValues,
+                                    double &numSamples, double &stdDev, double &iqr, double &min, double &max)
+{
+    if (weights == NULL) {
+        min = values[0];
+        max = values[numValues-1];
+        iqr = quantile(values, numValues, 0.75) - quantile(values, numValues, 0.25);
+        numSamples = numValues;
+
+        double sum = 0;
+        for (int i=0; i<numValues; i++)
+            sum += values[i];
+        double mean = sum/numValues;
+        double sumSq = 0;
+        for (int i=0; i<numValues; i++)
+            sumSq += (values[i]-mean)*(values[i]-mean);
+        stdDev = (numValues > 1) ? sqrt(sumSq/(numValues-1)) : 0;
+        return;
+    }
+
+    //
+    // weighted: moments, effective sample size and quantiles of the weights
+    //
+
+    double sumW = 0, sumW2 = 0, sumWX = 0;
+    std::vector<std::pair<double, double> > sorted(numValues);
+    for (int i=0; i<numValues; i++) {
+        double w = weights[i];
+        sumW += w;
+        sumW2 += w*w;
+        sumWX += w*values[i];
+        sorted[i] = std::make_pair(values[i], w);
+    }
+    double mean = (sumW > 0) ? sumWX/sumW : 0;
+    double sumWXX = 0;
+    for (int i=0; i<numValues; i++)
+        sumWXX += weights[i]*(values[i]-mean)*(values[i]-mean);
+
+    numSamples = (sumW2 > 0) ? sumW*sumW/sumW2 : 0;
+    stdDev = (sumW > 0) ? sqrt(sumWXX/sumW) : 0;
+
+    std::sort(sorted.begin(), sorted.end());
+    min = sorted.front().first;
+    max = sorted.back().first;
+    iqr = weightedQuantile(sorted, sumW, 0.75) - weightedQuantile(sorted, sumW, 0.25);
+}
+
+const ColumnDensity &
+DensityEstimator::getDensity(int col)
+{
+    if (col >= static_cast<int>(theDensities.size()))
+        theDensities.resize(theData->getNumColumns());
+
+    ColumnDensity &theDensity = theDensities[col];
+    int numRows = theColumnCache->getNumRows();
+    if (theDensity.numRows == numRows && theDensity.binRule == binRule)
+        return theDensity;
+
+    theDensity = ColumnDensity();
+    if (numRows == 0)
+        return theDensity;
+
+    // without weights the order of the values does not matter, the sorted
+    // column serves for the quantiles and the estimates alike and already
+    // holds only the rows in use, less any NaN
+    const double *values = NULL;
+    const double *weights = NULL;
+    int numValues = numRows;
+    std::vector<double> subsetValues, subsetWeights;
+    if (static_cast<int>(theWeights.size()) != theData->getNumRows()) {
+        const std::vector<double> &sorted = theColumnCache->getSortedColumn(col);
+        values = sorted.data();
+        numValues = static_cast<int>(sorted.size());
+        if (numValues == 0)
+            return theDensity;
+    } else {
+        values = theData->getColumn(col);
+        weights = theWeights.data();
+        const std::vector<int> *rows = theColumnCache->getRows();
+        if (rows != NULL) {
+            subsetValues.resize(numRows);
+            subsetWeights.resize(numRows);
+            for (int i=0; i<numRows; i++) {
+                subsetValues[i] = values[(*rows)[i]];
+                subsetWeights[i] = weights[(*rows)[i]];
+            }
+            values = subsetValues.data();
+            weights = subsetWeights.data();
+        }
+    }
+
+    double numSamples, stdDev, iqr, min, max;
+    this->computeStatistics(values, weights, numValues, numSamples, stdDev, iqr, min, max);
+    double range = max-min;
+
+    int numBins = getNumBins(binRule, numSamples, stdDev, iqr, range);
+    theDensity.min = min;
+    theDensity.max = max;
+    if (range > 0) {
+        theDensity.binStart = min;
+        theDensity.binWidth = range/numBins;
+    } else {
+        // all the same value, one bin around it
+        theDensity.binWidth = (min != 0) ? fabs(min)*0.1 : 1.0;
+        theDensity.binStart = min - 0.5*theDensity.binWidth;
+    }
+    computeHistogram(values, weights, numValues, theDensity.binStart, theDensity.binWidth, numBins, theDensity.histogram);
+
+    theDensity.bandwidth = getBandwidth(numSamples, stdDev, iqr, range);
+    computeKernelDensity(values, weights, numValues, min, max, theDensity.bandwidth, KDE_GRID_SIZE, theDensity.density);
+
+    theDensity.numRows = numRows;
+    theDensity.binRule = binRule;
+    return theDensity;
+}
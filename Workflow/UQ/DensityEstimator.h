@@ -0,0 +1,123 @@
+#ifndef DENSITY_ESTIMATOR_H
+#define DENSITY_ESTIMATOR_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// histograms and kernel density estimates of the columns of a
+// SampleDataStore, computed once per column and kept until the column grows,
+// the bin rule or the weights change, so switching plots does not recompute.
+//  - histogram bins by the Freedman-Diaconis (2 IQR n^-1/3) or Scott
+//    (3.49 sd n^-1/3) rule, the values are probability densities
+//  - kernel density: Gaussian kernel with Silverman's bandwidth, the samples
+//    linearly binned onto an even grid that is convolved with the kernel by
+//    FFT, so the cost is one pass over the samples plus a small FFT
+// samples may carry weights, e.g. the likelihood ratios of importance
+// sampling; n is then the effective sample size (sum w)^2/sum w^2. a subset
+// of rows, e.g. those passing a SampleFilter, is taken from the column cache
+
+#include <QVector>
+#include <QPointF>
+#include <vector>
+
+class SampleDataStore;
+class SampleColumnCache;
+
+class ColumnDensity
+{
+public:
+    ColumnDensity();
+
+    int numRows;                 // rows used when computed, -1 if not
+    int binRule;
+    double min;
+    double max;
+    double binStart;
+    double binWidth;
+    QVector<double> histogram;   // probability density in each bin
+    double bandwidth;
+    QVector<QPointF> density;    // (x, density) on an even grid
+};
+
+class DensityEstimator
+{
+public:
+    enum BinRule {
+        FreedmanDiaconis = 0,
+        Scott
+    };
+
+    // the cache provides sorted columns for quantiles when there are no weights
+    DensityEstimator(const SampleDataStore *theData, SampleColumnCache *theColumnCache);
+    ~DensityEstimator();
+
+    // to be called when the rows of the column cache are changed
+    void clear(void);
+    void setBinRule(BinRule rule);
+    BinRule getBinRule(void) const;
+
+    // one weight per row, an empty vector for equal weights
+    void setWeights(const std::vector<double> &weights);
+
+    const ColumnDensity &getDensity(int col);
+
+    //
+    // the pieces, for use on any array
+    //
+
+    static int getNumBins(BinRule rule, double numSamples, double stdDev, double iqr, double range);
+    static double getBandwidth(double numSamples, double stdDev, double iqr, double range);
+
+    // weights may be NULL, densities are relative to the total weight
+    static void computeHistogram(const double *values, const double *weights, int numValues,
+                                 double binStart, double binWidth, int numBins, QVector<double> &histogram);
+    static void computeKernelDensity(const double *values, const double *weights, int numValues,
+                                     double min, double max, double bandwidth, int gridSize,
+                                     QVector<QPointF> &density);
+
+private:
+    // values sorted if weights is NULL
+    void computeStatistics(const double *values, const double *weights, int numValues,
+                           double &numSamples, double &stdDev, double &iqr, double &min, double &max);
+
+    const SampleDataStore *theData;
+    SampleColumnCache *theColumnCache;
+    BinRule binRule;
+    std::vector<double> theWeights;
+    std::vector<ColumnDensity> theDensities;
+};
+
+#endif // DENSITY_ESTIMATOR_H
@@ -0,0 +1,743 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "DistributionFitter.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+#define MAX_NEWTON_STEPS 50
+#define NEWTON_TOLERANCE 1e-10
+#define KS_KNOTS 2048          // samples the fitted CDF is first evaluated at
+
+DistributionFit::DistributionFit()
+    :type(0), ok(false), numParameters(0), logLikelihood(NAN), aic(NAN), ks(NAN)
+{
+    for (int i=0; i<MAX_FIT_PARAMETERS; i++)
+        parameters[i] = NAN;
+}
+
+//
+// distributions, parameters as the random variable widgets take them
+//  - normal: mean, standard deviation
+//  - lognormal: lambda and zeta, the mean and standard deviation of ln x
+//  - Gumbel (largest value): alpha = 1/scale, beta = location
+//  - Weibull: shape, scale
+//  - beta: alpha, beta, lower bound, upper bound
+//  - gamma: shape k, scale theta
+//
+
+double
+DistributionFit::pdf(double x) const
+{
+    const double *p = parameters;
+    switch (type) {
+    case DistributionFitter::Normal: {
+        double z = (x-p[0])/p[1];
+        return exp(-0.5*z*z)/(sqrt(2*M_PI)*p[1]);
+    }
+    case DistributionFitter::Lognormal: {
+        if (!(x > 0))
+            return 0;
+        double z = (log(x)-p[0])/p[1];
+        return exp(-0.5*z*z)/(sqrt(2*M_PI)*p[1]*x);
+    }
+    case DistributionFitter::Gumbel: {
+        double z = exp(-p[0]*(x-p[1]));
+        return p[0]*z*exp(-z);
+    }
+    case DistributionFitter::Weibull: {
+        if (x < 0)
+            return 0;
+        double z = x/p[1];
+        return p[0]/p[1]*pow(z, p[0]-1)*exp(-pow(z, p[0]));
+    }
+    case DistributionFitter::Beta: {
+        if (!(x > p[2] && x < p[3]))
+            return 0;
+        double u = (x-p[2])/(p[3]-p[2]);
+        return exp((p[0]-1)*log(u) + (p[1]-1)*log(1-u) + lgamma(p[0]+p[1]) - lgamma(p[0]) - lgamma(p[1]))/(p[3]-p[2]);
+    }
+    case DistributionFitter::Gamma: {
+        if (!(x > 0))
+            return 0;
+        return exp((p[0]-1)*log(x) - x/p[1] - lgamma(p[0]) - p[0]*log(p[1]));
+    }
+    }
+    return 0;
+}
+
+double
+DistributionFit::cdf(double x) const
+{
+    const double *p = parameters;
+    switch (type) {
+    case DistributionFitter::Normal:
+        return 0.5*erfc(-(x-p[0])/(p[1]*sqrt(2.0)));
+    case DistributionFitter::Lognormal:
+        if (!(x > 0))
+            return 0;
+        return 0.5*erfc(-(log(x)-p[0])/(p[1]*sqrt(2.0)));
+    case DistributionFitter::Gumbel:
+        return exp(-exp(-p[0]*(x-p[1])));
+    case DistributionFitter::Weibull:
+        if (x < 0)
+            return 0;
+        return 1-exp(-pow(x/p[1], p[0]));
+    case DistributionFitter::Beta:
+        if (!(x > p[2]))
+            return 0;
+        if (!(x < p[3]))
+            return 1;
+        return DistributionFitter::incompleteBeta(p[0], p[1], (x-p[2])/(p[3]-p[2]));
+    case DistributionFitter::Gamma:
+        if (!(x > 0))
+            return 0;
+        return DistributionFitter::incompleteGamma(p[0], x/p[1]);
+    }
+    return 0;
+}
+
+QString
+DistributionFit::getParameterText(void) const
+{
+    QStringList names = DistributionFitter::getParameterNames(type);
+    QString text;
+    for (int i=0; i<numParameters; i++) {
+        if (i != 0)
+            text += QString(", ");
+        text += names.at(i) + QString(" = ") + QString::number(parameters[i], 'g', 5);
+    }
+    return text;
+}
+
+//
+// special functions
+//
+
+double
+DistributionFitter::digamma(double x)
+{
+    double result = 0;
+    while (x < 10) {
+        result -= 1/x;
+        x += 1;
+    }
+    double f = 1/(x*x);
+    return result + log(x) - 0.5/x - f*(1.0/12 - f*(1.0/120 - f*(1.0/252 - f*(1.0/240 - f/132))));
+}
+
+double
+DistributionFitter::trigamma(double x)
+{
+    double result = 0;
+    while (x < 10) {
+        result += 1/(x*x);
+        x += 1;
+    }
+    double f = 1/(x*x);
+    return result + 1/x + 0.5*f + (1/x)*f*(1.0/6 - f*(1.0/30 - f*(1.0/42 - f/30)));
+}
+
+double
+DistributionFitter::incompleteGamma(double a, double x)
+{
+    if (!(x > 0))
+        return 0;
+    double logPrefix = a*log(x) - x - lgamma(a);
+
+    if (x < a+1) {
+        // series
+        double term = 1/a;
+        double sum = term;
+        for (int n=1; n<1000; n++) {
+            term *= x/(a+n);
+            sum += term;
+            if (fabs(term) < fabs(sum)*1e-15)
+                break;
+        }
+        return sum*exp(logPrefix);
+    }
+
+    // continued fraction for Q, modified Lentz
+    double tiny = 1e-300;
+    double b = x+1-a;
+    double c = 1/tiny;
+    double d = 1/b;
+    double h = d;
+    for (int n=1; n<1000; n++) {
+        double an = -n*(n-a);
+        b += 2;
+        d = an*d + b;
+        if (fabs(d) < tiny)
+            d = tiny;
+        c = b + an/c;
+        if (fabs(c) < tiny)
+            c = tiny;
+        d = 1/d;
+        double delta = d*c;
+        h *= delta;
+        if (fabs(delta-1) < 1e-15)
+            break;
+    }
+    return 1 - exp(logPrefix)*h;
+}
+
+// continued fraction for the incomplete beta function, modified Lentz
+static double betaFraction(double a, double b, double x)
+{
+    double tiny = 1e-300;
+    double qab = a+b;
+    double qap = a+1;
+    double qam = a-1;
+    double c = 1;
+    double d = 1 - qab*x/qap;
+    if (fabs(d) < tiny)
+        d = tiny;
+    d = 1/d;
+    double h = d;
+    for (int m=1; m<1000; m++) {
+        int m2 = 2*m;
+        double aa = m*(b-m)*x/((qam+m2)*(a+m2));
+        d = 1 + aa*d;
+        if (fabs(d) < tiny)
+            d = tiny;
+        c = 1 + aa/c;
+        if (fabs(c) < tiny)
+            c = tiny;
+        d = 1/d;
+        h *= d*c;
+        aa = -(a+m)*(qab+m)*x/((a+m2)*(qap+m2));
+        d = 1 + aa*d;
+        if (fabs(d) < tiny)
+            d = tiny;
+        c = 1 + aa/c;
+        if (fabs(c) < tiny)
+            c = tiny;
+        d = 1/d;
+        double delta = d*c;
+        h *= delta;
+        if (fabs(delta-1) < 1e-15)
+            break;
+    }
+    return h;
+}
+
+double
+DistributionFitter::incompleteBeta(double a, double b, double x)
+{
+    if (!(x > 0))
+        return 0;
+    if (!(x < 1))
+        return 1;
+    double logPrefix = lgamma(a+b) - lgamma(a) - lgamma(b) + a*log(x) + b*log(1-x);
+    if (x < (a+1)/(a+b+2))
+        return exp(logPrefix)*betaFraction(a, b, x)/a;
+    return 1 - exp(logPrefix)*betaFraction(b, a, 1-x)/b;
+}
+
+//
+// the fits
+//
+
+static double sampleMean(const std::vector<double> &values)
+{
+    double sum = 0;
+    for (size_t i=0; i<values.size(); i++)
+        sum += values[i];
+    return sum/values.size();
+}
+
+static double sampleVariance(const std::vector<double> &values, double mean)
+{
+    double sum = 0;
+    for (size_t i=0; i<values.size(); i++)
+        sum += (values[i]-mean)*(values[i]-mean);
+    return sum/values.size();
+}
+
+static void setAIC(DistributionFit &theFit)
+{
+    theFit.aic = 2*theFit.numParameters - 2*theFit.logLikelihood;
+    theFit.ok = (theFit.aic == theFit.aic);
+}
+
+DistributionFit
+DistributionFitter::fitNormal(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Normal;
+    theFit.numParameters = 2;
+
+    double n = sorted.size();
+    double mean = sampleMean(sorted);
+    double variance = sampleVariance(sorted, mean);
+    if (!(variance > 0))
+        return theFit;
+
+    theFit.parameters[0] = mean;
+    theFit.parameters[1] = sqrt(variance);
+    theFit.logLikelihood = -0.5*n*(log(2*M_PI*variance) + 1);
+    setAIC(theFit);
+    return theFit;
+}
+
+DistributionFit
+DistributionFitter::fitLognormal(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Lognormal;
+    theFit.numParameters = 2;
+    if (!(sorted.front() > 0))
+        return theFit;
+
+    double n = sorted.size();
+    std::vector<double> logs(sorted.size());
+    for (size_t i=0; i<sorted.size(); i++)
+        logs[i] = log(sorted[i]);
+    double mean = sampleMean(logs);
+    double variance = sampleVariance(logs, mean);
+    if (!(variance > 0))
+        return theFit;
+
+    theFit.parameters[0] = mean;
+    theFit.parameters[1] = sqrt(variance);
+    theFit.logLikelihood = -0.5*n*(log(2*M_PI*variance) + 1) - n*mean;
+    setAIC(theFit);
+    return theFit;
+}
+
+DistributionFit
+DistributionFitter::fitGumbel(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Gumbel;
+    theFit.numParameters = 2;
+
+    // scale b solves b = mean - sum x w/sum w with w = exp(-x/b); with
+    // y = x-min the weights are at most 1 and can not overflow
+    double n = sorted.size();
+    double min = sorted.front();
+    double meanY = sampleMean(sorted) - min;
+    double variance = sampleVariance(sorted, meanY+min);
+    if (!(variance > 0))
+        return theFit;
+
+    double b = sqrt(6*variance)/M_PI;
+    double sumW = 0;
+    for (int step=0; step<MAX_NEWTON_STEPS; step++) {
+        double A = 0, B = 0, C = 0;
+        for (size_t i=0; i<sorted.size(); i++) {
+            double y = sorted[i]-min;
+            double w = exp(-y/b);
+            A += w;
+            B += y*w;
+            C += y*y*w;
+        }
+        sumW = A;
+        double g = b - meanY + B/A;
+        double dg = 1 + (C*A - B*B)/(b*b*A*A);
+        double newB = b - g/dg;
+        if (!(newB > 0))
+            newB = 0.5*b;
+        bool done = fabs(newB-b) < NEWTON_TOLERANCE*b;
+        b = newB;
+        if (done)
+            break;
+    }
+
+    sumW = 0;
+    for (size_t i=0; i<sorted.size(); i++)
+        sumW += exp(-(sorted[i]-min)/b);
+    double location = min - b*log(sumW/n);
+
+    theFit.parameters[0] = 1/b;
+    theFit.parameters[1] = location;
+    // at the optimum sum exp(-(x-location)/b) = n
+    theFit.logLikelihood = -n*log(b) - n*(meanY+min-location)/b - n;
+    setAIC(theFit);
+    return theFit;
+}
+
+DistributionFit
+DistributionFitter::fitWeibull(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Weibull;
+    theFit.numParameters = 2;
+    if (!(sorted.front() > 0))
+        return theFit;
+
+    // shape k solves sum x^k ln x/sum x^k - 1/k - mean ln x = 0; with
+    // t = ln(x/max) <= 0 the powers exp(k t) can not overflow
+    double n = sorted.size();
+    double logMax = log(sorted.back());
+    std::vector<double> t(sorted.size());
+    for (size_t i=0; i<sorted.size(); i++)
+        t[i] = log(sorted[i]) - logMax;
+    double meanT = sampleMean(t);
+    double varianceT = sampleVariance(t, meanT);
+    if (!(varianceT > 0))
+        return theFit;
+
+    double k = 1.2/sqrt(varianceT);
+    double A = 0;
+    for (int step=0; step<MAX_NEWTON_STEPS; step++) {
+        double B = 0, C = 0;
+        A = 0;
+        for (size_t i=0; i<t.size(); i++) {
+            double w = exp(k*t[i]);
+            A += w;
+            B += w*t[i];
+            C += w*t[i]*t[i];
+        }
+        double h = B/A - 1/k - meanT;
+        double dh = (C*A - B*B)/(A*A) + 1/(k*k);
+        double newK = k - h/dh;
+        if (!(newK > 0))
+            newK = 0.5*k;
+        bool done = fabs(newK-k) < NEWTON_TOLERANCE*k;
+        k = newK;
+        if (done)
+            break;
+    }
+
+    A = 0;
+    for (size_t i=0; i<t.size(); i++)
+        A += exp(k*t[i]);
+    double logScale = logMax + log(A/n)/k;
+
+    theFit.parameters[0] = k;
+    theFit.parameters[1] = exp(logScale);
+    // at the optimum sum (x/scale)^k = n
+    theFit.logLikelihood = n*log(k) - n*k*logScale + (k-1)*n*(meanT+logMax) - n;
+    setAIC(theFit);
+    return theFit;
+}
+
+DistributionFit
+DistributionFitter::fitBeta(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Beta;
+    theFit.numParameters = 4;
+
+    // the bounds are the end points widened by a sample spacing, as for a
+    // uniform distribution; the shapes are then the usual two parameter MLE
+    double n = sorted.size();
+    double range = sorted.back()-sorted.front();
+    if (!(range > 0) || n < 3)
+        return theFit;
+    double lower = sorted.front() - range/(n-1);
+    double upper = sorted.back() + range/(n-1);
+    double width = upper-lower;
+
+    double sumU = 0, sumUU = 0, G1 = 0, G2 = 0;
+    for (size_t i=0; i<sorted.size(); i++) {
+        double u = (sorted[i]-lower)/width;
+        sumU += u;
+        sumUU += u*u;
+        G1 += log(u);
+        G2 += log(1-u);
+    }
+    G1 /= n;
+    G2 /= n;
+    double mean = sumU/n;
+    double variance = sumUU/n - mean*mean;
+
+    // moments to start
+    double common = mean*(1-mean)/variance - 1;
+    double a = (common > 0) ? mean*common : 1;
+    double b = (common > 0) ? (1-mean)*common : 1;
+
+    for (int step=0; step<MAX_NEWTON_STEPS; step++) {
+        double psiAB = digamma(a+b);
+        double f1 = digamma(a) - psiAB - G1;
+        double f2 = digamma(b) - psiAB - G2;
+        double tAB = trigamma(a+b);
+        double j11 = trigamma(a) - tAB;
+        double j22 = trigamma(b) - tAB;
+        double j12 = -tAB;
+        double det = j11*j22 - j12*j12;
+        if (!(det != 0))
+            break;
+        double da = (j22*f1 - j12*f2)/det;
+        double db = (j11*f2 - j12*f1)/det;
+        double newA = a - da;
+        double newB = b - db;
+        if (!(newA > 0))
+            newA = 0.5*a;
+        if (!(newB > 0))
+            newB = 0.5*b;
+        bool done = fabs(newA-a) < NEWTON_TOLERANCE*a && fabs(newB-b) < NEWTON_TOLERANCE*b;
+        a = newA;
+        b = newB;
+        if (done)
+            break;
+    }
+
+    theFit.parameters[0] = a;
+    theFit.parameters[1] = b;
+    theFit.parameters[2] = lower;
+    theFit.parameters[3] = upper;
+    theFit.logLikelihood = n*((a-1)*G1 + (b-1)*G2 + lgamma(a+b) - lgamma(a) - lgamma(b) - log(width));
+    setAIC(theFit);
+    return theFit;
+}
+
+DistributionFit
+DistributionFitter::fitGamma(const std::vector<double> &sorted)
+{
+    DistributionFit theFit;
+    theFit.type = Gamma;
+    theFit.numParameters = 2;
+    if (!(sorted.front() > 0))
+        return theFit;
+
+    double n = sorted.size();
+    double mean = 0, meanLog = 0;
+    for (size_t i=0; i<sorted.size(); i++) {
+        mean += sorted[i];
+        meanLog += log(sorted[i]);
+    }
+    mean /= n;
+    meanLog /= n;
+    double s = log(mean) - meanLog;
+    if (!(s > 0))
+        return theFit;
+
+    // shape solves ln k - digamma(k) = s, from Minka's approximation
+    double k = (3 - s + sqrt((s-3)*(s-3) + 24*s))/(12*s);
+    for (int step=0; step<MAX_NEWTON_STEPS; step++) {
+        double f = log(k) - digamma(k) - s;
+        double df = 1/k - trigamma(k);
+        double newK = k - f/df;
+        if (!(newK > 0))
+            newK = 0.5*k;
+        bool done = fabs(newK-k) < NEWTON_TOLERANCE*k;
+        k = newK;
+        if (done)
+            break;
+    }
+    double theta = mean/k;
+
+    theFit.parameters[0] = k;
+    theFit.parameters[1] = theta;
+    theFit.logLikelihood = n*((k-1)*meanLog - k - lgamma(k) - k*log(theta));
+    setAIC(theFit);
+    return theFit;
+}
+
+double
+DistributionFitter::ksDistance(const DistributionFit &theFit, const std::vector<double> &sorted)
+{
+    int n = static_cast<int>(sorted.size());
+    if (n == 0 || !theFit.ok)
+        return NAN;
+
+    // at sample i the empirical CDF steps from i/n to (i+1)/n
+    double scale = 1.0/n;
+    int step = std::max(1, n/KS_KNOTS);
+    std::vector<int> knots;
+    for (int i=0; i<n; i+=step)
+        knots.push_back(i);
+    if (knots.back() != n-1)
+        knots.push_back(n-1);
+
+    std::vector<double> F(knots.size());
+    double distance = 0;
+    for (size_t k=0; k<knots.size(); k++) {
+        int i = knots[k];
+        F[k] = theFit.cdf(sorted[i]);
+        distance = std::max(distance, std::max(F[k] - i*scale, (i+1)*scale - F[k]));
+    }
+
+    // between two knots the fitted CDF lies between its values at them, so
+    // the distance there is at most bound; look inside largest bound first
+    std::vector<std::pair<double, int> > stretches;
+    for (size_t k=0; k+1<knots.size(); k++) {
+        if (knots[k+1]-knots[k] < 2)
+            continue;
+        double bound = std::max(F[k+1] - (knots[k]+1)*scale, knots[k+1]*scale - F[k]);
+        stretches.push_back(std::make_pair(bound, static_cast<int>(k)));
+    }
+    std::sort(stretches.begin(), stretches.end());
+
+    for (int s=static_cast<int>(stretches.size())-1; s>=0; s--) {
+        if (stretches[s].first <= distance)
+            break;
+        int k = stretches[s].second;
+        for (int i=knots[k]+1; i<knots[k+1]; i++) {
+            double Fi = theFit.cdf(sorted[i]);
+            distance = std::max(distance, std::max(Fi - i*scale, (i+1)*scale - Fi));
+        }
+    }
+
+    return distance;
+}
+
+//
+// the fitter
+//
+
+DistributionFitter::DistributionFitter()
+{
+
+}
+
+DistributionFitter::~DistributionFitter()
+{
+
+}
+
+QString
+DistributionFitter::getName(int type)
+{
+    switch (type) {
+    case Normal:
+        return QString("Normal");
+    case Lognormal:
+        return QString("Lognormal");
+    case Gumbel:
+        return QString("Gumbel");
+    case Weibull:
+        return QString("Weibull");
+    case Beta:
+        return QString("Beta");
+    case Gamma:
+        return QString("Gamma");
+    }
+    return QString();
+}
+
+QStringList
+DistributionFitter::getParameterNames(int type)
+{
+    switch (type) {
+    case Normal:
+        return QStringList() << "mean" << "stdDev";
+    case Lognormal:
+        return QStringList() << "lambda" << "zeta";
+    case Gumbel:
+        return QStringList() << "alpha" << "beta";
+    case Weibull:
+        return QStringList() << "shape" << "scale";
+    case Beta:
+        return QStringList() << "alpha" << "beta" << "lower" << "upper";
+    case Gamma:
+        return QStringList() << "k" << "theta";
+    }
+    return QStringList();
+}
+
+void
+DistributionFitter::setValues(const double *values, int numValues)
+{
+    theValues.assign(values, values+numValues);
+    std::sort(theValues.begin(), theValues.end());
+    theFits.clear();
+}
+
+void
+DistributionFitter::clear(void)
+{
+    theValues.clear();
+    theFits.clear();
+}
+
+static bool betterFit(const DistributionFit &a, const DistributionFit &b)
+{
+    if (a.ok != b.ok)
+        return a.ok;
+    return a.aic < b.aic;
+}
+
+void
+DistributionFitter::fit(void)
+{
+    theFits.clear();
+    if (theValues.size() < 3)
+        return;
+
+    QVector<DistributionFit> fits;
+    for (int type=0; type<NumTypes; type++) {
+        DistributionFit theFit;
+        theFit.type = type;
+        fits.append(theFit);
+    }
+
+    const std::vector<double> &sorted = theValues;
+    QtConcurrent::blockingMap(fits, [&sorted](DistributionFit &theFit) {
+        switch (theFit.type) {
+        case Normal:
+            theFit = fitNormal(sorted);
+            break;
+        case Lognormal:
+            theFit = fitLognormal(sorted);
+            break;
+        case Gumbel:
+            theFit = fitGumbel(sorted);
+            break;
+        case Weibull:
+            theFit = fitWeibull(sorted);
+            break;
+        case Beta:
+            theFit = fitBeta(sorted);
+            break;
+        case Gamma:
+            theFit = fitGamma(sorted);
+            break;
+        }
+        theFit.ks = ksDistance(theFit, sorted);
+    });
+
+    std::stable_sort(fits.begin(), fits.end(), betterFit);
+    theFits = fits;
+}
+
+int
+DistributionFitter::getNumFits(void) const
+{
+    return theFits.size();
+}
+
+const DistributionFit &
+DistributionFitter::getFit(int rank) const
+{
+    return theFits.at(rank);
+}
@@ -0,0 +1,130 @@
+#ifndef DISTRIBUTION_FITTER_H
+#define DISTRIBUTION_FITTER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// maximum likelihood fits of the distributions used for random variables
+// (normal, lognormal, Gumbel, Weibull, beta and gamma) to a column of
+// results, ranked by AIC, each with its Kolmogorov-Smirnov distance. it
+// replaces running fit.py in a QProcess. parameters are those the random
+// variable widgets take, so a fit can be entered as an input directly.
+//  - normal and lognormal are closed form; gamma and beta are solved by
+//    Newton's method on sums of logs found in one pass; Gumbel and Weibull
+//    need a pass over the samples per Newton step
+//  - the KS distance is exact, but as the fitted and empirical CDFs are both
+//    increasing the fitted CDF is only evaluated at every few samples first,
+//    and then at all samples only in the stretches where the largest
+//    difference could be
+// the fits are independent and run in parallel
+
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+#define MAX_FIT_PARAMETERS 4
+
+class DistributionFit
+{
+public:
+    DistributionFit();
+
+    double pdf(double x) const;
+    double cdf(double x) const;
+    QString getParameterText(void) const;
+
+    int type;               // DistributionFitter::Type
+    bool ok;                // false if the distribution can not be fit, e.g. lognormal to negative values
+    int numParameters;
+    double parameters[MAX_FIT_PARAMETERS];
+    double logLikelihood;
+    double aic;
+    double ks;
+};
+
+class DistributionFitter
+{
+public:
+    enum Type {
+        Normal = 0,
+        Lognormal,
+        Gumbel,
+        Weibull,
+        Beta,
+        Gamma,
+        NumTypes
+    };
+
+    DistributionFitter();
+    ~DistributionFitter();
+
+    static QString getName(int type);
+    static QStringList getParameterNames(int type);
+
+    // copies the values, which need not be sorted
+    void setValues(const double *values, int numValues);
+    void clear(void);
+
+    // fits every type, the results ordered best (smallest AIC) first with
+    // those that could not be fit last
+    void fit(void);
+
+    int getNumFits(void) const;
+    const DistributionFit &getFit(int rank) const;
+
+    //
+    // the pieces, each on sorted values
+    //
+
+    static DistributionFit fitNormal(const std::vector<double> &sorted);
+    static DistributionFit fitLognormal(const std::vector<double> &sorted);
+    static DistributionFit fitGumbel(const std::vector<double> &sorted);
+    static DistributionFit fitWeibull(const std::vector<double> &sorted);
+    static DistributionFit fitBeta(const std::vector<double> &sorted);
+    static DistributionFit fitGamma(const std::vector<double> &sorted);
+    static double ksDistance(const DistributionFit &theFit, const std::vector<double> &sorted);
+
+    static double digamma(double x);
+    static double trigamma(double x);
+    static double incompleteGamma(double a, double x);          // regularized P(a,x)
+    static double incompleteBeta(double a, double b, double x); // regularized I_x(a,b)
+
+private:
+    std::vector<double> theValues;   // sorted
+    QVector<DistributionFit> theFits;
+};
+
+#endif // DISTRIBUTION_FITTER_H
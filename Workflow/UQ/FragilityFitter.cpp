@@ -0,0 +1,433 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "FragilityFitter.h"
+
+#include <QRegExp>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+// at most this many observed fractions are plotted
+#define MAX_OBSERVED_BINS 20
+
+#define MAX_NEWTON_ITERATIONS 100
+
+// groups the first Newton steps are taken on when there are many more
+#define NUM_COARSE_GROUPS 1024
+
+// |(ln x - ln median)/beta| is clamped to this, beyond it the probabilities
+// underflow and the fit has separated
+#define MAX_ETA 37.0
+
+FragilityCurve::FragilityCurve()
+    :threshold(0), ok(false), median(NAN), beta(NAN), logLikelihood(NAN), numExceeding(0)
+{
+
+}
+
+double
+FragilityCurve::probability(double intensity) const
+{
+    if (!ok || !(intensity > 0))
+        return 0;
+    return 0.5*erfc(-(log(intensity)-log(median))/(beta*M_SQRT2));
+}
+
+FragilityFitter::FragilityFitter()
+{
+
+}
+
+void
+FragilityFitter::clear(void)
+{
+    samples.clear();
+    theThresholds.clear();
+    theCurves.clear();
+    groupX.clear();
+    groupEnd.clear();
+    binEnd.clear();
+    observedIntensities.clear();
+}
+
+void
+FragilityFitter::setSamples(const double *intensity, const double *response, int numSamples,
+                            const std::vector<int> *rows)
+{
+    samples.clear();
+    theCurves.clear();
+
+    int numRows = (rows != NULL) ? static_cast<int>(rows->size()) : numSamples;
+    samples.reserve(numRows);
+    for (int i=0; i<numRows; i++) {
+        int row = (rows != NULL) ? (*rows)[i] : i;
+        double x = intensity[row];
+        double y = response[row];
+        if (x > 0 && y == y)
+            samples.push_back(std::make_pair(log(x), y));
+    }
+}
+
+void
+FragilityFitter::setThresholds(const QVector<double> &thresholds)
+{
+    theThresholds = thresholds;
+    theCurves.clear();
+}
+
+bool
+FragilityFitter::parseThresholds(const QString &text, QVector<double> &thresholds)
+{
+    thresholds.clear();
+    QStringList tokens = text.split(QRegExp("[,;\\s]+"), QString::SkipEmptyParts);
+    foreach (const QString &token, tokens) {
+        bool ok;
+        double value = token.toDouble(&ok);
+        if (!ok)
+            return false;
+        thresholds.append(value);
+    }
+    return !thresholds.isEmpty();
+}
+
+int
+FragilityFitter::getNumSamples(void) const
+{
+    return static_cast<int>(samples.size());
+}
+
+int
+FragilityFitter::getNumCurves(void) const
+{
+    return theCurves.size();
+}
+
+const FragilityCurve &
+FragilityFitter::getCurve(int curve) const
+{
+    return theCurves.at(curve);
+}
+
+const std::vector<double> &
+FragilityFitter::getObservedIntensities(void) const
+{
+    return observedIntensities;
+}
+
+double
+FragilityFitter::getMinIntensity(void) const
+{
+    return groupX.empty() ? NAN : exp(groupX.front());
+}
+
+double
+FragilityFitter::getMaxIntensity(void) const
+{
+    return groupX.empty() ? NAN : exp(groupX.back());
+}
+
+bool
+FragilityFitter::fit(void)
+{
+    theCurves.clear();
+    groupX.clear();
+    groupEnd.clear();
+    binEnd.clear();
+    observedIntensities.clear();
+
+    int numSamples = static_cast<int>(samples.size());
+    if (numSamples < 2)
+        return false;
+
+    //
+    // sort by intensity and find the runs of equal intensity
+    //
+
+    std::sort(samples.begin(), samples.end());
+    for (int i=0; i<numSamples; i++) {
+        if (i == 0 || samples[i].first != groupX.back()) {
+            if (i != 0)
+                groupEnd.push_back(i);
+            groupX.push_back(samples[i].first);
+        }
+    }
+    groupEnd.push_back(numSamples);
+    int numGroups = static_cast<int>(groupX.size());
+
+    //
+    // bins for the observed fractions: each intensity if few, otherwise runs
+    // of groups holding about equal numbers of samples, plotted at the mean
+    // of their ln intensities
+    //
+
+    if (numGroups <= MAX_OBSERVED_BINS) {
+        for (int g=0; g<numGroups; g++) {
+            binEnd.push_back(g+1);
+            observedIntensities.push_back(exp(groupX[g]));
+        }
+    } else {
+        int first = 0;
+        for (int bin=1; bin<=MAX_OBSERVED_BINS && first<numGroups; bin++) {
+            int target = static_cast<int>(static_cast<qint64>(numSamples)*bin/MAX_OBSERVED_BINS);
+            int last = first+1;
+            while (last < numGroups && groupEnd[last-1] < target)
+                last++;
+            if (bin == MAX_OBSERVED_BINS)
+                last = numGroups;
+            int begin = (first == 0) ? 0 : groupEnd[first-1];
+            double sum = 0;
+            for (int i=begin; i<groupEnd[last-1]; i++)
+                sum += samples[i].first;
+            binEnd.push_back(last);
+            observedIntensities.push_back(exp(sum/(groupEnd[last-1]-begin)));
+            first = last;
+        }
+    }
+
+    //
+    // each threshold in parallel
+    //
+
+    for (int i=0; i<theThresholds.size(); i++) {
+        FragilityCurve theCurve;
+        theCurve.threshold = theThresholds.at(i);
+        theCurves.append(theCurve);
+    }
+
+    QtConcurrent::blockingMap(theCurves, [this](FragilityCurve &theCurve) {
+        this->fitCurve(theCurve);
+    });
+
+    return true;
+}
+
+//
+// the log likelihood of k of n samples at standardized ln intensity z
+// reaching the threshold, summed over the groups, with its gradient and
+// hessian in (a,b) for eta = a + b z
+//
+
+static double
+logLikelihood(const std::vector<double> &z, const std::vector<double> &n, const std::vector<double> &k,
+              double a, double b, double *gradient, double *hessian)
+{
+    double logL = 0;
+    double g0 = 0, g1 = 0, h00 = 0, h01 = 0, h11 = 0;
+    int numGroups = static_cast<int>(z.size());
+    for (int g=0; g<numGroups; g++) {
+        double eta = qBound(-MAX_ETA, a+b*z[g], MAX_ETA);
+
+        // Phi(eta) and 1-Phi(eta), the smaller found directly so neither is 0
+        double smaller = 0.5*erfc(fabs(eta)*M_SQRT1_2);
+        double p = (eta < 0) ? smaller : 1-smaller;
+        double q = (eta < 0) ? 1-smaller : smaller;
+        double density = exp(-0.5*eta*eta)/sqrt(2*M_PI);
+        double ratioP = density/p;
+        double ratioQ = density/q;
+
+        double exceeding = k[g];
+        double notExceeding = n[g]-k[g];
+        logL += exceeding*log(p) + notExceeding*log(q);
+
+        double d1 = exceeding*ratioP - notExceeding*ratioQ;
+        double d2 = -exceeding*ratioP*(eta+ratioP) - notExceeding*ratioQ*(ratioQ-eta);
+        g0 += d1;
+        g1 += d1*z[g];
+        h00 += d2;
+        h01 += d2*z[g];
+        h11 += d2*z[g]*z[g];
+    }
+    gradient[0] = g0;
+    gradient[1] = g1;
+    hessian[0] = h00;
+    hessian[1] = h01;
+    hessian[2] = h11;
+    return logL;
+}
+
+// Newton's method from (a,b), true if it converged
+static bool
+maximizeLikelihood(const std::vector<double> &z, const std::vector<double> &n, const std::vector<double> &k,
+                   double &a, double &b, double &logL)
+{
+    double gradient[2], hessian[3];
+    logL = logLikelihood(z, n, k, a, b, gradient, hessian);
+    for (int iter=0; iter<MAX_NEWTON_ITERATIONS; iter++) {
+        // the hessian is negative definite, the likelihood being log concave
+        double det = hessian[0]*hessian[2] - hessian[1]*hessian[1];
+        if (!(det > 0) || !(hessian[0] < 0))
+            return false;
+        double da = -(hessian[2]*gradient[0] - hessian[1]*gradient[1])/det;
+        double db = -(hessian[0]*gradient[1] - hessian[1]*gradient[0])/det;
+
+        // halve the step until the likelihood does not decrease
+        double newGradient[2], newHessian[3];
+        double step = 1;
+        double newLogL = logLikelihood(z, n, k, a+da, b+db, newGradient, newHessian);
+        while (!(newLogL >= logL) && step > 1e-10) {
+            step *= 0.5;
+            newLogL = logLikelihood(z, n, k, a+step*da, b+step*db, newGradient, newHessian);
+        }
+        if (!(newLogL >= logL))
+            return true;   // no further increase possible
+
+        a += step*da;
+        b += step*db;
+        double increase = newLogL-logL;
+        logL = newLogL;
+        for (int i=0; i<2; i++)
+            gradient[i] = newGradient[i];
+        for (int i=0; i<3; i++)
+            hessian[i] = newHessian[i];
+
+        if ((fabs(step*da) < 1e-9 && fabs(step*db) < 1e-9*fabs(b)) || increase < 1e-13*fabs(logL))
+            return true;
+    }
+    return false;
+}
+
+void
+FragilityFitter::fitCurve(FragilityCurve &theCurve) const
+{
+    //
+    // samples reaching the threshold in each group
+    //
+
+    int numGroups = static_cast<int>(groupX.size());
+    int numSamples = static_cast<int>(samples.size());
+    std::vector<double> numInGroup(numGroups);
+    std::vector<double> numExceeding(numGroups);
+    int total = 0;
+    int begin = 0;
+    for (int g=0; g<numGroups; g++) {
+        int count = 0;
+        for (int i=begin; i<groupEnd[g]; i++)
+            if (samples[i].second >= theCurve.threshold)
+                count++;
+        numInGroup[g] = groupEnd[g]-begin;
+        numExceeding[g] = count;
+        total += count;
+        begin = groupEnd[g];
+    }
+    theCurve.numExceeding = total;
+
+    int first = 0;
+    for (size_t bin=0; bin<binEnd.size(); bin++) {
+        double n = 0, k = 0;
+        for (int g=first; g<binEnd[bin]; g++) {
+            n += numInGroup[g];
+            k += numExceeding[g];
+        }
+        theCurve.observedFractions.push_back(k/n);
+        first = binEnd[bin];
+    }
+
+    if (total == 0) {
+        theCurve.errorMessage = QString("no sample reaches the threshold");
+        return;
+    }
+    if (total == numSamples) {
+        theCurve.errorMessage = QString("every sample reaches the threshold");
+        return;
+    }
+    if (numGroups < 2) {
+        theCurve.errorMessage = QString("all samples are at the same intensity");
+        return;
+    }
+
+    //
+    // eta = a + b z, z the standardized ln intensity, starting from the
+    // median at the mean and beta the spread of ln x
+    //
+
+    double meanX = 0;
+    for (int g=0; g<numGroups; g++)
+        meanX += numInGroup[g]*groupX[g];
+    meanX /= numSamples;
+    double sdX = 0;
+    for (int g=0; g<numGroups; g++)
+        sdX += numInGroup[g]*(groupX[g]-meanX)*(groupX[g]-meanX);
+    sdX = sqrt(sdX/numSamples);
+
+    std::vector<double> z(numGroups);
+    for (int g=0; g<numGroups; g++)
+        z[g] = (groupX[g]-meanX)/sdX;
+
+    // with many intensities most of the steps are taken on runs of groups
+    // merged, each at their mean z, leaving a step or two on all of them
+    double a = 0, b = 1, logL;
+    if (numGroups > 4*NUM_COARSE_GROUPS) {
+        std::vector<double> coarseZ, coarseN, coarseK;
+        int first = 0;
+        for (int i=1; i<=NUM_COARSE_GROUPS; i++) {
+            int last = static_cast<int>(static_cast<qint64>(numGroups)*i/NUM_COARSE_GROUPS);
+            double sumZ = 0, sumN = 0, sumK = 0;
+            for (int g=first; g<last; g++) {
+                sumZ += numInGroup[g]*z[g];
+                sumN += numInGroup[g];
+                sumK += numExceeding[g];
+            }
+            coarseZ.push_back(sumZ/sumN);
+            coarseN.push_back(sumN);
+            coarseK.push_back(sumK);
+            first = last;
+        }
+        if (!maximizeLikelihood(coarseZ, coarseN, coarseK, a, b, logL) || !(b > 0) || b > MAX_ETA) {
+            a = 0;
+            b = 1;
+        }
+    }
+    bool converged = maximizeLikelihood(z, numInGroup, numExceeding, a, b, logL);
+
+    // perfectly separated responses drive b, and beta to 0, without bound
+    double minSpacing = (z.back()-z.front())/numGroups;
+    if (!converged || b*minSpacing > MAX_ETA) {
+        theCurve.errorMessage = QString("the samples reaching the threshold are separated by intensity, beta is 0");
+        return;
+    }
+    if (!(b > 0)) {
+        theCurve.errorMessage = QString("the samples reaching the threshold decrease with intensity");
+        return;
+    }
+
+    theCurve.beta = sdX/b;
+    theCurve.median = exp(meanX - a*sdX/b);
+    theCurve.logLikelihood = logL;
+    theCurve.ok = true;
+}
@@ -0,0 +1,115 @@
+#ifndef FRAGILITY_FITTER_H
+#define FRAGILITY_FITTER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// lognormal fragility curves fitted to sampling results: for each damage
+// state, given by a threshold on a response column, the probability that the
+// response reaches the threshold at a given intensity is taken to be
+//     P(D >= t | IM = x) = Phi((ln x - ln median)/beta)
+// and median and beta are found by maximum likelihood (a probit regression
+// on ln x, solved by Newton's method, the likelihood being concave).
+//  - the samples are sorted by intensity once and those of equal intensity,
+//    e.g. the stripes of a multiple stripe analysis, grouped, so a Newton
+//    step costs one pass over the distinct intensities
+//  - the observed fractions exceeding each threshold are found for bins of
+//    about equal numbers of samples, or at each intensity if there are few
+// the damage states are fitted in parallel
+
+#include <QString>
+#include <QVector>
+#include <vector>
+
+class FragilityCurve
+{
+public:
+    FragilityCurve();
+
+    // probability of reaching the threshold at the intensity
+    double probability(double intensity) const;
+
+    double threshold;
+    bool ok;                // false if it can not be fitted, e.g. no sample reaches the threshold
+    double median;          // intensity with a 50% probability of reaching the threshold
+    double beta;            // lognormal standard deviation
+    double logLikelihood;
+    int numExceeding;       // samples reaching the threshold
+    std::vector<double> observedFractions; // at FragilityFitter::getObservedIntensities()
+    QString errorMessage;
+};
+
+class FragilityFitter
+{
+public:
+    FragilityFitter();
+
+    void clear(void);
+
+    // copies the pairs, only those of rows if given; samples with a missing
+    // value or an intensity that is not positive are left out
+    void setSamples(const double *intensity, const double *response, int numSamples,
+                    const std::vector<int> *rows = NULL);
+    void setThresholds(const QVector<double> &thresholds);
+
+    // thresholds separated by commas or spaces, false on anything else
+    static bool parseThresholds(const QString &text, QVector<double> &thresholds);
+
+    // fits all the thresholds, false if too few samples; may run on a worker thread
+    bool fit(void);
+
+    int getNumSamples(void) const;
+    int getNumCurves(void) const;
+    const FragilityCurve &getCurve(int curve) const;
+    const std::vector<double> &getObservedIntensities(void) const;
+    double getMinIntensity(void) const;
+    double getMaxIntensity(void) const;
+
+private:
+    void fitCurve(FragilityCurve &theCurve) const;
+
+    std::vector<std::pair<double, double> > samples; // (ln intensity, response), sorted once fitted
+    QVector<double> theThresholds;
+    QVector<FragilityCurve> theCurves;
+
+    // runs of samples with the same intensity, and the bins of the observed fractions
+    std::vector<double> groupX;
+    std::vector<int> groupEnd;
+    std::vector<int> binEnd;           // groups in each bin
+    std::vector<double> observedIntensities;
+};
+
+#endif // FRAGILITY_FITTER_H
@@ -0,0 +1,191 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "OnlineMoments.h"
+#include <math.h>
+
+OnlineMoments::OnlineMoments()
+    :n(0), mean(0), M2(0), M3(0), M4(0)
+{
+
+}
+
+void
+OnlineMoments::clear(void)
+{
+    n = 0;
+    mean = 0;
+    M2 = 0;
+    M3 = 0;
+    M4 = 0;
+}
+
+void
+OnlineMoments::add(double value)
+{
+    double n1 = n;
+    n += 1;
+    double delta = value - mean;
+    double delta_n = delta/n;
+    double delta_n2 = delta_n*delta_n;
+    double term1 = delta*delta_n*n1;
+    mean += delta_n;
+    M4 += term1*delta_n2*(n*n - 3*n + 3) + 6*delta_n2*M2 - 4*delta_n*M3;
+    M3 += term1*delta_n*(n - 2) - 3*delta_n*M2;
+    M2 += term1;
+}
+
+void
+OnlineMoments::add(const double *values, int numValues)
+{
+    for (int i=0; i<numValues; i++)
+        this->add(values[i]);
+}
+
+void
+OnlineMoments::merge(const OnlineMoments &other)
+{
+    if (other.n == 0)
+        return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+
+    double na = n;
+    double nb = other.n;
+    double nx = na + nb;
+    double delta = other.mean - mean;
+    double delta2 = delta*delta;
+    double delta3 = delta*delta2;
+    double delta4 = delta2*delta2;
+
+    double newMean = mean + delta*nb/nx;
+    double newM2 = M2 + other.M2 + delta2*na*nb/nx;
+    double newM3 = M3 + other.M3 + delta3*na*nb*(na - nb)/(nx*nx)
+            + 3.0*delta*(na*other.M2 - nb*M2)/nx;
+    double newM4 = M4 + other.M4 + delta4*na*nb*(na*na - na*nb + nb*nb)/(nx*nx*nx)
+            + 6.0*delta2*(na*na*other.M2 + nb*nb*M2)/(nx*nx)
+            + 4.0*delta*(na*other.M3 - nb*M3)/nx;
+
+    n = nx;
+    mean = newMean;
+    M2 = newM2;
+    M3 = newM3;
+    M4 = newM4;
+}
+
+void
+OnlineMoments::setSums(double count, double theMean, double sum2, double sum3, double sum4)
+{
+    n = count;
+    mean = theMean;
+    M2 = sum2;
+    M3 = sum3;
+    M4 = sum4;
+}
+
+double
+OnlineMoments::getCount(void) const
+{
+    return n;
+}
+
+double
+OnlineMoments::getMean(void) const
+{
+    return mean;
+}
+
+double
+OnlineMoments::getVariance(void) const
+{
+    if (n > 1)
+        return M2/(n-1);
+    return M2;
+}
+
+double
+OnlineMoments::getStdDev(void) const
+{
+    return sqrt(this->getVariance());
+}
+
+double
+OnlineMoments::getSkewness(void) const
+{
+    // biased skewness
+    double tmpV = sqrt(M2/n);
+    double skewness = M3/(n*tmpV*tmpV*tmpV);
+
+    // unbiased skewness like Matlab
+    if (n > 3)
+        skewness *= sqrt(n*(n-1))/(n-2);
+
+    return skewness;
+}
+
+double
+OnlineMoments::getKurtosis(void) const
+{
+    // biased Kurtosis
+    double tmpV = M2/n;
+    double kurtosis = M4/(n*tmpV*tmpV);
+
+    // unbiased kurtosis value as calculated by Matlab
+    if (n > 3)
+        kurtosis = (n-1)/((n-2)*(n-3))*((n+1)*kurtosis - 3*(n-1)) + 3;
+
+    return kurtosis;
+}
+
+double
+OnlineMoments::getM2(void) const
+{
+    return M2;
+}
+
+double
+OnlineMoments::getM3(void) const
+{
+    return M3;
+}
+
+double
+OnlineMoments::getM4(void) const
+{
+    return M4;
+}
@@ -0,0 +1,80 @@
+#ifndef ONLINE_MOMENTS_H
+#define ONLINE_MOMENTS_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// running count, mean and central moments of a column using the one pass
+// Welford/Terriberry updates. two sets of moments can be merged (Chan/Pebay),
+// so partial results from blocks, threads or files combine exactly. the
+// reported stdDev, skewness and kurtosis use the same Matlab compatible bias
+// corrections as the sampling results summary
+
+class OnlineMoments
+{
+public:
+    OnlineMoments();
+
+    void clear(void);
+    void add(double value);
+    void add(const double *values, int numValues);
+    void merge(const OnlineMoments &other);
+
+    // set from moments computed elsewhere, M2..M4 the sums of the 2nd to 4th
+    // powers of the deviations from the mean
+    void setSums(double n, double mean, double M2, double M3, double M4);
+
+    double getCount(void) const;
+    double getMean(void) const;
+    double getVariance(void) const;
+    double getStdDev(void) const;
+    double getSkewness(void) const;
+    double getKurtosis(void) const;
+
+    double getM2(void) const;
+    double getM3(void) const;
+    double getM4(void) const;
+
+private:
+    // raw sums of powers of deviations from the mean
+    double n;
+    double mean;
+    double M2;
+    double M3;
+    double M4;
+};
+
+#endif // ONLINE_MOMENTS_H
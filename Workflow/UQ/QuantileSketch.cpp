@@ -0,0 +1,318 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "QuantileSketch.h"
+#include <SampleDataStore.h>
+
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+// values held back before merging, as a multiple of the compression
+#define BUFFER_FACTOR 5
+
+QuantileSketch::QuantileSketch(double value)
+    :compression(value), totalWeight(0), min(NAN), max(NAN)
+{
+
+}
+
+void
+QuantileSketch::clear(void)
+{
+    totalWeight = 0;
+    min = NAN;
+    max = NAN;
+    means.clear();
+    weights.clear();
+    buffer.clear();
+}
+
+void
+QuantileSketch::add(double value, double weight)
+{
+    if (value != value || !(weight > 0))
+        return;
+
+    if (totalWeight == 0) {
+        min = value;
+        max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    totalWeight += weight;
+
+    buffer.push_back(std::make_pair(value, weight));
+    if (buffer.size() >= static_cast<size_t>(BUFFER_FACTOR*compression))
+        this->compress();
+}
+
+void
+QuantileSketch::add(const double *values, int numValues)
+{
+    for (int i=0; i<numValues; i++)
+        this->add(values[i], 1.0);
+}
+
+void
+QuantileSketch::merge(const QuantileSketch &other)
+{
+    if (other.totalWeight == 0)
+        return;
+
+    // the other's centroids are added as weighted values
+    other.compress();
+    for (size_t i=0; i<other.means.size(); i++)
+        this->add(other.means[i], other.weights[i]);
+
+    // the extremes are kept exactly
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+// the largest fraction of the samples a centroid starting at q may hold
+// runs to the q at which the k1 scale function, k = compression/(2 pi)
+// asin(2q-1), has grown by 1
+static double qLimit(double q, double compression)
+{
+    double k = asin(2*q-1) + 2*M_PI/compression;
+    if (k >= M_PI/2)
+        return 1;
+    return 0.5*(sin(k)+1);
+}
+
+void
+QuantileSketch::compress(void) const
+{
+    if (buffer.empty())
+        return;
+
+    for (size_t i=0; i<means.size(); i++)
+        buffer.push_back(std::make_pair(means[i], weights[i]));
+    std::sort(buffer.begin(), buffer.end());
+
+    means.clear();
+    weights.clear();
+
+    double total = 0;
+    for (size_t i=0; i<buffer.size(); i++)
+        total += buffer[i].second;
+
+    double mean = buffer[0].first;
+    double weight = buffer[0].second;
+    double weightSoFar = 0;
+    double limit = total*qLimit(0, compression);
+    for (size_t i=1; i<buffer.size(); i++) {
+        double nextMean = buffer[i].first;
+        double nextWeight = buffer[i].second;
+        if (weightSoFar + weight + nextWeight <= limit) {
+            weight += nextWeight;
+            mean += (nextMean-mean)*nextWeight/weight;
+        } else {
+            means.push_back(mean);
+            weights.push_back(weight);
+            weightSoFar += weight;
+            limit = total*qLimit(weightSoFar/total, compression);
+            mean = nextMean;
+            weight = nextWeight;
+        }
+    }
+    means.push_back(mean);
+    weights.push_back(weight);
+
+    buffer.clear();
+}
+
+double
+QuantileSketch::getCount(void) const
+{
+    return totalWeight;
+}
+
+double
+QuantileSketch::getMin(void) const
+{
+    return min;
+}
+
+double
+QuantileSketch::getMax(void) const
+{
+    return max;
+}
+
+int
+QuantileSketch::getNumCentroids(void) const
+{
+    this->compress();
+    return static_cast<int>(means.size());
+}
+
+//
+// reading: the weight of each centroid is taken as centred on its mean and
+// the quantile function as linear between those centres, and the exact
+// minimum and maximum at the ends
+//
+
+double
+QuantileSketch::quantile(double q) const
+{
+    if (totalWeight == 0)
+        return NAN;
+    this->compress();
+
+    double index = qBound(0.0, q, 1.0)*totalWeight;
+    double previousIndex = 0;
+    double previousValue = min;
+    double weightSoFar = 0;
+    for (size_t i=0; i<means.size(); i++) {
+        double centre = weightSoFar + 0.5*weights[i];
+        if (index <= centre) {
+            if (centre == previousIndex)
+                return means[i];
+            return previousValue + (index-previousIndex)/(centre-previousIndex)*(means[i]-previousValue);
+        }
+        previousIndex = centre;
+        previousValue = means[i];
+        weightSoFar += weights[i];
+    }
+
+    if (totalWeight == previousIndex)
+        return max;
+    return previousValue + (index-previousIndex)/(totalWeight-previousIndex)*(max-previousValue);
+}
+
+double
+QuantileSketch::cdf(double x) const
+{
+    if (totalWeight == 0)
+        return NAN;
+    if (x < min)
+        return 0;
+    if (x >= max)
+        return 1;
+    this->compress();
+
+    double previousIndex = 0;
+    double previousValue = min;
+    double weightSoFar = 0;
+    for (size_t i=0; i<means.size(); i++) {
+        double centre = weightSoFar + 0.5*weights[i];
+        if (x < means[i]) {
+            if (means[i] == previousValue)
+                return previousIndex/totalWeight;
+            return (previousIndex + (x-previousValue)/(means[i]-previousValue)*(centre-previousIndex))/totalWeight;
+        }
+        previousIndex = centre;
+        previousValue = means[i];
+        weightSoFar += weights[i];
+    }
+
+    if (max == previousValue)
+        return 1;
+    return (previousIndex + (x-previousValue)/(max-previousValue)*(totalWeight-previousIndex))/totalWeight;
+}
+
+//
+// json, the centroids as two arrays
+//
+
+void
+QuantileSketch::writeJSON(QJsonObject &sketchData) const
+{
+    this->compress();
+
+    QJsonArray meanData;
+    QJsonArray weightData;
+    for (size_t i=0; i<means.size(); i++) {
+        meanData.append(means[i]);
+        weightData.append(weights[i]);
+    }
+
+    sketchData["compression"]=compression;
+    sketchData["count"]=totalWeight;
+    if (totalWeight != 0) {
+        sketchData["min"]=min;
+        sketchData["max"]=max;
+    }
+    sketchData["means"]=meanData;
+    sketchData["weights"]=weightData;
+}
+
+bool
+QuantileSketch::readJSON(const QJsonObject &sketchData)
+{
+    this->clear();
+
+    QJsonArray meanData = sketchData["means"].toArray();
+    QJsonArray weightData = sketchData["weights"].toArray();
+    if (meanData.size() != weightData.size())
+        return false;
+
+    compression = sketchData["compression"].toDouble(200);
+    for (int i=0; i<meanData.size(); i++) {
+        means.push_back(meanData.at(i).toDouble());
+        weights.push_back(weightData.at(i).toDouble());
+        totalWeight += weights.back();
+    }
+    if (totalWeight != 0) {
+        min = sketchData["min"].toDouble(means.front());
+        max = sketchData["max"].toDouble(means.back());
+    }
+
+    return true;
+}
+
+void
+QuantileSketch::sketchColumns(const SampleDataStore &theData, QVector<QuantileSketch> &sketches)
+{
+    int numCols = theData.getNumColumns();
+    int numRows = theData.getNumRows();
+    sketches.clear();
+    sketches.resize(numCols);
+
+    QVector<int> columns;
+    for (int col=0; col<numCols; col++)
+        columns.append(col);
+
+    QtConcurrent::blockingMap(columns, [&theData, &sketches, numRows](int &col) {
+        sketches[col].add(theData.getColumn(col), numRows);
+    });
+}
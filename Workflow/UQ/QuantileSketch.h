@@ -0,0 +1,99 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a mergeable sketch of the distribution of a column (Dunning's merging
+// t-digest): a few hundred weighted centroids, small near the tails and
+// larger in the middle, from which any quantile or CDF value is read with a
+// rank error that is largest, about 1/compression, at the median and much
+// smaller in the tails. values are buffered and merged in sorted batches,
+// so adding costs a few tens of ns per value and the size does not grow
+// with the number of samples. sketches of separate chunks, threads or runs
+// merge into one for the combined samples without the raw values, and are
+// written to and read from the results json
+
+#include <QtGlobal>
+#include <QVector>
+#include <vector>
+
+class QJsonObject;
+class SampleDataStore;
+
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(double compression = 200);
+
+    void clear(void);
+
+    // NaN values, i.e. missing entries, are skipped
+    void add(double value, double weight = 1.0);
+    void add(const double *values, int numValues);
+    void merge(const QuantileSketch &other);
+
+    double getCount(void) const;
+    double getMin(void) const;
+    double getMax(void) const;
+    int getNumCentroids(void) const;
+
+    // value below which a fraction q of the samples lie, NaN if empty
+    double quantile(double q) const;
+    // fraction of the samples at or below x
+    double cdf(double x) const;
+
+    void writeJSON(QJsonObject &sketchData) const;
+    bool readJSON(const QJsonObject &sketchData);
+
+    // one sketch of each column of theData, columns in parallel
+    static void sketchColumns(const SampleDataStore &theData, QVector<QuantileSketch> &sketches);
+
+private:
+    void compress(void) const;
+
+    double compression;
+    double totalWeight;       // centroids and buffer
+    double min;
+    double max;
+
+    // sorted by mean; the buffer is merged in before reading
+    mutable std::vector<double> means;
+    mutable std::vector<double> weights;
+    mutable std::vector<std::pair<double, double> > buffer;
+};
+
+#endif // QUANTILE_SKETCH_H
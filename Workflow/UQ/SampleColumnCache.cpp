@@ -0,0 +1,168 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleColumnCache.h"
+#include <SampleDataStore.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+SampleColumnCache::SampleColumnCache(const SampleDataStore *data)
+    :theData(data), theRows(NULL)
+{
+
+}
+
+void
+SampleColumnCache::clear(void)
+{
+    sortedColumns.clear();
+    sortedRows.clear();
+}
+
+void
+SampleColumnCache::setRows(const std::vector<int> *rows)
+{
+    theRows = rows;
+    sortedColumns.clear();
+    sortedRows.clear();
+}
+
+const std::vector<int> *
+SampleColumnCache::getRows(void) const
+{
+    return theRows;
+}
+
+int
+SampleColumnCache::getNumRows(void) const
+{
+    if (theRows != NULL)
+        return static_cast<int>(theRows->size());
+    return theData->getNumRows();
+}
+
+const std::vector<double> &
+SampleColumnCache::getSortedColumn(int col)
+{
+    if (col >= static_cast<int>(sortedColumns.size())) {
+        sortedColumns.resize(theData->getNumColumns());
+        sortedRows.resize(theData->getNumColumns(), 0);
+    }
+
+    std::vector<double> &sorted = sortedColumns[col];
+    size_t numRows = this->getNumRows();
+    if (sortedRows[col] != numRows) {
+        const double *values = theData->getColumn(col);
+        if (theRows != NULL) {
+            sorted.resize(numRows);
+            for (size_t i=0; i<numRows; i++)
+                sorted[i] = values[(*theRows)[i]];
+        } else
+            sorted.assign(values, values+numRows);
+
+        // NaN compares false with everything, so would break the sort
+        std::vector<double>::iterator end = std::partition(sorted.begin(), sorted.end(), [](double value) { return value == value; });
+        sorted.erase(end, sorted.end());
+        std::sort(sorted.begin(), sorted.end());
+        sortedRows[col] = numRows;
+    }
+
+    return sorted;
+}
+
+void
+SampleColumnCache::sortColumns(void)
+{
+    this->sortColumns(0, theData->getNumColumns()-1);
+}
+
+void
+SampleColumnCache::sortColumns(int firstCol, int lastCol)
+{
+    int numCols = theData->getNumColumns();
+    sortedColumns.resize(numCols);
+    sortedRows.resize(numCols, 0);
+
+    QVector<int> columns;
+    for (int col=firstCol; col<=lastCol && col<numCols; col++)
+        columns.append(col);
+
+    // each task only touches its own column's vector
+    QtConcurrent::blockingMap(columns, [this](int &col) {
+        this->getSortedColumn(col);
+    });
+}
+
+void
+SampleColumnCache::getCDF(int col, int numBins, QVector<QPointF> &points)
+{
+    points.clear();
+
+    const std::vector<double> &sorted = this->getSortedColumn(col);
+    int numRows = static_cast<int>(sorted.size());
+    if (numRows == 0)
+        return;
+
+    // few enough samples, draw them all
+    if (numRows <= 2*numBins) {
+        points.reserve(numRows);
+        for (int i=0; i<numRows; i++)
+            points.append(QPointF(sorted[i], 1.0*i/numRows));
+        return;
+    }
+
+    // the CDF is increasing, so inside an interval its extremes are at the
+    // first and last sample falling in that interval
+    double min = sorted.front();
+    double dRange = (sorted.back()-min)/numBins;
+    points.reserve(2*numBins);
+
+    int first = 0;
+    for (int i=1; i<=numBins && first<numRows; i++) {
+        int last = numRows;
+        if (i < numBins)
+            last = std::lower_bound(sorted.begin()+first, sorted.end(), min+i*dRange) - sorted.begin();
+        if (last == first)
+            continue;
+
+        points.append(QPointF(sorted[first], 1.0*first/numRows));
+        if (last-1 > first)
+            points.append(QPointF(sorted[last-1], 1.0*(last-1)/numRows));
+        first = last;
+    }
+}
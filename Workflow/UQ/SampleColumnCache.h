@@ -0,0 +1,85 @@
+#ifndef SAMPLE_COLUMN_CACHE_H
+#define SAMPLE_COLUMN_CACHE_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// sorted copies of the columns of a SampleDataStore, made the first time a
+// column is plotted and reused after. from a sorted column the empirical CDF
+// is reduced to a few points per pixel, so a redraw does not touch every
+// sample. a column is sorted again if rows have been appended since it was cached.
+// when a subset of rows is set, e.g. those passing a SampleFilter, only those
+// rows are sorted and everything below describes the subset. missing values
+// (NaN) are left out of a sorted column, its size is the count of the others
+
+#include <QVector>
+#include <QPointF>
+#include <vector>
+
+class SampleDataStore;
+
+class SampleColumnCache
+{
+public:
+    explicit SampleColumnCache(const SampleDataStore *theData);
+
+    void clear(void);
+
+    // rows to use, NULL for all; the vector is not copied and must outlive its use
+    void setRows(const std::vector<int> *rows);
+    const std::vector<int> *getRows(void) const;
+    int getNumRows(void) const;
+
+    // the values of the column other than NaN, in increasing order
+    const std::vector<double> &getSortedColumn(int col);
+
+    // sort every column now, in parallel, so later plots do not wait on a sort
+    void sortColumns(void);
+    void sortColumns(int firstCol, int lastCol);
+
+    // CDF points (x, i/n) at most 2 per each of numBins equal x intervals,
+    // the first and last sample in each, which draw the same as every sample
+    // while an interval is no wider than a pixel
+    void getCDF(int col, int numBins, QVector<QPointF> &points);
+
+private:
+    const SampleDataStore *theData;
+    const std::vector<int> *theRows;
+    std::vector<std::vector<double> > sortedColumns;
+    std::vector<size_t> sortedRows;   // rows in use when each column was sorted
+};
+
+#endif // SAMPLE_COLUMN_CACHE_H
@@ -0,0 +1,394 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleComparison.h"
+#include <DakotaTabParser.h>
+#include <OnlineMoments.h>
+
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+const double SampleComparison::quantileLevels[NUM_COMPARISON_QUANTILES] = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+ColumnComparison::ColumnComparison()
+    :column(-1), baselineColumn(-1), count(0), baselineCount(0),
+      mean(NAN), baselineMean(NAN), variance(NAN), baselineVariance(NAN),
+      meanDifference(NAN), varianceDifference(NAN), meanPValue(NAN),
+      ks(NAN), ksPValue(NAN), ad(NAN), adPValue(NAN), changed(false)
+{
+    for (int i=0; i<NUM_COMPARISON_QUANTILES; i++)
+        quantileDifferences[i] = NAN;
+}
+
+SampleComparison::SampleComparison()
+    :numChanged(0)
+{
+
+}
+
+SampleComparison::~SampleComparison()
+{
+
+}
+
+void
+SampleComparison::clear(void)
+{
+    baseline.clear();
+    baselineCounts.clear();
+    baselineName.clear();
+    errorMessage.clear();
+    theColumns.clear();
+    numChanged = 0;
+}
+
+bool
+SampleComparison::readBaseline(const QString &filename)
+{
+    this->clear();
+
+    DakotaTabParser theParser;
+    if (theParser.parseFile(filename, baseline) < 0) {
+        errorMessage = theParser.getErrorMessage();
+        baseline.clear();
+        return false;
+    }
+    baselineName = QFileInfo(filename).absoluteFilePath();
+
+    // each column sorted in place, missing values moved to the end
+    int numCols = baseline.getNumColumns();
+    int numRows = baseline.getNumRows();
+    baselineCounts.resize(numCols);
+    QVector<int> columns;
+    for (int col=0; col<numCols; col++)
+        columns.append(col);
+    SampleDataStore &theData = baseline;
+    QVector<int> &counts = baselineCounts;
+    QtConcurrent::blockingMap(columns, [&theData, &counts, numRows](int &col) {
+        double *values = theData.getColumnData(col);
+        double *end = std::partition(values, values+numRows, [](double value) { return value == value; });
+        std::sort(values, end);
+        counts[col] = static_cast<int>(end-values);
+    });
+
+    return true;
+}
+
+bool
+SampleComparison::hasBaseline(void) const
+{
+    return baseline.getNumColumns() != 0;
+}
+
+QString
+SampleComparison::getBaselineName(void) const
+{
+    return baselineName;
+}
+
+QString
+SampleComparison::getErrorMessage(void) const
+{
+    return errorMessage;
+}
+
+int
+SampleComparison::getNumColumns(void) const
+{
+    return theColumns.size();
+}
+
+const ColumnComparison &
+SampleComparison::getColumn(int col) const
+{
+    return theColumns.at(col);
+}
+
+int
+SampleComparison::getNumChanged(void) const
+{
+    return numChanged;
+}
+
+//
+// the tests
+//
+
+double
+SampleComparison::kolmogorovQ(double lambda)
+{
+    // the series converges slowly for small lambda, where Q is 1 to double precision
+    if (lambda < 0.2)
+        return 1;
+
+    double sum = 0;
+    double sign = 1;
+    double previous = 0;
+    for (int k=1; k<=100; k++) {
+        double term = sign*exp(-2.0*k*k*lambda*lambda);
+        sum += term;
+        if (fabs(term) <= 1e-10*fabs(sum) || fabs(term) <= 1e-16*previous)
+            return qBound(0.0, 2*sum, 1.0);
+        sign = -sign;
+        previous = fabs(term);
+    }
+    return 1;
+}
+
+void
+SampleComparison::ksTest(const double *x, int n, const double *y, int m, double &d, double &pValue)
+{
+    d = NAN;
+    pValue = NAN;
+    if (n == 0 || m == 0)
+        return;
+
+    // both CDFs step at each distinct value, compared after the steps at it
+    int i = 0, j = 0;
+    double maxDifference = 0;
+    while (i < n && j < m) {
+        double value = qMin(x[i], y[j]);
+        while (i < n && x[i] == value)
+            i++;
+        while (j < m && y[j] == value)
+            j++;
+        maxDifference = qMax(maxDifference, fabs(1.0*i/n - 1.0*j/m));
+    }
+
+    d = maxDifference;
+    double en = sqrt(1.0*n*m/(n+m));
+    pValue = kolmogorovQ((en + 0.12 + 0.11/en)*d);
+}
+
+void
+SampleComparison::andersonDarlingTest(const double *x, int n, const double *y, int m, double &t, double &pValue)
+{
+    t = NAN;
+    pValue = NAN;
+    double N = 1.0*n + m;
+    if (n == 0 || m == 0 || N < 4)
+        return;
+
+    //
+    // A2 = (1/N)(1/n + 1/m) sum_{j<N} (N M_j - j n)^2/(j (N-j)), M_j the
+    // values of x among the first j of the pooled values
+    //
+
+    double sum = 0;
+    int i = 0, k = 0;
+    for (qint64 j=1; j<N; j++) {
+        if (k == m || (i < n && x[i] <= y[k]))
+            i++;
+        else
+            k++;
+        double difference = N*i - 1.0*j*n;
+        sum += difference*difference/(j*(N-j));
+    }
+    double a2 = sum*(1.0/n + 1.0/m)/N;
+
+    //
+    // its mean is k-1 = 1 and its variance that of Scholz and Stephens (1987)
+    //
+
+    double H = 1.0/n + 1.0/m;
+    double h = 0;
+    double g = 0;
+    double inner = 0;   // sum_{i<j} 1/(N-i)
+    for (qint64 j=1; j<N; j++) {
+        if (j >= 2) {
+            inner += 1.0/(N-(j-1));
+            g += inner/j;
+        }
+        h += 1.0/j;
+    }
+    double kk = 2;
+    double a = (4*g-6)*(kk-1) + (10-6*g)*H;
+    double b = (2*g-4)*kk*kk + 8*h*kk + (2*g-14*h-4)*H - 8*h + 4*g - 6;
+    double c = (6*h+2*g-2)*kk*kk + (4*h-4*g+6)*kk + (2*h-6)*H + 4*h;
+    double d = (2*h+6)*kk*kk - 4*h*kk;
+    double variance = ((a*N+b)*N+c)*N+d;
+    variance /= (N-1)*(N-2)*(N-3);
+    t = (a2 - (kk-1))/sqrt(variance);
+
+    //
+    // p-value interpolated in their table of critical values for k-1 = 1, by
+    // a quadratic in t fitted to the log of the levels
+    //
+
+    static const double levels[7] = {0.25, 0.1, 0.05, 0.025, 0.01, 0.005, 0.001};
+    static const double b0[7] = {0.675, 1.281, 1.645, 1.96, 2.326, 2.573, 3.085};
+    static const double b1[7] = {-0.245, 0.25, 0.678, 1.149, 1.822, 2.364, 3.615};
+    static const double b2[7] = {-0.105, -0.305, -0.362, -0.391, -0.396, -0.345, -0.154};
+
+    double critical[7];
+    for (int l=0; l<7; l++)
+        critical[l] = b0[l] + b1[l] + b2[l];
+    if (t <= critical[0]) {
+        pValue = levels[0];
+        return;
+    }
+    if (t >= critical[6]) {
+        pValue = levels[6];
+        return;
+    }
+
+    // least squares, the normal equations solved by Cramer's rule
+    double s[5] = {0, 0, 0, 0, 0};
+    double r[3] = {0, 0, 0};
+    for (int l=0; l<7; l++) {
+        double power = 1;
+        double logLevel = log(levels[l]);
+        for (int p=0; p<5; p++) {
+            s[p] += power;
+            if (p < 3)
+                r[p] += power*logLevel;
+            power *= critical[l];
+        }
+    }
+    double M[3][3] = {{s[0], s[1], s[2]}, {s[1], s[2], s[3]}, {s[2], s[3], s[4]}};
+    auto det3 = [](double A[3][3]) {
+        return A[0][0]*(A[1][1]*A[2][2]-A[1][2]*A[2][1]) - A[0][1]*(A[1][0]*A[2][2]-A[1][2]*A[2][0])
+                + A[0][2]*(A[1][0]*A[2][1]-A[1][1]*A[2][0]);
+    };
+    double det = det3(M);
+    double coefficients[3];
+    for (int col=0; col<3; col++) {
+        double A[3][3];
+        for (int row=0; row<3; row++)
+            for (int l=0; l<3; l++)
+                A[row][l] = (l == col) ? r[row] : M[row][l];
+        coefficients[col] = det3(A)/det;
+    }
+    pValue = qBound(levels[6], exp(coefficients[0] + coefficients[1]*t + coefficients[2]*t*t), levels[0]);
+}
+
+// linear interpolation between order statistics
+static double sortedQuantile(const double *sorted, int n, double p)
+{
+    double position = p*(n-1);
+    int below = static_cast<int>(floor(position));
+    if (below >= n-1)
+        return sorted[n-1];
+    return sorted[below] + (position-below)*(sorted[below+1]-sorted[below]);
+}
+
+void
+SampleComparison::compare(const QStringList &headings, const QVector<const std::vector<double> *> &sortedColumns,
+                          double significance)
+{
+    theColumns.clear();
+    numChanged = 0;
+    if (!this->hasBaseline())
+        return;
+
+    const QStringList &baselineHeadings = baseline.getHeadings();
+    for (int col=1; col<headings.size() && col<sortedColumns.size(); col++) {
+        int baselineCol = baselineHeadings.indexOf(headings.at(col));
+        if (baselineCol < 1)
+            continue;
+        ColumnComparison theColumn;
+        theColumn.name = headings.at(col);
+        theColumn.column = col;
+        theColumn.baselineColumn = baselineCol;
+        theColumns.append(theColumn);
+    }
+
+    const SampleDataStore &theBaseline = baseline;
+    const QVector<int> &counts = baselineCounts;
+    QtConcurrent::blockingMap(theColumns, [&theBaseline, &counts, &sortedColumns](ColumnComparison &theColumn) {
+        const std::vector<double> &sorted = *sortedColumns.at(theColumn.column);
+        const double *x = sorted.data();
+        int n = static_cast<int>(sorted.size());
+        const double *y = theBaseline.getColumn(theColumn.baselineColumn);
+        int m = counts.at(theColumn.baselineColumn);
+        theColumn.count = n;
+        theColumn.baselineCount = m;
+        if (n < 2 || m < 2)
+            return;
+
+        OnlineMoments moments, baselineMoments;
+        moments.add(x, n);
+        baselineMoments.add(y, m);
+        theColumn.mean = moments.getMean();
+        theColumn.variance = moments.getVariance();
+        theColumn.baselineMean = baselineMoments.getMean();
+        theColumn.baselineVariance = baselineMoments.getVariance();
+        theColumn.meanDifference = theColumn.mean - theColumn.baselineMean;
+        theColumn.varianceDifference = theColumn.variance - theColumn.baselineVariance;
+
+        // Welch, normal for the sample sizes here
+        double standardError = sqrt(theColumn.variance/n + theColumn.baselineVariance/m);
+        if (standardError > 0)
+            theColumn.meanPValue = erfc(fabs(theColumn.meanDifference)/standardError*M_SQRT1_2);
+        else
+            theColumn.meanPValue = (theColumn.meanDifference == 0) ? 1 : 0;
+
+        ksTest(x, n, y, m, theColumn.ks, theColumn.ksPValue);
+        andersonDarlingTest(x, n, y, m, theColumn.ad, theColumn.adPValue);
+
+        for (int i=0; i<NUM_COMPARISON_QUANTILES; i++)
+            theColumn.quantileDifferences[i] = sortedQuantile(x, n, quantileLevels[i]) - sortedQuantile(y, m, quantileLevels[i]);
+    });
+
+    //
+    // Benjamini-Hochberg: the columns with the r smallest p-values are
+    // changed, r the largest rank with p_(r) <= r/numColumns significance
+    //
+
+    QVector<int> order;
+    for (int i=0; i<theColumns.size(); i++)
+        if (theColumns.at(i).ksPValue == theColumns.at(i).ksPValue)
+            order.append(i);
+    const QVector<ColumnComparison> &columns = theColumns;
+    std::sort(order.begin(), order.end(), [&columns](int a, int b) {
+        return columns.at(a).ksPValue < columns.at(b).ksPValue;
+    });
+
+    int numTested = order.size();
+    int numRejected = 0;
+    for (int r=numTested; r>=1; r--) {
+        if (theColumns.at(order.at(r-1)).ksPValue <= significance*r/numTested) {
+            numRejected = r;
+            break;
+        }
+    }
+    for (int r=0; r<numRejected; r++)
+        theColumns[order.at(r)].changed = true;
+    numChanged = numRejected;
+}
@@ -0,0 +1,130 @@
+#ifndef SAMPLE_COMPARISON_H
+#define SAMPLE_COMPARISON_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// compares the results of a run with those of a baseline run, e.g. the
+// previous design iteration, column by column for the columns with the same
+// heading: the differences of the means and variances, with the Welch test
+// of the means, the two-sample Kolmogorov-Smirnov and Anderson-Darling
+// statistics and the differences of a set of quantiles. a column is flagged
+// as changed when its KS p-value passes the Benjamini-Hochberg procedure
+// over all the columns at the significance level, so with hundreds of
+// columns a few are not flagged by chance alone.
+//  - the baseline is parsed once and its columns sorted in place; the run is
+//    given as sorted columns, e.g. from a SampleColumnCache
+//  - KS and AD are each a single merge of the two sorted columns, ties
+//    being taken from the run first; the AD statistic is the standardized
+//    k-sample form of Scholz and Stephens with its tabulated p-value, which
+//    is only given between 0.001 and 0.25
+// columns are compared in parallel
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <SampleDataStore.h>
+#include <vector>
+
+#define NUM_COMPARISON_QUANTILES 5
+
+class ColumnComparison
+{
+public:
+    ColumnComparison();
+
+    QString name;
+    int column;               // in the run
+    int baselineColumn;
+    int count;
+    int baselineCount;
+    double mean;
+    double baselineMean;
+    double variance;
+    double baselineVariance;
+    double meanDifference;    // run - baseline
+    double varianceDifference;
+    double meanPValue;        // Welch
+    double ks;
+    double ksPValue;
+    double ad;                // standardized
+    double adPValue;          // clamped to [0.001, 0.25]
+    double quantileDifferences[NUM_COMPARISON_QUANTILES]; // at SampleComparison::quantileLevels
+    bool changed;
+};
+
+class SampleComparison
+{
+public:
+    static const double quantileLevels[NUM_COMPARISON_QUANTILES];
+
+    SampleComparison();
+    ~SampleComparison();
+
+    void clear(void);
+
+    // the baseline from a tab file, false on error
+    bool readBaseline(const QString &filename);
+    bool hasBaseline(void) const;
+    QString getBaselineName(void) const;
+    QString getErrorMessage(void) const;
+
+    // compare the run, col 0 being the run # and not compared
+    void compare(const QStringList &headings, const QVector<const std::vector<double> *> &sortedColumns,
+                 double significance = 0.05);
+
+    int getNumColumns(void) const;
+    const ColumnComparison &getColumn(int col) const;
+    int getNumChanged(void) const;
+
+    //
+    // the pieces, on sorted values
+    //
+
+    static void ksTest(const double *x, int n, const double *y, int m, double &d, double &pValue);
+    static void andersonDarlingTest(const double *x, int n, const double *y, int m, double &t, double &pValue);
+    static double kolmogorovQ(double lambda);   // P(K > lambda) of the Kolmogorov distribution
+
+private:
+    SampleDataStore baseline;  // columns sorted, missing values last
+    QVector<int> baselineCounts; // values in each column, without those missing
+    QString baselineName;
+    QString errorMessage;
+    QVector<ColumnComparison> theColumns;
+    int numChanged;
+};
+
+#endif // SAMPLE_COMPARISON_H
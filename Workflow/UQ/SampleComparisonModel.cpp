@@ -0,0 +1,216 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleComparisonModel.h"
+#include <SampleComparison.h>
+#include <QColor>
+
+#include <algorithm>
+
+// the columns of the view before the quantile differences
+enum ComparisonColumn {
+    NameColumn, MeanColumn, BaselineMeanColumn, MeanDifferenceColumn, MeanPValueColumn,
+    VarianceColumn, BaselineVarianceColumn, VarianceDifferenceColumn,
+    KSColumn, KSPValueColumn, ADColumn, ADPValueColumn, FirstQuantileColumn
+};
+
+static const char *columnNames[FirstQuantileColumn] = {
+    "Name", "Mean", "Baseline Mean", "Mean Change", "Mean p",
+    "Variance", "Baseline Variance", "Variance Change",
+    "KS", "KS p", "AD", "AD p"
+};
+
+static const char *columnToolTips[FirstQuantileColumn] = {
+    "columns changed significantly are shown in red",
+    "mean of this run", "mean of the baseline run", "this run less the baseline",
+    "p-value of the Welch test of the means",
+    "variance of this run", "variance of the baseline run", "this run less the baseline",
+    "two-sample Kolmogorov-Smirnov distance", "p-value of the KS distance, the columns changed are those passing Benjamini-Hochberg on it",
+    "standardized two-sample Anderson-Darling statistic", "p-value of the AD statistic, given between 0.001 and 0.25"
+};
+
+SampleComparisonModel::SampleComparisonModel(const SampleComparison *comparison, QObject *parent)
+    :QAbstractTableModel(parent), theComparison(comparison), sortColumn(-1), sortOrder(Qt::AscendingOrder)
+{
+    this->reset();
+}
+
+SampleComparisonModel::~SampleComparisonModel()
+{
+
+}
+
+int
+SampleComparisonModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return static_cast<int>(order.size());
+}
+
+int
+SampleComparisonModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return FirstQuantileColumn + NUM_COMPARISON_QUANTILES;
+}
+
+double
+SampleComparisonModel::getValue(int comparison, int column) const
+{
+    const ColumnComparison &theColumn = theComparison->getColumn(comparison);
+    switch (column) {
+    case MeanColumn:
+        return theColumn.mean;
+    case BaselineMeanColumn:
+        return theColumn.baselineMean;
+    case MeanDifferenceColumn:
+        return theColumn.meanDifference;
+    case MeanPValueColumn:
+        return theColumn.meanPValue;
+    case VarianceColumn:
+        return theColumn.variance;
+    case BaselineVarianceColumn:
+        return theColumn.baselineVariance;
+    case VarianceDifferenceColumn:
+        return theColumn.varianceDifference;
+    case KSColumn:
+        return theColumn.ks;
+    case KSPValueColumn:
+        return theColumn.ksPValue;
+    case ADColumn:
+        return theColumn.ad;
+    case ADPValueColumn:
+        return theColumn.adPValue;
+    default:
+        return theColumn.quantileDifferences[column-FirstQuantileColumn];
+    }
+}
+
+QVariant
+SampleComparisonModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(order.size()))
+        return QVariant();
+
+    int comparison = order[index.row()];
+    int col = index.column();
+
+    if (role == Qt::DisplayRole) {
+        if (col == NameColumn)
+            return theComparison->getColumn(comparison).name;
+        double value = this->getValue(comparison, col);
+        if (qIsNaN(value))
+            return QString();   // too few values to compare
+        return QString::number(value, 'g', 4);
+    }
+
+    if (role == Qt::BackgroundRole) {
+        if (theComparison->getColumn(comparison).changed)
+            return QColor(255, 200, 200);
+    }
+
+    return QVariant();
+}
+
+QVariant
+SampleComparisonModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (section < FirstQuantileColumn) {
+        if (role == Qt::DisplayRole)
+            return QString(columnNames[section]);
+        if (role == Qt::ToolTipRole)
+            return QString(columnToolTips[section]);
+        return QVariant();
+    }
+
+    double level = SampleComparison::quantileLevels[section-FirstQuantileColumn];
+    if (role == Qt::DisplayRole)
+        return QString("Q") + QString::number(100*level) + QString(" Change");
+    if (role == Qt::ToolTipRole)
+        return QString("the ") + QString::number(100*level) + QString("% quantile of this run less that of the baseline");
+    return QVariant();
+}
+
+void
+SampleComparisonModel::sort(int column, Qt::SortOrder newOrder)
+{
+    sortColumn = column;
+    sortOrder = newOrder;
+
+    emit layoutAboutToBeChanged();
+
+    // missing values last whichever the order
+    const SampleComparison *comparison = theComparison;
+    std::stable_sort(order.begin(), order.end(), [this, comparison, column, newOrder](int a, int b) {
+        if (column == NameColumn) {
+            int result = comparison->getColumn(a).name.compare(comparison->getColumn(b).name);
+            return (newOrder == Qt::AscendingOrder) ? result < 0 : result > 0;
+        }
+        double valueA = this->getValue(a, column);
+        double valueB = this->getValue(b, column);
+        if (qIsNaN(valueA) || qIsNaN(valueB))
+            return !qIsNaN(valueA) && qIsNaN(valueB);
+        return (newOrder == Qt::AscendingOrder) ? valueA < valueB : valueA > valueB;
+    });
+
+    emit layoutChanged();
+}
+
+void
+SampleComparisonModel::reset(void)
+{
+    this->beginResetModel();
+    order.resize(theComparison->getNumColumns());
+    for (size_t i=0; i<order.size(); i++)
+        order[i] = static_cast<int>(i);
+    this->endResetModel();
+
+    if (sortColumn >= 0)
+        this->sort(sortColumn, sortOrder);
+}
+
+int
+SampleComparisonModel::getResultColumn(int row) const
+{
+    if (row < 0 || row >= static_cast<int>(order.size()))
+        return -1;
+    return theComparison->getColumn(order[row]).column;
+}
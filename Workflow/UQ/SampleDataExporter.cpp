@@ -0,0 +1,408 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleDataExporter.h"
+#include <SampleDataStore.h>
+
+#include <QEventLoop>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QThread>
+#include <QVector>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <string.h>
+#include <vector>
+
+#define CSV_ROWS_PER_BLOCK 4096          // rows formatted by one task
+#define BINARY_VALUES_PER_WRITE (1 << 20) // doubles per write of a column
+
+static const char *csvFilter = "CSV (*.csv)";
+static const char *numpyFilter = "NumPy (*.npy)";
+static const char *rawFilter = "Binary float64 (*.bin)";
+
+//
+// shortest digits that read back to the same double, from Qt's round-trip
+// formatter, always with a '.'. NaN, for missing entries, is left empty
+//
+
+static inline void appendValue(QByteArray &text, double value)
+{
+    if (value == value)
+        text.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+}
+
+struct CSVBlock {
+    int firstRow;
+    int numRows;
+    QByteArray text;
+};
+
+static void formatBlock(CSVBlock &block, const double * const *columns, int numCols)
+{
+    block.text.clear();
+    block.text.reserve(block.numRows*numCols*12);
+    int lastRow = block.firstRow + block.numRows;
+    for (int row=block.firstRow; row<lastRow; row++) {
+        for (int col=0; col<numCols; col++) {
+            if (col != 0)
+                block.text.append(',');
+            appendValue(block.text, columns[col][row]);
+        }
+        block.text.append('\n');
+    }
+}
+
+// headings with a separator or quote in them are quoted
+static QByteArray csvHeading(const QString &heading)
+{
+    QByteArray text = heading.toUtf8();
+    if (text.contains(',') || text.contains('"') || text.contains('\n')) {
+        text.replace("\"", "\"\"");
+        text = "\"" + text + "\"";
+    }
+    return text;
+}
+
+SampleDataExporter::SampleDataExporter(QObject *parent)
+    :QObject(parent), theData(NULL), format(CSV), cancelled(0), lastProgress(-1)
+{
+
+}
+
+SampleDataExporter::~SampleDataExporter()
+{
+    this->cancel();
+    this->wait();
+}
+
+QString
+SampleDataExporter::getFileFilters(void)
+{
+    return QString("%1;;%2;;%3").arg(csvFilter).arg(numpyFilter).arg(rawFilter);
+}
+
+SampleDataExporter::Format
+SampleDataExporter::getFormat(const QString &fileName, const QString &selectedFilter)
+{
+    QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == "npy")
+        return NumPy;
+    if (suffix == "bin")
+        return RawFloat64;
+    if (suffix == "csv")
+        return CSV;
+
+    if (selectedFilter == numpyFilter)
+        return NumPy;
+    if (selectedFilter == rawFilter)
+        return RawFloat64;
+    return CSV;
+}
+
+void
+SampleDataExporter::exportData(const SampleDataStore &theData, QWidget *parent)
+{
+    QString selectedFilter;
+    QString fileName = QFileDialog::getSaveFileName(parent,
+                                                    tr("Save Data"), "",
+                                                    getFileFilters(), &selectedFilter);
+    if (fileName.isEmpty())
+        return;
+
+    SampleDataExporter theExporter;
+    QProgressDialog progress(tr("Saving %1").arg(QFileInfo(fileName).fileName()), tr("Cancel"), 0, 100, parent);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    QEventLoop loop;
+    connect(&theExporter, SIGNAL(progressChanged(int)), &progress, SLOT(setValue(int)));
+    connect(&progress, SIGNAL(canceled()), &theExporter, SLOT(cancel()));
+    connect(&theExporter, SIGNAL(exportFinished(bool,QString)), &loop, SLOT(quit()));
+
+    if (theExporter.start(&theData, fileName, getFormat(fileName, selectedFilter)) == false)
+        return;
+
+    // the interface keeps running while the worker writes
+    loop.exec();
+    theExporter.wait();
+    progress.reset();
+
+    if (!theExporter.errorMessage.isEmpty() && theExporter.cancelled.load() == 0)
+        QMessageBox::warning(parent, tr("Save Data"), theExporter.errorMessage);
+}
+
+bool
+SampleDataExporter::start(const SampleDataStore *data, const QString &name, Format theFormat)
+{
+    if (this->isRunning())
+        return false;
+
+    theData = data;
+    fileName = name;
+    format = theFormat;
+    errorMessage.clear();
+    cancelled.store(0);
+    lastProgress = -1;
+
+    theFuture = QtConcurrent::run(this, &SampleDataExporter::run);
+    return true;
+}
+
+bool
+SampleDataExporter::isRunning(void) const
+{
+    return theFuture.isRunning();
+}
+
+void
+SampleDataExporter::wait(void)
+{
+    theFuture.waitForFinished();
+}
+
+void
+SampleDataExporter::cancel(void)
+{
+    cancelled.store(1);
+}
+
+void
+SampleDataExporter::reportProgress(qint64 done, qint64 total)
+{
+    int percent = (total > 0) ? static_cast<int>(done*100/total) : 100;
+    if (percent != lastProgress) {
+        lastProgress = percent;
+        emit progressChanged(percent);
+    }
+}
+
+bool
+SampleDataExporter::write(QFile &file, const char *data, qint64 length)
+{
+    if (file.write(data, length) != length) {
+        errorMessage = QString("Could not write ") + fileName + QString(": ") + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void
+SampleDataExporter::run(void)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("Could not open ") + fileName + QString(": ") + file.errorString();
+        emit exportFinished(false, errorMessage);
+        return;
+    }
+
+    bool ok = (format == CSV) ? this->writeCSV(file) : this->writeBinary(file);
+    file.close();
+
+    if (ok && format != CSV)
+        ok = this->writeColumnNames();
+
+    if (cancelled.load() != 0) {
+        ok = false;
+        errorMessage = QString("Saving ") + fileName + QString(" cancelled");
+    }
+
+    // a partial file is no use to anyone
+    if (!ok) {
+        QFile::remove(fileName);
+        if (format != CSV)
+            QFile::remove(fileName + QString(".columns"));
+    }
+
+    emit exportFinished(ok, ok ? fileName : errorMessage);
+}
+
+bool
+SampleDataExporter::writeCSV(QFile &file)
+{
+    int numRows = theData->getNumRows();
+    int numCols = theData->getNumColumns();
+
+    QByteArray heading;
+    for (int col=0; col<numCols; col++) {
+        if (col != 0)
+            heading.append(',');
+        heading.append(csvHeading(theData->getHeading(col)));
+    }
+    heading.append('\n');
+    if (!this->write(file, heading.constData(), heading.size()))
+        return false;
+
+    std::vector<const double *> columns(numCols);
+    for (int col=0; col<numCols; col++)
+        columns[col] = theData->getColumn(col);
+    const double * const *columnPtrs = columns.data();
+
+    //
+    // format a batch of blocks in parallel, write them in order, repeat;
+    // only one batch of text is held in memory at a time
+    //
+
+    int blocksPerBatch = QThread::idealThreadCount()*2;
+    if (blocksPerBatch < 1)
+        blocksPerBatch = 1;
+
+    QVector<CSVBlock> blocks;
+    int row = 0;
+    while (row < numRows) {
+        if (cancelled.load() != 0)
+            return false;
+
+        blocks.clear();
+        for (int i=0; i<blocksPerBatch && row < numRows; i++) {
+            CSVBlock block;
+            block.firstRow = row;
+            block.numRows = qMin(CSV_ROWS_PER_BLOCK, numRows-row);
+            blocks.append(block);
+            row += block.numRows;
+        }
+
+        QtConcurrent::blockingMap(blocks, [columnPtrs, numCols](CSVBlock &block) {
+            formatBlock(block, columnPtrs, numCols);
+        });
+
+        for (int i=0; i<blocks.size(); i++)
+            if (!this->write(file, blocks.at(i).text.constData(), blocks.at(i).text.size()))
+                return false;
+
+        this->reportProgress(row, numRows);
+    }
+
+    this->reportProgress(numRows, numRows);
+    return true;
+}
+
+bool
+SampleDataExporter::writeBinary(QFile &file)
+{
+    qint64 numRows = theData->getNumRows();
+    int numCols = theData->getNumColumns();
+
+    //
+    // .npy version 1.0 header: magic, version, header length and a python
+    // dict, padded with spaces so the data starts on a 64 byte boundary
+    //
+
+    if (format == NumPy) {
+        QByteArray dict = QString("{'descr': '<f8', 'fortran_order': True, 'shape': (%1, %2), }")
+                .arg(numRows).arg(numCols).toLatin1();
+        int preambleLength = 10;
+        int padding = 64 - (preambleLength + dict.size() + 1) % 64;
+        if (padding == 64)
+            padding = 0;
+        dict.append(QByteArray(padding, ' '));
+        dict.append('\n');
+
+        char preamble[10] = {'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00', 0, 0};
+        qToLittleEndian<quint16>(static_cast<quint16>(dict.size()), reinterpret_cast<uchar *>(preamble+8));
+        if (!this->write(file, preamble, preambleLength) || !this->write(file, dict.constData(), dict.size()))
+            return false;
+    }
+
+    //
+    // the columns as stored, one after the other, in pieces so progress can
+    // be shown and a cancel is noticed
+    //
+
+    qint64 total = numRows*numCols;
+    qint64 done = 0;
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    std::vector<quint64> swapped(BINARY_VALUES_PER_WRITE);
+#endif
+    for (int col=0; col<numCols; col++) {
+        const double *column = theData->getColumn(col);
+        for (qint64 row=0; row<numRows; row += BINARY_VALUES_PER_WRITE) {
+            if (cancelled.load() != 0)
+                return false;
+
+            qint64 numValues = qMin(static_cast<qint64>(BINARY_VALUES_PER_WRITE), numRows-row);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            for (qint64 i=0; i<numValues; i++) {
+                quint64 bits;
+                memcpy(&bits, column+row+i, sizeof(double));
+                swapped[i] = qToLittleEndian<quint64>(bits);
+            }
+            const char *data = reinterpret_cast<const char *>(swapped.data());
+#else
+            const char *data = reinterpret_cast<const char *>(column+row);
+#endif
+            if (!this->write(file, data, numValues*sizeof(double)))
+                return false;
+
+            done += numValues;
+            this->reportProgress(done, total);
+        }
+    }
+
+    this->reportProgress(total, total);
+    return true;
+}
+
+bool
+SampleDataExporter::writeColumnNames(void)
+{
+    QString columnsName = fileName + QString(".columns");
+    QFile file(columnsName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        errorMessage = QString("Could not open ") + columnsName + QString(": ") + file.errorString();
+        return false;
+    }
+
+    QByteArray text;
+    int numCols = theData->getNumColumns();
+    for (int col=0; col<numCols; col++) {
+        text.append(theData->getHeading(col).toUtf8());
+        text.append('\n');
+    }
+
+    bool ok = (file.write(text) == text.size());
+    if (!ok)
+        errorMessage = QString("Could not write ") + columnsName + QString(": ") + file.errorString();
+    file.close();
+    return ok;
+}
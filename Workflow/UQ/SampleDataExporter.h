@@ -0,0 +1,110 @@
+#ifndef SAMPLE_DATA_EXPORTER_H
+#define SAMPLE_DATA_EXPORTER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// writes the values of a SampleDataStore to a file on a worker thread, so
+// large results can be saved without blocking the interface. three formats:
+//  - CSV: a heading line then one line per row, values formatted in
+//    parallel blocks with the shortest of %.15g/%.17g that reads back exactly
+//  - NumPy .npy: a float64 (rows, cols) array in fortran order, loadable
+//    with numpy.load; the column headings go one per line to <file>.columns
+//  - raw float64: little-endian doubles column after column, as stored, for
+//    numpy.fromfile(f).reshape((cols,rows)).T; headings again in <file>.columns
+// progress is reported in percent and the export can be cancelled, the
+// partial file is then removed. the store must not change while writing
+
+#include <QObject>
+#include <QString>
+#include <QAtomicInt>
+#include <QFuture>
+
+class QFile;
+class QWidget;
+class SampleDataStore;
+
+class SampleDataExporter : public QObject
+{
+    Q_OBJECT
+public:
+    enum Format {
+        CSV = 0,
+        NumPy,
+        RawFloat64
+    };
+
+    explicit SampleDataExporter(QObject *parent = 0);
+    ~SampleDataExporter();   // cancels and waits for a running export
+
+    // the filters for a save dialog and the format chosen from its result
+    static QString getFileFilters(void);
+    static Format getFormat(const QString &fileName, const QString &selectedFilter);
+
+    // ask for a file and export to it behind a progress dialog; what the
+    // "Save Data" buttons of the result widgets call
+    static void exportData(const SampleDataStore &theData, QWidget *parent);
+
+    // start writing on a worker thread, false if one is already running
+    bool start(const SampleDataStore *theData, const QString &fileName, Format format);
+    bool isRunning(void) const;
+    void wait(void);
+
+signals:
+    void progressChanged(int percent);
+    void exportFinished(bool ok, const QString &message);
+
+public slots:
+    void cancel(void);
+
+private:
+    void run(void);
+    bool writeCSV(QFile &file);
+    bool writeBinary(QFile &file);
+    bool writeColumnNames(void);
+    bool write(QFile &file, const char *data, qint64 length);
+    void reportProgress(qint64 done, qint64 total);
+
+    const SampleDataStore *theData;
+    QString fileName;
+    Format format;
+    QString errorMessage;
+    QAtomicInt cancelled;
+    int lastProgress;
+    QFuture<void> theFuture;
+};
+
+#endif // SAMPLE_DATA_EXPORTER_H
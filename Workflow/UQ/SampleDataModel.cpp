@@ -0,0 +1,159 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleDataModel.h"
+#include <SampleDataStore.h>
+#include <QColor>
+
+SampleDataModel::SampleDataModel(const SampleDataStore *data, QObject *parent)
+    :QAbstractTableModel(parent), theData(data), theRows(NULL), highlight1(-1), highlight2(-1)
+{
+    numRows = theData->getNumRows();
+
+}
+
+SampleDataModel::~SampleDataModel()
+{
+
+}
+
+int
+SampleDataModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return numRows;
+}
+
+int
+SampleDataModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return theData->getNumColumns();
+}
+
+QVariant
+SampleDataModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    int col = index.column();
+
+    if (role == Qt::DisplayRole) {
+        int row = (theRows != NULL) ? (*theRows)[index.row()] : index.row();
+        double value = theData->getValue(row, col);
+        if (qIsNaN(value))
+            return QString();   // missing entry
+        return QString::number(value, 'g', 10);
+    }
+
+    if (role == Qt::BackgroundRole) {
+        if (col == highlight1 || col == highlight2)
+            return QColor(Qt::lightGray);
+    }
+
+    return QVariant();
+}
+
+QVariant
+SampleDataModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Horizontal) {
+        if (section < theData->getNumColumns())
+            return theData->getHeading(section);
+        return QVariant();
+    }
+
+    if (theRows != NULL && section < numRows)
+        return (*theRows)[section]+1;
+    return section+1;
+}
+
+void
+SampleDataModel::reset(void)
+{
+    this->beginResetModel();
+    numRows = (theRows != NULL) ? static_cast<int>(theRows->size()) : theData->getNumRows();
+    this->endResetModel();
+}
+
+void
+SampleDataModel::appendRows(void)
+{
+    // a subset is fixed until set again
+    if (theRows != NULL)
+        return;
+
+    int newNumRows = theData->getNumRows();
+    if (newNumRows <= numRows)
+        return;
+
+    this->beginInsertRows(QModelIndex(), numRows, newNumRows-1);
+    numRows = newNumRows;
+    this->endInsertRows();
+}
+
+void
+SampleDataModel::setRows(const std::vector<int> *rows)
+{
+    theRows = rows;
+    this->reset();
+}
+
+void
+SampleDataModel::setHighlightedColumns(int col1, int col2)
+{
+    int old1 = highlight1;
+    int old2 = highlight2;
+
+    highlight1 = col1;
+    highlight2 = col2;
+
+    if (numRows == 0)
+        return;
+
+    // only the columns that changed need repainting
+    int cols[4] = {old1, old2, col1, col2};
+    for (int i=0; i<4; i++) {
+        if (cols[i] >= 0 && cols[i] < theData->getNumColumns())
+            emit dataChanged(this->index(0, cols[i]), this->index(numRows-1, cols[i]), QVector<int>() << Qt::BackgroundRole);
+    }
+}
@@ -0,0 +1,340 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleDataStore.h"
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+#include <string.h>
+#include <vector>
+
+// identifies the layout of the "values" block, anything else is not read
+static const char *VALUE_ENCODING = "float64-le-zlib-base64";
+// and of the "valuesFile", the raw doubles without compression
+static const char *FILE_ENCODING = "float64-le";
+
+// bytes of values above which they go to a file, well under what the base64
+// text of them may take in a json document even if they do not compress
+#define VALUES_FILE_THRESHOLD (64 << 20)
+#define DOUBLES_PER_SWAP (1 << 16)   // values byte swapped at a time on big endian
+
+QString SampleDataStore::projectFile;
+int SampleDataStore::numValuesFiles = 0;
+
+SampleDataStore::SampleDataStore()
+    :numRows(0)
+{
+
+}
+
+SampleDataStore::~SampleDataStore()
+{
+
+}
+
+void
+SampleDataStore::clear(void)
+{
+    theHeadings.clear();
+    theColumns.clear();
+    numRows = 0;
+}
+
+void
+SampleDataStore::setHeadings(const QStringList &headings)
+{
+    theHeadings = headings;
+    theColumns.clear();
+    theColumns.resize(headings.size());
+    numRows = 0;
+}
+
+const QStringList &
+SampleDataStore::getHeadings(void) const
+{
+    return theHeadings;
+}
+
+QString
+SampleDataStore::getHeading(int col) const
+{
+    return theHeadings.at(col);
+}
+
+int
+SampleDataStore::getNumRows(void) const
+{
+    return numRows;
+}
+
+int
+SampleDataStore::getNumColumns(void) const
+{
+    return static_cast<int>(theColumns.size());
+}
+
+void
+SampleDataStore::reserveRows(int numRowsExpected)
+{
+    for (auto &column : theColumns)
+        column.reserve(numRowsExpected);
+}
+
+void
+SampleDataStore::resizeRows(int newNumRows)
+{
+    for (auto &column : theColumns)
+        column.resize(newNumRows, 0.0);
+    numRows = newNumRows;
+}
+
+void
+SampleDataStore::appendRow(const double *values)
+{
+    int numCols = static_cast<int>(theColumns.size());
+    for (int col=0; col<numCols; col++)
+        theColumns[col].push_back(values[col]);
+    numRows++;
+}
+
+double
+SampleDataStore::getValue(int row, int col) const
+{
+    return theColumns[col][row];
+}
+
+void
+SampleDataStore::setValue(int row, int col, double value)
+{
+    theColumns[col][row] = value;
+}
+
+const double *
+SampleDataStore::getColumn(int col) const
+{
+    return theColumns[col].data();
+}
+
+double *
+SampleDataStore::getColumnData(int col)
+{
+    return theColumns[col].data();
+}
+
+void
+SampleDataStore::setProjectFile(const QString &fileName)
+{
+    projectFile = fileName;
+    numValuesFiles = 0;
+}
+
+void
+SampleDataStore::writeJSON(QJsonObject &spreadsheetData) const
+{
+    int numCols = this->getNumColumns();
+
+    spreadsheetData["numRow"]=numRows;
+    spreadsheetData["numCol"]=numCols;
+
+    QJsonArray headingsArray;
+    for (int i = 0; i <theHeadings.size(); ++i) {
+        headingsArray.append(QJsonValue(theHeadings.at(i)));
+    }
+    spreadsheetData["headings"]=headingsArray;
+
+    // too many values for the json, e.g. project.json gets project_values.bin
+    qint64 numBytes = static_cast<qint64>(numRows)*numCols*sizeof(double);
+    if (numBytes > VALUES_FILE_THRESHOLD && !projectFile.isEmpty()) {
+        QFileInfo projectInfo(projectFile);
+        QString fileName = projectInfo.absolutePath() + QDir::separator() + projectInfo.completeBaseName() + QString("_values");
+        if (numValuesFiles != 0)
+            fileName += QString("_") + QString::number(numValuesFiles);
+        fileName += QString(".bin");
+        numValuesFiles++;
+
+        if (this->writeValuesFile(fileName)) {
+            spreadsheetData["valueEncoding"]=QString(FILE_ENCODING);
+            spreadsheetData["valuesFile"]=fileName;
+            return;
+        }
+    }
+
+    // raw bytes of the columns one after another, in little-endian order
+    QByteArray values;
+    values.resize(numRows*numCols*sizeof(double));
+    char *dest = values.data();
+    for (int col=0; col<numCols; col++) {
+        const double *column = theColumns[col].data();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        for (int row=0; row<numRows; row++) {
+            quint64 bits;
+            memcpy(&bits, column+row, sizeof(double));
+            qToLittleEndian<quint64>(bits, reinterpret_cast<uchar *>(dest)+row*sizeof(double));
+        }
+#else
+        memcpy(dest, column, numRows*sizeof(double));
+#endif
+        dest += numRows*sizeof(double);
+    }
+
+    // fastest compression level, doubles do not compress much beyond it
+    spreadsheetData["valueEncoding"]=QString(VALUE_ENCODING);
+    spreadsheetData["values"]=QString::fromLatin1(qCompress(values, 1).toBase64());
+}
+
+bool
+SampleDataStore::readJSON(const QJsonObject &spreadsheetData)
+{
+    int numRow = spreadsheetData["numRow"].toInt();
+    int numCol = spreadsheetData["numCol"].toInt();
+
+    QStringList headings;
+    QJsonArray headingData= spreadsheetData["headings"].toArray();
+    for (int i=0; i<numCol; i++) {
+        headings << headingData.at(i).toString();
+    }
+
+    this->setHeadings(headings);
+    this->resizeRows(numRow);
+
+    if (spreadsheetData.contains("valuesFile")) {
+
+        if (spreadsheetData["valueEncoding"].toString() != QString(FILE_ENCODING))
+            return false;
+
+        return this->readValuesFile(spreadsheetData["valuesFile"].toString());
+
+    } else if (spreadsheetData.contains("values")) {
+
+        if (spreadsheetData["valueEncoding"].toString() != QString(VALUE_ENCODING))
+            return false;
+
+        QByteArray values = qUncompress(QByteArray::fromBase64(spreadsheetData["values"].toString().toLatin1()));
+        if (values.size() != static_cast<int>(numRow*numCol*sizeof(double)))
+            return false;
+
+        const char *src = values.constData();
+        for (int col=0; col<numCol; col++) {
+            double *column = theColumns[col].data();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+            for (int row=0; row<numRow; row++) {
+                quint64 bits = qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(src)+row*sizeof(double));
+                memcpy(column+row, &bits, sizeof(double));
+            }
+#else
+            memcpy(column, src, numRow*sizeof(double));
+#endif
+            src += numRow*sizeof(double);
+        }
+
+    } else {
+
+        // files written before the binary block, one json number per cell row by row
+        QJsonArray dataData= spreadsheetData["data"].toArray();
+        int dataCount =0;
+        for (int row =0; row<numRow; row++) {
+            for (int col=0; col<numCol; col++) {
+                theColumns[col][row] = dataData.at(dataCount).toDouble();
+                dataCount++;
+            }
+        }
+    }
+
+    return true;
+}
+
+// the columns one after another as little-endian doubles, written straight
+// from the columns so the values are never held twice
+bool
+SampleDataStore::writeValuesFile(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    qint64 columnBytes = static_cast<qint64>(numRows)*sizeof(double);
+    for (int col=0; col<this->getNumColumns(); col++) {
+        const double *column = theColumns[col].data();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        std::vector<quint64> swapped(DOUBLES_PER_SWAP);
+        for (int row=0; row<numRows; row += DOUBLES_PER_SWAP) {
+            int count = qMin(DOUBLES_PER_SWAP, numRows-row);
+            for (int i=0; i<count; i++) {
+                quint64 bits;
+                memcpy(&bits, column+row+i, sizeof(double));
+                swapped[i] = qToLittleEndian(bits);
+            }
+            qint64 bytes = count*sizeof(double);
+            if (file.write(reinterpret_cast<const char *>(swapped.data()), bytes) != bytes)
+                return false;
+        }
+#else
+        if (file.write(reinterpret_cast<const char *>(column), columnBytes) != columnBytes)
+            return false;
+#endif
+    }
+
+    return file.commit();
+}
+
+bool
+SampleDataStore::readValuesFile(const QString &fileName)
+{
+    QFile file(fileName);
+    qint64 columnBytes = static_cast<qint64>(numRows)*sizeof(double);
+    if (!file.open(QIODevice::ReadOnly) || file.size() != columnBytes*this->getNumColumns())
+        return false;
+
+    for (int col=0; col<this->getNumColumns(); col++) {
+        double *column = theColumns[col].data();
+        if (file.read(reinterpret_cast<char *>(column), columnBytes) != columnBytes)
+            return false;
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        for (int row=0; row<numRows; row++) {
+            quint64 bits;
+            memcpy(&bits, column+row, sizeof(double));
+            bits = qFromLittleEndian(bits);
+            memcpy(column+row, &bits, sizeof(double));
+        }
+#endif
+    }
+
+    return true;
+}
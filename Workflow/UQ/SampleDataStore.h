@@ -0,0 +1,100 @@
+#ifndef SAMPLE_DATA_STORE_H
+#define SAMPLE_DATA_STORE_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// a columnar store for the sample results, one contiguous array of doubles
+// per column. the result widgets own one of these and every consumer (stats,
+// charts, export, json) reads the raw values from it
+
+#include <QStringList>
+#include <vector>
+
+class QJsonObject;
+
+class SampleDataStore
+{
+public:
+    SampleDataStore();
+    ~SampleDataStore();
+
+    void clear(void);
+
+    // setting the headings resets the store to that many empty columns
+    void setHeadings(const QStringList &headings);
+    const QStringList &getHeadings(void) const;
+    QString getHeading(int col) const;
+
+    int getNumRows(void) const;
+    int getNumColumns(void) const;
+
+    void reserveRows(int numRows);
+    void resizeRows(int numRows);
+    void appendRow(const double *values);
+
+    double getValue(int row, int col) const;
+    void setValue(int row, int col, double value);
+
+    const double *getColumn(int col) const;
+    double *getColumnData(int col);
+
+    // the "spreadsheet" object of the results json: the headings and the
+    // values as one base64 block of compressed little-endian doubles, column
+    // after column. values too many for a json document, which Qt caps at
+    // about 128 MB, are written raw to a file beside the project file and
+    // only its path is in the json. reading also accepts the older array of
+    // one number per cell
+    void writeJSON(QJsonObject &spreadsheetData) const;
+    bool readJSON(const QJsonObject &spreadsheetData);
+
+    // the project file being saved, which the value files are named after;
+    // without one all values are written into the json
+    static void setProjectFile(const QString &fileName);
+
+private:
+    bool writeValuesFile(const QString &fileName) const;
+    bool readValuesFile(const QString &fileName);
+
+    static QString projectFile;
+    static int numValuesFiles;   // written since the project file was set
+
+    QStringList theHeadings;
+    std::vector<std::vector<double> > theColumns;
+    int numRows;
+};
+
+#endif // SAMPLE_DATA_STORE_H
@@ -0,0 +1,470 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleFilter.h"
+#include <SampleDataStore.h>
+
+#include <QRegExp>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+#define WORD_BITS 64
+#define BLOCK_WORDS 1024         // bitmap words per parallel task, 64k rows
+#define SPARSE_FRACTION 16       // matching 1/16 of the rows or less, set bits from the index
+
+static inline int popCount(quint64 word)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word != 0; word &= word-1)
+        count++;
+    return count;
+#endif
+}
+
+static inline int lowestBit(quint64 word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+SamplePredicate::SamplePredicate()
+    :column(-1),
+      lower(-std::numeric_limits<double>::infinity()),
+      upper(std::numeric_limits<double>::infinity()),
+      lowerInclusive(true), upperInclusive(true)
+{
+
+}
+
+bool
+SamplePredicate::contains(double value) const
+{
+    // false for NaN
+    bool aboveLower = lowerInclusive ? (value >= lower) : (value > lower);
+    bool belowUpper = upperInclusive ? (value <= upper) : (value < upper);
+    return aboveLower && belowUpper;
+}
+
+SampleFilter::SampleFilter(const SampleDataStore *data)
+    :theData(data), numRows(0)
+{
+
+}
+
+SampleFilter::~SampleFilter()
+{
+
+}
+
+void
+SampleFilter::clear(void)
+{
+    theExpression.clear();
+    thePredicates.clear();
+    numRows = 0;
+    theMask.clear();
+    theRows.clear();
+    theIndices.clear();
+    theSortedValues.clear();
+    indexedRows.clear();
+}
+
+//
+// reading the expression
+//
+
+static bool readNumber(const QString &text, double &value)
+{
+    bool ok = false;
+    value = text.toDouble(&ok);
+    return ok;
+}
+
+static int findColumn(const QStringList &headings, const QString &name)
+{
+    int col = headings.indexOf(name);
+    if (col >= 0)
+        return col;
+    for (int i=0; i<headings.length(); i++)
+        if (headings.at(i).compare(name, Qt::CaseInsensitive) == 0)
+            return i;
+    return -1;
+}
+
+// applies "column op value" to the predicate
+static void applyBound(SamplePredicate &predicate, const QString &op, double value)
+{
+    if (op == "<" || op == "<=") {
+        if (value < predicate.upper || (value == predicate.upper && op == "<")) {
+            predicate.upper = value;
+            predicate.upperInclusive = (op == "<=");
+        }
+    } else if (op == ">" || op == ">=") {
+        if (value > predicate.lower || (value == predicate.lower && op == ">")) {
+            predicate.lower = value;
+            predicate.lowerInclusive = (op == ">=");
+        }
+    } else {
+        applyBound(predicate, "<=", value);
+        applyBound(predicate, ">=", value);
+    }
+}
+
+// "value op column" is "column op' value"
+static QString flipOperator(const QString &op)
+{
+    if (op == "<")
+        return ">";
+    if (op == "<=")
+        return ">=";
+    if (op == ">")
+        return "<";
+    if (op == ">=")
+        return "<=";
+    return op;
+}
+
+bool
+SampleFilter::setExpression(const QString &expression, QString &errorMessage)
+{
+    QVector<SamplePredicate> predicates;
+    const QStringList &headings = theData->getHeadings();
+
+    QStringList clauses = expression.split(QRegExp("\\s+and\\s+|&&|,", Qt::CaseInsensitive),
+                                           QString::SkipEmptyParts);
+    QRegExp operators("<=|>=|==|<|>|=");
+
+    foreach (const QString &clause, clauses) {
+        if (clause.trimmed().isEmpty())
+            continue;
+
+        // split into operands and the operators between them
+        QStringList operands;
+        QStringList ops;
+        int start = 0;
+        int pos = 0;
+        while ((pos = operators.indexIn(clause, start)) >= 0) {
+            operands << clause.mid(start, pos-start).trimmed();
+            QString op = operators.cap(0);
+            ops << ((op == "==") ? QString("=") : op);
+            start = pos + operators.matchedLength();
+        }
+        operands << clause.mid(start).trimmed();
+
+        if (ops.isEmpty() || ops.length() > 2 || operands.contains(QString())) {
+            errorMessage = QString("can not read \"") + clause.trimmed() + QString("\"");
+            return false;
+        }
+
+        SamplePredicate predicate;
+        if (ops.length() == 1) {
+            double value;
+            int col = findColumn(headings, operands.at(0));
+            if (col >= 0 && readNumber(operands.at(1), value)) {
+                applyBound(predicate, ops.at(0), value);
+            } else {
+                col = findColumn(headings, operands.at(1));
+                if (col < 0 || !readNumber(operands.at(0), value)) {
+                    errorMessage = QString("\"") + clause.trimmed() + QString("\" needs a column and a number");
+                    return false;
+                }
+                applyBound(predicate, flipOperator(ops.at(0)), value);
+            }
+            predicate.column = col;
+        } else {
+            // value op column op value, both bounds the same way round
+            double first, second;
+            int col = findColumn(headings, operands.at(1));
+            bool sameWay = (ops.at(0).at(0) == ops.at(1).at(0)) && ops.at(0) != "=";
+            if (col < 0 || !sameWay || !readNumber(operands.at(0), first) || !readNumber(operands.at(2), second)) {
+                errorMessage = QString("\"") + clause.trimmed() + QString("\" needs a range such as 0.01 < name <= 0.02");
+                return false;
+            }
+            applyBound(predicate, flipOperator(ops.at(0)), first);
+            applyBound(predicate, ops.at(1), second);
+            predicate.column = col;
+        }
+
+        predicates.append(predicate);
+    }
+
+    theExpression = expression.trimmed();
+    thePredicates = predicates;
+    errorMessage.clear();
+    return true;
+}
+
+QString
+SampleFilter::getExpression(void) const
+{
+    return theExpression;
+}
+
+void
+SampleFilter::setPredicates(const QVector<SamplePredicate> &predicates)
+{
+    theExpression.clear();
+    thePredicates = predicates;
+}
+
+const QVector<SamplePredicate> &
+SampleFilter::getPredicates(void) const
+{
+    return thePredicates;
+}
+
+bool
+SampleFilter::isActive(void) const
+{
+    return !thePredicates.isEmpty();
+}
+
+//
+// the indices
+//
+
+void
+SampleFilter::indexColumns(void)
+{
+    int numCols = theData->getNumColumns();
+    int rows = theData->getNumRows();
+    if (static_cast<int>(theIndices.size()) != numCols) {
+        theIndices.assign(numCols, std::vector<int>());
+        theSortedValues.assign(numCols, std::vector<double>());
+        indexedRows.assign(numCols, -1);
+    }
+
+    QVector<int> columns;
+    foreach (const SamplePredicate &predicate, thePredicates)
+        if (indexedRows[predicate.column] != rows && !columns.contains(predicate.column))
+            columns.append(predicate.column);
+
+    // each task only touches its own column's vectors
+    QtConcurrent::blockingMap(columns, [this, rows](int &col) {
+        const double *values = theData->getColumn(col);
+        std::vector<std::pair<double, int> > pairs;
+        pairs.reserve(rows);
+        for (int i=0; i<rows; i++)
+            if (values[i] == values[i])     // no NaN, they would break the order
+                pairs.push_back(std::make_pair(values[i], i));
+        std::sort(pairs.begin(), pairs.end());
+
+        std::vector<int> &index = theIndices[col];
+        std::vector<double> &sorted = theSortedValues[col];
+        index.resize(pairs.size());
+        sorted.resize(pairs.size());
+        for (size_t i=0; i<pairs.size(); i++) {
+            sorted[i] = pairs[i].first;
+            index[i] = pairs[i].second;
+        }
+        indexedRows[col] = rows;
+    });
+}
+
+//
+// evaluation
+//
+
+struct FilterBlock {
+    int firstWord;
+    int numWords;
+    int count;
+};
+
+int
+SampleFilter::apply(void)
+{
+    numRows = theData->getNumRows();
+    int numWords = (numRows + WORD_BITS-1)/WORD_BITS;
+
+    // start with every row, the bits past the last row clear
+    theMask.assign(numWords, ~quint64(0));
+    if (numRows % WORD_BITS != 0)
+        theMask[numWords-1] = (quint64(1) << (numRows % WORD_BITS)) - 1;
+
+    QVector<FilterBlock> blocks;
+    for (int word=0; word<numWords; word+=BLOCK_WORDS) {
+        FilterBlock block;
+        block.firstWord = word;
+        block.numWords = std::min(BLOCK_WORDS, numWords-word);
+        block.count = 0;
+        blocks.append(block);
+    }
+
+    this->indexColumns();
+
+    //
+    // the most selective predicates first, as few rows match them their bits
+    // come straight from the index; the rest are scanned in one pass
+    //
+
+    QVector<QPair<int, int> > ranges;    // position in the index of the first match and the count
+    QVector<int> order;
+    for (int i=0; i<thePredicates.size(); i++) {
+        const SamplePredicate &predicate = thePredicates.at(i);
+        const std::vector<double> &sorted = theSortedValues[predicate.column];
+        std::vector<double>::const_iterator first = predicate.lowerInclusive ?
+                    std::lower_bound(sorted.begin(), sorted.end(), predicate.lower) :
+                    std::upper_bound(sorted.begin(), sorted.end(), predicate.lower);
+        std::vector<double>::const_iterator last = predicate.upperInclusive ?
+                    std::upper_bound(first, sorted.end(), predicate.upper) :
+                    std::lower_bound(first, sorted.end(), predicate.upper);
+        ranges.append(qMakePair(static_cast<int>(first-sorted.begin()), static_cast<int>(last-first)));
+        order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&ranges](int a, int b) {
+        return ranges[a].second < ranges[b].second;
+    });
+
+    QVector<const SamplePredicate *> scanned;
+    std::vector<quint64> matches;
+    foreach (int i, order) {
+        const SamplePredicate &predicate = thePredicates.at(i);
+        int count = ranges[i].second;
+        if (count == 0) {
+            // nothing can pass
+            std::fill(theMask.begin(), theMask.end(), 0);
+            scanned.clear();
+            break;
+        }
+        if (count > numRows/SPARSE_FRACTION) {
+            scanned.append(&predicate);
+            continue;
+        }
+
+        matches.assign(numWords, 0);
+        const int *rows = theIndices[predicate.column].data() + ranges[i].first;
+        for (int j=0; j<count; j++)
+            matches[rows[j]/WORD_BITS] |= quint64(1) << (rows[j] % WORD_BITS);
+        for (int word=0; word<numWords; word++)
+            theMask[word] &= matches[word];
+    }
+
+    QtConcurrent::blockingMap(blocks, [this, &scanned](FilterBlock &block) {
+        quint64 *mask = theMask.data();
+        for (int p=0; p<scanned.size(); p++) {
+            const SamplePredicate &predicate = *scanned.at(p);
+            const double *values = theData->getColumn(predicate.column);
+            for (int word=block.firstWord; word<block.firstWord+block.numWords; word++) {
+                if (mask[word] == 0)
+                    continue;
+                const double *wordValues = values + word*WORD_BITS;
+                int numBits = std::min(WORD_BITS, numRows - word*WORD_BITS);
+                quint64 bits = 0;
+                for (int bit=0; bit<numBits; bit++)
+                    bits |= quint64(predicate.contains(wordValues[bit])) << bit;
+                mask[word] &= bits;
+            }
+        }
+
+        int count = 0;
+        for (int word=block.firstWord; word<block.firstWord+block.numWords; word++)
+            count += popCount(mask[word]);
+        block.count = count;
+    });
+
+    //
+    // the selected rows, each block writing from its offset
+    //
+
+    QVector<int> offsets;
+    int numSelected = 0;
+    for (int i=0; i<blocks.size(); i++) {
+        offsets.append(numSelected);
+        numSelected += blocks[i].count;
+    }
+    theRows.resize(numSelected);
+
+    QVector<int> blockNumbers;
+    for (int i=0; i<blocks.size(); i++)
+        blockNumbers.append(i);
+    QtConcurrent::blockingMap(blockNumbers, [this, &blocks, &offsets](int &i) {
+        const FilterBlock &block = blocks.at(i);
+        int *rows = theRows.data() + offsets.at(i);
+        for (int word=block.firstWord; word<block.firstWord+block.numWords; word++) {
+            for (quint64 bits=theMask[word]; bits != 0; bits &= bits-1)
+                *rows++ = word*WORD_BITS + lowestBit(bits);
+        }
+    });
+
+    return numSelected;
+}
+
+int
+SampleFilter::getNumRows(void) const
+{
+    return numRows;
+}
+
+int
+SampleFilter::getNumSelected(void) const
+{
+    return static_cast<int>(theRows.size());
+}
+
+bool
+SampleFilter::isSelected(int row) const
+{
+    if (row < 0 || row >= numRows)
+        return false;
+    return (theMask[row/WORD_BITS] >> (row % WORD_BITS)) & 1;
+}
+
+const std::vector<quint64> &
+SampleFilter::getMask(void) const
+{
+    return theMask;
+}
+
+const std::vector<int> &
+SampleFilter::getRows(void) const
+{
+    return theRows;
+}
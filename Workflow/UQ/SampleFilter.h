@@ -0,0 +1,119 @@
+#ifndef SAMPLE_FILTER_H
+#define SAMPLE_FILTER_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// selects the rows of a SampleDataStore that satisfy range predicates on its
+// columns, e.g. "drift > 0.02 and 1.0 <= PFA < 1.5". the data is not copied:
+// the result is a bitmap of one bit per row and the selected row numbers.
+//  - a predicate on a column that has an index (the row numbers sorted by
+//    value, made the first time the column is filtered on) is answered by two
+//    binary searches; if few rows match only their bits are set
+//  - otherwise the column is scanned, blocks of the bitmap in parallel, and
+//    words already cleared by an earlier predicate are skipped
+// rows with a NaN in a filtered column never match
+
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include <vector>
+
+class SampleDataStore;
+
+class SamplePredicate
+{
+public:
+    SamplePredicate();
+
+    bool contains(double value) const;
+
+    int column;
+    double lower;          // -inf if none
+    double upper;          // +inf if none
+    bool lowerInclusive;
+    bool upperInclusive;
+};
+
+class SampleFilter
+{
+public:
+    explicit SampleFilter(const SampleDataStore *theData);
+    ~SampleFilter();
+
+    // drops the predicates, the selection and the indices
+    void clear(void);
+
+    // clauses "name op value", "value op name" or "value op name op value"
+    // with op one of < <= > >= =, joined by "and", "&&" or ","; an empty
+    // expression removes all predicates. returns false, and leaves the
+    // predicates as they were, if the expression can not be read
+    bool setExpression(const QString &expression, QString &errorMessage);
+    QString getExpression(void) const;
+
+    void setPredicates(const QVector<SamplePredicate> &predicates);
+    const QVector<SamplePredicate> &getPredicates(void) const;
+    bool isActive(void) const;
+
+    // evaluates the predicates over the rows now in the store, returns the
+    // number of rows selected. with no predicates every row is selected
+    int apply(void);
+
+    int getNumRows(void) const;        // rows when last applied
+    int getNumSelected(void) const;
+    bool isSelected(int row) const;
+    const std::vector<quint64> &getMask(void) const;
+    const std::vector<int> &getRows(void) const;
+
+private:
+    // (re)makes the indices of the filtered columns missing one, in parallel
+    void indexColumns(void);
+
+    const SampleDataStore *theData;
+    QString theExpression;
+    QVector<SamplePredicate> thePredicates;
+
+    int numRows;
+    std::vector<quint64> theMask;
+    std::vector<int> theRows;
+
+    // per column, the rows with a value sorted by value and those values
+    std::vector<std::vector<int> > theIndices;
+    std::vector<std::vector<double> > theSortedValues;
+    std::vector<int> indexedRows;      // rows in the store when each was made
+};
+
+#endif // SAMPLE_FILTER_H
@@ -0,0 +1,322 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SampleStatistics.h"
+#include <SampleDataStore.h>
+#include <SampleColumnCache.h>
+#include <QuantileSketch.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <math.h>
+
+// values per block, a block of doubles stays in L1 cache between its two passes
+static const int BLOCK_SIZE = 1024;
+
+// values per parallel task, long columns are split in segments of this size
+static const int SEGMENT_SIZE = 1 << 16;
+
+const double SampleStatistics::percentileLevels[NUM_PERCENTILES] = {0.05, 0.5, 0.95};
+
+ColumnStatistics::ColumnStatistics()
+    :count(0), mean(0), stdDev(0), skewness(0), kurtosis(0), min(NAN), max(NAN)
+{
+    for (int i=0; i<NUM_PERCENTILES; i++)
+        percentiles[i] = NAN;
+}
+
+void
+ColumnStatistics::setMoments(const OnlineMoments &moments)
+{
+    count = moments.getCount();
+    mean = moments.getMean();
+    stdDev = moments.getStdDev();
+    skewness = moments.getSkewness();
+    kurtosis = moments.getKurtosis();
+}
+
+//
+// moments of one block, four independent lanes in each pass so the loops
+// can be vectorized; the second pass runs on data still in cache
+//
+
+static void blockMoments(const double *x, int n, OnlineMoments &moments, double &min, double &max)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    double lo0 = x[0], lo1 = x[0], lo2 = x[0], lo3 = x[0];
+    double hi0 = x[0], hi1 = x[0], hi2 = x[0], hi3 = x[0];
+
+    int n4 = n - n%4;
+    for (int i=0; i<n4; i+=4) {
+        s0 += x[i]; s1 += x[i+1]; s2 += x[i+2]; s3 += x[i+3];
+        lo0 = x[i]   < lo0 ? x[i]   : lo0;
+        lo1 = x[i+1] < lo1 ? x[i+1] : lo1;
+        lo2 = x[i+2] < lo2 ? x[i+2] : lo2;
+        lo3 = x[i+3] < lo3 ? x[i+3] : lo3;
+        hi0 = x[i]   > hi0 ? x[i]   : hi0;
+        hi1 = x[i+1] > hi1 ? x[i+1] : hi1;
+        hi2 = x[i+2] > hi2 ? x[i+2] : hi2;
+        hi3 = x[i+3] > hi3 ? x[i+3] : hi3;
+    }
+    for (int i=n4; i<n; i++) {
+        s0 += x[i];
+        lo0 = x[i] < lo0 ? x[i] : lo0;
+        hi0 = x[i] > hi0 ? x[i] : hi0;
+    }
+
+    double mean = ((s0+s1) + (s2+s3))/n;
+    min = std::min(std::min(lo0, lo1), std::min(lo2, lo3));
+    max = std::max(std::max(hi0, hi1), std::max(hi2, hi3));
+
+    double a[4] = {0,0,0,0};  // sum of deviations, corrects rounding in the mean
+    double b[4] = {0,0,0,0};
+    double c[4] = {0,0,0,0};
+    double d[4] = {0,0,0,0};
+    for (int i=0; i<n4; i+=4) {
+        for (int j=0; j<4; j++) {
+            double dev = x[i+j] - mean;
+            double dev2 = dev*dev;
+            a[j] += dev;
+            b[j] += dev2;
+            c[j] += dev2*dev;
+            d[j] += dev2*dev2;
+        }
+    }
+    for (int i=n4; i<n; i++) {
+        double dev = x[i] - mean;
+        double dev2 = dev*dev;
+        a[0] += dev;
+        b[0] += dev2;
+        c[0] += dev2*dev;
+        d[0] += dev2*dev2;
+    }
+
+    double sumDev = (a[0]+a[1]) + (a[2]+a[3]);
+    double correction = sumDev/n;
+
+    moments.setSums(n, mean + correction,
+                    ((b[0]+b[1]) + (b[2]+b[3])) - sumDev*correction,
+                    (c[0]+c[1]) + (c[2]+c[3]),
+                    (d[0]+d[1]) + (d[2]+d[3]));
+}
+
+// merge neighbours, then neighbours of neighbours, ... into the first entry
+static void mergePairwise(std::vector<OnlineMoments> &moments)
+{
+    size_t num = moments.size();
+    for (size_t stride = 1; stride < num; stride *= 2)
+        for (size_t i = 0; i+stride < num; i += 2*stride)
+            moments[i].merge(moments[i+stride]);
+}
+
+void
+SampleStatistics::computeMoments(const double *values, int numValues,
+                                 OnlineMoments &moments, double &min, double &max)
+{
+    moments.clear();
+    if (numValues <= 0) {
+        min = 0;
+        max = 0;
+        return;
+    }
+
+    int numBlocks = (numValues + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    std::vector<OnlineMoments> blocks(numBlocks);
+
+    min = values[0];
+    max = values[0];
+    for (int i=0; i<numBlocks; i++) {
+        int start = i*BLOCK_SIZE;
+        int num = std::min(BLOCK_SIZE, numValues-start);
+        double blockMin, blockMax;
+        blockMoments(values+start, num, blocks[i], blockMin, blockMax);
+        min = std::min(min, blockMin);
+        max = std::max(max, blockMax);
+    }
+
+    mergePairwise(blocks);
+    moments = blocks[0];
+}
+
+double
+SampleStatistics::computePercentile(std::vector<double> &values, double p)
+{
+    size_t num = values.size();
+    if (num == 0)
+        return NAN;
+
+    double position = p*(num-1);
+    size_t below = static_cast<size_t>(floor(position));
+    if (below >= num-1)
+        below = num-1;
+    double fraction = position - below;
+
+    std::nth_element(values.begin(), values.begin()+below, values.end());
+    double lower = values[below];
+    if (fraction == 0 || below+1 >= num)
+        return lower;
+
+    // next order statistic is the smallest of those above
+    double upper = *std::min_element(values.begin()+below+1, values.end());
+    return lower + fraction*(upper-lower);
+}
+
+double
+SampleStatistics::sortedPercentile(const std::vector<double> &sorted, double p)
+{
+    size_t num = sorted.size();
+    if (num == 0)
+        return NAN;
+
+    double position = p*(num-1);
+    size_t below = static_cast<size_t>(floor(position));
+    if (below >= num-1)
+        return sorted[num-1];
+    double fraction = position - below;
+    return sorted[below] + fraction*(sorted[below+1]-sorted[below]);
+}
+
+struct StatisticsSegment {
+    const double *values;
+    const int *rows;      // rows of values to take, NULL for consecutive values
+    int numValues;
+    int column;
+    OnlineMoments moments;
+    double min;
+    double max;
+};
+
+QVector<ColumnStatistics>
+SampleStatistics::computeColumns(const SampleDataStore &theData, int firstCol, int lastCol,
+                                 SampleColumnCache &sortedColumns)
+{
+    QVector<ColumnStatistics> result = computeColumnMoments(theData, firstCol, lastCol, sortedColumns.getRows());
+    if (result.isEmpty() || sortedColumns.getNumRows() == 0)
+        return result;
+
+    // the sorts, one column per task, are shared with the plots of the columns
+    sortedColumns.sortColumns(firstCol, lastCol);
+    for (int col=0; col<result.size(); col++) {
+        const std::vector<double> &sorted = sortedColumns.getSortedColumn(firstCol+col);
+        for (int i=0; i<NUM_PERCENTILES; i++)
+            result[col].percentiles[i] = sortedPercentile(sorted, percentileLevels[i]);
+    }
+
+    return result;
+}
+
+QVector<ColumnStatistics>
+SampleStatistics::computeColumns(const SampleDataStore &theData, int firstCol, int lastCol,
+                                 const QVector<QuantileSketch> &sketches)
+{
+    QVector<ColumnStatistics> result = computeColumnMoments(theData, firstCol, lastCol, NULL);
+    for (int col=0; col<result.size() && firstCol+col<sketches.size(); col++) {
+        const QuantileSketch &sketch = sketches.at(firstCol+col);
+        if (sketch.getCount() != 0)
+            for (int i=0; i<NUM_PERCENTILES; i++)
+                result[col].percentiles[i] = sketch.quantile(percentileLevels[i]);
+    }
+
+    return result;
+}
+
+QVector<ColumnStatistics>
+SampleStatistics::computeColumnMoments(const SampleDataStore &theData, int firstCol, int lastCol,
+                                       const std::vector<int> *rows)
+{
+    QVector<ColumnStatistics> result;
+    int numRows = rows ? static_cast<int>(rows->size()) : theData.getNumRows();
+    int numCols = lastCol-firstCol+1;
+    if (numCols <= 0)
+        return result;
+    result.resize(numCols);
+    if (numRows == 0)
+        return result;
+
+    //
+    // moments: every column split in segments, all segments run in parallel
+    //
+
+    QVector<StatisticsSegment> segments;
+    for (int col=firstCol; col<=lastCol; col++) {
+        const double *values = theData.getColumn(col);
+        for (int start=0; start<numRows; start+=SEGMENT_SIZE) {
+            StatisticsSegment segment;
+            segment.values = rows ? values : values+start;
+            segment.rows = rows ? rows->data()+start : NULL;
+            segment.numValues = std::min(SEGMENT_SIZE, numRows-start);
+            segment.column = col-firstCol;
+            segment.min = 0;
+            segment.max = 0;
+            segments.append(segment);
+        }
+    }
+
+    QtConcurrent::blockingMap(segments, [](StatisticsSegment &segment) {
+        // a subset of rows is gathered a segment at a time, the column is not copied
+        const double *values = segment.values;
+        std::vector<double> gathered;
+        if (segment.rows != NULL) {
+            gathered.resize(segment.numValues);
+            for (int i=0; i<segment.numValues; i++)
+                gathered[i] = segment.values[segment.rows[i]];
+            values = gathered.data();
+        }
+        SampleStatistics::computeMoments(values, segment.numValues,
+                                         segment.moments, segment.min, segment.max);
+    });
+
+    // segments are in column order, merge those of each column pairwise
+    int segment = 0;
+    for (int col=0; col<numCols; col++) {
+        std::vector<OnlineMoments> columnMoments;
+        double min = segments.at(segment).min;
+        double max = segments.at(segment).max;
+        while (segment < segments.size() && segments.at(segment).column == col) {
+            columnMoments.push_back(segments.at(segment).moments);
+            min = std::min(min, segments.at(segment).min);
+            max = std::max(max, segments.at(segment).max);
+            segment++;
+        }
+        mergePairwise(columnMoments);
+        result[col].setMoments(columnMoments[0]);
+        result[col].min = min;
+        result[col].max = max;
+    }
+
+    return result;
+}
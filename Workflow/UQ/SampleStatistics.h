@@ -0,0 +1,106 @@
+#ifndef SAMPLE_STATISTICS_H
+#define SAMPLE_STATISTICS_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// summary statistics for the columns of a SampleDataStore. each column is read
+// once: values are taken a cache sized block at a time, the block moments are
+// formed with independent accumulators the compiler can vectorize and the
+// blocks are then combined by pairwise merging. columns, and long columns in
+// segments, are processed in parallel. percentiles are read from columns
+// already sorted for the plots, or from the quantile sketches of the columns,
+// so no column is copied or reordered here
+
+#include <OnlineMoments.h>
+#include <QVector>
+#include <vector>
+
+class SampleDataStore;
+class SampleColumnCache;
+class QuantileSketch;
+
+#define NUM_PERCENTILES 3
+
+class ColumnStatistics
+{
+public:
+    ColumnStatistics();
+    void setMoments(const OnlineMoments &moments);
+
+    double count;
+    double mean;
+    double stdDev;
+    double skewness;
+    double kurtosis;
+    double min;
+    double max;
+    double percentiles[NUM_PERCENTILES]; // at SampleStatistics::percentileLevels, NAN if not known
+};
+
+class SampleStatistics
+{
+public:
+    static const double percentileLevels[NUM_PERCENTILES];
+
+    // moments, min and max of one column
+    static void computeMoments(const double *values, int numValues,
+                               OnlineMoments &moments, double &min, double &max);
+
+    // percentile p in [0,1] by linear interpolation between order statistics,
+    // reorders the values
+    static double computePercentile(std::vector<double> &values, double p);
+
+    // the same of values already in increasing order
+    static double sortedPercentile(const std::vector<double> &sorted, double p);
+
+    // full statistics for columns firstCol to lastCol inclusive, over the rows
+    // of the cache, e.g. those passing a SampleFilter; the percentiles are of
+    // its sorted columns, which are sorted here if not already
+    static QVector<ColumnStatistics> computeColumns(const SampleDataStore &theData, int firstCol, int lastCol,
+                                                    SampleColumnCache &sortedColumns);
+
+    // the same over all the rows with the percentiles from sketches of the
+    // columns, indexed by column, for when the cache holds a subset
+    static QVector<ColumnStatistics> computeColumns(const SampleDataStore &theData, int firstCol, int lastCol,
+                                                    const QVector<QuantileSketch> &sketches);
+
+private:
+    static QVector<ColumnStatistics> computeColumnMoments(const SampleDataStore &theData, int firstCol, int lastCol,
+                                                          const std::vector<int> *rows);
+};
+
+#endif // SAMPLE_STATISTICS_H
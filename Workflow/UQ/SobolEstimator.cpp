@@ -0,0 +1,563 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+#include "SobolEstimator.h"
+#include <SampleDataStore.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <numeric>
+#include <math.h>
+
+// first order (or for unmatched inputs total) index an input needs, for some
+// output, to be matched on
+static const double SCREENING_THRESHOLD = 0.01;
+
+// the samples are bootstrapped for the first order indices in this many groups
+static const int NUM_GROUPS = 64;
+
+// queries share a pass over a tile of samples, sized to stay in cache
+static const int QUERY_BLOCK_SIZE = 32;
+static const int SAMPLE_TILE_SIZE = 2048;
+
+SobolIndex::SobolIndex()
+    :main(0), mainLower(0), mainUpper(0), total(0), totalLower(0), totalUpper(0)
+{
+
+}
+
+SobolEstimator::SobolEstimator()
+    :numBootstrap(100), numQueries(500), numRows(0), numRV(0), numEDP(0), numBins(0)
+{
+
+}
+
+SobolEstimator::~SobolEstimator()
+{
+
+}
+
+void
+SobolEstimator::setNumBootstrap(int num)
+{
+    numBootstrap = num;
+}
+
+void
+SobolEstimator::setNumQueries(int num)
+{
+    numQueries = num;
+}
+
+int
+SobolEstimator::getNumBins(void) const
+{
+    return numBins;
+}
+
+const SobolIndex &
+SobolEstimator::getIndex(int edp, int rv) const
+{
+    return theIndices.at(edp*numRV + rv);
+}
+
+//
+// bootstrap replicate r draws sample i Poisson(1) times; the draws come from a
+// hash of (r, i) so they do not depend on how the work is split over threads
+//
+
+static inline quint64 splitMix64(quint64 x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static unsigned char poissonOne(quint64 hash)
+{
+    // inverse of the Poisson(1) distribution function
+    static const double cdf[] = {0.36787944117144233, 0.73575888234288467, 0.91969860292860584,
+                                 0.98101184312384626, 0.99634015317265142, 0.99940581518306248,
+                                 0.99991675885147099, 0.99998975080410100, 0.99999887479797864};
+    double u = (hash >> 11) * (1.0/9007199254740992.0);
+    unsigned char k = 0;
+    while (k < 9 && u > cdf[k])
+        k++;
+    return k;
+}
+
+// a median-shifted interval: the 2.5% and 97.5% points of the replicates,
+// moved by the difference of their median and the estimate. it is neither the
+// percentile nor a BCa interval. a resample repeats samples, which the bias
+// correction of the first order indices takes for signal, so the replicates
+// sit above the estimate and their plain percentiles often miss it; moved,
+// the interval is about the estimate, with the width of the percentile interval
+static void medianShiftedInterval(std::vector<double> &replicates, double estimate, double &lower, double &upper)
+{
+    if (replicates.empty()) {
+        lower = upper = NAN;
+        return;
+    }
+    size_t last = replicates.size()-1;
+    size_t lo = static_cast<size_t>(floor(0.025*last + 0.5));
+    size_t mid = static_cast<size_t>(floor(0.5*last + 0.5));
+    size_t hi = static_cast<size_t>(floor(0.975*last + 0.5));
+    std::nth_element(replicates.begin(), replicates.begin()+mid, replicates.end());
+    double shift = replicates[mid] - estimate;
+    std::nth_element(replicates.begin(), replicates.begin()+lo, replicates.begin()+mid);
+    lower = replicates[lo] - shift;
+    std::nth_element(replicates.begin()+mid, replicates.begin()+hi, replicates.end());
+    upper = replicates[hi] - shift;
+}
+
+void
+SobolEstimator::estimate(const SampleDataStore &theData, int firstRV, int nRV, int firstEDP, int nEDP)
+{
+    numRows = theData.getNumRows();
+    numRV = nRV;
+    numEDP = nEDP;
+
+    theIndices.clear();
+    theIndices.resize(numRV*numEDP);
+    if (numRows < 4 || numRV <= 0 || numEDP <= 0)
+        return;
+
+    // about N^(1/3) bins, many samples per bin, the bias correction does the rest
+    numBins = static_cast<int>(floor(cbrt(static_cast<double>(numRows)) + 0.5));
+    numBins = std::max(2, std::min(numBins, 100));
+
+    this->computeBins(theData, firstRV);
+    this->computeWeights();
+    this->computeMain(theData, firstEDP);
+    this->selectMatchedInputs();
+    this->computeNeighbours();
+    this->computeTotal(theData, firstEDP);
+    if (this->addInteractingInputs()) {
+        this->computeNeighbours();
+        this->computeTotal(theData, firstEDP);
+    }
+
+    theBins.clear();
+    theScores.clear();
+    theWeights.clear();
+    theGroupWeights.clear();
+    theNeighbours.clear();
+    theFullNeighbours.clear();
+}
+
+void
+SobolEstimator::computeBins(const SampleDataStore &theData, int firstRV)
+{
+    theBins.assign(numRV, std::vector<unsigned char>(numRows));
+    theScores.assign(numRV, std::vector<double>(numRows));
+
+    QVector<int> inputs;
+    for (int rv=0; rv<numRV; rv++)
+        inputs.append(rv);
+
+    QtConcurrent::blockingMap(inputs, [this, &theData, firstRV](int &rv) {
+        const double *x = theData.getColumn(firstRV+rv);
+        std::vector<int> order(numRows);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [x](int a, int b) { return x[a] < x[b]; });
+
+        unsigned char *bins = theBins[rv].data();
+        double *scores = theScores[rv].data();
+        for (int rank=0; rank<numRows; rank++) {
+            int row = order[rank];
+            bins[row] = static_cast<unsigned char>(static_cast<qint64>(rank)*numBins/numRows);
+            scores[row] = rank;
+        }
+    });
+}
+
+void
+SobolEstimator::computeWeights(void)
+{
+    // samples are independent, so groups of every NUM_GROUPS'th sample are too
+    theGroupWeights.resize(numBootstrap*NUM_GROUPS);
+    for (int r=0; r<numBootstrap; r++)
+        for (int g=0; g<NUM_GROUPS; g++)
+            theGroupWeights[r*NUM_GROUPS + g] =
+                    poissonOne(splitMix64((static_cast<quint64>(r) << 32) ^ static_cast<quint64>(g) ^ 0x80000000ULL));
+
+    int numQ = std::min(numQueries, numRows);
+    theWeights.resize(static_cast<size_t>(numQ)*numBootstrap);
+    for (int q=0; q<numQ; q++)
+        for (int r=0; r<numBootstrap; r++)
+            theWeights[static_cast<size_t>(q)*numBootstrap + r] =
+                    poissonOne(splitMix64((static_cast<quint64>(r) << 32) ^ static_cast<quint64>(q)));
+}
+
+//
+// first order indices: per group and bin the count, sum and sum of squares of
+// the output in one pass over the samples; the full sample and every
+// bootstrap replicate (a weighted resample of the groups) are formed from them
+//
+
+void
+SobolEstimator::computeMain(const SampleDataStore &theData, int firstEDP)
+{
+    QVector<int> pairs;
+    for (int i=0; i<numRV*numEDP; i++)
+        pairs.append(i);
+
+    QtConcurrent::blockingMap(pairs, [this, &theData, firstEDP](int &pair) {
+        int edp = pair/numRV;
+        int rv = pair%numRV;
+        const double *y = theData.getColumn(firstEDP+edp);
+        const unsigned char *bins = theBins[rv].data();
+
+        // center the output so the sums of squares keep their precision
+        double mean = 0;
+        for (int row=0; row<numRows; row++)
+            mean += y[row];
+        mean /= numRows;
+
+        std::vector<double> groupCount(NUM_GROUPS*numBins, 0.);
+        std::vector<double> groupSum(NUM_GROUPS*numBins, 0.);
+        std::vector<double> groupSumSq(NUM_GROUPS*numBins, 0.);
+
+        int group = 0;
+        for (int row=0; row<numRows; row++) {
+            double value = y[row]-mean;
+            int index = group*numBins + bins[row];
+            groupCount[index] += 1;
+            groupSum[index] += value;
+            groupSumSq[index] += value*value;
+            if (++group == NUM_GROUPS)
+                group = 0;
+        }
+
+        int numSets = numBootstrap+1;   // set 0 is the sample itself
+        std::vector<double> count(numSets*numBins, 0.);
+        std::vector<double> sum(numSets*numBins, 0.);
+        std::vector<double> sumSq(numSets*numBins, 0.);
+        for (int set=0; set<numSets; set++) {
+            for (int g=0; g<NUM_GROUPS; g++) {
+                double w = (set == 0) ? 1 : theGroupWeights[(set-1)*NUM_GROUPS + g];
+                if (w == 0)
+                    continue;
+                for (int bin=0; bin<numBins; bin++) {
+                    count[set*numBins + bin] += w*groupCount[g*numBins + bin];
+                    sum[set*numBins + bin] += w*groupSum[g*numBins + bin];
+                    sumSq[set*numBins + bin] += w*groupSumSq[g*numBins + bin];
+                }
+            }
+        }
+
+        std::vector<double> replicates;
+        double main = 0;
+        for (int set=0; set<numSets; set++) {
+            double n = 0, s = 0, ss = 0, between = 0;
+            int numNonEmpty = 0;
+            for (int bin=0; bin<numBins; bin++) {
+                int index = set*numBins + bin;
+                if (count[index] == 0)
+                    continue;
+                n += count[index];
+                s += sum[index];
+                ss += sumSq[index];
+                between += sum[index]*sum[index]/count[index];
+                numNonEmpty++;
+            }
+            if (n <= numNonEmpty)
+                continue;
+
+            double totalSS = ss - s*s/n;
+            between -= s*s/n;
+            double within = totalSS - between;
+            double value = 0;
+            if (totalSS > 0)
+                value = (between - (numNonEmpty-1)/(n-numNonEmpty)*within)/totalSS;
+
+            if (set == 0)
+                main = value;
+            else
+                replicates.push_back(value);
+        }
+
+        SobolIndex &index = theIndices[pair];
+        index.main = main;
+        medianShiftedInterval(replicates, main, index.mainLower, index.mainUpper);
+    });
+}
+
+//
+// the inputs neighbours are matched in: those whose first order index, for
+// some output, is clearly non zero. inputs that do nothing only make the
+// nearest neighbours further apart, so are better left out of the distance
+//
+
+void
+SobolEstimator::selectMatchedInputs(void)
+{
+    theMatchedInputs.clear();
+    for (int rv=0; rv<numRV; rv++) {
+        bool matched = false;
+        for (int edp=0; edp<numEDP && !matched; edp++)
+            matched = theIndices.at(edp*numRV+rv).mainLower > SCREENING_THRESHOLD;
+        if (matched)
+            theMatchedInputs.push_back(rv);
+    }
+
+    // nothing stands out, use them all
+    if (theMatchedInputs.empty())
+        for (int rv=0; rv<numRV; rv++)
+            theMatchedInputs.push_back(rv);
+}
+
+//
+// inputs acting only through interactions show up as a drop in the mismatch
+// when they are also matched (the total estimate for unmatched inputs), add
+// those where the drop is clearly there
+//
+
+bool
+SobolEstimator::addInteractingInputs(void)
+{
+    std::vector<bool> matched(numRV, false);
+    for (size_t i=0; i<theMatchedInputs.size(); i++)
+        matched[theMatchedInputs[i]] = true;
+
+    bool added = false;
+    for (int rv=0; rv<numRV; rv++) {
+        if (matched[rv])
+            continue;
+        for (int edp=0; edp<numEDP; edp++) {
+            if (theIndices.at(edp*numRV+rv).totalLower > SCREENING_THRESHOLD) {
+                theMatchedInputs.push_back(rv);
+                added = true;
+                break;
+            }
+        }
+    }
+    std::sort(theMatchedInputs.begin(), theMatchedInputs.end());
+
+    return added;
+}
+
+//
+// for every query and matched input, the nearest other sample in rank space
+// in the other matched inputs; for an unmatched input, the nearest in the
+// matched inputs and it. the squared distance leaving an input out (or
+// adding one) is the distance in the matched inputs less (plus) that input's
+// term, so one distance per sample pair serves all the inputs. the distances
+// are sums of squared rank differences, whole numbers a double holds exactly,
+// so taking a term out leaves no rounding to pick between equally near
+// samples by the input taken out (and with it bias the totals); the first is
+// kept. queries are blocked so a tile of samples is reused from cache. with
+// one matched input nothing is left when it is left out, its neighbour is
+// then just another sample
+//
+
+void
+SobolEstimator::computeNeighbours(void)
+{
+    int numQ = std::min(numQueries, numRows);
+    theQueries.resize(numQ);
+    for (int q=0; q<numQ; q++)
+        theQueries[q] = static_cast<int>(static_cast<qint64>(q)*numRows/numQ);
+
+    // matched inputs first, then the rest
+    std::vector<bool> isMatched(numRV, false);
+    for (size_t i=0; i<theMatchedInputs.size(); i++)
+        isMatched[theMatchedInputs[i]] = true;
+    std::vector<int> inputs = theMatchedInputs;
+    for (int rv=0; rv<numRV; rv++)
+        if (!isMatched[rv])
+            inputs.push_back(rv);
+    int numMatched = static_cast<int>(theMatchedInputs.size());
+
+    theFullNeighbours.assign(numQ, 0);
+    theNeighbours.assign(static_cast<size_t>(numQ)*numRV, 0);
+
+    QVector<int> blocks;
+    for (int start=0; start<numQ; start+=QUERY_BLOCK_SIZE)
+        blocks.append(start);
+
+    QtConcurrent::blockingMap(blocks, [this, numQ, numMatched, &inputs](int &start) {
+        int numInBlock = std::min(QUERY_BLOCK_SIZE, numQ-start);
+        std::vector<double> bestDistance(numInBlock*numRV, 1e300);
+        std::vector<double> bestFullDistance(numInBlock, 1e300);
+        std::vector<double> distance(numInBlock*SAMPLE_TILE_SIZE);
+
+        for (int tile=0; tile<numRows; tile+=SAMPLE_TILE_SIZE) {
+            int numInTile = std::min(SAMPLE_TILE_SIZE, numRows-tile);
+
+            // squared distances in the matched inputs, query to each sample of the tile
+            std::fill(distance.begin(), distance.end(), 0.);
+            for (int m=0; m<numMatched; m++) {
+                const double *u = theScores[inputs[m]].data() + tile;
+                for (int q=0; q<numInBlock; q++) {
+                    double uq = theScores[inputs[m]][theQueries[start+q]];
+                    double *d = &distance[q*SAMPLE_TILE_SIZE];
+                    for (int k=0; k<numInTile; k++) {
+                        double delta = u[k]-uq;
+                        d[k] += delta*delta;
+                    }
+                }
+            }
+
+            // a query is not its own neighbour
+            for (int q=0; q<numInBlock; q++) {
+                int self = theQueries[start+q] - tile;
+                if (self >= 0 && self < numInTile)
+                    distance[q*SAMPLE_TILE_SIZE + self] = 1e300;
+            }
+
+            // nearest in all the matched inputs
+            for (int q=0; q<numInBlock; q++) {
+                const double *d = &distance[q*SAMPLE_TILE_SIZE];
+                double best = bestFullDistance[q];
+                int bestK = -1;
+                for (int k=0; k<numInTile; k++) {
+                    if (d[k] < best) {
+                        best = d[k];
+                        bestK = k;
+                    }
+                }
+                if (bestK >= 0) {
+                    bestFullDistance[q] = best;
+                    theFullNeighbours[start+q] = tile+bestK;
+                }
+            }
+
+            // leave each matched input out, add each unmatched one, in turn
+            for (int i=(numMatched == 1) ? 1 : 0; i<numRV; i++) {
+                const double *u = theScores[inputs[i]].data() + tile;
+                double sign = (i < numMatched) ? -1.0 : 1.0;
+                for (int q=0; q<numInBlock; q++) {
+                    double uq = theScores[inputs[i]][theQueries[start+q]];
+                    const double *d = &distance[q*SAMPLE_TILE_SIZE];
+                    double best = bestDistance[q*numRV+i];
+                    int bestK = -1;
+                    for (int k=0; k<numInTile; k++) {
+                        double delta = u[k]-uq;
+                        double candidate = d[k] + sign*delta*delta;
+                        if (candidate < best) {
+                            best = candidate;
+                            bestK = k;
+                        }
+                    }
+                    if (bestK >= 0) {
+                        bestDistance[q*numRV+i] = best;
+                        theNeighbours[static_cast<size_t>(start+q)*numRV+inputs[i]] = tile+bestK;
+                    }
+                }
+            }
+        }
+    });
+
+    if (numMatched == 1)
+        for (int q=0; q<numQ; q++)
+            theNeighbours[static_cast<size_t>(q)*numRV+inputs[0]] = (theQueries[q] + numRows/2) % numRows;
+}
+
+// E[(y - y')^2]/(2 Var y) over the queries, and its bootstrap interval. with
+// baseline neighbours, E[(y - y'')^2 - (y - y')^2]/(2 Var y) instead: how much
+// closer y' is than y''
+void
+SobolEstimator::jansenEstimate(const double *y, double variance, const int *neighbours, int stride,
+                               const int *baseline, double &estimate, double &lower, double &upper) const
+{
+    int numQ = static_cast<int>(theQueries.size());
+    std::vector<double> count(numBootstrap+1, 0.);
+    std::vector<double> sum(numBootstrap+1, 0.);
+    for (int q=0; q<numQ; q++) {
+        int query = theQueries[q];
+        double delta = y[query]-y[neighbours[static_cast<size_t>(q)*stride]];
+        double deltaSq = delta*delta;
+        if (baseline != 0) {
+            double deltaBaseline = y[query]-y[baseline[q]];
+            deltaSq = deltaBaseline*deltaBaseline - deltaSq;
+        }
+        count[0] += 1;
+        sum[0] += deltaSq;
+
+        // queries are resampled with the weights of the first samples
+        const unsigned char *w = &theWeights[static_cast<size_t>(q)*numBootstrap];
+        for (int r=0; r<numBootstrap; r++) {
+            count[r+1] += w[r];
+            sum[r+1] += w[r]*deltaSq;
+        }
+    }
+
+    estimate = sum[0]/(2*count[0]*variance);
+    std::vector<double> replicates;
+    for (int r=1; r<=numBootstrap; r++)
+        if (count[r] > 0)
+            replicates.push_back(sum[r]/(2*count[r]*variance));
+    medianShiftedInterval(replicates, estimate, lower, upper);
+}
+
+void
+SobolEstimator::computeTotal(const SampleDataStore &theData, int firstEDP)
+{
+    std::vector<bool> isMatched(numRV, false);
+    for (size_t i=0; i<theMatchedInputs.size(); i++)
+        isMatched[theMatchedInputs[i]] = true;
+
+    QVector<int> pairs;
+    for (int i=0; i<numRV*numEDP; i++)
+        pairs.append(i);
+
+    QtConcurrent::blockingMap(pairs, [this, &theData, firstEDP, &isMatched](int &pair) {
+        int edp = pair/numRV;
+        int rv = pair%numRV;
+        const double *y = theData.getColumn(firstEDP+edp);
+
+        // output variance over all the samples
+        double mean = 0;
+        for (int row=0; row<numRows; row++)
+            mean += y[row];
+        mean /= numRows;
+        double variance = 0;
+        for (int row=0; row<numRows; row++)
+            variance += (y[row]-mean)*(y[row]-mean);
+        variance /= numRows;
+        if (variance <= 0)
+            return;
+
+        // an unmatched input's total is how much matching it too brings y' closer
+        SobolIndex &index = theIndices[pair];
+        const int *baseline = isMatched[rv] ? 0 : &theFullNeighbours[0];
+        this->jansenEstimate(y, variance, &theNeighbours[rv], numRV, baseline,
+                             index.total, index.totalLower, index.totalUpper);
+    });
+}
@@ -0,0 +1,125 @@
+#ifndef SOBOL_ESTIMATOR_H
+#define SOBOL_ESTIMATOR_H
+
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// first order and total Sobol' indices estimated from the samples already in
+// the tab file, for when dakota was not asked to print them. each input is
+// replaced by its rank so inputs of any distribution are treated alike.
+//  - first order: the inputs are split into equiprobable bins and the index is
+//    the variance of the bin means over the output variance, corrected for
+//    the bias of using a finite number of samples per bin
+//  - total: for a subset of query samples the nearest sample in all the other
+//    inputs is found, the index is then E[(y - y')^2]/(2 Var y) (Jansen).
+//    as inputs that do nothing only push neighbours apart, neighbours are
+//    matched only in those with a clear first order index, plus those that
+//    act through interactions, seen as y' getting closer once they are also
+//    matched; for the other inputs that gain is given as the total. with many
+//    influential inputs neighbours are still far apart and totals are biased
+//    towards 1
+// 95% intervals are from a Poisson bootstrap, of interleaved groups of samples
+// for the first order indices and of the queries for the totals. they are
+// median-shifted, the 2.5% and 97.5% points of the replicates less the
+// difference of their median and the estimate, not percentile or BCa
+// intervals, as resampling repeats samples and so biases the replicates.
+// the work is divided over threads by input/output pair and by query block
+
+#include <QVector>
+#include <vector>
+
+class SampleDataStore;
+
+class SobolIndex
+{
+public:
+    SobolIndex();
+
+    double main;
+    double mainLower;     // median-shifted 95% bootstrap interval
+    double mainUpper;
+    double total;
+    double totalLower;    // likewise
+    double totalUpper;
+};
+
+class SobolEstimator
+{
+public:
+    SobolEstimator();
+    ~SobolEstimator();
+
+    void setNumBootstrap(int numBootstrap);
+    void setNumQueries(int numQueries);
+
+    // inputs are the numRV columns from firstRV, outputs the numEDP from firstEDP
+    void estimate(const SampleDataStore &theData, int firstRV, int numRV, int firstEDP, int numEDP);
+
+    int getNumBins(void) const;
+    const SobolIndex &getIndex(int edp, int rv) const;
+
+private:
+    void computeBins(const SampleDataStore &theData, int firstRV);
+    void computeWeights(void);
+    void computeMain(const SampleDataStore &theData, int firstEDP);
+    void selectMatchedInputs(void);
+    bool addInteractingInputs(void);
+    void computeNeighbours(void);
+    void computeTotal(const SampleDataStore &theData, int firstEDP);
+    void jansenEstimate(const double *y, double variance, const int *neighbours, int stride,
+                        const int *baseline, double &estimate, double &lower, double &upper) const;
+
+    int numBootstrap;
+    int numQueries;
+
+    int numRows;
+    int numRV;
+    int numEDP;
+    int numBins;
+
+    std::vector<std::vector<unsigned char> > theBins;   // equiprobable bin of each sample, per input
+    std::vector<std::vector<double> > theScores;        // rank of each sample, per input
+    std::vector<unsigned char> theGroupWeights;         // bootstrap counts, per replicate and sample group
+    std::vector<unsigned char> theWeights;              // bootstrap counts, numBootstrap per query
+    std::vector<int> theMatchedInputs;                  // inputs neighbours are matched in
+    std::vector<int> theQueries;                        // samples the total indices are estimated at
+    std::vector<int> theNeighbours;                     // per query and input, see computeNeighbours
+    std::vector<int> theFullNeighbours;                 // per query, the nearest sample in the matched inputs
+
+    QVector<SobolIndex> theIndices;                     // numRV per output
+};
+
+#endif // SOBOL_ESTIMATOR_H
@@ -0,0 +1,166 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// throughput of DakotaTabParser::parseFile on generated dakotaTab.out files
+// of 10 MB and up, reported in MB/s. the file is just written, so it is read
+// from the page cache and what is measured is the parse, not the disk. the
+// 4 GB file, past the 2 GB a signed 32 bit offset or byte count reaches, is
+// skipped if the disk holding the temporary directory is short of space
+
+#include <QtTest/QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QStorageInfo>
+#include <DakotaTabParser.h>
+#include <SampleDataStore.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+#include <vector>
+
+#define NUM_RANDOM_VARIABLES 6
+#define NUM_EDP 4
+#define NUM_DISTINCT_LINES 4096      // values of a line repeat after this many lines
+#define WRITE_BUFFER_SIZE (8 << 20)
+#define FREE_SPACE_MARGIN (Q_INT64_C(1) << 30)   // left free on the disk by the large files
+
+class BenchmarkDakotaTabParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseFile_data(void);
+    void parseFile(void);
+
+private:
+    bool writeTabFile(const QString &fileName, qint64 size, int &numRows);
+
+    QTemporaryDir theDir;
+};
+
+// lines as dakota writes them, an id, the interface and the values at %.10e
+bool
+BenchmarkDakotaTabParser::writeTabFile(const QString &fileName, qint64 size, int &numRows)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray text("%eval_id interface");
+    for (int i=0; i<NUM_RANDOM_VARIABLES; i++)
+        text.append(QString(" x%1").arg(i+1).toLatin1());
+    for (int i=0; i<NUM_EDP; i++)
+        text.append(QString(" EDP_%1").arg(i+1).toLatin1());
+    text.append('\n');
+
+    std::mt19937_64 generator(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<QByteArray> values(NUM_DISTINCT_LINES);
+    char buffer[64];
+    for (int i=0; i<NUM_DISTINCT_LINES; i++) {
+        for (int j=0; j<NUM_RANDOM_VARIABLES+NUM_EDP; j++) {
+            int length = snprintf(buffer, sizeof(buffer), "   %.10e", 100.0*exp(0.2*normal(generator)));
+            values[i].append(buffer, length);
+        }
+        values[i].append('\n');
+    }
+
+    qint64 written = 0;
+    numRows = 0;
+    while (written + text.size() < size) {
+        int length = snprintf(buffer, sizeof(buffer), "%d   NO_ID", numRows+1);
+        text.append(buffer, length);
+        text.append(values[numRows % NUM_DISTINCT_LINES]);
+        numRows++;
+        if (text.size() > WRITE_BUFFER_SIZE) {
+            if (file.write(text) != text.size())
+                return false;
+            written += text.size();
+            text.clear();
+        }
+    }
+    return file.write(text) == text.size();
+}
+
+void
+BenchmarkDakotaTabParser::parseFile_data(void)
+{
+    QTest::addColumn<int>("megabytes");
+
+    QTest::newRow("10 MB") << 10;
+    QTest::newRow("100 MB") << 100;
+    QTest::newRow("1000 MB") << 1000;
+    QTest::newRow("4000 MB") << 4000;
+}
+
+void
+BenchmarkDakotaTabParser::parseFile(void)
+{
+    QFETCH(int, megabytes);
+
+    qint64 size = static_cast<qint64>(megabytes) << 20;
+    QStorageInfo theStorage(theDir.path());
+    if (theStorage.bytesAvailable() < size + FREE_SPACE_MARGIN)
+        QSKIP("not enough free disk space for the file");
+
+    QString fileName = theDir.filePath(QString("dakotaTab%1.out").arg(megabytes));
+    int numRows = 0;
+    QVERIFY(this->writeTabFile(fileName, size, numRows));
+    qint64 fileSize = QFile(fileName).size();
+
+    DakotaTabParser theParser;
+    SampleDataStore theData;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    int numRuns = 0;
+    QBENCHMARK {
+        timer.start();
+        int numRead = theParser.parseFile(fileName, theData);
+        nsecs += timer.nsecsElapsed();
+        numRuns++;
+        QCOMPARE(numRead, numRows);
+    }
+
+    double megabytesPerSecond = (static_cast<double>(fileSize)*numRuns/(1 << 20))/(nsecs*1e-9);
+    qDebug("%d rows, %.0f MB/s", numRows, megabytesPerSecond);
+
+    QFile::remove(fileName);
+}
+
+QTEST_MAIN(BenchmarkDakotaTabParser)
+#include "BenchmarkDakotaTabParser.moc"
@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# MB/s of DakotaTabParser::parseFile on generated files of 10 MB to 4 GB,
+# run by hand in a release build, e.g. ./BenchmarkDakotaTabParser
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+TARGET = BenchmarkDakotaTabParser
+
+SOURCES += BenchmarkDakotaTabParser.cpp \
+    $$UQ/DakotaTabParser.cpp \
+    $$UQ/SampleDataStore.cpp \
+    $$UQ/QuantileSketch.cpp
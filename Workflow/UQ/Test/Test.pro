@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# tests of the result kernels in Workflow/UQ; "make check" runs the tests,
+# the benchmarks are run by hand
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += TestDakotaTabParser \
+    TestOnlineMoments \
+    TestSobolEstimator \
+    TestBootstrapEstimator \
+    TestDistributionFitter \
+    TestQuantileSketch \
+    TestFragilityFitter \
+    TestSampleComparison \
+    TestFollowResults \
+    BenchmarkDakotaTabParser
@@ -0,0 +1,228 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of BootstrapEstimator: the normal distribution, the jackknife
+// acceleration and the BCa interval worked by hand, and the intervals of
+// normal samples against the large sample ones
+
+#include <QtTest/QtTest>
+#include <BootstrapEstimator.h>
+#include <SampleDataStore.h>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+class TestBootstrapEstimator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void normalDistribution_data(void);
+    void normalDistribution(void);
+    void acceleration(void);
+    void unbiasedInterval(void);
+    void biasCorrectedInterval(void);
+    void normalSamples(void);
+    void reproducible(void);
+};
+
+void
+TestBootstrapEstimator::normalDistribution_data(void)
+{
+    QTest::addColumn<double>("p");
+    QTest::addColumn<double>("x");
+
+    QTest::newRow("0.5") << 0.5 << 0.0;
+    QTest::newRow("0.8413") << 0.8413447460685429 << 1.0;
+    QTest::newRow("0.975") << 0.975 << 1.959963984540054;
+    QTest::newRow("0.05") << 0.05 << -1.6448536269514722;
+    QTest::newRow("1e-6") << 1e-6 << -4.753424308822899;
+}
+
+void
+TestBootstrapEstimator::normalDistribution(void)
+{
+    QFETCH(double, p);
+    QFETCH(double, x);
+
+    QVERIFY(fabs(BootstrapEstimator::normalQuantile(p) - x) < 1e-12);
+    QVERIFY(fabs(BootstrapEstimator::normalCDF(x) - p) < 1e-15 + 1e-12*p);
+}
+
+// jackknife means of 0 0 0 1 are 1/3 1/3 1/3 0: a = 1/(6 sqrt 3), also when
+// 0 is given once with a count of 3
+void
+TestBootstrapEstimator::acceleration(void)
+{
+    double jackknife[] = {1.0/3, 1.0/3, 1.0/3, 0.0};
+    double expected = 1.0/(6*sqrt(3.0));
+    QVERIFY(fabs(BootstrapEstimator::getAcceleration(jackknife, 0, 4) - expected) < 1e-15);
+
+    double values[] = {1.0/3, 0.0};
+    double counts[] = {3, 1};
+    QVERIFY(fabs(BootstrapEstimator::getAcceleration(values, counts, 2) - expected) < 1e-15);
+
+    double constant[] = {2, 2, 2};
+    QCOMPARE(BootstrapEstimator::getAcceleration(constant, 0, 3), 0.0);
+}
+
+// replicates 0..1000 about an estimate of 500 and no acceleration: the BCa
+// interval is the percentile one, the 25th and 975th replicates at 95%
+void
+TestBootstrapEstimator::unbiasedInterval(void)
+{
+    std::vector<double> replicates;
+    for (int i=1000; i>=0; i--)
+        replicates.push_back(i);
+    replicates.push_back(NAN);
+
+    BootstrapInterval interval;
+    BootstrapEstimator::computeInterval(replicates, 500, 0, 0.95, interval);
+    QCOMPARE(interval.estimate, 500.0);
+    QCOMPARE(interval.lower, 25.0);
+    QCOMPARE(interval.upper, 975.0);
+    QCOMPARE(interval.bcaLower, 25.0);
+    QCOMPARE(interval.bcaUpper, 975.0);
+}
+
+// an estimate with 84.13% of the replicates below is z0 = 1, so the BCa
+// interval is at Phi(2 -+ 1.96) = 0.5159 and 0.99995 with no acceleration;
+// at a = 0.1, Phi(z0 + t/(1 - 0.1 t)) with t = z0 -+ 1.96
+void
+TestBootstrapEstimator::biasCorrectedInterval(void)
+{
+    std::vector<double> replicates;
+    for (int i=0; i<=100000; i++)
+        replicates.push_back(i);
+    double estimate = 84134.0;
+
+    BootstrapInterval interval;
+    std::vector<double> copy = replicates;
+    BootstrapEstimator::computeInterval(copy, estimate, 0, 0.95, interval);
+    QVERIFY(fabs(interval.bcaLower - 51595) <= 2);
+    QVERIFY(fabs(interval.bcaUpper - 99995) <= 2);
+
+    copy = replicates;
+    BootstrapEstimator::computeInterval(copy, estimate, 0.1, 0.95, interval);
+    double z0 = BootstrapEstimator::normalQuantile(84134.5/100001);
+    double z = 1.959963984540054;
+    double qLower = BootstrapEstimator::normalCDF(z0 + (z0-z)/(1 - 0.1*(z0-z)));
+    double qUpper = BootstrapEstimator::normalCDF(z0 + (z0+z)/(1 - 0.1*(z0+z)));
+    QCOMPARE(interval.bcaLower, floor(qLower*100000 + 0.5));
+    QCOMPARE(interval.bcaUpper, floor(qUpper*100000 + 0.5));
+    QCOMPARE(interval.lower, 2500.0);
+    QCOMPARE(interval.upper, 97500.0);
+}
+
+// 4000 standard normal samples: the mean is within 1.96 s/sqrt(n) and the
+// standard deviation within 1.96 s/sqrt(2n), to the bootstrap's 10%
+void
+TestBootstrapEstimator::normalSamples(void)
+{
+    const int numSamples = 4000;
+    SampleDataStore theData;
+    theData.setHeadings(QStringList() << "Run #" << "x");
+    std::mt19937_64 generator(11);
+    std::normal_distribution<double> normal(0, 1);
+    double sum = 0, sumSq = 0;
+    for (int i=0; i<numSamples; i++) {
+        double row[2] = {static_cast<double>(i+1), normal(generator)};
+        theData.appendRow(row);
+        sum += row[1];
+        sumSq += row[1]*row[1];
+    }
+    double mean = sum/numSamples;
+    double stdDev = sqrt((sumSq - numSamples*mean*mean)/(numSamples-1));
+
+    BootstrapEstimator theBootstrap;
+    theBootstrap.setNumReplicates(2000);
+    theBootstrap.setColumns(theData, 1, 1, 0);
+    QVERIFY(theBootstrap.estimate());
+    QCOMPARE(theBootstrap.getNumColumns(), 1);
+
+    const BootstrapInterval &meanInterval = theBootstrap.getInterval(0, BootstrapEstimator::Mean);
+    double halfWidth = 1.959963984540054*stdDev/sqrt(static_cast<double>(numSamples));
+    QVERIFY(fabs(meanInterval.estimate - mean) < 1e-12);
+    QVERIFY(fabs(meanInterval.bcaLower - (mean-halfWidth)) < 0.1*halfWidth);
+    QVERIFY(fabs(meanInterval.bcaUpper - (mean+halfWidth)) < 0.1*halfWidth);
+    QVERIFY(fabs(meanInterval.lower - (mean-halfWidth)) < 0.1*halfWidth);
+    QVERIFY(fabs(meanInterval.upper - (mean+halfWidth)) < 0.1*halfWidth);
+
+    const BootstrapInterval &stdDevInterval = theBootstrap.getInterval(0, BootstrapEstimator::StdDev);
+    halfWidth = 1.959963984540054*stdDev/sqrt(2.0*numSamples);
+    QVERIFY(fabs(stdDevInterval.estimate - stdDev) < 1e-12);
+    QVERIFY(fabs(stdDevInterval.bcaLower - (stdDev-halfWidth)) < 0.1*halfWidth);
+    QVERIFY(fabs(stdDevInterval.bcaUpper - (stdDev+halfWidth)) < 0.1*halfWidth);
+
+    for (int i=0; i<NUM_BOOTSTRAP_STATISTICS; i++) {
+        const BootstrapInterval &interval = theBootstrap.getInterval(0, i);
+        QVERIFY(interval.bcaLower <= interval.estimate && interval.estimate <= interval.bcaUpper);
+    }
+}
+
+// the draws are hashes of the seed, not of the order the threads run in
+void
+TestBootstrapEstimator::reproducible(void)
+{
+    SampleDataStore theData;
+    theData.setHeadings(QStringList() << "Run #" << "x" << "y");
+    std::mt19937_64 generator(3);
+    std::exponential_distribution<double> exponential(1);
+    for (int i=0; i<500; i++) {
+        double row[3] = {static_cast<double>(i+1), exponential(generator), exponential(generator)};
+        theData.appendRow(row);
+    }
+
+    BootstrapEstimator first, second;
+    first.setColumns(theData, 1, 2, 0);
+    second.setColumns(theData, 1, 2, 0);
+    QVERIFY(first.estimate());
+    QVERIFY(second.estimate());
+    for (int col=0; col<2; col++) {
+        for (int i=0; i<NUM_BOOTSTRAP_STATISTICS; i++) {
+            QCOMPARE(first.getInterval(col, i).bcaLower, second.getInterval(col, i).bcaLower);
+            QCOMPARE(first.getInterval(col, i).bcaUpper, second.getInterval(col, i).bcaUpper);
+        }
+    }
+
+    second.setSeed(12345);
+    QVERIFY(second.estimate());
+    QVERIFY(first.getInterval(0, BootstrapEstimator::Mean).bcaLower != second.getInterval(0, BootstrapEstimator::Mean).bcaLower);
+}
+
+QTEST_MAIN(TestBootstrapEstimator)
+#include "TestBootstrapEstimator.moc"
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# BootstrapEstimator: BCa pieces worked by hand, intervals of normal samples
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestBootstrapEstimator
+
+SOURCES += TestBootstrapEstimator.cpp \
+    $$UQ/BootstrapEstimator.cpp \
+    $$UQ/OnlineMoments.cpp \
+    $$UQ/SampleStatistics.cpp \
+    $$UQ/SampleColumnCache.cpp \
+    $$UQ/QuantileSketch.cpp \
+    $$UQ/SampleDataStore.cpp
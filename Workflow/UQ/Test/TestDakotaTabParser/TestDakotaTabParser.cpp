@@ -0,0 +1,219 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of DakotaTabParser: the fast number parser against strtod, and whole
+// files, small and large enough to be parsed in several chunks
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <DakotaTabParser.h>
+#include <SampleDataStore.h>
+#include <QuantileSketch.h>
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+
+class TestDakotaTabParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseNumber_data(void);
+    void parseNumber(void);
+    void parseNumberMatchesStrtod(void);
+    void parseFile(void);
+    void parseFileInChunks(void);
+    void parseMissingFile(void);
+
+private:
+    bool writeFile(const QString &fileName, const QByteArray &text);
+
+    QTemporaryDir theDir;
+};
+
+bool
+TestDakotaTabParser::writeFile(const QString &fileName, const QByteArray &text)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text) == text.size();
+}
+
+void
+TestDakotaTabParser::parseNumber_data(void)
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("dakota") << QString("1.2345678901e+02") << 123.45678901;
+    QTest::newRow("negative") << QString("-4.5000000000e-01") << -0.45;
+    QTest::newRow("zero") << QString("0.0000000000e+00") << 0.0;
+    QTest::newRow("integer") << QString("7") << 7.0;
+    QTest::newRow("plus") << QString("+3.25") << 3.25;
+    QTest::newRow("largest exact power") << QString("1e22") << 1e22;
+    QTest::newRow("past the exact powers") << QString("1e23") << 1e23;
+    QTest::newRow("past 2^53, ties to even") << QString("9007199254740993") << 9007199254740992.0;
+    QTest::newRow("20 digits") << QString("12345678901234567890") << 12345678901234567890.0;
+    QTest::newRow("smallest normal") << QString("2.2250738585072014e-308") << DBL_MIN;
+    QTest::newRow("largest") << QString("1.7976931348623157e+308") << DBL_MAX;
+    QTest::newRow("subnormal") << QString("4.9406564584124654e-324") << 4.9406564584124654e-324;
+}
+
+void
+TestDakotaTabParser::parseNumber(void)
+{
+    QFETCH(QString, text);
+    QFETCH(double, expected);
+
+    // followed by the next token, which must be left alone
+    QByteArray line = text.toLatin1() + QByteArray(" 5\n");
+    const char *begin = line.constData();
+    const char *end = begin + line.size();
+
+    double value = -1;
+    const char *next = DakotaTabParser::parseNumber(begin, end, value);
+    QCOMPARE(static_cast<int>(next-begin), text.size());
+    QVERIFY2(value == expected, qPrintable(QString::number(value, 'g', 17)));
+}
+
+// the fast path is exact, so every value must equal what strtod gives
+void
+TestDakotaTabParser::parseNumberMatchesStrtod(void)
+{
+    std::mt19937_64 generator(2019);
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-40, 40);
+    const char *formats[] = {"%.10e", "%.17g", "%.3f"};
+
+    char buffer[64];
+    for (int i=0; i<300000; i++) {
+        double x = mantissa(generator)*pow(10.0, exponent(generator));
+        int length = snprintf(buffer, sizeof(buffer), formats[i%3], x);
+        double value = 0;
+        const char *next = DakotaTabParser::parseNumber(buffer, buffer+length, value);
+        QCOMPARE(static_cast<int>(next-buffer), length);
+        double expected = strtod(buffer, NULL);
+        QVERIFY2(memcmp(&value, &expected, sizeof(double)) == 0, buffer);
+    }
+}
+
+void
+TestDakotaTabParser::parseFile(void)
+{
+    // the interface column is skipped; blank lines and a last line without a
+    // newline are what dakota leaves when it is stopped part way
+    QByteArray text =
+        "%eval_id interface   E   P   Node_1_Disp\n"
+        "1   NO_ID   2.0500000000e+02   1.0000000000e+01   -3.1250000000e-02\n"
+        "\n"
+        "2   NO_ID   1.9500000000e+02   1.2500000000e+01   -4.0000000000e-02\r\n"
+        "3   NO_ID   2.1000000000e+02   8.0000000000e+00   -2.5000000000e-02";
+    QString fileName = theDir.filePath("dakotaTab.out");
+    QVERIFY(this->writeFile(fileName, text));
+
+    DakotaTabParser theParser;
+    SampleDataStore theData;
+    QCOMPARE(theParser.parseFile(fileName, theData), 3);
+    QCOMPARE(theParser.getInterfaceToken(), 1);
+
+    QStringList headings;
+    headings << "Run #" << "E" << "P" << "Node_1_Disp";
+    QCOMPARE(theData.getHeadings(), headings);
+    QCOMPARE(theData.getNumRows(), 3);
+
+    QCOMPARE(theData.getValue(0, 0), 1.0);
+    QCOMPARE(theData.getValue(1, 1), 195.0);
+    QCOMPARE(theData.getValue(1, 3), -0.04);
+    QCOMPARE(theData.getValue(2, 0), 3.0);
+    QCOMPARE(theData.getValue(2, 2), 8.0);
+    QCOMPARE(theData.getValue(2, 3), -0.025);
+}
+
+// several MB, so the rows are split among chunks and sketched per chunk
+void
+TestDakotaTabParser::parseFileInChunks(void)
+{
+    const int numRows = 100000;
+    QByteArray text("%eval_id interface x y z\n");
+    char buffer[128];
+    for (int i=0; i<numRows; i++) {
+        // every tenth line blank, to leave gaps at the ends of the chunks
+        if (i%10 == 0)
+            text.append("  \n");
+        int length = snprintf(buffer, sizeof(buffer), "%d NO_ID %.10e %.10e %.10e\n",
+                              i+1, 0.25*i, -1.0*i, i*1e-6);
+        text.append(buffer, length);
+    }
+    QVERIFY(text.size() > 4*(1 << 20));
+
+    QString fileName = theDir.filePath("large.out");
+    QVERIFY(this->writeFile(fileName, text));
+
+    DakotaTabParser theParser;
+    SampleDataStore theData;
+    QVector<QuantileSketch> theSketches;
+    theParser.setSketches(&theSketches);
+    QCOMPARE(theParser.parseFile(fileName, theData), numRows);
+    QCOMPARE(theData.getNumColumns(), 4);
+
+    for (int i=0; i<numRows; i++) {
+        QCOMPARE(theData.getValue(i, 0), i+1.0);
+        QCOMPARE(theData.getValue(i, 1), 0.25*i);
+        QCOMPARE(theData.getValue(i, 2), -1.0*i);
+    }
+
+    QCOMPARE(theSketches.size(), 4);
+    QCOMPARE(theSketches.at(1).getCount(), static_cast<double>(numRows));
+    QCOMPARE(theSketches.at(1).getMin(), 0.0);
+    QCOMPARE(theSketches.at(1).getMax(), 0.25*(numRows-1));
+}
+
+void
+TestDakotaTabParser::parseMissingFile(void)
+{
+    DakotaTabParser theParser;
+    SampleDataStore theData;
+    QCOMPARE(theParser.parseFile(theDir.filePath("missing.out"), theData), -1);
+    QVERIFY(!theParser.getErrorMessage().isEmpty());
+}
+
+QTEST_MAIN(TestDakotaTabParser)
+#include "TestDakotaTabParser.moc"
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# DakotaTabParser: numbers against strtod, small and chunked files
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestDakotaTabParser
+
+SOURCES += TestDakotaTabParser.cpp \
+    $$UQ/DakotaTabParser.cpp \
+    $$UQ/SampleDataStore.cpp \
+    $$UQ/QuantileSketch.cpp
@@ -0,0 +1,260 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of DistributionFitter: the special functions at known values, the
+// maximum likelihood fits recovering the parameters samples were drawn with,
+// their log likelihoods against the densities, and the KS distance against
+// the one found at every sample
+
+#include <QtTest/QtTest>
+#include <DistributionFitter.h>
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#define NUM_SAMPLES 20000
+
+class TestDistributionFitter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void specialFunctions(void);
+    void recoversParameters_data(void);
+    void recoversParameters(void);
+    void ranksTheSource(void);
+    void notFit(void);
+
+private:
+    static std::vector<double> makeSamples(int type, const double *parameters);
+    static DistributionFit fit(int type, const std::vector<double> &sorted);
+};
+
+std::vector<double>
+TestDistributionFitter::makeSamples(int type, const double *p)
+{
+    std::mt19937_64 generator(5);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> values(NUM_SAMPLES);
+    for (int i=0; i<NUM_SAMPLES; i++) {
+        switch (type) {
+        case DistributionFitter::Normal:
+            values[i] = p[0] + p[1]*normal(generator);
+            break;
+        case DistributionFitter::Lognormal:
+            values[i] = exp(p[0] + p[1]*normal(generator));
+            break;
+        case DistributionFitter::Gumbel:
+            values[i] = p[1] - log(-log(uniform(generator)))/p[0];
+            break;
+        case DistributionFitter::Weibull:
+            values[i] = p[1]*pow(-log(1-uniform(generator)), 1/p[0]);
+            break;
+        case DistributionFitter::Beta: {
+            std::gamma_distribution<double> first(p[0], 1), second(p[1], 1);
+            double x = first(generator);
+            double y = second(generator);
+            values[i] = p[2] + (p[3]-p[2])*x/(x+y);
+            break;
+        }
+        case DistributionFitter::Gamma: {
+            std::gamma_distribution<double> gamma(p[0], p[1]);
+            values[i] = gamma(generator);
+            break;
+        }
+        }
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+DistributionFit
+TestDistributionFitter::fit(int type, const std::vector<double> &sorted)
+{
+    switch (type) {
+    case DistributionFitter::Normal:
+        return DistributionFitter::fitNormal(sorted);
+    case DistributionFitter::Lognormal:
+        return DistributionFitter::fitLognormal(sorted);
+    case DistributionFitter::Gumbel:
+        return DistributionFitter::fitGumbel(sorted);
+    case DistributionFitter::Weibull:
+        return DistributionFitter::fitWeibull(sorted);
+    case DistributionFitter::Beta:
+        return DistributionFitter::fitBeta(sorted);
+    case DistributionFitter::Gamma:
+        return DistributionFitter::fitGamma(sorted);
+    }
+    return DistributionFit();
+}
+
+void
+TestDistributionFitter::specialFunctions(void)
+{
+    QVERIFY(fabs(DistributionFitter::digamma(1) + 0.5772156649015329) < 1e-12);
+    QVERIFY(fabs(DistributionFitter::digamma(0.5) + 1.9635100260214235) < 1e-12);
+    QVERIFY(fabs(DistributionFitter::trigamma(1) - M_PI*M_PI/6) < 1e-12);
+    QVERIFY(fabs(DistributionFitter::trigamma(0.5) - M_PI*M_PI/2) < 1e-12);
+
+    // P(1,x) = 1 - exp(-x), P(1/2,x) = erf(sqrt x)
+    double x[] = {0.1, 1, 3, 20};
+    for (int i=0; i<4; i++) {
+        QVERIFY(fabs(DistributionFitter::incompleteGamma(1, x[i]) - (1-exp(-x[i]))) < 1e-12);
+        QVERIFY(fabs(DistributionFitter::incompleteGamma(0.5, x[i]) - erf(sqrt(x[i]))) < 1e-12);
+    }
+
+    // I_x(a,1) = x^a, I_0.4(2,3) = 1 - 0.6^4 - 4 0.4 0.6^3 and I_x(a,b) = 1 - I_1-x(b,a)
+    QVERIFY(fabs(DistributionFitter::incompleteBeta(2.5, 1, 0.3) - pow(0.3, 2.5)) < 1e-12);
+    QVERIFY(fabs(DistributionFitter::incompleteBeta(2, 3, 0.4) - 0.5248) < 1e-12);
+    QVERIFY(fabs(DistributionFitter::incompleteBeta(0.7, 4.2, 0.15) + DistributionFitter::incompleteBeta(4.2, 0.7, 0.85) - 1) < 1e-12);
+}
+
+void
+TestDistributionFitter::recoversParameters_data(void)
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<QVector<double> >("parameters");
+
+    QTest::newRow("normal") << int(DistributionFitter::Normal) << (QVector<double>() << 10 << 2);
+    QTest::newRow("lognormal") << int(DistributionFitter::Lognormal) << (QVector<double>() << 0.5 << 0.4);
+    QTest::newRow("gumbel") << int(DistributionFitter::Gumbel) << (QVector<double>() << 2 << 5);
+    QTest::newRow("weibull") << int(DistributionFitter::Weibull) << (QVector<double>() << 1.8 << 3);
+    QTest::newRow("beta") << int(DistributionFitter::Beta) << (QVector<double>() << 2 << 3 << 1 << 4);
+    QTest::newRow("gamma") << int(DistributionFitter::Gamma) << (QVector<double>() << 2.5 << 1.5);
+}
+
+// with 20000 samples the estimates are within a few percent; the beta
+// bounds are the sample range widened, so its shapes are looser
+void
+TestDistributionFitter::recoversParameters(void)
+{
+    QFETCH(int, type);
+    QFETCH(QVector<double>, parameters);
+
+    std::vector<double> sorted = makeSamples(type, parameters.constData());
+    DistributionFit theFit = fit(type, sorted);
+    QVERIFY(theFit.ok);
+    QCOMPARE(theFit.type, type);
+    QCOMPARE(theFit.numParameters, parameters.size());
+
+    double tolerance = (type == DistributionFitter::Beta) ? 0.1 : 0.03;
+    for (int i=0; i<theFit.numParameters; i++)
+        QVERIFY2(fabs(theFit.parameters[i] - parameters[i]) < tolerance*fabs(parameters[i]),
+                 qPrintable(QString::number(theFit.parameters[i])));
+
+    // the closed form log likelihood is the sum of the log densities
+    double logLikelihood = 0;
+    for (size_t i=0; i<sorted.size(); i++)
+        logLikelihood += log(theFit.pdf(sorted[i]));
+    QVERIFY(fabs(theFit.logLikelihood - logLikelihood) < 1e-8*fabs(logLikelihood));
+    QVERIFY(fabs(theFit.aic - (2*theFit.numParameters - 2*logLikelihood)) < 1e-8*fabs(logLikelihood));
+
+    // the MLE is a maximum: nudging a parameter lowers the likelihood
+    for (int i=0; i<2; i++) {
+        for (int sign=-1; sign<=1; sign+=2) {
+            DistributionFit nudged = theFit;
+            nudged.parameters[i] *= 1 + sign*0.01;
+            double nudgedLikelihood = 0;
+            for (size_t j=0; j<sorted.size(); j++)
+                nudgedLikelihood += log(nudged.pdf(sorted[j]));
+            QVERIFY(nudgedLikelihood < logLikelihood);
+        }
+    }
+
+    // the KS distance looked for in stretches is the one at every sample
+    double ks = 0;
+    double n = sorted.size();
+    for (size_t i=0; i<sorted.size(); i++) {
+        double F = theFit.cdf(sorted[i]);
+        ks = std::max(ks, std::max(F - i/n, (i+1)/n - F));
+    }
+    QCOMPARE(DistributionFitter::ksDistance(theFit, sorted), ks);
+    QVERIFY(ks < 1.36/sqrt(n));
+}
+
+// samples of each distribution are best fit by it, save that the beta with
+// its two extra parameters can match a gamma or Weibull closely
+void
+TestDistributionFitter::ranksTheSource(void)
+{
+    double normal[] = {10, 2};
+    double gumbel[] = {2, 5};
+    double lognormal[] = {0.5, 0.4};
+    int types[] = {DistributionFitter::Normal, DistributionFitter::Gumbel, DistributionFitter::Lognormal};
+    const double *parameters[] = {normal, gumbel, lognormal};
+
+    for (int i=0; i<3; i++) {
+        std::vector<double> sorted = makeSamples(types[i], parameters[i]);
+        DistributionFitter theFitter;
+        theFitter.setValues(sorted.data(), static_cast<int>(sorted.size()));
+        theFitter.fit();
+        QCOMPARE(theFitter.getNumFits(), int(DistributionFitter::NumTypes));
+        QCOMPARE(theFitter.getFit(0).type, types[i]);
+        for (int rank=1; rank<theFitter.getNumFits(); rank++)
+            QVERIFY(!theFitter.getFit(rank).ok || theFitter.getFit(rank-1).aic <= theFitter.getFit(rank).aic);
+    }
+}
+
+// values at or below zero can not be lognormal, Weibull or gamma; those
+// fits are ranked last
+void
+TestDistributionFitter::notFit(void)
+{
+    double p[] = {0, 1};
+    std::vector<double> sorted = makeSamples(DistributionFitter::Normal, p);
+    DistributionFitter theFitter;
+    theFitter.setValues(sorted.data(), static_cast<int>(sorted.size()));
+    theFitter.fit();
+
+    int numOk = 0;
+    for (int rank=0; rank<theFitter.getNumFits(); rank++) {
+        const DistributionFit &theFit = theFitter.getFit(rank);
+        if (theFit.ok) {
+            QCOMPARE(numOk, rank);
+            numOk++;
+        } else {
+            QVERIFY(theFit.type == DistributionFitter::Lognormal || theFit.type == DistributionFitter::Weibull
+                    || theFit.type == DistributionFitter::Gamma);
+        }
+    }
+    QCOMPARE(numOk, 3);
+}
+
+QTEST_MAIN(TestDistributionFitter)
+#include "TestDistributionFitter.moc"
@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# DistributionFitter: special functions at known values, fits recovering the
+# parameters samples were drawn with
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestDistributionFitter
+
+SOURCES += TestDistributionFitter.cpp \
+    $$UQ/DistributionFitter.cpp
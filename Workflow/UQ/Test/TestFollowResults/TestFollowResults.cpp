@@ -0,0 +1,157 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of the path the results of a local run are followed by: signals of
+// the application reach the result widget set in a UQ_Results, through the
+// slots of WorkflowAppWidget set up by setFollowedResults
+
+#include <QtTest/QtTest>
+#include <QJsonObject>
+#include <Application.h>
+#include <WorkflowAppWidget.h>
+#include <UQ_Results.h>
+
+// records what reaches it, as DakotaResultsSampling would act on it
+class FollowedResults : public UQ_Results
+{
+public:
+    FollowedResults() : numFollowed(0), numStopped(0) {}
+
+    int followResults(QString &filenameTab) override {
+        followedTab = filenameTab;
+        numFollowed++;
+        return 0;
+    }
+
+    void stopFollowingResults(void) override {
+        numStopped++;
+    }
+
+    QString followedTab;
+    int numFollowed;
+    int numStopped;
+};
+
+// emits the signals as LocalApplication does around running the workflow
+class RunningApplication : public Application
+{
+public:
+    void start(const QString &filenameTab) { emit followResults(filenameTab); }
+    void fail(void) { emit stopFollowingResults(); }
+};
+
+// the app parts a WorkflowAppWidget leaves to each app, none used here
+class FollowingApp : public WorkflowAppWidget
+{
+public:
+    FollowingApp() : WorkflowAppWidget(NULL) {}
+
+    bool outputToJSON(QJsonObject &) override { return true; }
+    bool inputFromJSON(QJsonObject &) override { return true; }
+    void clear(void) override {}
+    void onRunButtonClicked() override {}
+    void onRemoteRunButtonClicked() override {}
+    void onRemoteGetButtonClicked() override {}
+    void onExitButtonClicked() override {}
+    int getMaxNumParallelTasks() override { return 1; }
+    void setUpForApplicationRun(QString &, QString &) override {}
+    void processResults(QString, QString, QString) override {}
+    void loadFile(QString) override {}
+};
+
+class TestFollowResults : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void follow(void);
+    void stopFollowing(void);
+    void noResults(void);
+};
+
+// the UQ_Results an app holds passes the file on to the result widget set in it
+void
+TestFollowResults::follow(void)
+{
+    RunningApplication theApplication;
+    FollowingApp theApp;
+    UQ_Results theResults;
+    FollowedResults *theResultWidget = new FollowedResults();
+    theResults.setResultWidget(theResultWidget);
+    theApp.setFollowedResults(&theApplication, &theResults);
+
+    theApplication.start(QString("/tmp/run/dakotaTab.out"));
+    QCOMPARE(theResultWidget->numFollowed, 1);
+    QCOMPARE(theResultWidget->followedTab, QString("/tmp/run/dakotaTab.out"));
+    QCOMPARE(theResultWidget->numStopped, 0);
+}
+
+void
+TestFollowResults::stopFollowing(void)
+{
+    RunningApplication theApplication;
+    FollowingApp theApp;
+    UQ_Results theResults;
+    FollowedResults *theResultWidget = new FollowedResults();
+    theResults.setResultWidget(theResultWidget);
+    theApp.setFollowedResults(&theApplication, &theResults);
+
+    theApplication.start(QString("dakotaTab.out"));
+    theApplication.fail();
+    QCOMPARE(theResultWidget->numFollowed, 1);
+    QCOMPARE(theResultWidget->numStopped, 1);
+}
+
+// without results to follow in, or before any result widget is set, the signals are dropped
+void
+TestFollowResults::noResults(void)
+{
+    RunningApplication theApplication;
+    FollowingApp theApp;
+    theApp.setFollowedResults(&theApplication, NULL);
+    theApplication.start(QString("dakotaTab.out"));
+    theApplication.fail();
+
+    FollowingApp otherApp;
+    UQ_Results theResults;
+    RunningApplication otherApplication;
+    otherApp.setFollowedResults(&otherApplication, &theResults);
+    otherApplication.start(QString("dakotaTab.out"));
+    otherApplication.fail();
+}
+
+QTEST_MAIN(TestFollowResults)
+#include "TestFollowResults.moc"
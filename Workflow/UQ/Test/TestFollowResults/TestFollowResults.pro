@@ -0,0 +1,30 @@
+#-------------------------------------------------
+#
+# the path the results of a local run are followed by: the application's
+# followResults and stopFollowingResults, through WorkflowAppWidget, to the
+# result widget of a UQ_Results
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+QT       += gui widgets
+CONFIG   += testcase
+
+TARGET = TestFollowResults
+
+INCLUDEPATH += $$UQ/../WORKFLOW \
+    $$UQ/../EXECUTION \
+    $$UQ/../../Common \
+    $$UQ/../../RandomVariables
+
+SOURCES += TestFollowResults.cpp \
+    $$UQ/UQ_Results.cpp \
+    $$UQ/../WORKFLOW/WorkflowAppWidget.cpp \
+    $$UQ/../EXECUTION/Application.cpp \
+    $$UQ/../../Common/SimCenterWidget.cpp
+
+HEADERS += $$UQ/UQ_Results.h \
+    $$UQ/../WORKFLOW/WorkflowAppWidget.h \
+    $$UQ/../EXECUTION/Application.h \
+    $$UQ/../../Common/SimCenterWidget.h
@@ -0,0 +1,205 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of FragilityFitter: two intensities, where the fit runs through the
+// observed fractions, samples of known lognormal fragilities, at stripes and
+// at scattered intensities, and the cases that can not be fitted
+
+#include <QtTest/QtTest>
+#include <FragilityFitter.h>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+class TestFragilityFitter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseThresholds(void);
+    void setSamples(void);
+    void twoIntensities(void);
+    void recoversCurve_data(void);
+    void recoversCurve(void);
+    void notFitted(void);
+};
+
+void
+TestFragilityFitter::parseThresholds(void)
+{
+    QVector<double> thresholds;
+    QVERIFY(FragilityFitter::parseThresholds(QString("0.01, 0.02 0.05;0.1"), thresholds));
+    QCOMPARE(thresholds.size(), 4);
+    QCOMPARE(thresholds.at(0), 0.01);
+    QCOMPARE(thresholds.at(3), 0.1);
+
+    QVERIFY(!FragilityFitter::parseThresholds(QString("0.01, drift"), thresholds));
+    QVERIFY(!FragilityFitter::parseThresholds(QString(" "), thresholds));
+}
+
+// missing values and intensities that are not positive are left out
+void
+TestFragilityFitter::setSamples(void)
+{
+    double intensity[] = {0.1, 0, -1, 0.2, NAN, 0.3};
+    double response[] = {1, 2, 3, NAN, 5, 6};
+    FragilityFitter theFitter;
+    theFitter.setSamples(intensity, response, 6);
+    QCOMPARE(theFitter.getNumSamples(), 2);
+
+    std::vector<int> rows;
+    rows.push_back(5);
+    theFitter.setSamples(intensity, response, 6, &rows);
+    QCOMPARE(theFitter.getNumSamples(), 1);
+}
+
+// 1 of 4 samples at intensity 1 and 3 of 4 at e reach the threshold: the
+// curve passes through both fractions, so with z = 0.6745 the 75% point of
+// the normal, beta = 1/(2z) and the median is e^(1/2)
+void
+TestFragilityFitter::twoIntensities(void)
+{
+    double intensity[] = {1, 1, 1, 1, M_E, M_E, M_E, M_E};
+    double response[] = {2, 0, 0, 0, 2, 2, 2, 0};
+    FragilityFitter theFitter;
+    theFitter.setSamples(intensity, response, 8);
+    theFitter.setThresholds(QVector<double>() << 1);
+    QVERIFY(theFitter.fit());
+    QCOMPARE(theFitter.getNumCurves(), 1);
+    QCOMPARE(theFitter.getMinIntensity(), 1.0);
+    QCOMPARE(theFitter.getMaxIntensity(), M_E);
+
+    const FragilityCurve &theCurve = theFitter.getCurve(0);
+    double z = 0.6744897501960817;
+    QVERIFY(theCurve.ok);
+    QCOMPARE(theCurve.numExceeding, 4);
+    QVERIFY(fabs(theCurve.beta - 0.5/z) < 1e-7);
+    QVERIFY(fabs(theCurve.median - exp(0.5)) < 1e-7);
+    QVERIFY(fabs(theCurve.logLikelihood - 2*(log(0.25) + 3*log(0.75))) < 1e-10);
+    QVERIFY(fabs(theCurve.probability(1) - 0.25) < 1e-7);
+    QVERIFY(fabs(theCurve.probability(M_E) - 0.75) < 1e-7);
+
+    QCOMPARE(theFitter.getObservedIntensities().size(), size_t(2));
+    QCOMPARE(theCurve.observedFractions.size(), size_t(2));
+    QCOMPARE(theCurve.observedFractions[0], 0.25);
+    QCOMPARE(theCurve.observedFractions[1], 0.75);
+}
+
+void
+TestFragilityFitter::recoversCurve_data(void)
+{
+    QTest::addColumn<bool>("stripes");
+
+    QTest::newRow("stripes") << true;
+    QTest::newRow("scattered") << false;
+}
+
+// responses x e^(beta e), e standard normal, reach a threshold t with
+// probability Phi((ln x - ln t)/beta): the median is t. 20000 samples at 10
+// stripes, or at as many lognormal intensities, which takes the coarse steps
+void
+TestFragilityFitter::recoversCurve(void)
+{
+    QFETCH(bool, stripes);
+
+    const int numSamples = 20000;
+    const double beta = 0.4;
+    std::mt19937_64 generator(17);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> intensity(numSamples), response(numSamples);
+    for (int i=0; i<numSamples; i++) {
+        intensity[i] = stripes ? 0.1*(1 + i%10) : exp(log(0.4) + 0.6*normal(generator));
+        response[i] = intensity[i]*exp(beta*normal(generator));
+    }
+
+    FragilityFitter theFitter;
+    theFitter.setSamples(intensity.data(), response.data(), numSamples);
+    theFitter.setThresholds(QVector<double>() << 0.3 << 0.5 << 100);
+    QVERIFY(theFitter.fit());
+    QCOMPARE(theFitter.getNumCurves(), 3);
+    QCOMPARE(theFitter.getObservedIntensities().size(), size_t(stripes ? 10 : 20));
+
+    for (int i=0; i<2; i++) {
+        const FragilityCurve &theCurve = theFitter.getCurve(i);
+        QVERIFY(theCurve.ok);
+        QVERIFY2(fabs(theCurve.median - theCurve.threshold) < 0.03*theCurve.threshold, qPrintable(QString::number(theCurve.median)));
+        QVERIFY2(fabs(theCurve.beta - beta) < 0.03*beta, qPrintable(QString::number(theCurve.beta)));
+    }
+
+    // no sample reaches 100, the others are fitted all the same
+    QVERIFY(!theFitter.getCurve(2).ok);
+    QCOMPARE(theFitter.getCurve(2).numExceeding, 0);
+    QVERIFY(!theFitter.getCurve(2).errorMessage.isEmpty());
+}
+
+void
+TestFragilityFitter::notFitted(void)
+{
+    FragilityFitter theFitter;
+    double one[] = {1};
+    theFitter.setSamples(one, one, 1);
+    QVERIFY(!theFitter.fit());
+
+    // every sample reaches the threshold, or all are at one intensity
+    double sameIntensity[] = {1, 1, 1};
+    double responses[] = {1, 2, 3};
+    theFitter.setSamples(sameIntensity, responses, 3);
+    theFitter.setThresholds(QVector<double>() << 0.5 << 2);
+    QVERIFY(theFitter.fit());
+    QVERIFY(!theFitter.getCurve(0).ok);
+    QVERIFY(!theFitter.getCurve(1).ok);
+    QVERIFY(!theFitter.getCurve(1).errorMessage.isEmpty());
+
+    // separated by intensity: beta would be 0
+    double intensity[] = {1, 2, 3, 4, 5, 6};
+    double separated[] = {0, 0, 0, 1, 1, 1};
+    theFitter.setSamples(intensity, separated, 6);
+    theFitter.setThresholds(QVector<double>() << 0.5);
+    QVERIFY(theFitter.fit());
+    QVERIFY(!theFitter.getCurve(0).ok);
+    QVERIFY(!theFitter.getCurve(0).errorMessage.isEmpty());
+
+    // reached less often at higher intensities
+    double decreasing[] = {1, 0, 1, 0, 0, 0};
+    theFitter.setSamples(intensity, decreasing, 6);
+    QVERIFY(theFitter.fit());
+    QVERIFY(!theFitter.getCurve(0).ok);
+    QCOMPARE(theFitter.getCurve(0).probability(1), 0.0);
+}
+
+QTEST_MAIN(TestFragilityFitter)
+#include "TestFragilityFitter.moc"
@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# FragilityFitter: probit fits through known fractions and of known curves
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestFragilityFitter
+
+SOURCES += TestFragilityFitter.cpp \
+    $$UQ/FragilityFitter.cpp
@@ -0,0 +1,184 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of OnlineMoments: the moments of a small set worked by hand, and
+// moments merged from blocks (Chan/Pebay) against those of one pass
+
+#include <QtTest/QtTest>
+#include <OnlineMoments.h>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+class TestOnlineMoments : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void knownValues(void);
+    void largeOffset(void);
+    void mergeMatchesOnePass_data(void);
+    void mergeMatchesOnePass(void);
+    void mergeEmpty(void);
+
+private:
+    static bool isClose(double value, double expected, double tolerance);
+};
+
+bool
+TestOnlineMoments::isClose(double value, double expected, double tolerance)
+{
+    return fabs(value-expected) <= tolerance*qMax(fabs(expected), 1.0);
+}
+
+// 2 4 4 4 5 5 7 9: mean 5, sums of powers of the deviations 32, 42 and 356
+void
+TestOnlineMoments::knownValues(void)
+{
+    double values[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    OnlineMoments theMoments;
+    theMoments.add(values, 8);
+
+    QCOMPARE(theMoments.getCount(), 8.0);
+    QCOMPARE(theMoments.getMean(), 5.0);
+    QCOMPARE(theMoments.getM2(), 32.0);
+    QCOMPARE(theMoments.getM3(), 42.0);
+    QCOMPARE(theMoments.getM4(), 356.0);
+    QCOMPARE(theMoments.getVariance(), 32.0/7.0);
+    QCOMPARE(theMoments.getStdDev(), sqrt(32.0/7.0));
+
+    // biased 0.65625 and 2.78125, corrected as Matlab does
+    QCOMPARE(theMoments.getSkewness(), 0.65625*sqrt(56.0)/6.0);
+    QCOMPARE(theMoments.getKurtosis(), 7.0/30.0*(9.0*2.78125 - 21.0) + 3.0);
+}
+
+// the deviations are what is summed, so an offset far larger than the spread
+// loses nothing, in one pass or merged
+void
+TestOnlineMoments::largeOffset(void)
+{
+    double values[] = {1e9+4, 1e9+7, 1e9+13, 1e9+16};
+
+    OnlineMoments onePass;
+    onePass.add(values, 4);
+    QCOMPARE(onePass.getMean(), 1e9+10);
+    QCOMPARE(onePass.getVariance(), 30.0);
+
+    OnlineMoments first, second;
+    first.add(values, 2);
+    second.add(values+2, 2);
+    first.merge(second);
+    QCOMPARE(first.getCount(), 4.0);
+    QCOMPARE(first.getMean(), 1e9+10);
+    QCOMPARE(first.getVariance(), 30.0);
+    QVERIFY(isClose(first.getM3(), 0.0, 1e-9));
+}
+
+void
+TestOnlineMoments::mergeMatchesOnePass_data(void)
+{
+    QTest::addColumn<int>("numValues");
+    QTest::addColumn<int>("numBlocks");
+
+    QTest::newRow("two") << 2 << 2;
+    QTest::newRow("uneven halves") << 1001 << 2;
+    QTest::newRow("many blocks") << 100000 << 37;
+    QTest::newRow("blocks of one") << 500 << 500;
+}
+
+void
+TestOnlineMoments::mergeMatchesOnePass(void)
+{
+    QFETCH(int, numValues);
+    QFETCH(int, numBlocks);
+
+    // skewed, so the third and fourth moments are far from 0
+    std::mt19937_64 generator(numValues);
+    std::lognormal_distribution<double> lognormal(1.0, 0.5);
+    std::vector<double> values(numValues);
+    for (int i=0; i<numValues; i++)
+        values[i] = lognormal(generator);
+
+    OnlineMoments onePass;
+    onePass.add(values.data(), numValues);
+
+    // blocks of unequal size, merged in a tree as the threads do
+    std::vector<OnlineMoments> blocks(numBlocks);
+    int start = 0;
+    for (int i=0; i<numBlocks; i++) {
+        int end = static_cast<int>(static_cast<long long>(numValues)*(i+1)*(i+1)/(numBlocks*numBlocks));
+        if (i == numBlocks-1)
+            end = numValues;
+        blocks[i].add(values.data()+start, end-start);
+        start = end;
+    }
+    for (int step=1; step<numBlocks; step *= 2)
+        for (int i=0; i+step<numBlocks; i += 2*step)
+            blocks[i].merge(blocks[i+step]);
+    const OnlineMoments &merged = blocks[0];
+
+    QCOMPARE(merged.getCount(), onePass.getCount());
+    QVERIFY(isClose(merged.getMean(), onePass.getMean(), 1e-12));
+    QVERIFY(isClose(merged.getM2(), onePass.getM2(), 1e-11));
+    QVERIFY(isClose(merged.getM3(), onePass.getM3(), 1e-10));
+    QVERIFY(isClose(merged.getM4(), onePass.getM4(), 1e-10));
+    QVERIFY(isClose(merged.getSkewness(), onePass.getSkewness(), 1e-10));
+    QVERIFY(isClose(merged.getKurtosis(), onePass.getKurtosis(), 1e-10));
+}
+
+void
+TestOnlineMoments::mergeEmpty(void)
+{
+    double values[] = {1.5, -2.0, 8.25};
+    OnlineMoments theMoments;
+    theMoments.add(values, 3);
+
+    OnlineMoments empty;
+    OnlineMoments merged = theMoments;
+    merged.merge(empty);
+    QCOMPARE(merged.getCount(), 3.0);
+    QCOMPARE(merged.getMean(), theMoments.getMean());
+    QCOMPARE(merged.getM2(), theMoments.getM2());
+
+    empty.merge(theMoments);
+    QCOMPARE(empty.getCount(), 3.0);
+    QCOMPARE(empty.getMean(), theMoments.getMean());
+    QCOMPARE(empty.getM4(), theMoments.getM4());
+}
+
+QTEST_MAIN(TestOnlineMoments)
+#include "TestOnlineMoments.moc"
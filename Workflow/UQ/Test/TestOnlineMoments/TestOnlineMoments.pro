@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# OnlineMoments: moments worked by hand, merged blocks against one pass
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestOnlineMoments
+
+SOURCES += TestOnlineMoments.cpp \
+    $$UQ/OnlineMoments.cpp
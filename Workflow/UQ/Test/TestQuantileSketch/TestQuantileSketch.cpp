@@ -0,0 +1,243 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of QuantileSketch: a few values held exactly, the quantiles and CDF
+// of a million samples against their exact ranks, for one sketch and for
+// sketches of chunks merged, and the json round trip
+
+#include <QtTest/QtTest>
+#include <QuantileSketch.h>
+#include <SampleDataStore.h>
+
+#include <QJsonObject>
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <vector>
+
+#define NUM_SAMPLES 1000000
+#define NUM_CHUNKS 10
+
+class TestQuantileSketch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase(void);
+    void fewValues(void);
+    void weightsAndMissing(void);
+    void rankError_data(void);
+    void rankError(void);
+    void jsonRoundTrip(void);
+    void sketchColumns(void);
+
+private:
+    // fraction of the sorted samples below x
+    double rank(double x) const;
+    // the k1 scale function bounds a centroid's share near q by this
+    static double centroidShare(double q, double compression);
+
+    std::vector<double> theSamples;
+    std::vector<double> theSortedSamples;
+    QuantileSketch theSketch;
+    QuantileSketch theMergedSketch;
+};
+
+void
+TestQuantileSketch::initTestCase(void)
+{
+    std::mt19937_64 generator(13);
+    std::exponential_distribution<double> exponential(1);
+    theSamples.resize(NUM_SAMPLES);
+    for (int i=0; i<NUM_SAMPLES; i++)
+        theSamples[i] = exponential(generator);
+    theSortedSamples = theSamples;
+    std::sort(theSortedSamples.begin(), theSortedSamples.end());
+
+    theSketch.add(theSamples.data(), NUM_SAMPLES);
+    int chunk = NUM_SAMPLES/NUM_CHUNKS;
+    for (int c=0; c<NUM_CHUNKS; c++) {
+        QuantileSketch theChunk;
+        theChunk.add(theSamples.data() + c*chunk, chunk);
+        theMergedSketch.merge(theChunk);
+    }
+}
+
+double
+TestQuantileSketch::rank(double x) const
+{
+    return (std::lower_bound(theSortedSamples.begin(), theSortedSamples.end(), x) - theSortedSamples.begin())
+            /static_cast<double>(NUM_SAMPLES);
+}
+
+double
+TestQuantileSketch::centroidShare(double q, double compression)
+{
+    return 2*M_PI/compression*sqrt(q*(1-q));
+}
+
+// fewer values than would be merged: each is its own centroid, the
+// quantiles run through them and the ends are the exact extremes
+void
+TestQuantileSketch::fewValues(void)
+{
+    QuantileSketch theSketch;
+    QVERIFY(qIsNaN(theSketch.quantile(0.5)));
+    QVERIFY(qIsNaN(theSketch.cdf(0)));
+
+    double values[] = {5, 3, 1, 4, 2};
+    theSketch.add(values, 5);
+    QCOMPARE(theSketch.getCount(), 5.0);
+    QCOMPARE(theSketch.getNumCentroids(), 5);
+    QCOMPARE(theSketch.getMin(), 1.0);
+    QCOMPARE(theSketch.getMax(), 5.0);
+    QCOMPARE(theSketch.quantile(0), 1.0);
+    QCOMPARE(theSketch.quantile(0.5), 3.0);
+    QCOMPARE(theSketch.quantile(0.7), 4.0);
+    QCOMPARE(theSketch.quantile(1), 5.0);
+    QCOMPARE(theSketch.cdf(0.5), 0.0);
+    QCOMPARE(theSketch.cdf(3), 0.5);
+    QCOMPARE(theSketch.cdf(3.5), 0.6);
+    QCOMPARE(theSketch.cdf(5), 1.0);
+}
+
+// a weighted value counts as that many samples, a NaN or a zero weight not
+// at all
+void
+TestQuantileSketch::weightsAndMissing(void)
+{
+    QuantileSketch weighted, clean;
+    weighted.add(1, 3);
+    weighted.add(NAN);
+    weighted.add(2, 1);
+    weighted.add(7, 0);
+    clean.add(1, 3);
+    clean.add(2, 1);
+
+    QCOMPARE(weighted.getCount(), 4.0);
+    QCOMPARE(weighted.getMin(), 1.0);
+    QCOMPARE(weighted.getMax(), 2.0);
+    QCOMPARE(weighted.getNumCentroids(), 2);
+    for (int i=0; i<=10; i++)
+        QCOMPARE(weighted.quantile(0.1*i), clean.quantile(0.1*i));
+    QCOMPARE(weighted.cdf(1), 0.375);
+}
+
+void
+TestQuantileSketch::rankError_data(void)
+{
+    QTest::addColumn<double>("q");
+
+    double levels[] = {1e-4, 1e-3, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 0.9999};
+    for (int i=0; i<11; i++)
+        QTest::newRow(qPrintable(QString::number(levels[i]))) << levels[i];
+}
+
+// the rank of the quantile read, and the CDF at the exact quantile, are off
+// by less than a centroid's share there, which is largest at the median
+// where it is also held to the 1/compression the header promises
+void
+TestQuantileSketch::rankError(void)
+{
+    QFETCH(double, q);
+
+    double exact = theSortedSamples[static_cast<size_t>(q*NUM_SAMPLES)];
+    double tolerance = std::min(centroidShare(q, 200), 1.0/200);
+
+    QCOMPARE(theSketch.getCount(), double(NUM_SAMPLES));
+    QVERIFY2(fabs(rank(theSketch.quantile(q)) - q) < tolerance, qPrintable(QString::number(rank(theSketch.quantile(q)))));
+    QVERIFY2(fabs(theSketch.cdf(exact) - q) < tolerance, qPrintable(QString::number(theSketch.cdf(exact))));
+
+    QCOMPARE(theMergedSketch.getCount(), double(NUM_SAMPLES));
+    QCOMPARE(theMergedSketch.getMin(), theSortedSamples.front());
+    QCOMPARE(theMergedSketch.getMax(), theSortedSamples.back());
+    QVERIFY2(fabs(rank(theMergedSketch.quantile(q)) - q) < tolerance, qPrintable(QString::number(rank(theMergedSketch.quantile(q)))));
+    QVERIFY2(fabs(theMergedSketch.cdf(exact) - q) < tolerance, qPrintable(QString::number(theMergedSketch.cdf(exact))));
+
+    // the size does not grow with the samples
+    QVERIFY(theSketch.getNumCentroids() <= 200);
+    QVERIFY(theMergedSketch.getNumCentroids() <= 200);
+}
+
+void
+TestQuantileSketch::jsonRoundTrip(void)
+{
+    QJsonObject sketchData;
+    theSketch.writeJSON(sketchData);
+
+    QuantileSketch theCopy(50);
+    QVERIFY(theCopy.readJSON(sketchData));
+    QCOMPARE(theCopy.getCount(), theSketch.getCount());
+    QCOMPARE(theCopy.getMin(), theSketch.getMin());
+    QCOMPARE(theCopy.getMax(), theSketch.getMax());
+    QCOMPARE(theCopy.getNumCentroids(), theSketch.getNumCentroids());
+    for (int i=0; i<=100; i++)
+        QCOMPARE(theCopy.quantile(0.01*i), theSketch.quantile(0.01*i));
+
+    QJsonObject emptyData;
+    QuantileSketch theEmpty;
+    theEmpty.writeJSON(emptyData);
+    QVERIFY(theCopy.readJSON(emptyData));
+    QCOMPARE(theCopy.getCount(), 0.0);
+    QVERIFY(qIsNaN(theCopy.quantile(0.5)));
+}
+
+// one sketch per column, as when the columns are sketched separately
+void
+TestQuantileSketch::sketchColumns(void)
+{
+    SampleDataStore theData;
+    theData.setHeadings(QStringList() << "Run #" << "x");
+    for (int i=0; i<10000; i++) {
+        double row[2] = {static_cast<double>(i+1), theSamples[i]};
+        theData.appendRow(row);
+    }
+
+    QVector<QuantileSketch> sketches;
+    QuantileSketch::sketchColumns(theData, sketches);
+    QCOMPARE(sketches.size(), 2);
+
+    QuantileSketch theColumn;
+    theColumn.add(theSamples.data(), 10000);
+    QCOMPARE(sketches[0].getMin(), 1.0);
+    QCOMPARE(sketches[0].getMax(), 10000.0);
+    for (int i=0; i<=10; i++)
+        QCOMPARE(sketches[1].quantile(0.1*i), theColumn.quantile(0.1*i));
+}
+
+QTEST_MAIN(TestQuantileSketch)
+#include "TestQuantileSketch.moc"
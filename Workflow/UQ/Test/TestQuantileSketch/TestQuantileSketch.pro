@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# QuantileSketch: t-digest quantiles against exact ranks, merged and read back
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestQuantileSketch
+
+SOURCES += TestQuantileSketch.cpp \
+    $$UQ/QuantileSketch.cpp \
+    $$UQ/SampleDataStore.cpp
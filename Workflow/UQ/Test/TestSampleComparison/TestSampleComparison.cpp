@@ -0,0 +1,263 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of SampleComparison: the Kolmogorov distribution and the KS distance
+// at known values, the standardized Anderson-Darling statistic against its
+// exact permutation distribution, and a run compared with a baseline file
+
+#include <QtTest/QtTest>
+#include <SampleComparison.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <vector>
+
+class TestSampleComparison : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void kolmogorovQ_data(void);
+    void kolmogorovQ(void);
+    void ksDistance(void);
+    void andersonDarlingSeparated(void);
+    void andersonDarlingPermutations_data(void);
+    void andersonDarlingPermutations(void);
+    void andersonDarlingPValue(void);
+    void compareWithBaseline(void);
+
+private:
+    QTemporaryDir theDir;
+};
+
+void
+TestSampleComparison::kolmogorovQ_data(void)
+{
+    QTest::addColumn<double>("lambda");
+    QTest::addColumn<double>("q");
+
+    QTest::newRow("0.1") << 0.1 << 1.0;
+    QTest::newRow("0.5") << 0.5 << 0.9639452436648751;
+    QTest::newRow("1") << 1.0 << 0.26999967167735456;
+    QTest::newRow("1.3581") << 1.3580986393225507 << 0.05;
+    QTest::newRow("1.6276") << 1.6276236115189502 << 0.01;
+}
+
+void
+TestSampleComparison::kolmogorovQ(void)
+{
+    QFETCH(double, lambda);
+    QFETCH(double, q);
+
+    QVERIFY(fabs(SampleComparison::kolmogorovQ(lambda) - q) < 1e-9);
+}
+
+// 1 2 3 4 against 2.5 5 6 is furthest apart after 4, at 1 - 1/3; with ties
+// both CDFs step before they are compared
+void
+TestSampleComparison::ksDistance(void)
+{
+    double d, pValue;
+    double x[] = {1, 2, 3, 4};
+    double y[] = {2.5, 5, 6};
+    SampleComparison::ksTest(x, 4, y, 3, d, pValue);
+    QCOMPARE(d, 2.0/3);
+    double en = sqrt(12.0/7);
+    QCOMPARE(pValue, SampleComparison::kolmogorovQ((en + 0.12 + 0.11/en)*d));
+
+    double tiedX[] = {1, 1, 2};
+    double tiedY[] = {1, 2, 2};
+    SampleComparison::ksTest(tiedX, 3, tiedY, 3, d, pValue);
+    QCOMPARE(d, 1.0/3);
+
+    SampleComparison::ksTest(x, 4, x, 4, d, pValue);
+    QCOMPARE(d, 0.0);
+    QCOMPARE(pValue, 1.0);
+
+    SampleComparison::ksTest(x, 0, y, 3, d, pValue);
+    QVERIFY(qIsNaN(d) && qIsNaN(pValue));
+}
+
+// 1 2 against 3 4: A2 = 5/3, its variance with N = 4 is 2/9, so t = sqrt 2
+void
+TestSampleComparison::andersonDarlingSeparated(void)
+{
+    double x[] = {1, 2};
+    double y[] = {3, 4};
+    double t, pValue;
+    SampleComparison::andersonDarlingTest(x, 2, y, 2, t, pValue);
+    QVERIFY(fabs(t - sqrt(2.0)) < 1e-12);
+
+    double three[] = {1, 2, 3};
+    SampleComparison::andersonDarlingTest(three, 1, three+1, 2, t, pValue);
+    QVERIFY(qIsNaN(t) && qIsNaN(pValue));
+}
+
+void
+TestSampleComparison::andersonDarlingPermutations_data(void)
+{
+    QTest::addColumn<int>("n");
+    QTest::addColumn<int>("m");
+
+    QTest::newRow("2,3") << 2 << 3;
+    QTest::newRow("3,4") << 3 << 4;
+    QTest::newRow("5,5") << 5 << 5;
+    QTest::newRow("4,9") << 4 << 9;
+}
+
+// under the null every split of the pooled ranks 1..N into samples of n and
+// m is equally likely; the standardization of Scholz and Stephens is exact
+// for that distribution, so over all the splits t has mean 0 and variance 1
+void
+TestSampleComparison::andersonDarlingPermutations(void)
+{
+    QFETCH(int, n);
+    QFETCH(int, m);
+
+    int N = n+m;
+    std::vector<bool> inX(N, false);
+    std::fill(inX.begin(), inX.begin()+n, true);
+    double sum = 0, sumSq = 0, count = 0;
+    do {
+        std::vector<double> x, y;
+        for (int i=0; i<N; i++)
+            (inX[i] ? x : y).push_back(i+1);
+        double t, pValue;
+        SampleComparison::andersonDarlingTest(x.data(), n, y.data(), m, t, pValue);
+        sum += t;
+        sumSq += t*t;
+        count += 1;
+    } while (std::prev_permutation(inX.begin(), inX.end()));
+
+    QVERIFY(fabs(sum/count) < 1e-12);
+    QVERIFY(fabs(sumSq/count - 1) < 1e-12);
+}
+
+// p-values are only tabulated from 0.001 to 0.25: a clear shift is beyond
+// the table, samples of one distribution within it or at its upper end
+void
+TestSampleComparison::andersonDarlingPValue(void)
+{
+    const int n = 200;
+    std::mt19937_64 generator(23);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(n), y(n), shifted(n);
+    for (int i=0; i<n; i++) {
+        x[i] = normal(generator);
+        y[i] = normal(generator);
+        shifted[i] = y[i] + 2;
+    }
+    std::sort(x.begin(), x.end());
+    std::sort(y.begin(), y.end());
+    std::sort(shifted.begin(), shifted.end());
+
+    double t, pValue;
+    SampleComparison::andersonDarlingTest(x.data(), n, shifted.data(), n, t, pValue);
+    QVERIFY(t > 3.085);
+    QCOMPARE(pValue, 0.001);
+
+    SampleComparison::andersonDarlingTest(x.data(), n, y.data(), n, t, pValue);
+    QVERIFY(pValue >= 0.001 && pValue <= 0.25);
+    if (t < 0.325)
+        QCOMPARE(pValue, 0.25);
+}
+
+// the baseline x and y are standard normal; in the run x is too, y has moved
+// by half a standard deviation: only y is changed
+void
+TestSampleComparison::compareWithBaseline(void)
+{
+    const int n = 2000;
+    std::mt19937_64 generator(29);
+    std::normal_distribution<double> normal(0, 1);
+
+    QByteArray text("%eval_id interface x y\n");
+    for (int i=0; i<n; i++)
+        text += QByteArray::number(i+1) + " NO_ID " + QByteArray::number(normal(generator), 'g', 17)
+                + " " + QByteArray::number(normal(generator), 'g', 17) + "\n";
+    QString fileName = theDir.filePath("baselineTab.out");
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.write(text) == text.size());
+    file.close();
+
+    SampleComparison theComparison;
+    QVERIFY(theComparison.readBaseline(fileName));
+    QVERIFY(theComparison.hasBaseline());
+
+    std::vector<double> run(n), x(n), y(n);
+    for (int i=0; i<n; i++) {
+        run[i] = i+1;
+        x[i] = normal(generator);
+        y[i] = normal(generator) + 0.5;
+    }
+    std::sort(x.begin(), x.end());
+    std::sort(y.begin(), y.end());
+    QStringList headings;
+    headings << "Run #" << "y" << "z" << "x";
+    std::vector<double> z(x);
+    QVector<const std::vector<double> *> columns;
+    columns << &run << &y << &z << &x;
+
+    theComparison.compare(headings, columns);
+    QCOMPARE(theComparison.getNumColumns(), 2);
+    QCOMPARE(theComparison.getNumChanged(), 1);
+
+    const ColumnComparison &theY = theComparison.getColumn(0);
+    QCOMPARE(theY.name, QString("y"));
+    QCOMPARE(theY.count, n);
+    QCOMPARE(theY.baselineCount, n);
+    QVERIFY(theY.changed);
+    QVERIFY(fabs(theY.meanDifference - 0.5) < 0.1);
+    QVERIFY(theY.meanPValue < 1e-6);
+    QVERIFY(theY.ksPValue < 1e-6);
+    QCOMPARE(theY.adPValue, 0.001);
+    for (int i=0; i<NUM_COMPARISON_QUANTILES; i++)
+        QVERIFY(fabs(theY.quantileDifferences[i] - 0.5) < 0.2);
+
+    const ColumnComparison &theX = theComparison.getColumn(1);
+    QCOMPARE(theX.name, QString("x"));
+    QVERIFY(!theX.changed);
+    QVERIFY(theX.ksPValue > 0.05);
+    QVERIFY(fabs(theX.meanDifference) < 0.1);
+}
+
+QTEST_MAIN(TestSampleComparison)
+#include "TestSampleComparison.moc"
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# SampleComparison: KS at known values, AD against its permutation
+# distribution, and a run compared with a baseline file
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestSampleComparison
+
+SOURCES += TestSampleComparison.cpp \
+    $$UQ/SampleComparison.cpp \
+    $$UQ/DakotaTabParser.cpp \
+    $$UQ/OnlineMoments.cpp \
+    $$UQ/SampleDataStore.cpp \
+    $$UQ/QuantileSketch.cpp
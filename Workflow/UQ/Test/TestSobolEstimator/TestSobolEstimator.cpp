@@ -0,0 +1,134 @@
+/* *****************************************************************************
+Copyright (c) 2016-2017, The Regents of the University of California (Regents).
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without 
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+The views and conclusions contained in the software and documentation are those
+of the authors and should not be interpreted as representing official policies,
+either expressed or implied, of the FreeBSD Project.
+
+REGENTS SPECIFICALLY DISCLAIMS ANY WARRANTIES, INCLUDING, BUT NOT LIMITED TO, 
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+THE SOFTWARE AND ACCOMPANYING DOCUMENTATION, IF ANY, PROVIDED HEREUNDER IS 
+PROVIDED "AS IS". REGENTS HAS NO OBLIGATION TO PROVIDE MAINTENANCE, SUPPORT, 
+UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
+
+*************************************************************************** */
+
+// tests of SobolEstimator against functions whose indices are known
+// analytically: a linear function and the Ishigami function
+
+#include <QtTest/QtTest>
+#include <SobolEstimator.h>
+#include <SampleDataStore.h>
+
+#include <math.h>
+#include <random>
+
+#define NUM_SAMPLES 20000
+#define NUM_QUERIES 5000    // the totals' error goes as one over its root
+
+class TestSobolEstimator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void linear(void);
+    void ishigami(void);
+
+private:
+    // columns Run #, x1, x2, x3 and y, the inputs uniform on [-pi, pi]
+    void makeSamples(SampleDataStore &theData, double (*function)(const double *x));
+    void compareIndex(const SobolIndex &theIndex, double main, double total, double tolerance);
+};
+
+static double linearFunction(const double *x)
+{
+    return x[0] + 2.0*x[1];
+}
+
+static double ishigamiFunction(const double *x)
+{
+    return sin(x[0]) + 7.0*sin(x[1])*sin(x[1]) + 0.1*pow(x[2], 4)*sin(x[0]);
+}
+
+void
+TestSobolEstimator::makeSamples(SampleDataStore &theData, double (*function)(const double *x))
+{
+    QStringList headings;
+    headings << "Run #" << "x1" << "x2" << "x3" << "y";
+    theData.setHeadings(headings);
+
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> uniform(-M_PI, M_PI);
+    double row[5];
+    for (int i=0; i<NUM_SAMPLES; i++) {
+        row[0] = i+1;
+        for (int j=1; j<4; j++)
+            row[j] = uniform(generator);
+        row[4] = function(row+1);
+        theData.appendRow(row);
+    }
+}
+
+void
+TestSobolEstimator::compareIndex(const SobolIndex &theIndex, double main, double total, double tolerance)
+{
+    QVERIFY2(fabs(theIndex.main - main) < tolerance, qPrintable(QString::number(theIndex.main)));
+    QVERIFY2(fabs(theIndex.total - total) < tolerance, qPrintable(QString::number(theIndex.total)));
+    QVERIFY(theIndex.mainLower <= theIndex.main && theIndex.main <= theIndex.mainUpper);
+    QVERIFY(theIndex.totalLower <= theIndex.total && theIndex.total <= theIndex.totalUpper);
+}
+
+// no interactions, Var y = 5 Var x: 1/5 and 4/5, x3 does nothing
+void
+TestSobolEstimator::linear(void)
+{
+    SampleDataStore theData;
+    this->makeSamples(theData, linearFunction);
+
+    SobolEstimator theEstimator;
+    theEstimator.setNumQueries(NUM_QUERIES);
+    theEstimator.estimate(theData, 1, 3, 4, 1);
+    this->compareIndex(theEstimator.getIndex(0, 0), 0.2, 0.2, 0.03);
+    this->compareIndex(theEstimator.getIndex(0, 1), 0.8, 0.8, 0.03);
+    this->compareIndex(theEstimator.getIndex(0, 2), 0.0, 0.0, 0.03);
+}
+
+// a = 7, b = 0.1: first order 0.3139, 0.4424 and 0, totals 0.5576, 0.4424
+// and 0.2437, x3 acting only with x1
+void
+TestSobolEstimator::ishigami(void)
+{
+    SampleDataStore theData;
+    this->makeSamples(theData, ishigamiFunction);
+
+    SobolEstimator theEstimator;
+    theEstimator.setNumQueries(NUM_QUERIES);
+    theEstimator.estimate(theData, 1, 3, 4, 1);
+    this->compareIndex(theEstimator.getIndex(0, 0), 0.3139, 0.5576, 0.05);
+    this->compareIndex(theEstimator.getIndex(0, 1), 0.4424, 0.4424, 0.05);
+    this->compareIndex(theEstimator.getIndex(0, 2), 0.0, 0.2437, 0.05);
+}
+
+QTEST_MAIN(TestSobolEstimator)
+#include "TestSobolEstimator.moc"
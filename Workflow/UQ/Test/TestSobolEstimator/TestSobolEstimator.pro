@@ -0,0 +1,15 @@
+#-------------------------------------------------
+#
+# SobolEstimator: the linear and Ishigami functions, indices known analytically
+#
+#-------------------------------------------------
+
+include(../UQTest.pri)
+
+CONFIG   += testcase
+
+TARGET = TestSobolEstimator
+
+SOURCES += TestSobolEstimator.cpp \
+    $$UQ/SobolEstimator.cpp \
+    $$UQ/SampleDataStore.cpp
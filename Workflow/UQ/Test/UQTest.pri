@@ -0,0 +1,17 @@
+#-------------------------------------------------
+#
+# shared by the tests of the result kernels in Workflow/UQ, each a QtTest
+# console application built against the sources it tests
+#
+#-------------------------------------------------
+
+QT       += core testlib concurrent
+QT       -= gui
+
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+UQ = $$PWD/..
+INCLUDEPATH += $$UQ
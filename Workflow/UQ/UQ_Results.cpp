@@ -120,6 +120,23 @@ UQ_Results::processResults(QString &filenameResults, QString &filenameTab) {
     }
 }
 
+int
+UQ_Results::followResults(QString &filenameTab) {
+
+    // not all results can be followed, those that cannot wait for processResults
+    if (resultWidget != 0)
+        return resultWidget->followResults(filenameTab);
+
+    return 0;
+}
+
+void
+UQ_Results::stopFollowingResults(void) {
+
+    if (resultWidget != 0)
+        resultWidget->stopFollowingResults();
+}
+
 void
 UQ_Results::setResultWidget(UQ_Results *result) {
     if (resultWidget != 0) {
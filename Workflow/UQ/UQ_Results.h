@@ -54,6 +54,11 @@ public:
 
     virtual int processResults(QString &filenameResults, QString &filenameTab);
 
+    // show results as they are written by an analysis that is still running
+    virtual int followResults(QString &filenameTab);
+    // the analysis failed, the results followed are all there will be
+    virtual void stopFollowingResults(void);
+
     void setResultWidget(UQ_Results *result);
 
 signals:
@@ -36,6 +36,7 @@
 #include <RemoteService.h>
 #include <SimCenterPreferences.h>
 #include <Utils/RelativePathResolver.h>
+#include <SampleDataStore.h>
 #include "Utils/dialogabout.h"
 
 MainWindowWorkflowApp::MainWindowWorkflowApp(QString appName, WorkflowAppWidget *theApp, RemoteService *theService, QWidget *parent)
@@ -406,8 +407,12 @@ bool MainWindowWorkflowApp::saveFile(const QString &fileName)
     // to write the contents of the object to the file in JSON format
     //
 
+    // result values too many for the json are written beside it
+    SampleDataStore::setProjectFile(fileName);
+
     QJsonObject json;
     inputWidget->outputToJSON(json);
+    SampleDataStore::setProjectFile(QString());
 
     //Resolve relative paths before saving
     QFileInfo fileInfo(fileName);
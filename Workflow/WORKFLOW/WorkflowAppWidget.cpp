@@ -1,11 +1,13 @@
 #include <WorkflowAppWidget.h>
 #include <QWidget>
 #include <RemoteService.h>
+#include <Application.h>
+#include <UQ_Results.h>
 
 #include <QDebug>
 
 WorkflowAppWidget::WorkflowAppWidget(RemoteService *theService, QWidget *parent)
-  :QWidget(parent), theRemoteService(theService)
+  :QWidget(parent), theRemoteService(theService), theFollowedResults(NULL)
 {
   this->setContentsMargins(0,0,0,0);
 }
@@ -22,6 +24,29 @@ WorkflowAppWidget::setMainWindow(MainWindowWorkflowApp* window) {
 }
 
 
+void
+WorkflowAppWidget::setFollowedResults(Application *theApplication, UQ_Results *theResults) {
+    theFollowedResults = theResults;
+    connect(theApplication,SIGNAL(followResults(QString)),this,SLOT(followResults(QString)));
+    connect(theApplication,SIGNAL(stopFollowingResults()),this,SLOT(stopFollowingResults()));
+}
+
+
+void
+WorkflowAppWidget::followResults(QString dakotaTab){
+    // results that cannot be followed wait for processResults
+    if (theFollowedResults != NULL)
+        theFollowedResults->followResults(dakotaTab);
+}
+
+void
+WorkflowAppWidget::stopFollowingResults(void){
+    // the analysis failed, what was followed is all there will be
+    if (theFollowedResults != NULL)
+        theFollowedResults->stopFollowingResults();
+}
+
+
 void
 WorkflowAppWidget::statusMessage(const QString msg){
      qDebug() << "WorkflowAppWidget::statusMessage" << msg;
@@ -43,6 +43,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 class MainWindowWorkflowApp;
 class RemoteService;
+class Application;
+class UQ_Results;
 
 
 class WorkflowAppWidget : public QWidget
@@ -54,6 +56,11 @@ public:
 
     void setMainWindow(MainWindowWorkflowApp* window);
 
+    // the results of an analysis theApplication runs are shown in theResults
+    // while it runs: its followResults and stopFollowingResults come to the
+    // slots here, which pass them on
+    void setFollowedResults(Application *theApplication, UQ_Results *theResults);
+
     virtual bool outputToJSON(QJsonObject &rvObject) =0;
     virtual bool inputFromJSON(QJsonObject &rvObject) =0;
     virtual void clear(void) =0;
@@ -78,6 +85,8 @@ public slots:
 
     virtual void setUpForApplicationRun(QString &, QString &) =0;
     virtual void processResults(QString dakotaOut, QString dakotaTab, QString inputFile) =0;
+    virtual void followResults(QString dakotaTab);
+    virtual void stopFollowingResults(void);
 
     virtual void loadFile(QString filename) =0;
     void statusMessage(QString message);
@@ -87,6 +96,7 @@ public slots:
 protected:
     MainWindowWorkflowApp *theMainWindow;
     RemoteService *theRemoteService;
+    UQ_Results *theFollowedResults;
 };
 
 #endif // WORKFLOW_APP_WIDGET_H
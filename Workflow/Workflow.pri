@@ -18,6 +18,11 @@ INCLUDEPATH += $$PWD/ANALYSIS
 INCLUDEPATH += $$PWD/GRAPHICS
 INCLUDEPATH += $$PWD/EDP
 
+# results plots are drawn through OpenGL when built with CONFIG+=qcustomplot_opengl
+qcustomplot_opengl {
+    DEFINES += QCUSTOMPLOT_USE_OPENGL
+    win32: LIBS += -lopengl32
+}
 
 #INCLUDEPATH += "../SimCenterCommon/Workflow"
 #INCLUDEPATH += "../QUO_Methods"
@@ -28,6 +33,28 @@ SOURCES += $$PWD/UQ/DakotaResults.cpp \
     $$PWD/UQ/DakotaResultsSampling.cpp \
     $$PWD/UQ/DakotaResultsReliability.cpp \
     $$PWD/UQ/DakotaResultsSensitivity.cpp \
+    $$PWD/UQ/SampleDataStore.cpp \
+    $$PWD/UQ/SampleDataModel.cpp \
+    $$PWD/UQ/SampleComparisonModel.cpp \
+    $$PWD/UQ/SampleDataExporter.cpp \
+    $$PWD/UQ/DakotaTabParser.cpp \
+    $$PWD/UQ/DakotaTabFollower.cpp \
+    $$PWD/UQ/DakotaTabMerger.cpp \
+    $$PWD/UQ/DakotaOutIndex.cpp \
+    $$PWD/UQ/DakotaResultsCache.cpp \
+    $$PWD/UQ/DakotaCDFParser.cpp \
+    $$PWD/UQ/SobolEstimator.cpp \
+    $$PWD/UQ/OnlineMoments.cpp \
+    $$PWD/UQ/SampleStatistics.cpp \
+    $$PWD/UQ/SampleColumnCache.cpp \
+    $$PWD/UQ/DensityEstimator.cpp \
+    $$PWD/UQ/SampleFilter.cpp \
+    $$PWD/UQ/BootstrapEstimator.cpp \
+    $$PWD/UQ/DistributionFitter.cpp \
+    $$PWD/UQ/QuantileSketch.cpp \
+    $$PWD/UQ/FragilityFitter.cpp \
+    $$PWD/UQ/SampleComparison.cpp \
+    $$PWD/UQ/CorrelationMatrix.cpp \
     $$PWD/UQ/ImportanceSamplingInputWidget.cpp \
     $$PWD/UQ/MonteCarloInputWidget.cpp \
     $$PWD/UQ/PCEInputWidget.cpp \
@@ -70,6 +97,10 @@ SOURCES += $$PWD/UQ/DakotaResults.cpp \
     $$PWD/GRAPHICS/Controller2D.cpp \
     $$PWD/GRAPHICS/GlWidget2D.cpp \
     $$PWD/GRAPHICS/MyTableWidget.cpp \
+    $$PWD/GRAPHICS/MyTableView.cpp \
+    $$PWD/GRAPHICS/SamplePlot.cpp \
+    $$PWD/GRAPHICS/CorrelationMatrixView.cpp \
+    $$PWD/GRAPHICS/ParallelCoordinatesView.cpp \
     $$PWD/GRAPHICS/GraphicView2D.cpp \
     $$PWD/GRAPHICS/SimCenterGraphPlot.cpp \
     $$PWD/GRAPHICS/qcustomplot.cpp \
@@ -84,6 +115,28 @@ HEADERS += $$PWD/UQ/DakotaResults.h \
     $$PWD/UQ/DakotaResultsSampling.h \
     $$PWD/UQ/DakotaResultsReliability.h \
     $$PWD/UQ/DakotaResultsSensitivity.h \
+    $$PWD/UQ/SampleDataStore.h \
+    $$PWD/UQ/SampleDataModel.h \
+    $$PWD/UQ/SampleComparisonModel.h \
+    $$PWD/UQ/SampleDataExporter.h \
+    $$PWD/UQ/DakotaTabParser.h \
+    $$PWD/UQ/DakotaTabFollower.h \
+    $$PWD/UQ/DakotaTabMerger.h \
+    $$PWD/UQ/DakotaOutIndex.h \
+    $$PWD/UQ/DakotaResultsCache.h \
+    $$PWD/UQ/DakotaCDFParser.h \
+    $$PWD/UQ/SobolEstimator.h \
+    $$PWD/UQ/OnlineMoments.h \
+    $$PWD/UQ/SampleStatistics.h \
+    $$PWD/UQ/SampleColumnCache.h \
+    $$PWD/UQ/DensityEstimator.h \
+    $$PWD/UQ/SampleFilter.h \
+    $$PWD/UQ/BootstrapEstimator.h \
+    $$PWD/UQ/DistributionFitter.h \
+    $$PWD/UQ/QuantileSketch.h \
+    $$PWD/UQ/FragilityFitter.h \
+    $$PWD/UQ/SampleComparison.h \
+    $$PWD/UQ/CorrelationMatrix.h \
     $$PWD/UQ/DakotaInputReliability.h \
     $$PWD/UQ/DakotaInputSensitivity.h \
     $$PWD/UQ/ImportanceSamplingInputWidget.h \
@@ -126,6 +179,10 @@ HEADERS += $$PWD/UQ/DakotaResults.h \
     $$PWD/GRAPHICS/Controller2D.h \
     $$PWD/GRAPHICS/GlWidget2D.h \
     $$PWD/GRAPHICS/MyTableWidget.h \
+    $$PWD/GRAPHICS/MyTableView.h \
+    $$PWD/GRAPHICS/SamplePlot.h \
+    $$PWD/GRAPHICS/CorrelationMatrixView.h \
+    $$PWD/GRAPHICS/ParallelCoordinatesView.h \
     $$PWD/GRAPHICS/GraphicView2D.h \
     $$PWD/GRAPHICS/SimCenterGraphPlot.h \
     $$PWD/GRAPHICS/qcustomplot.h \